@@ -0,0 +1,202 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "pico/platform.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+#include "dma_stream.h"
+
+// The DMA's address for the ring and buffers; the model has its own address
+// space
+#if !PICO_NO_HARDWARE
+#define dma_stream_addr(p) ((uint32_t)(uintptr_t)(p))
+#else
+#define dma_stream_addr(p) dma_model_addr(p)
+#endif
+
+#define SLOT_MASK (DMA_STREAM_SLOTS - 1)
+
+static_assert(!(DMA_STREAM_SLOTS & SLOT_MASK), "DMA_STREAM_SLOTS must be a power of 2");
+
+static dma_stream_t *streams[DMA_STREAM_MAX_STREAMS];
+static bool handler_added;
+
+// Give the fill callback the buffers before the upto'th
+static void release(dma_stream_t *s, uint32_t upto) {
+    while (s->released != upto) {
+        void *buffer = s->buffers[s->released & SLOT_MASK];
+        // Free the slot first, so the callback can queue the buffer again
+        s->released++;
+        if (s->fill) {
+            s->fill(s, buffer, s->user_data);
+        }
+    }
+}
+
+// Start the control channel again, if it has stopped and there is now a
+// buffer where it stopped
+static void restart(dma_stream_t *s) {
+    uint32_t save = save_and_disable_interrupts();
+    if (s->stopped && s->started && s->ring[s->released & SLOT_MASK]) {
+        s->stopped = false;
+        dma_channel_start(s->ctrl_chan);
+    }
+    restore_interrupts(save);
+}
+
+static void service(dma_stream_t *s) {
+    bool underrun = dma_channel_get_irq0_status(s->data_chan);
+    bool moved = dma_channel_get_irq0_status(s->ctrl_chan);
+    if (!underrun && !moved) {
+        return;
+    }
+    if (moved) {
+        dma_channel_acknowledge_irq0(s->ctrl_chan);
+    }
+    // The slots the control channel has read, the last of which is the
+    // buffer being sent, or the zero it stopped at. Slots released to queued
+    // are in use, and queued - released < DMA_STREAM_SLOTS, so the position
+    // in the ring is enough to tell which.
+    uint32_t pos = (dma_hw->ch[s->ctrl_chan].read_addr - dma_stream_addr(s->ring)) / sizeof(uint32_t);
+    if (underrun) {
+        dma_channel_acknowledge_irq0(s->data_chan);
+        s->underruns++;
+        // Back up to the zero, which is where the next buffer goes, and
+        // where the control channel has to start again
+        pos--;
+        dma_channel_set_read_addr(s->ctrl_chan, &s->ring[pos & SLOT_MASK], false);
+        release(s, s->released + ((pos - s->released) & SLOT_MASK));
+        // Only now, or a buffer queued by the callback would restart it on
+        // a slot not yet released
+        s->stopped = true;
+        restart(s);
+    } else {
+        uint32_t read = s->released + ((pos - s->released) & SLOT_MASK);
+        // If it reads as none, the control channel has gone on to the zero,
+        // and the underrun tidies up
+        if (read != s->released) {
+            release(s, read - 1);
+        }
+    }
+}
+
+static void __not_in_flash_func(dma_stream_irq_handler)(void) {
+    for (uint32_t i = 0; i < DMA_STREAM_MAX_STREAMS; ++i) {
+        if (streams[i]) {
+            service(streams[i]);
+        }
+    }
+}
+
+dma_channel_config dma_stream_get_default_config(void) {
+    // The channel isn't known until dma_stream_init(), and CHAIN_TO is set
+    // then
+    return dma_channel_get_default_config(0);
+}
+
+void dma_stream_init(dma_stream_t *stream, const dma_channel_config *config, volatile void *write_addr,
+                     uint32_t transfer_count, dma_stream_fill_callback_t fill, void *user_data) {
+    memset(stream, 0, sizeof(*stream));
+    stream->stopped = true;
+    stream->fill = fill;
+    stream->user_data = user_data;
+    stream->data_chan = (uint)dma_claim_unused_channel(true);
+    stream->ctrl_chan = (uint)dma_claim_unused_channel(true);
+#if PICO_NO_HARDWARE
+    dma_model_add_region(stream->ring, sizeof(stream->ring));
+#endif
+
+    // The data channel raises its interrupt only for a null trigger: an
+    // underrun
+    dma_channel_config c = *config;
+    channel_config_set_chain_to(&c, stream->ctrl_chan);
+    channel_config_set_irq_quiet(&c, true);
+    dma_channel_configure(stream->data_chan, &c, write_addr, NULL, transfer_count, false);
+
+    // The control channel copies one address from the ring to the data
+    // channel's READ_ADDR_TRIG each time it is triggered
+    c = dma_channel_get_default_config(stream->ctrl_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_ring(&c, false, __builtin_ctz(sizeof(stream->ring)));
+    dma_channel_configure(stream->ctrl_chan, &c, &dma_hw->ch[stream->data_chan].al3_read_addr_trig, stream->ring,
+                          1, false);
+
+    for (uint32_t i = 0; i < DMA_STREAM_MAX_STREAMS; ++i) {
+        if (!streams[i]) {
+            streams[i] = stream;
+            break;
+        }
+    }
+    dma_channel_set_irq0_enabled(stream->data_chan, true);
+    dma_channel_set_irq0_enabled(stream->ctrl_chan, true);
+    if (!handler_added) {
+        handler_added = true;
+        irq_add_shared_handler(DMA_IRQ_0, dma_stream_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+    }
+}
+
+void dma_stream_start(dma_stream_t *stream) {
+    stream->started = true;
+    restart(stream);
+}
+
+void dma_stream_deinit(dma_stream_t *stream) {
+    stream->started = false;
+    dma_channel_set_irq0_enabled(stream->data_chan, false);
+    dma_channel_set_irq0_enabled(stream->ctrl_chan, false);
+    // Stop the control channel first, then the data channel, which may have
+    // chained to the control channel before it stopped
+    dma_channel_abort(stream->ctrl_chan);
+    dma_channel_abort(stream->data_chan);
+    dma_channel_abort(stream->ctrl_chan);
+    dma_channel_acknowledge_irq0(stream->data_chan);
+    dma_channel_acknowledge_irq0(stream->ctrl_chan);
+    for (uint32_t i = 0; i < DMA_STREAM_MAX_STREAMS; ++i) {
+        if (streams[i] == stream) {
+            streams[i] = NULL;
+        }
+    }
+    dma_channel_unclaim(stream->data_chan);
+    dma_channel_unclaim(stream->ctrl_chan);
+}
+
+bool dma_stream_enqueue(dma_stream_t *stream, void *buffer) {
+    uint32_t save = save_and_disable_interrupts();
+    uint32_t i = stream->queued;
+    if (i - stream->released >= DMA_STREAM_SLOTS - 1) {
+        restore_interrupts(save);
+        return false;
+    }
+    stream->buffers[i & SLOT_MASK] = buffer;
+    // The new end of the queue, then the buffer over the old one, so the
+    // control channel sees one or the other but never a stale address
+    stream->ring[(i + 1) & SLOT_MASK] = 0;
+    stream->ring[i & SLOT_MASK] = dma_stream_addr(buffer);
+    stream->queued = i + 1;
+    restore_interrupts(save);
+    // The start of the stream, or after an underrun
+    if (stream->stopped) {
+        restart(stream);
+    }
+    return true;
+}
+
+uint32_t dma_stream_get_free(const dma_stream_t *stream) {
+    return DMA_STREAM_SLOTS - 1 - (stream->queued - stream->released);
+}
+
+uint32_t dma_stream_get_underruns(const dma_stream_t *stream) {
+    return stream->underruns;
+}
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _DMA_STREAM_H
+#define _DMA_STREAM_H
+
+// A gapless stream of buffers to a peripheral, e.g. a PIO state machine's TX
+// FIFO, for output which has to keep going at its own rate: LED panels, DACs,
+// serial links.
+//
+// Where channel_irq.c restarts its channel from the interrupt handler, and so
+// leaves a gap of the interrupt latency between buffers, here the DMA goes
+// from one buffer to the next itself. Two channels do the work: the data
+// channel sends a buffer to the peripheral, then chains to a control channel,
+// which reads the address of the next buffer from a ring of them and writes
+// it to the data channel's READ_ADDR_TRIG, starting it again. The end of the
+// queue is a zero in the ring, a null trigger which stops the data channel.
+//
+// The ring is the queue: dma_stream_enqueue() writes a buffer's address into
+// it ahead of the DMA, which takes them without the processor, so producers
+// never wait for the DMA nor it for them. dma_stream_start() sets it going,
+// usually once a few buffers are queued. The interrupt only tidies up after
+// it: for each buffer the DMA has finished with, it calls the fill callback,
+// which can refill it and queue it again. If the DMA catches up with the
+// producers, that is an underrun: the stream stops (the peripheral holds its
+// last output), the underrun is counted, and the next buffer queued starts it
+// again.
+//
+// All the buffers of a stream are the same length, as the data channel keeps
+// its TRANS_COUNT from one to the next.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hardware/dma.h"
+
+// The length of the ring, a power of 2. One slot always holds the zero at
+// the end, so a stream can have one fewer buffers queued, including the one
+// being sent.
+#ifndef DMA_STREAM_SLOTS
+#define DMA_STREAM_SLOTS 8u
+#endif
+
+// The most streams there can be at once
+#ifndef DMA_STREAM_MAX_STREAMS
+#define DMA_STREAM_MAX_STREAMS 4u
+#endif
+
+typedef struct dma_stream dma_stream_t;
+
+// Called from DMA_IRQ_0 with each buffer the DMA has finished with, in the
+// order they were queued. It may queue the buffer (or another) again.
+typedef void (*dma_stream_fill_callback_t)(dma_stream_t *stream, void *buffer, void *user_data);
+
+struct dma_stream {
+    // The addresses of the queued buffers, which the control channel reads
+    volatile uint32_t ring[DMA_STREAM_SLOTS] __attribute__((aligned(DMA_STREAM_SLOTS * sizeof(uint32_t))));
+    void *buffers[DMA_STREAM_SLOTS];
+    // Buffers queued and given back to the fill callback, ever, so that
+    // queued - released are waiting or being sent
+    volatile uint32_t queued;
+    volatile uint32_t released;
+    // Whether dma_stream_start() has been called, and whether the DMA has
+    // stopped at the end of the queue (or not yet started)
+    volatile bool started;
+    volatile bool stopped;
+    volatile uint32_t underruns;
+    uint data_chan;
+    uint ctrl_chan;
+    dma_stream_fill_callback_t fill;
+    void *user_data;
+};
+
+// A configuration for the data channel, to which the caller adds the
+// transfer size, DREQ and so on. Its CHAIN_TO and IRQ_QUIET are set by
+// dma_stream_init(), as the channel isn't known until then.
+dma_channel_config dma_stream_get_default_config(void);
+
+// Claim the two channels for a stream of buffers of transfer_count transfers
+// each, sent to write_addr, and install a shared handler on DMA_IRQ_0. fill
+// may be NULL.
+void dma_stream_init(dma_stream_t *stream, const dma_channel_config *config, volatile void *write_addr,
+                     uint32_t transfer_count, dma_stream_fill_callback_t fill, void *user_data);
+
+// Start sending the queued buffers, and any queued later
+void dma_stream_start(dma_stream_t *stream);
+
+// Stop the stream, without calling the fill callback for the buffers left,
+// and unclaim its channels
+void dma_stream_deinit(dma_stream_t *stream);
+
+// Queue a buffer, which must stay put until it is given to the fill callback.
+// Returns false, having done nothing, if the queue is full. It may be called
+// from the fill callback, and from other interrupts on the same core.
+bool dma_stream_enqueue(dma_stream_t *stream, void *buffer);
+
+// How many more buffers can be queued
+uint32_t dma_stream_get_free(const dma_stream_t *stream);
+
+// How many times the DMA has run out of buffers, not counting the start
+uint32_t dma_stream_get_underruns(const dma_stream_t *stream);
+
+#endif
@@ -0,0 +1,218 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Check the gapless stream in dma_stream.c: the buffers queued are sent one
+// after another, in order, and given back to the fill callback to be sent
+// again; running out of them is counted as an underrun, after which the next
+// one queued starts the stream again; and nothing is sent until it is started
+//
+// Instead of a PIO FIFO, the stream writes to memory, one buffer after the
+// last, so what it sent can be checked. That also means ../dma_model can
+// play the two chained channels and their interrupt on the host:
+//
+//   cc -DPICO_NO_HARDWARE=1 -I../dma_model/include dma_stream_check.c dma_stream.c ../dma_model/dma_model.c
+//
+// where a gap, a buffer out of order or an uncounted underrun fails the run.
+
+#include <stdio.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#include "hardware/irq.h"
+#define count_of(a) (sizeof(a)/sizeof((a)[0]))
+#endif
+
+#include "dma_stream.h"
+
+#define BUF_WORDS 8
+#define N_BUFFERS DMA_STREAM_SLOTS
+// More than the ring holds, so buffers go round several times
+#define N_SENT 40
+
+// The buffers queued, and where they are sent to in place of a PIO FIFO, one
+// after another, with a spare on the end which must stay zero. These are one
+// region in the model; dma_stream.c registers its own ring.
+static struct {
+    uint32_t buffers[N_BUFFERS][BUF_WORDS];
+    uint32_t sent[N_SENT + 1][BUF_WORDS];
+} mem;
+
+static uint32_t failures;
+
+static void check(const char *what, bool ok) {
+    if (!ok) {
+        printf("  %s is wrong\n", what);
+        failures++;
+    }
+}
+
+static dma_stream_t stream;
+
+// The sequence number of the next buffer to fill, the last to fill, and of
+// the next the fill callback should get back
+static volatile uint32_t next_seq;
+static uint32_t last_seq;
+static volatile uint32_t next_back;
+static bool out_of_order;
+
+static void fill_buffer(uint32_t *buffer, uint32_t seq) {
+    for (uint32_t i = 0; i < BUF_WORDS; ++i) {
+        buffer[i] = seq << 16 | i;
+    }
+}
+
+static bool queue_next(uint32_t *buffer) {
+    fill_buffer(buffer, next_seq);
+    if (!dma_stream_enqueue(&stream, buffer)) {
+        return false;
+    }
+    next_seq++;
+    return true;
+}
+
+static void refill(dma_stream_t *s, void *buffer, void *user_data) {
+    (void)s;
+    (void)user_data;
+    uint32_t *b = buffer;
+    if (b[0] >> 16 != next_back++) {
+        out_of_order = true;
+    }
+    if (next_seq < last_seq) {
+        queue_next(b);
+    }
+}
+
+static void start_stream(uint32_t n_sent) {
+    memset(mem.sent, 0, sizeof(mem.sent));
+    next_seq = 0;
+    last_seq = n_sent;
+    next_back = 0;
+    out_of_order = false;
+    dma_channel_config c = dma_stream_get_default_config();
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_write_increment(&c, true);
+    dma_stream_init(&stream, &c, mem.sent, BUF_WORDS, refill, NULL);
+}
+
+// Whether the first n buffers sent were those numbered first onwards, and
+// nothing after them
+static bool sent_ok(uint32_t n, uint32_t first) {
+    static uint32_t expected[BUF_WORDS];
+    for (uint32_t i = 0; i < n; ++i) {
+        fill_buffer(expected, first + i);
+        if (memcmp(mem.sent[i], expected, sizeof(expected))) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < BUF_WORDS; ++i) {
+        if (mem.sent[n][i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void wait_for_sent(uint32_t n) {
+    while (next_back < n) {
+        tight_loop_contents();
+    }
+}
+
+// Fill the queue, then start it. The fill callback keeps it going until
+// N_SENT buffers have gone.
+static void check_stream(void) {
+    start_stream(N_SENT);
+    uint32_t n_queued = 0;
+    while (n_queued < N_BUFFERS && queue_next(mem.buffers[n_queued])) {
+        n_queued++;
+    }
+    check("queue length", n_queued == DMA_STREAM_SLOTS - 1 && !dma_stream_get_free(&stream));
+    check("nothing sent before the start", sent_ok(0, 0) && !next_back);
+    dma_stream_start(&stream);
+    wait_for_sent(N_SENT);
+    check("buffers sent", sent_ok(N_SENT, 0));
+    check("buffers given back", next_back == N_SENT && !out_of_order);
+    check("queue empty", dma_stream_get_free(&stream) == DMA_STREAM_SLOTS - 1);
+    // It has finished, which is an underrun
+    check("underrun", dma_stream_get_underruns(&stream) >= 1);
+    dma_stream_deinit(&stream);
+}
+
+// After an underrun, the next buffer queued goes straight away
+static void check_underrun(void) {
+    start_stream(0);
+    dma_stream_start(&stream);
+    check("no underrun before the first buffer", !dma_stream_get_underruns(&stream));
+    queue_next(mem.buffers[0]);
+    wait_for_sent(1);
+    uint32_t underruns = dma_stream_get_underruns(&stream);
+    check("underrun", underruns == 1);
+    queue_next(mem.buffers[1]);
+    wait_for_sent(2);
+    check("buffers sent", sent_ok(2, 0));
+    check("underrun after restart", dma_stream_get_underruns(&stream) == underruns + 1);
+    dma_stream_deinit(&stream);
+}
+
+// With the interrupt held off, the DMA sends the queue and stops at its end
+// before the handler knows. Buffers queued then go where it stopped, and the
+// handler starts it again.
+static void check_late_handler(void) {
+    start_stream(0);
+    dma_stream_start(&stream);
+    irq_set_enabled(DMA_IRQ_0, false);
+    queue_next(mem.buffers[0]);
+#if PICO_NO_HARDWARE
+    check("sent before the handler", sent_ok(1, 0) && !next_back);
+#else
+    busy_wait_us(100);
+#endif
+    queue_next(mem.buffers[1]);
+    queue_next(mem.buffers[2]);
+    irq_set_enabled(DMA_IRQ_0, true);
+    wait_for_sent(3);
+    check("buffers sent", sent_ok(3, 0));
+    check("buffers given back", next_back == 3 && !out_of_order);
+    dma_stream_deinit(&stream);
+}
+
+typedef struct stream_check {
+    const char *name;
+    void (*run)(void);
+} stream_check_t;
+
+static const stream_check_t checks[] = {
+    {"stream", check_stream},
+    {"underrun", check_underrun},
+    {"late handler", check_late_handler},
+};
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+    puts("DMA stream checks, on the device");
+#else
+    dma_model_add_region(&mem, sizeof(mem));
+    puts("DMA stream checks, on the DMA model");
+#endif
+
+    for (uint32_t i = 0; i < count_of(checks); ++i) {
+        uint32_t before = failures;
+        checks[i].run();
+        printf("%-13s %s\n", checks[i].name, failures == before ? "ok" : "FAILED");
+    }
+
+#if PICO_NO_HARDWARE
+    if (dma_model_get_errors()) {
+        printf("%u DMA bus errors\n", (unsigned)dma_model_get_errors());
+        failures++;
+    }
+#endif
+    printf("\n%s\n", failures ? "DMA stream checks FAILED" : "All DMA stream checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// The LED PWM of channel_irq.c, but sent as a gapless stream of buffers
+// (dma_stream.c) instead of restarting the channel from the interrupt.
+//
+// Three buffers are queued to the PIO serialiser. As each one is sent, the
+// DMA goes straight on to the next without waiting for the processor, and the
+// fill callback refills the one just sent with the next PWM level and queues
+// it again. So the output has no gaps, however late the interrupt, as long as
+// it is less than two buffers late; if it ever is, the stream stops until the
+// next buffer is queued, which is counted as an underrun.
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "pio_serialiser.pio.h"
+
+#include "dma_stream.h"
+
+// As in channel_irq.c: one bit per 10 system clock cycles, and 10 000 words
+// for each of the 32 PWM levels, so about a second for all of them
+#define PIO_SERIAL_CLKDIV 10.f
+#define BUF_WORDS 1000
+#define BUFS_PER_LEVEL 10
+#define N_PWM_LEVELS 32
+#define N_BUFS 3
+
+static uint32_t bufs[N_BUFS][BUF_WORDS];
+static dma_stream_t stream;
+
+static void fill(dma_stream_t *s, void *buffer, void *user_data) {
+    (void)user_data;
+    static uint32_t n;
+    uint32_t level = n++ / BUFS_PER_LEVEL % N_PWM_LEVELS;
+    // Every word has `level` one bits and `(32 - level)` zero bits.
+    uint32_t *words = buffer;
+    for (uint32_t i = 0; i < BUF_WORDS; ++i) {
+        words[i] = ~(~0u << level);
+    }
+    dma_stream_enqueue(s, buffer);
+}
+
+int main() {
+#ifndef PICO_DEFAULT_LED_PIN
+#warning dma/channel_irq stream example requires a board with a regular LED
+#else
+    stdio_init_all();
+
+    uint offset = pio_add_program(pio0, &pio_serialiser_program);
+    pio_serialiser_program_init(pio0, 0, offset, PICO_DEFAULT_LED_PIN, PIO_SERIAL_CLKDIV);
+
+    // Words to PIO0 SM0's TX FIFO, paced by its DREQ
+    dma_channel_config c = dma_stream_get_default_config();
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_dreq(&c, DREQ_PIO0_TX0);
+    dma_stream_init(&stream, &c, &pio0_hw->txf[0], BUF_WORDS, fill, NULL);
+
+    // Fill and queue the buffers, then start
+    for (uint32_t i = 0; i < N_BUFS; ++i) {
+        fill(&stream, bufs[i], NULL);
+    }
+    dma_stream_start(&stream);
+
+    // The processor only has to refill buffers, in the interrupt, leaving it
+    // free to report how it is doing
+    while (true) {
+        sleep_ms(1000);
+        printf("Underruns: %u\n", (unsigned)dma_stream_get_underruns(&stream));
+    }
+#endif
+}
@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Share the DMA between several "drivers" with a pool of channels
+// (dma_pool.c), then print how much each channel did
+//
+// One driver sends lines of text to the UART on a channel of its own, paced
+// by the UART, starting the next line from its callback. Meanwhile a second
+// driver copies blocks of memory on the pool's two channels, more blocks than
+// there are channels, some of them high priority. The copies queue for the
+// channels, high priority first, and all the callbacks come from the one
+// DMA_IRQ_0 handler the pool installs.
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/structs/uart.h"
+
+#include "dma_pool.h"
+
+#define N_BLOCKS 16
+#define BLOCK_WORDS 2048
+
+static const char *const lines[] = {
+    "This text goes to the UART by DMA, one line per transfer,\n",
+    "while other transfers copy blocks of memory, high priority\n",
+    "ones first, on a pool of channels which share one interrupt.\n",
+};
+
+static dma_channel_config uart_config;
+static volatile uint32_t next_line;
+
+// The UART driver's callback: start the next line, if there is one. When
+// next_line has gone past the last line, the last one has been sent.
+static void uart_line_sent(uint channel, void *user_data) {
+    (void)user_data;
+    uint32_t n = next_line++;
+    if (n < count_of(lines)) {
+        dma_pool_channel_start(channel, &uart_config, &uart_get_hw(uart_default)->dr, lines[n], strlen(lines[n]),
+                               DMA_POOL_PRIORITY_NORMAL);
+    }
+}
+
+static uint32_t src[N_BLOCKS][BLOCK_WORDS];
+static uint32_t dst[N_BLOCKS][BLOCK_WORDS];
+static dma_pool_xfer_t copies[N_BLOCKS];
+static volatile uint32_t order[N_BLOCKS];
+static volatile uint32_t n_done;
+
+static void copy_done(dma_pool_xfer_t *xfer, void *user_data) {
+    (void)xfer;
+    order[n_done++] = (uint32_t)(uintptr_t)user_data;
+}
+
+int main() {
+#ifndef uart_default
+#warning dma/channel_pool example requires a UART
+#else
+    stdio_init_all();
+    puts("DMA channel pool example:");
+    dma_pool_init(0, 2);
+
+    for (uint32_t b = 0; b < N_BLOCKS; ++b) {
+        for (uint32_t i = 0; i < BLOCK_WORDS; ++i) {
+            src[b][i] = b << 16 | i;
+        }
+    }
+
+    // The UART driver, on a channel of its own
+    int uart_chan = dma_pool_claim_channel(uart_line_sent, NULL, true);
+    uart_config = dma_channel_get_default_config((uint)uart_chan);
+    channel_config_set_transfer_data_size(&uart_config, DMA_SIZE_8);
+    channel_config_set_dreq(&uart_config, uart_get_dreq(uart_default, true));
+    uart_tx_wait_blocking(uart_default);
+    uart_line_sent((uint)uart_chan, NULL);
+
+    // The copies, every fourth one high priority
+    for (uint32_t b = 0; b < N_BLOCKS; ++b) {
+        dma_pool_xfer_t *x = &copies[b];
+        x->config = dma_pool_get_default_config();
+        channel_config_set_write_increment(&x->config, true);
+        x->write_addr = dst[b];
+        x->read_addr = src[b];
+        x->transfer_count = BLOCK_WORDS;
+        x->priority = b % 4 == 3 ? DMA_POOL_PRIORITY_HIGH : DMA_POOL_PRIORITY_NORMAL;
+        x->callback = copy_done;
+        x->user_data = (void *)(uintptr_t)b;
+        dma_pool_submit(x);
+    }
+
+    while (n_done < N_BLOCKS || next_line <= count_of(lines)) {
+        tight_loop_contents();
+    }
+    dma_pool_unclaim_channel((uint)uart_chan);
+
+    printf("Copies finished in the order:");
+    for (uint32_t i = 0; i < N_BLOCKS; ++i) {
+        printf(" %u%s", (unsigned)order[i], copies[order[i]].priority == DMA_POOL_PRIORITY_HIGH ? "(high)" : "");
+    }
+    printf("\nCopies are %s\n\n", memcmp(src, dst, sizeof(src)) ? "WRONG" : "correct");
+    dma_pool_print_stats();
+    puts("DMA finished.");
+#endif
+}
@@ -0,0 +1,227 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/platform.h"
+#include "pico/time.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+#include "dma_pool.h"
+
+typedef struct slot {
+    // For a driver's channel
+    dma_pool_channel_callback_t callback;
+    void *user_data;
+    // For a pool channel, the transfer it is running
+    dma_pool_xfer_t *xfer;
+    // The transfer the pool started, if it hasn't finished
+    bool timing;
+    uint32_t bytes;
+    uint64_t start_us;
+    dma_pool_stats_t stats;
+} slot_t;
+
+static slot_t slots[NUM_DMA_CHANNELS];
+// The pool's channels, those of them with nothing to do, and drivers' channels
+static uint32_t pool_mask;
+static uint32_t free_mask;
+static uint32_t claimed_mask;
+static uint pool_irq_index;
+
+// Transfers waiting for a channel, by priority
+static dma_pool_xfer_t *queue_head[2];
+static dma_pool_xfer_t *queue_tail[2];
+
+static void enqueue(dma_pool_xfer_t *xfer) {
+    uint p = xfer->priority == DMA_POOL_PRIORITY_HIGH;
+    xfer->next = NULL;
+    if (queue_tail[p]) {
+        queue_tail[p]->next = xfer;
+    } else {
+        queue_head[p] = xfer;
+    }
+    queue_tail[p] = xfer;
+}
+
+static dma_pool_xfer_t *dequeue(void) {
+    for (int p = 1; p >= 0; --p) {
+        dma_pool_xfer_t *xfer = queue_head[p];
+        if (xfer) {
+            queue_head[p] = xfer->next;
+            if (!queue_head[p]) {
+                queue_tail[p] = NULL;
+            }
+            return xfer;
+        }
+    }
+    return NULL;
+}
+
+static void start_channel(uint channel, dma_channel_config c, volatile void *write_addr,
+                          const volatile void *read_addr, uint32_t transfer_count, dma_pool_priority_t priority) {
+    channel_config_set_high_priority(&c, priority == DMA_POOL_PRIORITY_HIGH);
+    channel_config_set_irq_quiet(&c, false);
+    // The error flags are write 1 to clear, so this clears any left by the
+    // last transfer
+    c.ctrl |= DMA_CH0_CTRL_TRIG_READ_ERROR_BITS | DMA_CH0_CTRL_TRIG_WRITE_ERROR_BITS;
+
+    slot_t *s = &slots[channel];
+    uint32_t size = (channel_config_get_ctrl_value(&c) & DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS) >>
+                    DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB;
+    s->bytes = transfer_count << size;
+    s->timing = true;
+    s->start_us = time_us_64();
+    dma_channel_configure(channel, &c, write_addr, read_addr, transfer_count, true);
+}
+
+// Start queued transfers on free channels, high priority first
+static void start_queued(void) {
+    while (free_mask) {
+        dma_pool_xfer_t *xfer = dequeue();
+        if (!xfer) {
+            return;
+        }
+        uint ch = (uint)__builtin_ctz(free_mask);
+        free_mask &= ~(1u << ch);
+        xfer->channel = ch;
+        slots[ch].xfer = xfer;
+        dma_channel_config c = xfer->config;
+        channel_config_set_chain_to(&c, ch);
+        start_channel(ch, c, xfer->write_addr, xfer->read_addr, xfer->transfer_count, xfer->priority);
+    }
+}
+
+static void __not_in_flash_func(dma_pool_irq_handler)(void) {
+    uint32_t mask = pool_mask | claimed_mask;
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch) {
+        if (!(mask & (1u << ch)) || !dma_irqn_get_channel_status(pool_irq_index, ch)) {
+            continue;
+        }
+        dma_irqn_acknowledge_channel(pool_irq_index, ch);
+        slot_t *s = &slots[ch];
+        bool error = dma_hw->ch[ch].ctrl_trig & DMA_CH0_CTRL_TRIG_AHB_ERROR_BITS;
+        if (s->timing) {
+            s->timing = false;
+            s->stats.transfers++;
+            s->stats.busy_us += time_us_64() - s->start_us;
+            if (error) {
+                s->stats.errors++;
+            } else {
+                s->stats.bytes += s->bytes;
+            }
+        }
+        if (pool_mask & (1u << ch)) {
+            // Give the channel to the next transfer before calling back, so
+            // the callback can submit another without it going to the back
+            dma_pool_xfer_t *xfer = s->xfer;
+            s->xfer = NULL;
+            free_mask |= 1u << ch;
+            start_queued();
+            if (xfer) {
+                xfer->error = error;
+                xfer->busy = false;
+                if (xfer->callback) {
+                    xfer->callback(xfer, xfer->user_data);
+                }
+            }
+        } else if (s->callback) {
+            s->callback(ch, s->user_data);
+        }
+    }
+}
+
+void dma_pool_init(uint irq_index, uint n_channels) {
+    pool_irq_index = irq_index;
+    for (uint i = 0; i < n_channels; ++i) {
+        uint ch = (uint)dma_claim_unused_channel(true);
+        pool_mask |= 1u << ch;
+        dma_irqn_set_channel_enabled(irq_index, ch, true);
+    }
+    free_mask = pool_mask;
+    irq_add_shared_handler(DMA_IRQ_0 + irq_index, dma_pool_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0 + irq_index, true);
+}
+
+dma_channel_config dma_pool_get_default_config(void) {
+    // The channel isn't known until the transfer starts, and CHAIN_TO is set
+    // then
+    return dma_channel_get_default_config(0);
+}
+
+void dma_pool_submit(dma_pool_xfer_t *xfer) {
+    xfer->busy = true;
+    xfer->error = false;
+    uint32_t save = save_and_disable_interrupts();
+    enqueue(xfer);
+    start_queued();
+    restore_interrupts(save);
+}
+
+bool dma_pool_xfer_is_busy(const dma_pool_xfer_t *xfer) {
+    return xfer->busy;
+}
+
+void dma_pool_xfer_wait(const dma_pool_xfer_t *xfer) {
+    while (xfer->busy) {
+        tight_loop_contents();
+    }
+}
+
+int dma_pool_claim_channel(dma_pool_channel_callback_t callback, void *user_data, bool required) {
+    int ch = dma_claim_unused_channel(required);
+    if (ch < 0) {
+        return -1;
+    }
+    slot_t *s = &slots[ch];
+    memset(s, 0, sizeof(*s));
+    s->callback = callback;
+    s->user_data = user_data;
+    claimed_mask |= 1u << ch;
+    dma_irqn_set_channel_enabled(pool_irq_index, (uint)ch, true);
+    return ch;
+}
+
+void dma_pool_unclaim_channel(uint channel) {
+    dma_irqn_set_channel_enabled(pool_irq_index, channel, false);
+    claimed_mask &= ~(1u << channel);
+    slots[channel].callback = NULL;
+    dma_channel_unclaim(channel);
+}
+
+void dma_pool_channel_start(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                            const volatile void *read_addr, uint32_t transfer_count, dma_pool_priority_t priority) {
+    start_channel(channel, *config, write_addr, read_addr, transfer_count, priority);
+}
+
+uint32_t dma_pool_get_channel_mask(void) {
+    return pool_mask | claimed_mask;
+}
+
+uint dma_pool_get_free_channels(void) {
+    return (uint)__builtin_popcount(free_mask);
+}
+
+const dma_pool_stats_t *dma_pool_get_stats(uint channel) {
+    return &slots[channel].stats;
+}
+
+void dma_pool_print_stats(void) {
+    printf("%-8s %9s %10s %10s %8s %6s\n", "channel", "transfers", "bytes", "busy us", "MB/s", "errors");
+    uint32_t mask = dma_pool_get_channel_mask();
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch) {
+        if (!(mask & (1u << ch))) {
+            continue;
+        }
+        const dma_pool_stats_t *s = &slots[ch].stats;
+        printf("%-2u %-5s %9u %10llu %10llu %8.1f %6u\n", ch, pool_mask & (1u << ch) ? "pool" : "driver",
+               (unsigned)s->transfers, (unsigned long long)s->bytes, (unsigned long long)s->busy_us,
+               s->busy_us ? (double)s->bytes / (double)s->busy_us : 0.0, (unsigned)s->errors);
+    }
+}
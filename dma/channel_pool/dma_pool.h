@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _DMA_POOL_H
+#define _DMA_POOL_H
+
+// A DMA manager for drivers sharing the DMA: a pool of channels which runs
+// transfers as channels come free, one interrupt handler for all of them, and
+// statistics for each channel.
+//
+// There are two ways to use it:
+//
+// - Submit a dma_pool_xfer_t, and it runs on the first of the pool's
+//   channels to come free. Until then it waits in a queue, behind any other
+//   transfers of the same or higher priority. Its callback is called when it
+//   has finished.
+//
+// - Claim a channel for a driver to use as it likes (e.g. a stream paced by a
+//   peripheral, which restarts itself from its callback), which leaves the
+//   interrupt to the pool. The callback is called each time the channel's
+//   interrupt flag is raised.
+//
+// A transfer's priority also sets HIGH_PRIORITY in its channel's CTRL, so the
+// DMA gives it more of the bus while it runs. Callbacks are called from the
+// pool's interrupt, DMA_IRQ_0 + irq_index, which is installed as a shared
+// handler so other code can still have other channels' interrupts on it.
+//
+// The statistics count transfers, bytes and the time from start to finish,
+// for the transfers the pool starts: those submitted, and those started on a
+// claimed channel by dma_pool_channel_start().
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hardware/dma.h"
+
+typedef enum dma_pool_priority {
+    DMA_POOL_PRIORITY_NORMAL,
+    DMA_POOL_PRIORITY_HIGH
+} dma_pool_priority_t;
+
+typedef struct dma_pool_xfer dma_pool_xfer_t;
+
+typedef void (*dma_pool_xfer_callback_t)(dma_pool_xfer_t *xfer, void *user_data);
+typedef void (*dma_pool_channel_callback_t)(uint channel, void *user_data);
+
+struct dma_pool_xfer {
+    // From dma_pool_get_default_config(); its CHAIN_TO, IRQ_QUIET and
+    // HIGH_PRIORITY are set by the pool
+    dma_channel_config config;
+    volatile void *write_addr;
+    const volatile void *read_addr;
+    uint32_t transfer_count;
+    dma_pool_priority_t priority;
+    // May be NULL
+    dma_pool_xfer_callback_t callback;
+    void *user_data;
+
+    // Set by the pool: whether it is queued or running, the channel it ran
+    // on, and whether that channel stopped with a bus error
+    volatile bool busy;
+    uint channel;
+    bool error;
+    dma_pool_xfer_t *next;
+};
+
+typedef struct dma_pool_stats {
+    uint32_t transfers;
+    uint32_t errors;
+    uint64_t bytes;
+    // Time from start to the interrupt, in microseconds
+    uint64_t busy_us;
+} dma_pool_stats_t;
+
+// Claim n_channels for the pool, and install its handler on
+// DMA_IRQ_0 + irq_index
+void dma_pool_init(uint irq_index, uint n_channels);
+
+dma_channel_config dma_pool_get_default_config(void);
+
+// Run a transfer on the pool's channels. xfer must stay put until it has
+// finished.
+void dma_pool_submit(dma_pool_xfer_t *xfer);
+bool dma_pool_xfer_is_busy(const dma_pool_xfer_t *xfer);
+void dma_pool_xfer_wait(const dma_pool_xfer_t *xfer);
+
+// Claim a channel for a driver, with a callback for its interrupt (which the
+// pool acknowledges). Returns -1 if there are none left and !required.
+int dma_pool_claim_channel(dma_pool_channel_callback_t callback, void *user_data, bool required);
+void dma_pool_unclaim_channel(uint channel);
+
+// Configure and start a claimed channel, counting the transfer in its
+// statistics. CHAIN_TO is left as config has it.
+void dma_pool_channel_start(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                            const volatile void *read_addr, uint32_t transfer_count, dma_pool_priority_t priority);
+
+// The channels the pool manages, its own and claimed ones
+uint32_t dma_pool_get_channel_mask(void);
+
+// How many of the pool's own channels have nothing to do, so a transfer
+// submitted now would start at once
+uint dma_pool_get_free_channels(void);
+const dma_pool_stats_t *dma_pool_get_stats(uint channel);
+void dma_pool_print_stats(void);
+
+#endif
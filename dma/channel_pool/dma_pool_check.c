@@ -0,0 +1,218 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Check the DMA pool in dma_pool.c: transfers run and call back, wait their
+// turn by priority when the channels are busy, and are counted, and a claimed
+// channel gets its callbacks from the pool's interrupt
+//
+// The transfers copy between buffers in RAM, so with ../dma_model standing in
+// for the channels and the shared interrupt this also runs on the host:
+//
+//   cc -DPICO_NO_HARDWARE=1 -I../dma_model/include dma_pool_check.c dma_pool.c ../dma_model/dma_model.c
+//
+// where a transfer left waiting, or a callback missed, fails the run.
+
+#include <stdio.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#include "hardware/irq.h"
+#define count_of(a) (sizeof(a)/sizeof((a)[0]))
+#endif
+
+#include "dma_pool.h"
+
+#define POOL_CHANNELS 2
+#define BUF_WORDS 1024
+
+// The source and destination of the pool's copies, registered with the model
+// as one region
+static struct {
+    uint32_t src[BUF_WORDS];
+    uint32_t dst[BUF_WORDS];
+} mem;
+
+static uint32_t failures;
+
+static void check(const char *what, bool ok) {
+    if (!ok) {
+        printf("  %s is wrong\n", what);
+        failures++;
+    }
+}
+
+static void reset_buffers(void) {
+    for (uint32_t i = 0; i < BUF_WORDS; ++i) {
+        mem.src[i] = i * 0x9e3779b9u;
+    }
+    memset(mem.dst, 0, sizeof(mem.dst));
+}
+
+static void init_xfer(dma_pool_xfer_t *x, uint32_t first, uint32_t words, dma_pool_priority_t priority,
+                      dma_pool_xfer_callback_t callback, void *user_data) {
+    x->config = dma_pool_get_default_config();
+    channel_config_set_write_increment(&x->config, true);
+    x->write_addr = &mem.dst[first];
+    x->read_addr = &mem.src[first];
+    x->transfer_count = words;
+    x->priority = priority;
+    x->callback = callback;
+    x->user_data = user_data;
+}
+
+static uint64_t pool_bytes(void) {
+    uint64_t bytes = 0;
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch) {
+        if (dma_pool_get_channel_mask() & (1u << ch)) {
+            bytes += dma_pool_get_stats(ch)->bytes;
+        }
+    }
+    return bytes;
+}
+
+// The order the transfers finish in
+static uint32_t finished[8];
+static uint32_t n_finished;
+
+static void record_finish(dma_pool_xfer_t *x, void *user_data) {
+    (void)x;
+    finished[n_finished++] = (uint32_t)(uintptr_t)user_data;
+}
+
+// More transfers than channels, all of which run, in pieces which together
+// copy the whole buffer
+static void check_submit(void) {
+    reset_buffers();
+    uint64_t bytes_before = pool_bytes();
+    dma_pool_xfer_t xfers[8];
+    n_finished = 0;
+    for (uint32_t i = 0; i < count_of(xfers); ++i) {
+        init_xfer(&xfers[i], i * BUF_WORDS / 8, BUF_WORDS / 8, DMA_POOL_PRIORITY_NORMAL, record_finish, NULL);
+        dma_pool_submit(&xfers[i]);
+    }
+    for (uint32_t i = 0; i < count_of(xfers); ++i) {
+        dma_pool_xfer_wait(&xfers[i]);
+        check("channel", dma_pool_get_channel_mask() & (1u << xfers[i].channel));
+        check("error flag", !xfers[i].error);
+    }
+    check("callbacks", n_finished == count_of(xfers));
+    check("copy", !memcmp(mem.dst, mem.src, sizeof(mem.src)));
+    check("bytes counted", pool_bytes() - bytes_before == sizeof(mem.src));
+}
+
+// With the interrupt held off, the first two transfers take the channels and
+// the rest queue. The high priority ones then go next, and their channels are
+// set to high priority while they run.
+static void check_priority(void) {
+    static const dma_pool_priority_t priorities[6] = {
+        DMA_POOL_PRIORITY_NORMAL, DMA_POOL_PRIORITY_NORMAL, DMA_POOL_PRIORITY_NORMAL,
+        DMA_POOL_PRIORITY_HIGH, DMA_POOL_PRIORITY_NORMAL, DMA_POOL_PRIORITY_HIGH,
+    };
+    reset_buffers();
+    dma_pool_xfer_t xfers[6];
+    n_finished = 0;
+    irq_set_enabled(DMA_IRQ_0, false);
+    for (uint32_t i = 0; i < count_of(xfers); ++i) {
+        init_xfer(&xfers[i], i * 64, 64, priorities[i], record_finish, (void *)(uintptr_t)i);
+        dma_pool_submit(&xfers[i]);
+    }
+    irq_set_enabled(DMA_IRQ_0, true);
+    for (uint32_t i = 0; i < count_of(xfers); ++i) {
+        dma_pool_xfer_wait(&xfers[i]);
+    }
+    check("callbacks", n_finished == count_of(xfers));
+    // 0 and 1 ran first, then 3 and 5, then 2 and 4, each pair side by side
+    uint32_t order = 0;
+    for (uint32_t i = 0; i < n_finished; ++i) {
+        order |= (i / 2) << (2 * finished[i]);
+    }
+    check("order", order == (0u << 0 | 0u << 2 | 2u << 4 | 1u << 6 | 2u << 8 | 1u << 10));
+    check("copy", !memcmp(mem.dst, mem.src, 6 * 64 * sizeof(uint32_t)));
+
+    // One on its own, so nothing follows it on its channel
+    init_xfer(&xfers[0], 0, 64, DMA_POOL_PRIORITY_HIGH, NULL, NULL);
+    dma_pool_submit(&xfers[0]);
+    dma_pool_xfer_wait(&xfers[0]);
+    check("HIGH_PRIORITY", dma_hw->ch[xfers[0].channel].al1_ctrl & DMA_CH0_CTRL_TRIG_HIGH_PRIORITY_BITS);
+}
+
+// A driver's channel, which its callback restarts until it has sent the
+// whole buffer in pieces
+#define DRIVER_PIECES 4
+
+static volatile uint32_t driver_callbacks;
+static dma_channel_config driver_config;
+
+static void driver_callback(uint ch, void *user_data) {
+    (void)user_data;
+    uint32_t n = ++driver_callbacks;
+    if (n < DRIVER_PIECES) {
+        uint32_t first = n * BUF_WORDS / DRIVER_PIECES;
+        dma_pool_channel_start(ch, &driver_config, &mem.dst[first], &mem.src[first], BUF_WORDS / DRIVER_PIECES,
+                               DMA_POOL_PRIORITY_NORMAL);
+    }
+}
+
+static void check_driver_channel(void) {
+    reset_buffers();
+    driver_callbacks = 0;
+    int ch = dma_pool_claim_channel(driver_callback, NULL, true);
+    driver_config = dma_channel_get_default_config((uint)ch);
+    channel_config_set_write_increment(&driver_config, true);
+    dma_pool_channel_start((uint)ch, &driver_config, mem.dst, mem.src, BUF_WORDS / DRIVER_PIECES,
+                           DMA_POOL_PRIORITY_HIGH);
+    while (driver_callbacks < DRIVER_PIECES) {
+        tight_loop_contents();
+    }
+    const dma_pool_stats_t *stats = dma_pool_get_stats((uint)ch);
+    check("copy", !memcmp(mem.dst, mem.src, sizeof(mem.src)));
+    check("transfers counted", stats->transfers == DRIVER_PIECES);
+    check("bytes counted", stats->bytes == sizeof(mem.src));
+    check("channel mask", dma_pool_get_channel_mask() & (1u << ch));
+    dma_pool_unclaim_channel((uint)ch);
+    check("channel released", !(dma_pool_get_channel_mask() & (1u << ch)) && !dma_channel_is_claimed((uint)ch));
+}
+
+typedef struct pool_check {
+    const char *name;
+    void (*run)(void);
+} pool_check_t;
+
+static const pool_check_t checks[] = {
+    {"submit", check_submit},
+    {"priority", check_priority},
+    {"driver channel", check_driver_channel},
+};
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+    puts("DMA pool checks, on the device");
+#else
+    dma_model_add_region(&mem, sizeof(mem));
+    puts("DMA pool checks, on the DMA model");
+#endif
+    dma_pool_init(0, POOL_CHANNELS);
+
+    for (uint32_t i = 0; i < count_of(checks); ++i) {
+        uint32_t before = failures;
+        checks[i].run();
+        printf("%-15s %s\n", checks[i].name, failures == before ? "ok" : "FAILED");
+    }
+    puts("");
+    dma_pool_print_stats();
+
+#if PICO_NO_HARDWARE
+    if (dma_model_get_errors()) {
+        printf("%u DMA bus errors\n", (unsigned)dma_model_get_errors());
+        failures++;
+    }
+#endif
+    printf("\n%s\n", failures ? "DMA pool checks FAILED" : "All DMA pool checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,691 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+// Where the registers are, as on the device
+#define DMA_BASE 0x50000000u
+// Where regions go
+#define REGION_BASE 0x20000000u
+#define MAX_REGIONS 32
+
+// The writable bits of CTRL, and the error flags, which are write 1 to clear
+#define CTRL_WRITE_BITS 0x00ffffffu
+#define CTRL_ERROR_BITS (DMA_CH0_CTRL_TRIG_READ_ERROR_BITS | DMA_CH0_CTRL_TRIG_WRITE_ERROR_BITS)
+
+dma_hw_t dma_model_hw;
+
+typedef struct channel {
+    uint32_t reload;
+    bool busy;
+    uint64_t transfers;
+} channel_t;
+
+static channel_t channels[NUM_DMA_CHANNELS];
+static uint32_t claimed;
+
+typedef struct region {
+    const volatile uint8_t *p;
+    size_t len;
+    uint32_t addr;
+} region_t;
+
+static region_t regions[MAX_REGIONS];
+static uint32_t n_regions;
+static uint32_t next_region_addr = REGION_BASE;
+
+static uint32_t errors;
+static uint32_t spins;
+
+// The sniffer's accumulator, before OUT_REV and OUT_INV
+static uint32_t sniff_acc;
+
+// Channels triggered but not yet run, and whether we are running them
+static uint32_t pending;
+static bool running;
+static uint32_t budget;
+
+#define MAX_HANDLERS 8
+
+typedef struct irq_line {
+    irq_handler_t handlers[MAX_HANDLERS];
+    uint32_t n_handlers;
+    bool enabled;
+} irq_line_t;
+
+static irq_line_t irq_lines[2];
+
+static void run_pending(void);
+
+// ----------------------------------------------------------------------------
+// Addresses
+
+void dma_model_add_region(const volatile void *p, size_t len) {
+    if (n_regions == MAX_REGIONS) {
+        fprintf(stderr, "dma_model: too many regions\n");
+        abort();
+    }
+    region_t *r = &regions[n_regions++];
+    r->p = p;
+    r->len = len;
+    r->addr = next_region_addr + (uint32_t)((uintptr_t)p & 0xffffu);
+    // Leave a gap after each region, so running off the end is a bus error
+    next_region_addr = ((r->addr + (uint32_t)len + 0xffffu) & ~0xffffu) + 0x10000u;
+}
+
+uint32_t dma_model_addr(const volatile void *p) {
+    if (!p) {
+        return 0;
+    }
+    const volatile uint8_t *b = p;
+    const volatile uint8_t *regs = (const volatile uint8_t *)&dma_model_hw;
+    if (b >= regs && b < regs + sizeof(dma_model_hw)) {
+        return DMA_BASE + (uint32_t)(b - regs);
+    }
+    for (uint32_t i = 0; i < n_regions; ++i) {
+        if (b >= regions[i].p && b < regions[i].p + regions[i].len) {
+            return regions[i].addr + (uint32_t)(b - regions[i].p);
+        }
+    }
+    // One past the end of a region, e.g. the end of a buffer, only if it
+    // isn't the start of another
+    for (uint32_t i = 0; i < n_regions; ++i) {
+        if (b == regions[i].p + regions[i].len) {
+            return regions[i].addr + (uint32_t)regions[i].len;
+        }
+    }
+    fprintf(stderr, "dma_model: %p is not in a region\n", (const void *)p);
+    abort();
+}
+
+// The memory at a DMA address, or NULL if there is none
+static volatile uint8_t *host_ptr(uint32_t addr, uint32_t size) {
+    for (uint32_t i = 0; i < n_regions; ++i) {
+        if (addr >= regions[i].addr && addr - regions[i].addr + size <= regions[i].len) {
+            return (volatile uint8_t *)(uintptr_t)(regions[i].p + (addr - regions[i].addr));
+        }
+    }
+    return NULL;
+}
+
+static bool is_register(uint32_t addr) {
+    return addr >= DMA_BASE && addr - DMA_BASE < sizeof(dma_model_hw);
+}
+
+uint32_t dma_model_get_errors(void) {
+    return errors;
+}
+
+uint64_t dma_model_get_transfers(uint channel) {
+    return channels[channel].transfers;
+}
+
+void tight_loop_contents(void) {
+    if (++spins == 1u << 24) {
+        fprintf(stderr, "dma_model: waiting for DMA which has stopped\n");
+        exit(1);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Registers
+
+// Which of READ_ADDR, WRITE_ADDR, TRANS_COUNT and CTRL each of the 16
+// registers of a channel's four aliases is. The last of each alias triggers.
+enum { REG_READ, REG_WRITE, REG_COUNT, REG_CTRL };
+static const uint8_t alias_reg[16] = {
+    REG_READ, REG_WRITE, REG_COUNT, REG_CTRL,
+    REG_CTRL, REG_READ, REG_WRITE, REG_COUNT,
+    REG_CTRL, REG_COUNT, REG_READ, REG_WRITE,
+    REG_CTRL, REG_WRITE, REG_COUNT, REG_READ,
+};
+
+static uint32_t *channel_words(uint channel) {
+    return (uint32_t *)&dma_model_hw.ch[channel];
+}
+
+// Alias 0 has them in order
+static uint32_t get_reg(uint channel, uint reg) {
+    return channel_words(channel)[reg];
+}
+
+// Set a register, in all four aliases
+static void set_reg(uint channel, uint reg, uint32_t value) {
+    uint32_t *words = channel_words(channel);
+    for (uint32_t slot = 0; slot < 16; ++slot) {
+        if (alias_reg[slot] == reg) {
+            words[slot] = value;
+        }
+    }
+}
+
+static uint32_t bit_reverse(uint32_t v) {
+    uint32_t r = 0;
+    for (uint32_t i = 0; i < 32; ++i, v >>= 1) {
+        r = (r << 1) | (v & 1);
+    }
+    return r;
+}
+
+// SNIFF_DATA as read
+static void update_sniff_data(void) {
+    uint32_t v = sniff_acc;
+    if (dma_model_hw.sniff_ctrl & DMA_SNIFF_CTRL_OUT_REV_BITS) {
+        v = bit_reverse(v);
+    }
+    if (dma_model_hw.sniff_ctrl & DMA_SNIFF_CTRL_OUT_INV_BITS) {
+        v = ~v;
+    }
+    dma_model_hw.sniff_data = v;
+}
+
+static void update_ints(void) {
+    dma_model_hw.ints0 = (dma_model_hw.intr & dma_model_hw.inte0) | dma_model_hw.intf0;
+    dma_model_hw.ints1 = (dma_model_hw.intr & dma_model_hw.inte1) | dma_model_hw.intf1;
+}
+
+static void raise_irq(uint channel) {
+    dma_model_hw.intr |= 1u << channel;
+    update_ints();
+}
+
+static void trigger(uint channel) {
+    if (!channels[channel].busy && (get_reg(channel, REG_CTRL) & DMA_CH0_CTRL_TRIG_EN_BITS)) {
+        pending |= 1u << channel;
+    }
+}
+
+static void abort_channels(uint32_t mask) {
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch) {
+        if (mask & (1u << ch)) {
+            channels[ch].busy = false;
+            set_reg(ch, REG_CTRL, get_reg(ch, REG_CTRL) & ~DMA_CH0_CTRL_TRIG_BUSY_BITS);
+        }
+    }
+    pending &= ~mask;
+}
+
+static void write_channel_reg(uint channel, uint slot, uint32_t value) {
+    uint reg = alias_reg[slot];
+    if (reg == REG_CTRL) {
+        uint32_t old = get_reg(channel, REG_CTRL);
+        uint32_t errs = old & CTRL_ERROR_BITS & ~value;
+        uint32_t ctrl = (value & CTRL_WRITE_BITS) | (old & DMA_CH0_CTRL_TRIG_BUSY_BITS) | errs;
+        if (errs) {
+            ctrl |= DMA_CH0_CTRL_TRIG_AHB_ERROR_BITS;
+        }
+        set_reg(channel, REG_CTRL, ctrl);
+    } else if (reg == REG_COUNT) {
+        channels[channel].reload = value;
+        set_reg(channel, REG_COUNT, value);
+    } else {
+        set_reg(channel, reg, value);
+    }
+    if ((slot & 3) == 3) {
+        if (!value) {
+            // Null trigger: the channel doesn't start, but raises its IRQ in
+            // IRQ_QUIET mode, to mark the end of a chain of control blocks
+            if (get_reg(channel, REG_CTRL) & DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS) {
+                raise_irq(channel);
+            }
+        } else {
+            trigger(channel);
+        }
+    }
+}
+
+// A write to the DMA's registers, by the processor or the DMA itself
+static void write_reg(uint32_t offset, uint32_t value) {
+    if (offset < sizeof(dma_model_hw.ch)) {
+        write_channel_reg(offset / sizeof(dma_channel_hw_t), (offset % sizeof(dma_channel_hw_t)) / 4, value);
+        return;
+    }
+    uint32_t *word = (uint32_t *)((uint8_t *)&dma_model_hw + offset);
+    if (offset == offsetof(dma_hw_t, intr) || offset == offsetof(dma_hw_t, ints0) ||
+        offset == offsetof(dma_hw_t, ints1)) {
+        dma_model_hw.intr &= ~value;
+    } else if (offset == offsetof(dma_hw_t, multi_channel_trigger)) {
+        for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch) {
+            if (value & (1u << ch)) {
+                trigger(ch);
+            }
+        }
+    } else if (offset == offsetof(dma_hw_t, abort)) {
+        abort_channels(value);
+    } else if (offset != offsetof(dma_hw_t, fifo_levels)) {
+        *word = value;
+    }
+    if (offset == offsetof(dma_hw_t, sniff_data)) {
+        sniff_acc = value;
+    }
+    update_sniff_data();
+    update_ints();
+}
+
+// ----------------------------------------------------------------------------
+// Transfers
+
+static bool bus_read(uint32_t addr, uint32_t size, uint32_t *value) {
+    if (addr & (size - 1)) {
+        return false;
+    }
+    if (is_register(addr)) {
+        uint32_t word = *(const uint32_t *)((const uint8_t *)&dma_model_hw + ((addr - DMA_BASE) & ~3u));
+        *value = size == 4 ? word : (word >> (8 * (addr & 3))) & ((1u << (8 * size)) - 1);
+        return true;
+    }
+    volatile uint8_t *p = host_ptr(addr, size);
+    if (!p) {
+        return false;
+    }
+    *value = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+        *value |= (uint32_t)p[i] << (8 * i);
+    }
+    return true;
+}
+
+static bool bus_write(uint32_t addr, uint32_t size, uint32_t value) {
+    if (addr & (size - 1)) {
+        return false;
+    }
+    if (is_register(addr)) {
+        // Narrow writes to registers are replicated across the word
+        if (size == 1) {
+            value = (value & 0xffu) * 0x01010101u;
+        } else if (size == 2) {
+            value = (value & 0xffffu) * 0x00010001u;
+        }
+        write_reg((addr - DMA_BASE) & ~3u, value);
+        return true;
+    }
+    volatile uint8_t *p = host_ptr(addr, size);
+    if (!p) {
+        return false;
+    }
+    for (uint32_t i = 0; i < size; ++i) {
+        p[i] = (uint8_t)(value >> (8 * i));
+    }
+    return true;
+}
+
+static uint32_t next_addr(uint32_t addr, uint32_t size, bool incr, uint32_t ring_bits) {
+    if (!incr) {
+        return addr;
+    }
+    if (!ring_bits) {
+        return addr + size;
+    }
+    uint32_t mask = (1u << ring_bits) - 1;
+    return (addr & ~mask) | ((addr + size) & mask);
+}
+
+static uint32_t bswap(uint32_t value, uint32_t size) {
+    if (size == 2) {
+        return (value >> 8 & 0xffu) | (value & 0xffu) << 8;
+    }
+    if (size == 4) {
+        return value >> 24 | (value >> 8 & 0xff00u) | (value & 0xff00u) << 8 | value << 24;
+    }
+    return value;
+}
+
+static uint32_t crc_byte(uint32_t acc, uint32_t b, bool crc16) {
+    if (crc16) {
+        acc = (acc & 0xffffu) ^ (b << 8);
+        for (uint32_t i = 0; i < 8; ++i) {
+            acc = acc & 0x8000u ? (acc << 1) ^ 0x1021u : acc << 1;
+        }
+        return acc & 0xffffu;
+    }
+    acc ^= b << 24;
+    for (uint32_t i = 0; i < 8; ++i) {
+        acc = acc & 0x80000000u ? (acc << 1) ^ 0x04c11db7u : acc << 1;
+    }
+    return acc;
+}
+
+// Feed a transfer's data to the sniffer, if it is watching the channel
+static void sniff(uint ch, uint32_t ctrl, uint32_t value, uint32_t size) {
+    uint32_t sniff_ctrl = dma_model_hw.sniff_ctrl;
+    if (!(ctrl & DMA_CH0_CTRL_TRIG_SNIFF_EN_BITS) || !(sniff_ctrl & DMA_SNIFF_CTRL_EN_BITS) ||
+        (sniff_ctrl & DMA_SNIFF_CTRL_DMACH_BITS) >> DMA_SNIFF_CTRL_DMACH_LSB != ch) {
+        return;
+    }
+    if (sniff_ctrl & DMA_SNIFF_CTRL_BSWAP_BITS) {
+        value = bswap(value, size);
+    }
+    uint32_t calc = (sniff_ctrl & DMA_SNIFF_CTRL_CALC_BITS) >> DMA_SNIFF_CTRL_CALC_LSB;
+    switch (calc) {
+        case DMA_SNIFF_CTRL_CALC_VALUE_CRC32:
+        case DMA_SNIFF_CTRL_CALC_VALUE_CRC32R:
+        case DMA_SNIFF_CTRL_CALC_VALUE_CRC16:
+        case DMA_SNIFF_CTRL_CALC_VALUE_CRC16R:
+            // The CRCs take the data MSB first, so the most significant byte
+            // of a word goes first; the reflected ones bit reverse the data,
+            // so the least significant byte goes first, LSB first
+            for (uint32_t i = 0; i < size; ++i) {
+                uint32_t b;
+                if (calc & 1) {
+                    b = bit_reverse((value >> (8 * i)) & 0xffu) >> 24;
+                } else {
+                    b = (value >> (8 * (size - 1 - i))) & 0xffu;
+                }
+                sniff_acc = crc_byte(sniff_acc, b, calc & 2);
+            }
+            break;
+        case DMA_SNIFF_CTRL_CALC_VALUE_EVEN:
+            sniff_acc ^= value;
+            break;
+        case DMA_SNIFF_CTRL_CALC_VALUE_SUM:
+            sniff_acc += value;
+            break;
+        default:
+            break;
+    }
+    update_sniff_data();
+}
+
+static void run_channel(uint ch) {
+    channel_t *c = &channels[ch];
+    uint32_t ctrl = get_reg(ch, REG_CTRL);
+    const uint32_t size = 1u << ((ctrl & DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS) >> DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB);
+    const uint32_t ring_bits = (ctrl & DMA_CH0_CTRL_TRIG_RING_SIZE_BITS) >> DMA_CH0_CTRL_TRIG_RING_SIZE_LSB;
+    const bool ring_write = ctrl & DMA_CH0_CTRL_TRIG_RING_SEL_BITS;
+    uint32_t rd = get_reg(ch, REG_READ);
+    uint32_t wr = get_reg(ch, REG_WRITE);
+    uint32_t count = c->reload;
+
+    c->busy = true;
+    set_reg(ch, REG_CTRL, ctrl | DMA_CH0_CTRL_TRIG_BUSY_BITS);
+    uint32_t error = 0;
+    while (count && !error) {
+        if (!budget) {
+            fprintf(stderr, "dma_model: channel %u still going after %u transfers\n", ch, DMA_MODEL_MAX_TRANSFERS);
+            errors++;
+            pending = 0;
+            break;
+        }
+        budget--;
+        uint32_t value;
+        if (!bus_read(rd, size, &value)) {
+            error = DMA_CH0_CTRL_TRIG_READ_ERROR_BITS;
+            break;
+        }
+        if (ctrl & DMA_CH0_CTRL_TRIG_BSWAP_BITS) {
+            value = bswap(value, size);
+        }
+        sniff(ch, ctrl, value, size);
+        // Update the registers first, as the write may be to this channel
+        count--;
+        set_reg(ch, REG_COUNT, count);
+        uint32_t this_wr = wr;
+        rd = next_addr(rd, size, ctrl & DMA_CH0_CTRL_TRIG_INCR_READ_BITS, ring_write ? 0 : ring_bits);
+        wr = next_addr(wr, size, ctrl & DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS, ring_write ? ring_bits : 0);
+        set_reg(ch, REG_READ, rd);
+        set_reg(ch, REG_WRITE, wr);
+        c->transfers += 2;
+        if (!bus_write(this_wr, size, value)) {
+            error = DMA_CH0_CTRL_TRIG_WRITE_ERROR_BITS;
+        }
+        if (!c->busy) {
+            // Aborted by its own write
+            return;
+        }
+    }
+    c->busy = false;
+    ctrl = get_reg(ch, REG_CTRL) & ~DMA_CH0_CTRL_TRIG_BUSY_BITS;
+    if (error) {
+        fprintf(stderr, "dma_model: channel %u bus error at 0x%08x\n", ch,
+                error == DMA_CH0_CTRL_TRIG_READ_ERROR_BITS ? rd : wr);
+        errors++;
+        set_reg(ch, REG_CTRL, ctrl | error | DMA_CH0_CTRL_TRIG_AHB_ERROR_BITS);
+        raise_irq(ch);
+        return;
+    }
+    set_reg(ch, REG_CTRL, ctrl);
+    if (!(ctrl & DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS)) {
+        raise_irq(ch);
+    }
+    uint chain_to = (ctrl & DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS) >> DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB;
+    if (chain_to != ch) {
+        trigger(chain_to);
+    }
+}
+
+// Call the handlers of each enabled interrupt until its flags are clear
+static void deliver_irqs(void) {
+    for (uint32_t n = 0; n < 2; ++n) {
+        irq_line_t *line = &irq_lines[n];
+        volatile uint32_t *ints = n ? &dma_model_hw.ints1 : &dma_model_hw.ints0;
+        while (line->enabled && line->n_handlers && *ints) {
+            uint32_t before = *ints;
+            for (uint32_t i = 0; i < line->n_handlers; ++i) {
+                line->handlers[i]();
+            }
+            if (*ints == before && !pending) {
+                // On the device this would be an interrupt storm
+                fprintf(stderr, "dma_model: DMA_IRQ_%u handlers left INTS%u at 0x%08x\n", n, n, before);
+                errors++;
+                return;
+            }
+            if (pending) {
+                return;
+            }
+        }
+    }
+}
+
+static void run_pending(void) {
+    if (running) {
+        return;
+    }
+    running = true;
+    spins = 0;
+    budget = DMA_MODEL_MAX_TRANSFERS;
+    do {
+        while (pending) {
+            uint ch = (uint)__builtin_ctz(pending);
+            pending &= ~(1u << ch);
+            run_channel(ch);
+        }
+        deliver_irqs();
+    } while (pending);
+    running = false;
+}
+
+// ----------------------------------------------------------------------------
+// SDK functions
+
+void dma_channel_claim(uint channel) {
+    if (claimed & (1u << channel)) {
+        fprintf(stderr, "dma_model: channel %u is already claimed\n", channel);
+        abort();
+    }
+    claimed |= 1u << channel;
+}
+
+void dma_claim_mask(uint32_t channel_mask) {
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch) {
+        if (channel_mask & (1u << ch)) {
+            dma_channel_claim(ch);
+        }
+    }
+}
+
+void dma_channel_unclaim(uint channel) {
+    claimed &= ~(1u << channel);
+}
+
+void dma_unclaim_mask(uint32_t channel_mask) {
+    claimed &= ~channel_mask;
+}
+
+int dma_claim_unused_channel(bool required) {
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch) {
+        if (!(claimed & (1u << ch))) {
+            claimed |= 1u << ch;
+            return (int)ch;
+        }
+    }
+    if (required) {
+        fprintf(stderr, "dma_model: no DMA channels are available\n");
+        abort();
+    }
+    return -1;
+}
+
+bool dma_channel_is_claimed(uint channel) {
+    return claimed & (1u << channel);
+}
+
+dma_channel_config dma_get_channel_config(uint channel) {
+    dma_channel_config c = {get_reg(channel, REG_CTRL) & CTRL_WRITE_BITS};
+    return c;
+}
+
+static void write_slot(uint channel, uint slot, uint32_t value) {
+    write_channel_reg(channel, slot, value);
+    run_pending();
+}
+
+void dma_channel_set_config(uint channel, const dma_channel_config *config, bool trigger) {
+    // CTRL_TRIG or AL1_CTRL
+    write_slot(channel, trigger ? 3 : 4, channel_config_get_ctrl_value(config));
+}
+
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger) {
+    // AL3_READ_ADDR_TRIG or READ_ADDR
+    write_slot(channel, trigger ? 15 : 0, dma_model_addr(read_addr));
+}
+
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger) {
+    // AL2_WRITE_ADDR_TRIG or WRITE_ADDR
+    write_slot(channel, trigger ? 11 : 1, dma_model_addr(write_addr));
+}
+
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger) {
+    // AL1_TRANSFER_COUNT_TRIG or TRANSFER_COUNT
+    write_slot(channel, trigger ? 7 : 2, trans_count);
+}
+
+void dma_start_channel_mask(uint32_t chan_mask) {
+    write_reg(offsetof(dma_hw_t, multi_channel_trigger), chan_mask);
+    run_pending();
+}
+
+void dma_channel_abort(uint channel) {
+    abort_channels(1u << channel);
+}
+
+bool dma_channel_is_busy(uint channel) {
+    return channels[channel].busy || (pending & (1u << channel));
+}
+
+void dma_irqn_set_channel_mask_enabled(uint irq_index, uint32_t channel_mask, bool enabled) {
+    uint32_t *inte = irq_index ? &dma_model_hw.inte1 : &dma_model_hw.inte0;
+    *inte = enabled ? *inte | channel_mask : *inte & ~channel_mask;
+    update_ints();
+    run_pending();
+}
+
+void dma_irqn_acknowledge_channel(uint irq_index, uint channel) {
+    (void)irq_index;
+    dma_model_hw.intr &= ~(1u << channel);
+    update_ints();
+}
+
+void dma_sniffer_enable(uint channel, uint mode, bool force_channel_enable) {
+    if (force_channel_enable) {
+        // AL1_CTRL
+        write_slot(channel, 4, get_reg(channel, REG_CTRL) | DMA_CH0_CTRL_TRIG_SNIFF_EN_BITS);
+    }
+    uint32_t mask = DMA_SNIFF_CTRL_DMACH_BITS | DMA_SNIFF_CTRL_CALC_BITS | DMA_SNIFF_CTRL_EN_BITS;
+    uint32_t value = ((channel << DMA_SNIFF_CTRL_DMACH_LSB) & DMA_SNIFF_CTRL_DMACH_BITS) |
+                     ((mode << DMA_SNIFF_CTRL_CALC_LSB) & DMA_SNIFF_CTRL_CALC_BITS) | DMA_SNIFF_CTRL_EN_BITS;
+    write_reg(offsetof(dma_hw_t, sniff_ctrl), (dma_model_hw.sniff_ctrl & ~mask) | value);
+}
+
+static void set_sniff_ctrl_bits(uint32_t bits, bool set) {
+    uint32_t ctrl = dma_model_hw.sniff_ctrl;
+    write_reg(offsetof(dma_hw_t, sniff_ctrl), set ? ctrl | bits : ctrl & ~bits);
+}
+
+void dma_sniffer_set_byte_swap_enabled(bool swap) {
+    set_sniff_ctrl_bits(DMA_SNIFF_CTRL_BSWAP_BITS, swap);
+}
+
+void dma_sniffer_set_output_invert_enabled(bool invert) {
+    set_sniff_ctrl_bits(DMA_SNIFF_CTRL_OUT_INV_BITS, invert);
+}
+
+void dma_sniffer_set_output_reverse_enabled(bool reverse) {
+    set_sniff_ctrl_bits(DMA_SNIFF_CTRL_OUT_REV_BITS, reverse);
+}
+
+void dma_sniffer_disable(void) {
+    write_reg(offsetof(dma_hw_t, sniff_ctrl), 0);
+}
+
+void dma_sniffer_set_data_accumulator(uint32_t seed_value) {
+    write_reg(offsetof(dma_hw_t, sniff_data), seed_value);
+}
+
+uint32_t dma_sniffer_get_data_accumulator(void) {
+    return dma_model_hw.sniff_data;
+}
+
+// ----------------------------------------------------------------------------
+// Interrupts
+
+static irq_line_t *irq_line(uint num) {
+    if (num != DMA_IRQ_0 && num != DMA_IRQ_1) {
+        fprintf(stderr, "dma_model: IRQ %u isn't modelled\n", num);
+        abort();
+    }
+    return &irq_lines[num - DMA_IRQ_0];
+}
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    irq_line_t *line = irq_line(num);
+    line->handlers[0] = handler;
+    line->n_handlers = 1;
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority) {
+    (void)order_priority;
+    irq_line_t *line = irq_line(num);
+    if (line->n_handlers == MAX_HANDLERS) {
+        fprintf(stderr, "dma_model: too many handlers for IRQ %u\n", num);
+        abort();
+    }
+    line->handlers[line->n_handlers++] = handler;
+}
+
+void irq_remove_handler(uint num, irq_handler_t handler) {
+    irq_line_t *line = irq_line(num);
+    for (uint32_t i = 0; i < line->n_handlers; ++i) {
+        if (line->handlers[i] == handler) {
+            memmove(&line->handlers[i], &line->handlers[i + 1], (line->n_handlers - i - 1) * sizeof(irq_handler_t));
+            line->n_handlers--;
+            return;
+        }
+    }
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    irq_line(num)->enabled = enabled;
+    run_pending();
+}
+
+bool irq_is_enabled(uint num) {
+    return irq_line(num)->enabled;
+}
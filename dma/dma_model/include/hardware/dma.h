@@ -0,0 +1,339 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _HARDWARE_DMA_H
+#define _HARDWARE_DMA_H
+
+// A software model of the RP2040 DMA, for building DMA code on the host, e.g.
+// to check it in CI.
+//
+// This stands in for the SDK's hardware/dma.h (and hardware/irq.h, with
+// hardware/sync.h, pico/platform.h and pico/time.h for the little else DMA
+// drivers use), with the same types and functions, so the code under test is
+// the same as on the device; build with dma_model/include on the include path
+// and dma_model.c alongside it.
+//
+// The model has the 12 channels with their four register aliases, trigger
+// and null trigger, CHAIN_TO, IRQ_QUIET, the transfer sizes, increments, RING
+// and BSWAP, the interrupt flags for DMA_IRQ_0/1, and the sniffer. A channel moves all its
+// data when triggered, as if infinitely fast with DREQs always asserted, so
+// chained channels and the interrupt handlers all run before the call which
+// triggered the first one returns. A list of control blocks which never ends
+// would never return, so the model stops after DMA_MODEL_MAX_TRANSFERS bus
+// transfers from one trigger, and counts that as an error.
+//
+// Addresses are 32 bits, so memory the DMA can see has to be registered with
+// dma_model_add_region(), which gives it addresses in a 32 bit space; the
+// channel registers are already there. A transfer touching any other address
+// stops the channel with a bus error, and is counted by dma_model_get_errors(),
+// which makes bad addresses in hand built descriptors easy to spot.
+//
+// As in hardware, a DMA write to a channel's registers has side effects (a
+// trigger starts the channel), but a processor write to a member of dma_hw
+// doesn't: use the functions, e.g. dma_channel_set_read_addr(), and
+// dma_channel_acknowledge_irq0() rather than writing INTS0.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef _PICO_TYPES_UINT
+#define _PICO_TYPES_UINT
+typedef unsigned int uint;
+#endif
+
+#define NUM_DMA_CHANNELS 12u
+#define DREQ_FORCE 0x3fu
+
+#define DMA_CH0_CTRL_TRIG_EN_BITS            0x00000001u
+#define DMA_CH0_CTRL_TRIG_HIGH_PRIORITY_BITS 0x00000002u
+#define DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB      2
+#define DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS     0x0000000cu
+#define DMA_CH0_CTRL_TRIG_INCR_READ_BITS     0x00000010u
+#define DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS    0x00000020u
+#define DMA_CH0_CTRL_TRIG_RING_SIZE_LSB      6
+#define DMA_CH0_CTRL_TRIG_RING_SIZE_BITS     0x000003c0u
+#define DMA_CH0_CTRL_TRIG_RING_SEL_BITS      0x00000400u
+#define DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB       11
+#define DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS      0x00007800u
+#define DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB       15
+#define DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS      0x001f8000u
+#define DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS     0x00200000u
+#define DMA_CH0_CTRL_TRIG_BSWAP_BITS         0x00400000u
+#define DMA_CH0_CTRL_TRIG_SNIFF_EN_BITS      0x00800000u
+#define DMA_CH0_CTRL_TRIG_BUSY_BITS          0x01000000u
+#define DMA_CH0_CTRL_TRIG_WRITE_ERROR_BITS   0x20000000u
+#define DMA_CH0_CTRL_TRIG_READ_ERROR_BITS    0x40000000u
+#define DMA_CH0_CTRL_TRIG_AHB_ERROR_BITS     0x80000000u
+
+#define DMA_SNIFF_CTRL_EN_BITS      0x00000001u
+#define DMA_SNIFF_CTRL_DMACH_LSB    1
+#define DMA_SNIFF_CTRL_DMACH_BITS   0x0000001eu
+#define DMA_SNIFF_CTRL_CALC_LSB     5
+#define DMA_SNIFF_CTRL_CALC_BITS    0x000001e0u
+#define DMA_SNIFF_CTRL_BSWAP_BITS   0x00000200u
+#define DMA_SNIFF_CTRL_OUT_REV_BITS 0x00000400u
+#define DMA_SNIFF_CTRL_OUT_INV_BITS 0x00000800u
+
+#define DMA_SNIFF_CTRL_CALC_VALUE_CRC32  0x0u
+#define DMA_SNIFF_CTRL_CALC_VALUE_CRC32R 0x1u
+#define DMA_SNIFF_CTRL_CALC_VALUE_CRC16  0x2u
+#define DMA_SNIFF_CTRL_CALC_VALUE_CRC16R 0x3u
+#define DMA_SNIFF_CTRL_CALC_VALUE_EVEN   0xeu
+#define DMA_SNIFF_CTRL_CALC_VALUE_SUM    0xfu
+
+typedef struct {
+    uint32_t read_addr;
+    uint32_t write_addr;
+    uint32_t transfer_count;
+    uint32_t ctrl_trig;
+    uint32_t al1_ctrl;
+    uint32_t al1_read_addr;
+    uint32_t al1_write_addr;
+    uint32_t al1_transfer_count_trig;
+    uint32_t al2_ctrl;
+    uint32_t al2_transfer_count;
+    uint32_t al2_read_addr;
+    uint32_t al2_write_addr_trig;
+    uint32_t al3_ctrl;
+    uint32_t al3_write_addr;
+    uint32_t al3_transfer_count;
+    uint32_t al3_read_addr_trig;
+} dma_channel_hw_t;
+
+typedef struct {
+    dma_channel_hw_t ch[NUM_DMA_CHANNELS];
+    uint32_t _pad0[64];
+    uint32_t intr;
+    uint32_t inte0;
+    uint32_t intf0;
+    uint32_t ints0;
+    uint32_t _pad1;
+    uint32_t inte1;
+    uint32_t intf1;
+    uint32_t ints1;
+    uint32_t timer[4];
+    uint32_t multi_channel_trigger;
+    uint32_t sniff_ctrl;
+    uint32_t sniff_data;
+    uint32_t _pad2;
+    uint32_t fifo_levels;
+    uint32_t abort;
+} dma_hw_t;
+
+extern dma_hw_t dma_model_hw;
+
+#define dma_hw (&dma_model_hw)
+
+enum dma_channel_transfer_size {
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2
+};
+
+typedef struct {
+    uint32_t ctrl;
+} dma_channel_config;
+
+// ----------------------------------------------------------------------------
+// Claiming
+
+void dma_channel_claim(uint channel);
+void dma_claim_mask(uint32_t channel_mask);
+void dma_channel_unclaim(uint channel);
+void dma_unclaim_mask(uint32_t channel_mask);
+int dma_claim_unused_channel(bool required);
+bool dma_channel_is_claimed(uint channel);
+
+// ----------------------------------------------------------------------------
+// Channel configuration
+
+static inline void channel_config_set_read_increment(dma_channel_config *c, bool incr) {
+    c->ctrl = incr ? (c->ctrl | DMA_CH0_CTRL_TRIG_INCR_READ_BITS) : (c->ctrl & ~DMA_CH0_CTRL_TRIG_INCR_READ_BITS);
+}
+
+static inline void channel_config_set_write_increment(dma_channel_config *c, bool incr) {
+    c->ctrl = incr ? (c->ctrl | DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS) : (c->ctrl & ~DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS);
+}
+
+static inline void channel_config_set_dreq(dma_channel_config *c, uint dreq) {
+    c->ctrl = (c->ctrl & ~DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS) | (dreq << DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB);
+}
+
+static inline void channel_config_set_chain_to(dma_channel_config *c, uint chain_to) {
+    c->ctrl = (c->ctrl & ~DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS) | (chain_to << DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB);
+}
+
+static inline void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {
+    c->ctrl = (c->ctrl & ~DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS) | (((uint32_t)size) << DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB);
+}
+
+static inline void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits) {
+    c->ctrl = (c->ctrl & ~(DMA_CH0_CTRL_TRIG_RING_SIZE_BITS | DMA_CH0_CTRL_TRIG_RING_SEL_BITS)) |
+              (size_bits << DMA_CH0_CTRL_TRIG_RING_SIZE_LSB) | (write ? DMA_CH0_CTRL_TRIG_RING_SEL_BITS : 0);
+}
+
+static inline void channel_config_set_bswap(dma_channel_config *c, bool bswap) {
+    c->ctrl = bswap ? (c->ctrl | DMA_CH0_CTRL_TRIG_BSWAP_BITS) : (c->ctrl & ~DMA_CH0_CTRL_TRIG_BSWAP_BITS);
+}
+
+static inline void channel_config_set_irq_quiet(dma_channel_config *c, bool irq_quiet) {
+    c->ctrl = irq_quiet ? (c->ctrl | DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS) : (c->ctrl & ~DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS);
+}
+
+static inline void channel_config_set_high_priority(dma_channel_config *c, bool high_priority) {
+    c->ctrl = high_priority ? (c->ctrl | DMA_CH0_CTRL_TRIG_HIGH_PRIORITY_BITS)
+                            : (c->ctrl & ~DMA_CH0_CTRL_TRIG_HIGH_PRIORITY_BITS);
+}
+
+static inline void channel_config_set_enable(dma_channel_config *c, bool enable) {
+    c->ctrl = enable ? (c->ctrl | DMA_CH0_CTRL_TRIG_EN_BITS) : (c->ctrl & ~DMA_CH0_CTRL_TRIG_EN_BITS);
+}
+
+static inline void channel_config_set_sniff_enable(dma_channel_config *c, bool sniff_enable) {
+    c->ctrl = sniff_enable ? (c->ctrl | DMA_CH0_CTRL_TRIG_SNIFF_EN_BITS) : (c->ctrl & ~DMA_CH0_CTRL_TRIG_SNIFF_EN_BITS);
+}
+
+static inline dma_channel_config dma_channel_get_default_config(uint channel) {
+    dma_channel_config c = {0};
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, DREQ_FORCE);
+    channel_config_set_chain_to(&c, channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_ring(&c, false, 0);
+    channel_config_set_bswap(&c, false);
+    channel_config_set_irq_quiet(&c, false);
+    channel_config_set_enable(&c, true);
+    channel_config_set_sniff_enable(&c, false);
+    channel_config_set_high_priority(&c, false);
+    return c;
+}
+
+static inline uint32_t channel_config_get_ctrl_value(const dma_channel_config *config) {
+    return config->ctrl;
+}
+
+dma_channel_config dma_get_channel_config(uint channel);
+
+// ----------------------------------------------------------------------------
+// Registers
+
+void dma_channel_set_config(uint channel, const dma_channel_config *config, bool trigger);
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger);
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger);
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger);
+
+static inline void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                                         const volatile void *read_addr, uint transfer_count, bool trigger) {
+    dma_channel_set_read_addr(channel, read_addr, false);
+    dma_channel_set_write_addr(channel, write_addr, false);
+    dma_channel_set_trans_count(channel, transfer_count, false);
+    dma_channel_set_config(channel, config, trigger);
+}
+
+void dma_start_channel_mask(uint32_t chan_mask);
+
+static inline void dma_channel_start(uint channel) {
+    dma_start_channel_mask(1u << channel);
+}
+
+void dma_channel_abort(uint channel);
+bool dma_channel_is_busy(uint channel);
+
+static inline void dma_channel_wait_for_finish_blocking(uint channel) {
+    while (dma_channel_is_busy(channel));
+}
+
+// ----------------------------------------------------------------------------
+// Interrupts
+
+void dma_irqn_set_channel_mask_enabled(uint irq_index, uint32_t channel_mask, bool enabled);
+
+static inline void dma_channel_set_irq0_enabled(uint channel, bool enabled) {
+    dma_irqn_set_channel_mask_enabled(0, 1u << channel, enabled);
+}
+
+static inline void dma_set_irq0_channel_mask_enabled(uint32_t channel_mask, bool enabled) {
+    dma_irqn_set_channel_mask_enabled(0, channel_mask, enabled);
+}
+
+static inline void dma_channel_set_irq1_enabled(uint channel, bool enabled) {
+    dma_irqn_set_channel_mask_enabled(1, 1u << channel, enabled);
+}
+
+static inline void dma_set_irq1_channel_mask_enabled(uint32_t channel_mask, bool enabled) {
+    dma_irqn_set_channel_mask_enabled(1, channel_mask, enabled);
+}
+
+static inline void dma_irqn_set_channel_enabled(uint irq_index, uint channel, bool enabled) {
+    dma_irqn_set_channel_mask_enabled(irq_index, 1u << channel, enabled);
+}
+
+static inline bool dma_irqn_get_channel_status(uint irq_index, uint channel) {
+    return (irq_index ? dma_hw->ints1 : dma_hw->ints0) & (1u << channel);
+}
+
+static inline bool dma_channel_get_irq0_status(uint channel) {
+    return dma_irqn_get_channel_status(0, channel);
+}
+
+static inline bool dma_channel_get_irq1_status(uint channel) {
+    return dma_irqn_get_channel_status(1, channel);
+}
+
+// Clears the channel's flag in INTR, so for either IRQ
+void dma_irqn_acknowledge_channel(uint irq_index, uint channel);
+
+static inline void dma_channel_acknowledge_irq0(uint channel) {
+    dma_irqn_acknowledge_channel(0, channel);
+}
+
+static inline void dma_channel_acknowledge_irq1(uint channel) {
+    dma_irqn_acknowledge_channel(1, channel);
+}
+
+// ----------------------------------------------------------------------------
+// Sniffer
+//
+// The accumulator is kept as written, and OUT_REV and OUT_INV are applied as
+// it is read. The CRCs are MSB first, with CRC32R and CRC16R bit reversing
+// each byte on the way in; a CRC16 is in the low 16 bits. Each transfer feeds
+// its bytes in address order (after BSWAP), and EVEN and SUM take the value
+// transferred, zero extended: EVEN XORs it into the accumulator, whose parity
+// is then that of the data, and SUM adds it.
+
+void dma_sniffer_enable(uint channel, uint mode, bool force_channel_enable);
+void dma_sniffer_set_byte_swap_enabled(bool swap);
+void dma_sniffer_set_output_invert_enabled(bool invert);
+void dma_sniffer_set_output_reverse_enabled(bool reverse);
+void dma_sniffer_disable(void);
+void dma_sniffer_set_data_accumulator(uint32_t seed_value);
+uint32_t dma_sniffer_get_data_accumulator(void);
+
+// ----------------------------------------------------------------------------
+// Not in the SDK
+
+#ifndef DMA_MODEL_MAX_TRANSFERS
+#define DMA_MODEL_MAX_TRANSFERS (1u << 24)
+#endif
+
+// Make len bytes at p visible to the DMA, giving them addresses which keep
+// the alignment of p (up to 64 KiB)
+void dma_model_add_region(const volatile void *p, size_t len);
+// The DMA's address for p, which must be in a region (or NULL, which is 0)
+uint32_t dma_model_addr(const volatile void *p);
+// The number of bus errors, and of runs stopped at DMA_MODEL_MAX_TRANSFERS
+uint32_t dma_model_get_errors(void);
+// The number of bus transfers (reads and writes) made by a channel
+uint64_t dma_model_get_transfers(uint channel);
+
+// The DMA has always finished by the time the processor looks, so a loop
+// waiting for it which spins here for long with no DMA activity is waiting
+// for something that will never happen: it exits with an error
+void tight_loop_contents(void);
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _HARDWARE_IRQ_H
+#define _HARDWARE_IRQ_H
+
+// The interrupt handling half of the DMA model (see hardware/dma.h): handlers
+// for the two DMA interrupts, which the model calls when their INTS flags are
+// set and the interrupt is enabled. Shared handlers are called in the order
+// they were added, as order_priority isn't modelled.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hardware/dma.h"
+
+#define DMA_IRQ_0 11u
+#define DMA_IRQ_1 12u
+
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+#define PICO_SHARED_IRQ_HANDLER_HIGHEST_ORDER_PRIORITY 0xff
+#define PICO_SHARED_IRQ_HANDLER_LOWEST_ORDER_PRIORITY 0x00
+
+typedef void (*irq_handler_t)(void);
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority);
+void irq_remove_handler(uint num, irq_handler_t handler);
+void irq_set_enabled(uint num, bool enabled);
+bool irq_is_enabled(uint num);
+
+#endif
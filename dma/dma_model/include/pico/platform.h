@@ -0,0 +1,16 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_PLATFORM_H
+#define _PICO_PLATFORM_H
+
+// Stands in for the SDK's pico/platform.h with the DMA model (see
+// hardware/dma.h). There is no flash on the host, so functions which have to
+// run from RAM on the device are just functions.
+
+#define __not_in_flash_func(func_name) func_name
+
+#endif
@@ -0,0 +1,191 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#endif
+
+#include "dma_memcpy.h"
+
+static uint32_t crossover = DMA_MEMCPY_CROSSOVER;
+
+static void finish(dma_memcpy_op_t *op) {
+    op->busy = false;
+    if (op->callback) {
+        op->callback(op, op->user_data);
+    }
+}
+
+// From the pool's interrupt, as each piece finishes
+static void piece_done(dma_pool_xfer_t *xfer, void *user_data) {
+    (void)xfer;
+    dma_memcpy_op_t *op = user_data;
+    if (!--op->pending) {
+        finish(op);
+    }
+}
+
+void dma_memcpy_set_crossover(uint32_t bytes) {
+    crossover = bytes;
+}
+
+uint32_t dma_memcpy_get_crossover(void) {
+    return crossover;
+}
+
+static void init_piece(dma_memcpy_op_t *op, dma_pool_xfer_t *x, enum dma_channel_transfer_size size,
+                       bool read_increment, void *dst, const void *src, uint32_t count) {
+    x->config = dma_pool_get_default_config();
+    channel_config_set_transfer_data_size(&x->config, size);
+    channel_config_set_read_increment(&x->config, read_increment);
+    channel_config_set_write_increment(&x->config, true);
+    x->write_addr = dst;
+    x->read_addr = src;
+    x->transfer_count = count;
+    x->priority = DMA_POOL_PRIORITY_NORMAL;
+    x->callback = piece_done;
+    x->user_data = op;
+}
+
+// Submit the pieces set up, once they are all counted, so that the first to
+// finish can't finish the op
+static void submit_pieces(dma_memcpy_op_t *op, uint32_t n) {
+    op->busy = true;
+    op->pending = n;
+    for (uint32_t i = 0; i < n; ++i) {
+        dma_pool_submit(&op->pieces[i]);
+    }
+}
+
+// Copy (or set, if src is NULL) len bytes with the DMA: the processor does
+// the ends, and the middle is split between as many of the pool's free
+// channels as its size allows. Returns false, having done nothing, if none
+// of them is free.
+static bool start_split(dma_memcpy_op_t *op, uint8_t *dst, const uint8_t *src, uint8_t value, uint32_t len) {
+    // The widest transfers which keep both addresses aligned
+    uint32_t misalign = src ? (uint32_t)((uintptr_t)dst ^ (uintptr_t)src) : 0;
+    enum dma_channel_transfer_size size = !(misalign & 3) ? DMA_SIZE_32 : !(misalign & 1) ? DMA_SIZE_16 : DMA_SIZE_8;
+    uint32_t head = (uint32_t)-(uintptr_t)dst & ((1u << size) - 1);
+    if (head > len) {
+        head = len;
+    }
+    uint32_t items = (len - head) >> size;
+    uint32_t n = dma_pool_get_free_channels();
+    if (!items || !n) {
+        return false;
+    }
+    uint32_t pieces = (items << size) / DMA_MEMCPY_SPLIT_MIN;
+    if (n > pieces) {
+        n = pieces ? pieces : 1;
+    }
+    if (n > DMA_MEMCPY_MAX_PIECES) {
+        n = DMA_MEMCPY_MAX_PIECES;
+    }
+
+    uint32_t tail = len - head - (items << size);
+    uint32_t tail_offset = head + (items << size);
+    if (src) {
+        memcpy(dst, src, head);
+        memcpy(dst + tail_offset, src + tail_offset, tail);
+    } else {
+        memset(dst, value, head);
+        memset(dst + tail_offset, value, tail);
+        op->pattern = value * 0x01010101u;
+    }
+
+    uint32_t per_piece = items / n;
+    uint32_t offset = head;
+    for (uint32_t i = 0; i < n; ++i) {
+        uint32_t count = i < n - 1 ? per_piece : items - per_piece * (n - 1);
+        init_piece(op, &op->pieces[i], size, src != NULL, dst + offset, src ? src + offset : (void *)&op->pattern,
+                   count);
+        offset += count << size;
+    }
+    submit_pieces(op, n);
+    return true;
+}
+
+bool dma_memcpy_async(dma_memcpy_op_t *op, void *dst, const void *src, uint32_t len,
+                      dma_memcpy_callback_t callback, void *user_data) {
+    op->callback = callback;
+    op->user_data = user_data;
+    if (len >= crossover && start_split(op, dst, src, 0, len)) {
+        return true;
+    }
+    memcpy(dst, src, len);
+    finish(op);
+    return false;
+}
+
+bool dma_memset_async(dma_memcpy_op_t *op, void *dst, uint8_t value, uint32_t len,
+                      dma_memcpy_callback_t callback, void *user_data) {
+    op->callback = callback;
+    op->user_data = user_data;
+    if (len >= crossover && start_split(op, dst, NULL, value, len)) {
+        return true;
+    }
+    memset(dst, value, len);
+    finish(op);
+    return false;
+}
+
+static uintptr_t next_addr(uintptr_t addr, uint32_t size, uint ring_bits) {
+    if (!ring_bits) {
+        return addr + size;
+    }
+    uintptr_t mask = ((uintptr_t)1 << ring_bits) - 1;
+    return (addr & ~mask) | ((addr + size) & mask);
+}
+
+// What the DMA would do, for when there isn't a channel
+static void cpu_copy_with_opts(void *dst, const void *src, uint32_t len, const dma_memcpy_opts_t *opts) {
+    uint32_t size = 1u << opts->size;
+    uintptr_t rd = (uintptr_t)src, wr = (uintptr_t)dst;
+    for (uint32_t i = 0; i < len; i += size) {
+        uint8_t item[4];
+        memcpy(item, (const void *)rd, size);
+        if (opts->bswap) {
+            for (uint32_t j = 0; j < size / 2; ++j) {
+                uint8_t t = item[j];
+                item[j] = item[size - 1 - j];
+                item[size - 1 - j] = t;
+            }
+        }
+        memcpy((void *)wr, item, size);
+        rd = next_addr(rd, size, opts->ring_write ? 0 : opts->ring_bits);
+        wr = next_addr(wr, size, opts->ring_write ? opts->ring_bits : 0);
+    }
+}
+
+bool dma_memcpy_async_with_opts(dma_memcpy_op_t *op, void *dst, const void *src, uint32_t len,
+                                const dma_memcpy_opts_t *opts, dma_memcpy_callback_t callback, void *user_data) {
+    op->callback = callback;
+    op->user_data = user_data;
+    if (!dma_pool_get_free_channels()) {
+        cpu_copy_with_opts(dst, src, len, opts);
+        finish(op);
+        return false;
+    }
+    dma_pool_xfer_t *x = &op->pieces[0];
+    init_piece(op, x, opts->size, true, dst, src, len >> opts->size);
+    channel_config_set_bswap(&x->config, opts->bswap);
+    channel_config_set_ring(&x->config, opts->ring_write, opts->ring_bits);
+    submit_pieces(op, 1);
+    return true;
+}
+
+bool dma_memcpy_is_busy(const dma_memcpy_op_t *op) {
+    return op->busy;
+}
+
+void dma_memcpy_wait(const dma_memcpy_op_t *op) {
+    while (op->busy) {
+        tight_loop_contents();
+    }
+}
@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _DMA_MEMCPY_H
+#define _DMA_MEMCPY_H
+
+// memcpy() and memset() by DMA, in the background.
+//
+// A copy of at least the crossover size is done by the DMA, with the widest
+// transfers the alignment of dst and src allows: the processor does the bytes
+// up to the first word (or halfword) boundary, and after the last, and the
+// DMA the rest. A large copy is split across several channels, each starting
+// DMA_MEMCPY_SPLIT_MIN or more bytes apart. Anything smaller than the
+// crossover is quicker for the processor to do itself, as it is, before the
+// call returns; the default crossover is only a rough guess, so measure it
+// with dma_memcpy_bench and set it with dma_memcpy_set_crossover().
+//
+// dma_memcpy_async_with_opts() instead gives the transfer size, byte swap and
+// address ring to use, and always copies as one DMA transfer of len bytes.
+//
+// The channels are those of the DMA pool (dma/channel_pool), which the
+// caller sets up with dma_pool_init(), so copies share them with the other
+// users of the pool. When none of them is free, the processor does the copy,
+// rather than wait for one. The completion callbacks come from the pool's
+// interrupt.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hardware/dma.h"
+
+#include "dma_pool.h"
+
+#ifndef DMA_MEMCPY_CROSSOVER
+#define DMA_MEMCPY_CROSSOVER 256u
+#endif
+
+#ifndef DMA_MEMCPY_SPLIT_MIN
+#define DMA_MEMCPY_SPLIT_MIN 4096u
+#endif
+
+// The most pieces a copy is split into
+#ifndef DMA_MEMCPY_MAX_PIECES
+#define DMA_MEMCPY_MAX_PIECES 4u
+#endif
+
+typedef struct dma_memcpy_op dma_memcpy_op_t;
+
+typedef void (*dma_memcpy_callback_t)(dma_memcpy_op_t *op, void *user_data);
+
+// The DMA reads pattern for a memset, so like the pieces, the op has to be
+// somewhere the DMA can see until it has finished
+struct dma_memcpy_op {
+    dma_pool_xfer_t pieces[DMA_MEMCPY_MAX_PIECES];
+    uint32_t pattern;
+    // The pieces still copying
+    volatile uint32_t pending;
+    volatile bool busy;
+    dma_memcpy_callback_t callback;
+    void *user_data;
+};
+
+typedef struct dma_memcpy_opts {
+    enum dma_channel_transfer_size size;
+    bool bswap;
+    // Wrap the read (or write) address on a (1 << ring_bits) byte boundary,
+    // if ring_bits isn't 0
+    uint ring_bits;
+    bool ring_write;
+} dma_memcpy_opts_t;
+
+void dma_memcpy_set_crossover(uint32_t bytes);
+uint32_t dma_memcpy_get_crossover(void);
+
+// Copy len bytes from src to dst, which mustn't overlap. Returns true if the
+// DMA is doing it, in which case callback (which may be NULL) is called from
+// DMA_IRQ_0 when it's done; otherwise it's already done, and callback has
+// been called. Neither buffer may be used until then.
+bool dma_memcpy_async(dma_memcpy_op_t *op, void *dst, const void *src, uint32_t len,
+                      dma_memcpy_callback_t callback, void *user_data);
+
+// Set len bytes at dst to value, in the same way
+bool dma_memset_async(dma_memcpy_op_t *op, void *dst, uint8_t value, uint32_t len,
+                      dma_memcpy_callback_t callback, void *user_data);
+
+// Copy len bytes as opts says; len must be a multiple of the transfer size,
+// and dst and src aligned to it. Without a free channel, the processor does
+// the same thing.
+bool dma_memcpy_async_with_opts(dma_memcpy_op_t *op, void *dst, const void *src, uint32_t len,
+                                const dma_memcpy_opts_t *opts, dma_memcpy_callback_t callback, void *user_data);
+
+bool dma_memcpy_is_busy(const dma_memcpy_op_t *op);
+void dma_memcpy_wait(const dma_memcpy_op_t *op);
+
+#endif
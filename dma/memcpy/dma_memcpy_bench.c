@@ -0,0 +1,308 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Check the copies and sets dma_memcpy.c makes, then time them against the
+// processor's memcpy() and memset()
+//
+// The checks copy and set buffers of many sizes and alignments, with and
+// without the DMA, with byte swaps and rings, split across channels and with
+// no channel free, and compare the results (and the bytes either side) with
+// the same done by the processor a byte at a time.
+//
+// The timings sweep copy sizes and alignments, and print bytes per processor
+// clock cycle for the processor alone, the DMA alone, and both at once with
+// the DMA doing half and the processor the other half, then measure the
+// crossover size below which the processor is quicker.
+//
+// On the host, which can't time the DMA, the checks run on the DMA model, and
+// the timings give way to the model's count of bus transfers per byte, which
+// still shows up a change to narrower transfers:
+//
+//   cc -DPICO_NO_HARDWARE=1 -I../dma_model/include -I../channel_pool dma_memcpy_bench.c dma_memcpy.c ../channel_pool/dma_pool.c ../dma_model/dma_model.c
+
+#include <stdio.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "cycle_counter.h"
+#else
+#include "hardware/irq.h"
+#define count_of(a) (sizeof(a)/sizeof((a)[0]))
+#endif
+
+#include "dma_memcpy.h"
+
+#define N_CHANNELS 4
+#define BUF_SIZE (4 * DMA_MEMCPY_SPLIT_MIN)
+// Room either side of a copy, to check it leaves it alone, which keeps the
+// buffers aligned for the rings
+#define GUARD 64
+#define GUARD_BYTE 0xa5
+
+// The buffers, with GUARD bytes either side to catch a copy running over, and
+// the ops, whose memset patterns the DMA reads, registered with the model as
+// one region. 64 byte aligned, so the address rings start where the copies
+// do.
+static struct {
+    uint8_t src[BUF_SIZE + 2 * GUARD];
+    uint8_t dst[BUF_SIZE + 2 * GUARD];
+    // The DMA reads a memset's pattern from its op, and the second is for
+    // copies made while the first is still going
+    dma_memcpy_op_t op;
+    dma_memcpy_op_t small_op;
+} mem __attribute__((aligned(64)));
+
+static uint8_t expected[BUF_SIZE + 2 * GUARD];
+
+static uint32_t failures;
+
+static void check(const char *what, uint32_t len, uint32_t dst_offset, uint32_t src_offset, bool ok) {
+    if (!ok) {
+        printf("  %s of %u bytes, dst + %u, src + %u is wrong\n", what, (unsigned)len, (unsigned)dst_offset,
+               (unsigned)src_offset);
+        failures++;
+    }
+}
+
+static uint32_t rand_state = 1;
+
+static uint32_t next_rand(void) {
+    rand_state = rand_state * 1103515245u + 12345u;
+    return rand_state >> 8;
+}
+
+static void reset_buffers(void) {
+    for (uint32_t i = 0; i < sizeof(mem.src); ++i) {
+        mem.src[i] = (uint8_t)next_rand();
+    }
+    memset(mem.dst, GUARD_BYTE, sizeof(mem.dst));
+    memset(expected, GUARD_BYTE, sizeof(expected));
+}
+
+static bool dst_ok(void) {
+    return !memcmp(mem.dst, expected, sizeof(expected));
+}
+
+static const uint32_t sizes[] = {0, 1, 3, 4, 7, 64, DMA_MEMCPY_CROSSOVER - 1, DMA_MEMCPY_CROSSOVER,
+                                 DMA_MEMCPY_CROSSOVER + 3, 1000, 4097, 3 * DMA_MEMCPY_SPLIT_MIN + 5};
+
+static const struct { uint32_t dst, src; } offsets[] = {
+    {0, 0}, {1, 1}, {2, 2}, {3, 3}, {0, 2}, {1, 3}, {0, 1}, {3, 0},
+};
+
+static void check_copies(void) {
+    for (uint32_t s = 0; s < count_of(sizes); ++s) {
+        for (uint32_t o = 0; o < count_of(offsets); ++o) {
+            uint32_t len = sizes[s], d = GUARD + offsets[o].dst, sr = GUARD + offsets[o].src;
+            reset_buffers();
+            for (uint32_t i = 0; i < len; ++i) {
+                expected[d + i] = mem.src[sr + i];
+            }
+            dma_memcpy_async(&mem.op, mem.dst + d, mem.src + sr, len, NULL, NULL);
+            dma_memcpy_wait(&mem.op);
+            check("copy", len, offsets[o].dst, offsets[o].src, dst_ok());
+        }
+    }
+}
+
+static void check_sets(void) {
+    for (uint32_t s = 0; s < count_of(sizes); ++s) {
+        for (uint32_t o = 0; o < 4; ++o) {
+            uint32_t len = sizes[s], d = GUARD + o;
+            uint8_t value = (uint8_t)next_rand();
+            reset_buffers();
+            for (uint32_t i = 0; i < len; ++i) {
+                expected[d + i] = value;
+            }
+            dma_memset_async(&mem.op, mem.dst + d, value, len, NULL, NULL);
+            dma_memcpy_wait(&mem.op);
+            check("set", len, o, 0, dst_ok());
+        }
+    }
+}
+
+// Byte swapped halfwords and words, a 16 byte pattern read round a ring, and
+// writes round a 64 byte ring, which keep the last 64 bytes
+static void run_opts(bool dma) {
+    static const dma_memcpy_opts_t opts[] = {
+        {.size = DMA_SIZE_16, .bswap = true},
+        {.size = DMA_SIZE_32, .bswap = true},
+        {.size = DMA_SIZE_32, .ring_bits = 4},
+        {.size = DMA_SIZE_8, .ring_bits = 6, .ring_write = true},
+    };
+    const uint32_t len = 256;
+    for (uint32_t i = 0; i < count_of(opts); ++i) {
+        const dma_memcpy_opts_t *o = &opts[i];
+        reset_buffers();
+        uint8_t *d = mem.dst + GUARD, *s = mem.src + GUARD;
+        for (uint32_t j = 0; j < len; ++j) {
+            if (o->bswap) {
+                uint32_t size = 1u << o->size;
+                expected[GUARD + j] = s[(j & ~(size - 1)) + size - 1 - (j & (size - 1))];
+            } else if (o->ring_write) {
+                expected[GUARD + (j & 63)] = s[j];
+            } else {
+                expected[GUARD + j] = s[j & 15];
+            }
+        }
+        bool used_dma = dma_memcpy_async_with_opts(&mem.small_op, d, s, len, o, NULL, NULL);
+        dma_memcpy_wait(&mem.small_op);
+        check(dma ? "copy with options" : "copy with options, no channel", len, i, 0, dst_ok() && used_dma == dma);
+    }
+}
+
+static void check_opts(void) {
+    run_opts(true);
+}
+
+static volatile uint32_t callbacks;
+
+static void count_callback(dma_memcpy_op_t *op, void *user_data) {
+    (void)op;
+    (void)user_data;
+    callbacks++;
+}
+
+// A big copy goes on as many of the pool's channels as its size allows. With
+// the interrupt held off the pool doesn't get them back, so the next copies
+// find none free and the processor does them.
+static void check_split(void) {
+    reset_buffers();
+    memcpy(expected + GUARD, mem.src + GUARD, BUF_SIZE);
+    callbacks = 0;
+    irq_set_enabled(DMA_IRQ_0, false);
+    bool used_dma = dma_memcpy_async(&mem.op, mem.dst + GUARD, mem.src + GUARD, BUF_SIZE, count_callback, NULL);
+    uint32_t n = mem.op.pending;
+    check("split", BUF_SIZE, 0, 0, used_dma && n == (BUF_SIZE / DMA_MEMCPY_SPLIT_MIN < N_CHANNELS ?
+                                                       BUF_SIZE / DMA_MEMCPY_SPLIT_MIN : N_CHANNELS));
+    used_dma = dma_memcpy_async(&mem.small_op, mem.dst + GUARD, mem.src + GUARD, 1024, count_callback, NULL);
+    check("copy, no channel", 1024, 0, 0, !used_dma && callbacks == 1);
+    run_opts(false);
+    irq_set_enabled(DMA_IRQ_0, true);
+    dma_memcpy_wait(&mem.op);
+    check("split callback", BUF_SIZE, 0, 0, callbacks == 2);
+}
+
+typedef struct memcpy_check {
+    const char *name;
+    void (*run)(void);
+} memcpy_check_t;
+
+static const memcpy_check_t checks[] = {
+    {"copies", check_copies},
+    {"sets", check_sets},
+    {"options", check_opts},
+    {"split", check_split},
+};
+
+#if !PICO_NO_HARDWARE
+typedef enum { BY_CPU, BY_DMA, BY_BOTH } bench_how_t;
+
+// Bytes per cycle to copy len bytes
+static float bench_copy(bench_how_t how, uint32_t len, uint32_t dst_offset, uint32_t src_offset) {
+    uint8_t *d = mem.dst + dst_offset, *s = mem.src + src_offset;
+    uint32_t start = cycle_counter();
+    if (how == BY_CPU) {
+        memcpy(d, s, len);
+    } else if (how == BY_DMA) {
+        dma_memcpy_async(&mem.op, d, s, len, NULL, NULL);
+        dma_memcpy_wait(&mem.op);
+    } else {
+        uint32_t half = len / 2;
+        dma_memcpy_async(&mem.op, d, s, half, NULL, NULL);
+        memcpy(d + half, s + half, len - half);
+        dma_memcpy_wait(&mem.op);
+    }
+    uint32_t cycles = cycles_since(start);
+    return (float)len / (float)cycles;
+}
+
+static void bench(void) {
+    static const uint32_t bench_sizes[] = {16, 64, 256, 1024, 4096, BUF_SIZE};
+    static const char *const how_names[] = {"CPU", "DMA", "CPU+DMA"};
+
+    // The DMA for any size
+    uint32_t crossover = dma_memcpy_get_crossover();
+    dma_memcpy_set_crossover(0);
+
+    printf("\nCopies, bytes/cycle, aligned:\n%-8s", "bytes");
+    for (uint32_t s = 0; s < count_of(bench_sizes); ++s) {
+        printf(" %7u", (unsigned)bench_sizes[s]);
+    }
+    for (bench_how_t how = BY_CPU; how <= BY_BOTH; ++how) {
+        printf("\n%-8s", how_names[how]);
+        for (uint32_t s = 0; s < count_of(bench_sizes); ++s) {
+            printf(" %7.2f", bench_copy(how, bench_sizes[s], GUARD, GUARD));
+        }
+    }
+
+    printf("\n\nCopies of 4096 bytes, bytes/cycle, by alignment:\n%-8s", "dst,src");
+    for (uint32_t o = 0; o < count_of(offsets); ++o) {
+        printf("     %u,%u", (unsigned)offsets[o].dst, (unsigned)offsets[o].src);
+    }
+    for (bench_how_t how = BY_CPU; how <= BY_BOTH; ++how) {
+        printf("\n%-8s", how_names[how]);
+        for (uint32_t o = 0; o < count_of(offsets); ++o) {
+            printf(" %7.2f", bench_copy(how, 4096, GUARD + offsets[o].dst, GUARD + offsets[o].src));
+        }
+    }
+
+    // The smallest aligned copy the DMA does quicker, in steps of 16 bytes
+    uint32_t measured = 0;
+    for (uint32_t len = 16; len <= 4096 && !measured; len += 16) {
+        if (bench_copy(BY_DMA, len, GUARD, GUARD) > bench_copy(BY_CPU, len, GUARD, GUARD)) {
+            measured = len;
+        }
+    }
+    printf("\n\nCrossover: %u bytes (default %u)\n", (unsigned)measured, (unsigned)crossover);
+    dma_memcpy_set_crossover(measured ? measured : crossover);
+}
+#endif
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+    cycle_counter_init();
+    printf("DMA memcpy, system clock %u MHz\n", (unsigned)(clock_get_hz(clk_sys) / 1000000));
+#else
+    dma_model_add_region(&mem, sizeof(mem));
+    puts("DMA memcpy, on the DMA model");
+#endif
+    dma_pool_init(0, N_CHANNELS);
+
+    for (uint32_t i = 0; i < count_of(checks); ++i) {
+        uint32_t before = failures;
+        checks[i].run();
+        printf("%-14s %s\n", checks[i].name, failures == before ? "ok" : "FAILED");
+    }
+
+#if !PICO_NO_HARDWARE
+    bench();
+#else
+    for (uint32_t o = 0; o < count_of(offsets); ++o) {
+        uint64_t transfers = 0;
+        for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch) {
+            transfers -= dma_model_get_transfers(ch);
+        }
+        dma_memcpy_async(&mem.op, mem.dst + GUARD + offsets[o].dst, mem.src + GUARD + offsets[o].src, 4096, NULL, NULL);
+        for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch) {
+            transfers += dma_model_get_transfers(ch);
+        }
+        printf("%s%u,%u: %.2f", o ? ", " : "\nDMA bus transfers/byte copying 4096 bytes, by dst,src alignment:\n",
+               (unsigned)offsets[o].dst, (unsigned)offsets[o].src, (double)transfers / 4096);
+    }
+    puts("");
+    if (dma_model_get_errors()) {
+        printf("%u DMA bus errors\n", (unsigned)dma_model_get_errors());
+        failures++;
+    }
+#endif
+
+    printf("\n%s\n", failures ? "DMA memcpy checks FAILED" : "All DMA memcpy checks passed");
+    return failures ? 1 : 0;
+}
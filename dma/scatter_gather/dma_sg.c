@@ -0,0 +1,208 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "pico/platform.h"
+#include "hardware/irq.h"
+
+#include "dma_sg.h"
+
+// A descriptor is alias 3 of a channel
+static_assert(offsetof(dma_sg_desc_t, write_addr) ==
+              offsetof(dma_channel_hw_t, al3_write_addr) - offsetof(dma_channel_hw_t, al3_ctrl), "");
+static_assert(offsetof(dma_sg_desc_t, transfer_count) ==
+              offsetof(dma_channel_hw_t, al3_transfer_count) - offsetof(dma_channel_hw_t, al3_ctrl), "");
+static_assert(offsetof(dma_sg_desc_t, read_addr) ==
+              offsetof(dma_channel_hw_t, al3_read_addr_trig) - offsetof(dma_channel_hw_t, al3_ctrl), "");
+static_assert(sizeof(dma_sg_desc_t) == 16, "");
+
+// Each dma_sg_t by its data channel, for the interrupt handler
+static dma_sg_t *sg_by_data_chan[NUM_DMA_CHANNELS];
+static uint32_t data_chan_mask;
+
+// The data channel's interrupt is only raised by the null trigger at the end
+// of a list, as every entry has IRQ_QUIET set
+static void __not_in_flash_func(dma_sg_irq_handler)(void) {
+    uint32_t ints = dma_hw->ints0 & data_chan_mask;
+    while (ints) {
+        uint ch = (uint)__builtin_ctz(ints);
+        ints &= ~(1u << ch);
+        dma_channel_acknowledge_irq0(ch);
+        dma_sg_t *sg = sg_by_data_chan[ch];
+        sg->busy = false;
+        sg->lists_done++;
+        if (sg->callback) {
+            sg->callback(sg, sg->user_data);
+        }
+    }
+}
+
+void dma_sg_init(dma_sg_t *sg) {
+    sg->ctrl_chan = (uint)dma_claim_unused_channel(true);
+    sg->data_chan = (uint)dma_claim_unused_channel(true);
+    sg->callback = NULL;
+    sg->user_data = NULL;
+    sg->busy = false;
+    sg->lists_done = 0;
+
+    // The control channel writes four words to alias 3 of the data channel,
+    // then halts. The write address wraps on a four word boundary, so each
+    // descriptor lands on the same four registers.
+    dma_channel_config c = dma_channel_get_default_config(sg->ctrl_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, 4);
+    dma_channel_configure(sg->ctrl_chan, &c, &dma_hw->ch[sg->data_chan].al3_ctrl, NULL,
+                          sizeof(dma_sg_desc_t) / sizeof(uint32_t), false);
+
+    if (!data_chan_mask) {
+        irq_add_shared_handler(DMA_IRQ_0, dma_sg_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+    }
+    sg_by_data_chan[sg->data_chan] = sg;
+    data_chan_mask |= 1u << sg->data_chan;
+    dma_channel_set_irq0_enabled(sg->data_chan, true);
+}
+
+void dma_sg_deinit(dma_sg_t *sg) {
+    dma_sg_abort(sg);
+    dma_channel_set_irq0_enabled(sg->data_chan, false);
+    data_chan_mask &= ~(1u << sg->data_chan);
+    sg_by_data_chan[sg->data_chan] = NULL;
+    if (!data_chan_mask) {
+        irq_remove_handler(DMA_IRQ_0, dma_sg_irq_handler);
+    }
+    dma_channel_unclaim(sg->ctrl_chan);
+    dma_channel_unclaim(sg->data_chan);
+}
+
+dma_channel_config dma_sg_get_default_config(const dma_sg_t *sg) {
+    return dma_channel_get_default_config(sg->data_chan);
+}
+
+void dma_sg_list_init(dma_sg_list_t *list, dma_sg_t *sg, dma_sg_desc_t *descs, uint32_t max_descs) {
+    list->sg = sg;
+    list->descs = descs;
+    list->max_descs = max_descs;
+    dma_sg_list_clear(list);
+}
+
+void dma_sg_list_clear(dma_sg_list_t *list) {
+    list->n_descs = 0;
+    list->link_addr = 0;
+    list->overflow = false;
+}
+
+// Each entry chains back to the control channel for the next, quietly
+static uint32_t entry_ctrl(const dma_sg_t *sg, const dma_channel_config *config) {
+    dma_channel_config c = *config;
+    channel_config_set_chain_to(&c, sg->ctrl_chan);
+    channel_config_set_irq_quiet(&c, true);
+    channel_config_set_enable(&c, true);
+    return channel_config_get_ctrl_value(&c);
+}
+
+static dma_sg_desc_t *next_desc(dma_sg_list_t *list, bool last) {
+    // Keep room for the last entry
+    if (list->n_descs + (last ? 1 : 2) > list->max_descs) {
+        list->overflow = true;
+        return NULL;
+    }
+    return &list->descs[list->n_descs++];
+}
+
+bool dma_sg_list_add(dma_sg_list_t *list, const dma_channel_config *config, volatile void *write_addr,
+                     const volatile void *read_addr, uint32_t transfer_count) {
+    if (!transfer_count) {
+        return true;
+    }
+    dma_sg_desc_t *d = next_desc(list, false);
+    if (!d) {
+        return false;
+    }
+    d->ctrl = entry_ctrl(list->sg, config);
+    d->write_addr = dma_sg_addr(write_addr);
+    d->transfer_count = transfer_count;
+    d->read_addr = dma_sg_addr(read_addr);
+    return true;
+}
+
+bool dma_sg_list_add_copy(dma_sg_list_t *list, void *dst, const void *src, uint32_t len) {
+    uint32_t align = (uint32_t)(uintptr_t)dst | (uint32_t)(uintptr_t)src | len;
+    enum dma_channel_transfer_size size = !(align & 3) ? DMA_SIZE_32 : !(align & 1) ? DMA_SIZE_16 : DMA_SIZE_8;
+    dma_channel_config c = dma_sg_get_default_config(list->sg);
+    channel_config_set_transfer_data_size(&c, size);
+    channel_config_set_write_increment(&c, true);
+    return dma_sg_list_add(list, &c, dst, src, len >> size);
+}
+
+void dma_sg_list_end(dma_sg_list_t *list) {
+    dma_sg_desc_t *d = next_desc(list, true);
+    if (!d) {
+        return;
+    }
+    // READ_ADDR_TRIG = 0 is a null trigger, which raises the interrupt as
+    // IRQ_QUIET is set
+    dma_channel_config c = dma_sg_get_default_config(list->sg);
+    d->ctrl = entry_ctrl(list->sg, &c);
+    d->write_addr = 0;
+    d->transfer_count = 0;
+    d->read_addr = 0;
+}
+
+void dma_sg_list_link(dma_sg_list_t *list, const dma_sg_list_t *next) {
+    dma_sg_desc_t *d = next_desc(list, true);
+    if (!d) {
+        return;
+    }
+    // One word, from link_addr to the control channel's READ_ADDR (which
+    // doesn't trigger it), after which the data channel chains to it as usual
+    list->link_addr = dma_sg_addr(next->descs);
+    dma_channel_config c = dma_sg_get_default_config(list->sg);
+    channel_config_set_read_increment(&c, false);
+    d->ctrl = entry_ctrl(list->sg, &c);
+    d->write_addr = dma_sg_addr(&dma_hw->ch[list->sg->ctrl_chan].read_addr);
+    d->transfer_count = 1;
+    d->read_addr = dma_sg_addr(&list->link_addr);
+}
+
+void dma_sg_start(dma_sg_t *sg, const dma_sg_list_t *list, dma_sg_callback_t callback, void *user_data) {
+    sg->callback = callback;
+    sg->user_data = user_data;
+    sg->busy = true;
+    // An abort can leave the write address part way through the four
+    // registers, so set it each time
+    dma_channel_set_write_addr(sg->ctrl_chan, &dma_hw->ch[sg->data_chan].al3_ctrl, false);
+    dma_channel_set_read_addr(sg->ctrl_chan, list->descs, true);
+}
+
+bool dma_sg_is_busy(const dma_sg_t *sg) {
+    return sg->busy;
+}
+
+void dma_sg_wait(const dma_sg_t *sg) {
+    while (sg->busy) {
+        tight_loop_contents();
+    }
+}
+
+void dma_sg_abort(dma_sg_t *sg) {
+    // The abort can raise the channel's interrupt (RP2040-E13), so keep it
+    // disabled until the flag has been cleared
+    dma_channel_set_irq0_enabled(sg->data_chan, false);
+    // The data channel may chain to the control channel as it stops, so stop
+    // the control channel either side of it
+    dma_channel_abort(sg->ctrl_chan);
+    dma_channel_abort(sg->data_chan);
+    dma_channel_abort(sg->ctrl_chan);
+    dma_channel_acknowledge_irq0(sg->data_chan);
+    dma_channel_set_irq0_enabled(sg->data_chan, true);
+    sg->busy = false;
+}
@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _DMA_SG_H
+#define _DMA_SG_H
+
+// Scatter-gather DMA: run a list of transfers one after another, with no
+// processor involvement in between.
+//
+// This is dma/control_blocks made general. A dma_sg_t is a pair of channels:
+// the data channel does the transfers, and the control channel loads each one
+// into it from a list of descriptors. A descriptor is the four registers of
+// alias 3 of the data channel, in the same order (CTRL, WRITE_ADDR,
+// TRANS_COUNT, READ_ADDR_TRIG), so the control channel reloads a whole entry
+// with one four word burst, the last word of which starts the data channel.
+// The data channel chains back to the control channel when it finishes, to
+// load the next entry. As each entry has its own CTRL, the transfer size,
+// DREQ, increments, byte swap etc. can change from one entry to the next.
+//
+// A list ends in one of two ways:
+//
+// - dma_sg_list_end() adds an entry whose READ_ADDR_TRIG is 0. This null
+//   trigger leaves the data channel stopped and raises its interrupt, and the
+//   list's completion callback is called from DMA_IRQ_0.
+//
+// - dma_sg_list_link() adds an entry which has the data channel write the
+//   address of another list to the control channel's READ_ADDR, so that list
+//   runs next. Lists can be linked in a chain, or a ring which runs until
+//   dma_sg_abort().
+//
+// The descriptors name the channels of the dma_sg_t a list is built for, so
+// a list can only be run by that one. A list can be run again as it is, and
+// can be changed when it isn't running.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hardware/dma.h"
+
+// The DMA's address for p, as written into a descriptor. The DMA model has
+// its own 32 bit address space.
+static inline uint32_t dma_sg_addr(const volatile void *p) {
+#if !PICO_NO_HARDWARE
+    return (uint32_t)(uintptr_t)p;
+#else
+    return dma_model_addr(p);
+#endif
+}
+
+typedef struct dma_sg_desc {
+    uint32_t ctrl;
+    uint32_t write_addr;
+    uint32_t transfer_count;
+    uint32_t read_addr;
+} dma_sg_desc_t;
+
+typedef struct dma_sg dma_sg_t;
+
+typedef void (*dma_sg_callback_t)(dma_sg_t *sg, void *user_data);
+
+struct dma_sg {
+    uint ctrl_chan;
+    uint data_chan;
+    dma_sg_callback_t callback;
+    void *user_data;
+    volatile bool busy;
+    // Lists run to their end
+    volatile uint32_t lists_done;
+};
+
+typedef struct dma_sg_list {
+    dma_sg_t *sg;
+    dma_sg_desc_t *descs;
+    uint32_t max_descs;
+    uint32_t n_descs;
+    // The address of the list to run next, for the data channel to copy to
+    // the control channel by dma_sg_list_link()
+    uint32_t link_addr;
+    // Set if an entry didn't fit
+    bool overflow;
+} dma_sg_list_t;
+
+// Claim two channels, and set up the control channel. Installs a shared
+// handler for DMA_IRQ_0 the first time.
+void dma_sg_init(dma_sg_t *sg);
+void dma_sg_deinit(dma_sg_t *sg);
+
+// A config for an entry to start from: 32 bit transfers, incrementing the
+// read address but not the write address, unpaced
+dma_channel_config dma_sg_get_default_config(const dma_sg_t *sg);
+
+// descs has room for max_descs entries, including the one which ends the list
+void dma_sg_list_init(dma_sg_list_t *list, dma_sg_t *sg, dma_sg_desc_t *descs, uint32_t max_descs);
+void dma_sg_list_clear(dma_sg_list_t *list);
+
+// Add a transfer of transfer_count items, each of the size set in config,
+// which also gives the DREQ, increments, ring, byte swap and priority. Its
+// CHAIN_TO and IRQ_QUIET are set by the list. Returns false, and sets
+// list->overflow, if the list is full. An entry with a count of 0 is left out,
+// as it would do nothing.
+bool dma_sg_list_add(dma_sg_list_t *list, const dma_channel_config *config, volatile void *write_addr,
+                     const volatile void *read_addr, uint32_t transfer_count);
+
+// Add a copy of len bytes between buffers in memory, with the widest
+// transfers their alignment allows
+bool dma_sg_list_add_copy(dma_sg_list_t *list, void *dst, const void *src, uint32_t len);
+
+// Finish the list, with either a null trigger or a link to the next list
+void dma_sg_list_end(dma_sg_list_t *list);
+void dma_sg_list_link(dma_sg_list_t *list, const dma_sg_list_t *next);
+
+// Start running a finished list. callback, which may be NULL, is called from
+// DMA_IRQ_0 when a list ending in dma_sg_list_end() is reached.
+void dma_sg_start(dma_sg_t *sg, const dma_sg_list_t *list, dma_sg_callback_t callback, void *user_data);
+bool dma_sg_is_busy(const dma_sg_t *sg);
+void dma_sg_wait(const dma_sg_t *sg);
+// Stop at once, e.g. to stop a ring of lists. The callback isn't called.
+void dma_sg_abort(dma_sg_t *sg);
+
+#endif
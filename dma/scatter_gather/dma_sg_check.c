@@ -0,0 +1,266 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Check the descriptors dma_sg.c builds, and the transfers they make
+//
+// Each check builds lists of transfers in memory (gathers, scatters, mixed
+// transfer sizes and byte swaps, and linked lists), runs them, and compares
+// the results with the same copies done by the processor. Off the device,
+// ../dma_model runs the descriptors instead, and stops a channel with a bus
+// error on any address that isn't in memory it knows about, so a descriptor
+// encoded wrongly fails rather than scribbling somewhere:
+//
+//   cc -DPICO_NO_HARDWARE=1 -I../dma_model/include dma_sg_check.c dma_sg.c ../dma_model/dma_model.c
+
+#include <stdio.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#define count_of(a) (sizeof(a)/sizeof((a)[0]))
+#endif
+
+#include "dma_sg.h"
+
+#define BUF_SIZE 256
+
+// The descriptor lists, and the buffers they copy between, registered with
+// the model as one region. Descriptors are loaded through a 16 byte write
+// ring, so they must be 16 byte aligned.
+static struct {
+    dma_sg_desc_t descs_a[16];
+    dma_sg_desc_t descs_b[8];
+    dma_sg_list_t list_a;
+    dma_sg_list_t list_b;
+    uint8_t src[BUF_SIZE];
+    uint8_t dst[BUF_SIZE];
+} mem __attribute__((aligned(16)));
+
+static uint8_t expected[BUF_SIZE];
+
+static dma_sg_t sg;
+static uint32_t callbacks;
+static uint32_t failures;
+
+static void on_done(dma_sg_t *s, void *user_data) {
+    (void)s;
+    *(uint32_t *)user_data += 1;
+}
+
+static void check(const char *what, bool ok) {
+    if (!ok) {
+        printf("  %s is wrong\n", what);
+        failures++;
+    }
+}
+
+static void reset_buffers(void) {
+    for (uint32_t i = 0; i < BUF_SIZE; ++i) {
+        mem.src[i] = (uint8_t)(i * 7 + 3);
+    }
+    memset(mem.dst, 0xee, BUF_SIZE);
+    memset(expected, 0xee, BUF_SIZE);
+}
+
+static void run(const dma_sg_list_t *list, uint32_t lists) {
+    uint32_t before = callbacks;
+    dma_sg_start(&sg, list, on_done, &callbacks);
+    dma_sg_wait(&sg);
+    check("callback count", callbacks == before + lists);
+    check("result", !memcmp(mem.dst, expected, BUF_SIZE));
+}
+
+// The words of each descriptor are those of the channel's alias 3 registers
+static void check_encoding(void) {
+    dma_sg_list_t *l = &mem.list_a;
+    dma_sg_list_init(l, &sg, mem.descs_a, count_of(mem.descs_a));
+    dma_channel_config c = dma_sg_get_default_config(&sg);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_bswap(&c, true);
+    dma_sg_list_add(l, &c, mem.dst, mem.src + 2, 5);
+    dma_sg_list_init(&mem.list_b, &sg, mem.descs_b, count_of(mem.descs_b));
+    dma_sg_list_link(l, &mem.list_b);
+    dma_sg_list_end(&mem.list_b);
+
+    channel_config_set_chain_to(&c, sg.ctrl_chan);
+    channel_config_set_irq_quiet(&c, true);
+    const dma_sg_desc_t *d = &mem.descs_a[0];
+    check("entry CTRL", d->ctrl == channel_config_get_ctrl_value(&c));
+    check("entry WRITE_ADDR", d->write_addr == dma_sg_addr(mem.dst));
+    check("entry TRANS_COUNT", d->transfer_count == 5);
+    check("entry READ_ADDR", d->read_addr == dma_sg_addr(mem.src + 2));
+
+    d = &mem.descs_a[1];
+    check("link WRITE_ADDR", d->write_addr == dma_sg_addr(&dma_hw->ch[sg.ctrl_chan].read_addr));
+    check("link TRANS_COUNT", d->transfer_count == 1);
+    check("link READ_ADDR", d->read_addr == dma_sg_addr(&mem.list_a.link_addr));
+    check("link target", mem.list_a.link_addr == dma_sg_addr(mem.descs_b));
+
+    d = &mem.descs_b[0];
+    check("end READ_ADDR", d->read_addr == 0);
+    check("end IRQ_QUIET", d->ctrl & DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS);
+    check("list length", mem.list_a.n_descs == 2 && mem.list_b.n_descs == 1);
+}
+
+// Pieces from all over src, one after another into dst
+static void check_gather(void) {
+    static const struct { uint32_t offset, len; } pieces[] = {
+        {0, 16}, {37, 3}, {100, 20}, {2, 6}, {200, 1}, {64, 32}, {131, 0}, {150, 9},
+    };
+    reset_buffers();
+    dma_sg_list_t *l = &mem.list_a;
+    dma_sg_list_init(l, &sg, mem.descs_a, count_of(mem.descs_a));
+    uint32_t pos = 0;
+    for (uint32_t i = 0; i < count_of(pieces); ++i) {
+        dma_sg_list_add_copy(l, mem.dst + pos, mem.src + pieces[i].offset, pieces[i].len);
+        memcpy(expected + pos, mem.src + pieces[i].offset, pieces[i].len);
+        pos += pieces[i].len;
+    }
+    dma_sg_list_end(l);
+    check("gather list", !l->overflow);
+    run(l, 1);
+    // and again, as lists can be rerun
+    memset(mem.dst, 0xee, BUF_SIZE);
+    run(l, 1);
+}
+
+// Pieces of src, one after another, to all over dst
+static void check_scatter(void) {
+    static const struct { uint32_t offset, len; } pieces[] = {
+        {240, 16}, {0, 8}, {17, 13}, {128, 64}, {33, 2}, {90, 11},
+    };
+    reset_buffers();
+    dma_sg_list_t *l = &mem.list_a;
+    dma_sg_list_init(l, &sg, mem.descs_a, count_of(mem.descs_a));
+    uint32_t pos = 0;
+    for (uint32_t i = 0; i < count_of(pieces); ++i) {
+        dma_sg_list_add_copy(l, mem.dst + pieces[i].offset, mem.src + pos, pieces[i].len);
+        memcpy(expected + pieces[i].offset, mem.src + pos, pieces[i].len);
+        pos += pieces[i].len;
+    }
+    dma_sg_list_end(l);
+    run(l, 1);
+}
+
+// Entries with their own sizes, byte swaps and increments
+static void check_mixed(void) {
+    reset_buffers();
+    dma_sg_list_t *l = &mem.list_a;
+    dma_sg_list_init(l, &sg, mem.descs_a, count_of(mem.descs_a));
+
+    // Byte swapped halfwords
+    dma_channel_config c = dma_sg_get_default_config(&sg);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_bswap(&c, true);
+    dma_sg_list_add(l, &c, mem.dst, mem.src, 8);
+    for (uint32_t i = 0; i < 16; i += 2) {
+        expected[i] = mem.src[i + 1];
+        expected[i + 1] = mem.src[i];
+    }
+
+    // Byte swapped words
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    dma_sg_list_add(l, &c, mem.dst + 32, mem.src + 32, 4);
+    for (uint32_t i = 32; i < 48; i += 4) {
+        for (uint32_t j = 0; j < 4; ++j) {
+            expected[i + j] = mem.src[i + 3 - j];
+        }
+    }
+
+    // One word written 8 times (no read increment)
+    c = dma_sg_get_default_config(&sg);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    dma_sg_list_add(l, &c, mem.dst + 64, mem.src + 8, 8);
+    for (uint32_t i = 64; i < 96; i += 4) {
+        memcpy(expected + i, mem.src + 8, 4);
+    }
+
+    // 12 bytes read round a 4 byte ring
+    c = dma_sg_get_default_config(&sg);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, false, 2);
+    dma_sg_list_add(l, &c, mem.dst + 128, mem.src + 4, 12);
+    for (uint32_t i = 0; i < 12; ++i) {
+        expected[128 + i] = mem.src[4 + i % 4];
+    }
+
+    dma_sg_list_end(l);
+    run(l, 1);
+}
+
+// Two lists, the first linked to the second, and only the second ending
+static void check_link(void) {
+    reset_buffers();
+    dma_sg_list_t *a = &mem.list_a, *b = &mem.list_b;
+    dma_sg_list_init(a, &sg, mem.descs_a, count_of(mem.descs_a));
+    dma_sg_list_init(b, &sg, mem.descs_b, count_of(mem.descs_b));
+    dma_sg_list_add_copy(a, mem.dst, mem.src + 128, 64);
+    dma_sg_list_add_copy(a, mem.dst + 64, mem.src + 1, 7);
+    dma_sg_list_link(a, b);
+    dma_sg_list_add_copy(b, mem.dst + 200, mem.src, 50);
+    dma_sg_list_end(b);
+    memcpy(expected, mem.src + 128, 64);
+    memcpy(expected + 64, mem.src + 1, 7);
+    memcpy(expected + 200, mem.src, 50);
+    run(a, 1);
+}
+
+// A full list refuses more entries, keeping room for its end
+static void check_overflow(void) {
+    dma_sg_list_t *l = &mem.list_b;
+    dma_sg_list_init(l, &sg, mem.descs_b, 3);
+    check("add to list with room", dma_sg_list_add_copy(l, mem.dst, mem.src, 4) &&
+                                   dma_sg_list_add_copy(l, mem.dst, mem.src, 4));
+    check("add to full list", !dma_sg_list_add_copy(l, mem.dst, mem.src, 4) && l->overflow);
+    dma_sg_list_end(l);
+    check("end of full list", l->n_descs == 3);
+}
+
+typedef struct sg_check {
+    const char *name;
+    void (*run)(void);
+} sg_check_t;
+
+static const sg_check_t checks[] = {
+    {"encoding", check_encoding},
+    {"gather", check_gather},
+    {"scatter", check_scatter},
+    {"mixed entries", check_mixed},
+    {"linked lists", check_link},
+    {"overflow", check_overflow},
+};
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+    puts("Scatter-gather DMA checks, on the device");
+#else
+    dma_model_add_region(&mem, sizeof(mem));
+    puts("Scatter-gather DMA checks, on the DMA model");
+#endif
+    dma_sg_init(&sg);
+
+    for (uint32_t i = 0; i < count_of(checks); ++i) {
+        uint32_t before = failures;
+        checks[i].run();
+        printf("%-14s %s\n", checks[i].name, failures == before ? "ok" : "FAILED");
+    }
+    dma_sg_deinit(&sg);
+
+#if PICO_NO_HARDWARE
+    if (dma_model_get_errors()) {
+        printf("%u DMA bus errors\n", (unsigned)dma_model_get_errors());
+        failures++;
+    }
+#endif
+    printf("\n%s\n", failures ? "Scatter-gather checks FAILED" : "All scatter-gather checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Use scatter-gather DMA (dma_sg.c) to send a message to the UART from words
+// all over memory, then split a packet into its fields, all in one go
+//
+// This is the dma/control_blocks example made general: the first list gathers
+// the words of the message to the UART, one byte at a time and paced by the
+// UART, then links to a second list which copies the length, payload and
+// checksum of a packet to three different places in memory, byte swapping
+// the big endian length and checksum on the way. The processor only starts
+// the first list, and is told when the second one ends by a callback from the
+// DMA interrupt.
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/structs/uart.h"
+
+#include "dma_sg.h"
+
+static const char *const words[] = {
+    "Gathering ", "words ", "from ", "all ", "over ", "memory, ", "then ", "scattering ", "a ", "packet.\n",
+};
+
+// A packet as it arrives, with a big endian length and checksum
+static const uint8_t packet[] __attribute__((aligned(4))) = {
+    0x00, 0x0a,
+    'H', 'e', 'l', 'l', 'o', ',', ' ', 'D', 'M', 'A',
+    0xde, 0xad, 0xbe, 0xef,
+};
+
+static uint16_t length;
+static char payload[11];
+static uint32_t checksum;
+
+static dma_sg_desc_t message_descs[count_of(words) + 1];
+static dma_sg_desc_t packet_descs[4];
+static dma_sg_list_t message_list;
+static dma_sg_list_t packet_list;
+
+static volatile bool done;
+
+static void on_done(dma_sg_t *sg, void *user_data) {
+    (void)sg;
+    *(volatile bool *)user_data = true;
+}
+
+int main() {
+#ifndef uart_default
+#warning dma/scatter_gather example requires a UART
+#else
+    stdio_init_all();
+    puts("DMA scatter-gather example:");
+
+    dma_sg_t sg;
+    dma_sg_init(&sg);
+
+    // Both lists are set up before linking one to the other
+    dma_sg_list_init(&message_list, &sg, message_descs, count_of(message_descs));
+    dma_sg_list_init(&packet_list, &sg, packet_descs, count_of(packet_descs));
+
+    // Bytes to the UART's TX FIFO, paced by its DREQ
+    dma_channel_config c = dma_sg_get_default_config(&sg);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_dreq(&c, uart_get_dreq(uart_default, true));
+    for (uint i = 0; i < count_of(words); ++i) {
+        dma_sg_list_add(&message_list, &c, &uart_get_hw(uart_default)->dr, words[i], strlen(words[i]));
+    }
+    dma_sg_list_link(&message_list, &packet_list);
+
+    c = dma_sg_get_default_config(&sg);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_bswap(&c, true);
+    dma_sg_list_add(&packet_list, &c, &length, packet, 1);
+    dma_sg_list_add_copy(&packet_list, payload, packet + 2, 10);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    dma_sg_list_add(&packet_list, &c, &checksum, packet + 12, 1);
+    dma_sg_list_end(&packet_list);
+
+    // Wait for the UART to be idle, so the message doesn't get mixed up with
+    // the output above
+    uart_tx_wait_blocking(uart_default);
+    dma_sg_start(&sg, &message_list, on_done, (void *)&done);
+    while (!done) {
+        tight_loop_contents();
+    }
+
+    printf("Length %u, payload \"%s\", checksum %08x\n", length, payload, (uint)checksum);
+    dma_sg_deinit(&sg);
+    puts("DMA finished.");
+#endif
+}
@@ -0,0 +1,377 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdlib.h>
+
+#include "pico/platform.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+#include "dma_csum.h"
+
+typedef struct alg_info {
+    const char *name;
+    uint8_t calc;
+    // Of a CRC, else 0
+    uint8_t width;
+    bool reflected;
+    uint32_t init;
+    uint32_t xor_out;
+} alg_info_t;
+
+static const alg_info_t algs[DMA_CSUM_ALG_COUNT] = {
+    [DMA_CSUM_CRC32] = {"CRC-32", DMA_SNIFF_CTRL_CALC_VALUE_CRC32R, 32, true, 0xffffffffu, 0xffffffffu},
+    [DMA_CSUM_CRC32_BZIP2] = {"CRC-32/BZIP2", DMA_SNIFF_CTRL_CALC_VALUE_CRC32, 32, false, 0xffffffffu, 0xffffffffu},
+    [DMA_CSUM_CRC32_MPEG2] = {"CRC-32/MPEG-2", DMA_SNIFF_CTRL_CALC_VALUE_CRC32, 32, false, 0xffffffffu, 0},
+    [DMA_CSUM_CRC16_CCITT] = {"CRC-16/CCITT-FALSE", DMA_SNIFF_CTRL_CALC_VALUE_CRC16, 16, false, 0xffffu, 0},
+    [DMA_CSUM_CRC16_XMODEM] = {"CRC-16/XMODEM", DMA_SNIFF_CTRL_CALC_VALUE_CRC16, 16, false, 0, 0},
+    [DMA_CSUM_CRC16_KERMIT] = {"CRC-16/KERMIT", DMA_SNIFF_CTRL_CALC_VALUE_CRC16R, 16, true, 0, 0},
+    [DMA_CSUM_CRC16_X25] = {"CRC-16/X-25", DMA_SNIFF_CTRL_CALC_VALUE_CRC16R, 16, true, 0xffffu, 0xffffu},
+    [DMA_CSUM_PARITY] = {"parity", DMA_SNIFF_CTRL_CALC_VALUE_EVEN, 0, false, 0, 0},
+    [DMA_CSUM_SUM32] = {"sum32", DMA_SNIFF_CTRL_CALC_VALUE_SUM, 0, false, 0, 0},
+};
+
+// ----------------------------------------------------------------------------
+// The processor's part
+//
+// The sniffer keeps a CRC MSB first, feeding it bit reversed bytes for the
+// reflected ones, and a CRC-16 in the low 16 bits. The processor works on
+// reflected CRCs LSB first instead, which is the same thing bit reversed, and
+// on a CRC-16 MSB first in the top 16 bits, which lets the CRC-32 code do it.
+
+enum { TABLE_CRC32, TABLE_CRC32R, TABLE_CRC16, TABLE_CRC16R, TABLE_COUNT };
+
+static const uint32_t table_polys[TABLE_COUNT] = {0x04c11db7u, 0xedb88320u, 0x10210000u, 0x00008408u};
+
+// Slice-by-8: table k gives the effect of a byte followed by k zero bytes,
+// so eight bytes take eight lookups. They are made when first needed, and if
+// there isn't room for one, the CRC is done a bit at a time.
+typedef uint32_t crc_table_t[8][256];
+static crc_table_t *crc_tables[TABLE_COUNT];
+
+static uint32_t bit_reverse(uint32_t v) {
+    v = ((v >> 1) & 0x55555555u) | ((v & 0x55555555u) << 1);
+    v = ((v >> 2) & 0x33333333u) | ((v & 0x33333333u) << 2);
+    v = ((v >> 4) & 0x0f0f0f0fu) | ((v & 0x0f0f0f0fu) << 4);
+    return __builtin_bswap32(v);
+}
+
+static uint32_t crc_msb_bits(uint32_t poly, uint32_t crc) {
+    for (uint32_t i = 0; i < 8; ++i) {
+        crc = crc & 0x80000000u ? (crc << 1) ^ poly : crc << 1;
+    }
+    return crc;
+}
+
+static uint32_t crc_lsb_bits(uint32_t poly, uint32_t crc) {
+    for (uint32_t i = 0; i < 8; ++i) {
+        crc = crc & 1u ? (crc >> 1) ^ poly : crc >> 1;
+    }
+    return crc;
+}
+
+static void make_table(uint32_t which) {
+    if (crc_tables[which]) {
+        return;
+    }
+    crc_table_t *t = malloc(sizeof(crc_table_t));
+    if (!t) {
+        return;
+    }
+    uint32_t poly = table_polys[which];
+    bool lsb_first = which & 1;
+    for (uint32_t i = 0; i < 256; ++i) {
+        (*t)[0][i] = lsb_first ? crc_lsb_bits(poly, i) : crc_msb_bits(poly, i << 24);
+    }
+    for (uint32_t k = 1; k < 8; ++k) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = (*t)[k - 1][i];
+            (*t)[k][i] = lsb_first ? (c >> 8) ^ (*t)[0][c & 0xffu] : (c << 8) ^ (*t)[0][c >> 24];
+        }
+    }
+    crc_tables[which] = t;
+}
+
+static uint32_t crc_msb_first(uint32_t which, uint32_t crc, const uint8_t *p, uint32_t len) {
+    const crc_table_t *t = crc_tables[which];
+    if (!t) {
+        while (len--) {
+            crc = crc_msb_bits(table_polys[which], crc ^ ((uint32_t)*p++ << 24));
+        }
+        return crc;
+    }
+    for (; len >= 8; len -= 8, p += 8) {
+        uint32_t hi = crc ^ ((uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3]);
+        crc = (*t)[7][hi >> 24] ^ (*t)[6][(hi >> 16) & 0xffu] ^ (*t)[5][(hi >> 8) & 0xffu] ^ (*t)[4][hi & 0xffu] ^
+              (*t)[3][p[4]] ^ (*t)[2][p[5]] ^ (*t)[1][p[6]] ^ (*t)[0][p[7]];
+    }
+    while (len--) {
+        crc = (crc << 8) ^ (*t)[0][(crc >> 24) ^ *p++];
+    }
+    return crc;
+}
+
+static uint32_t crc_lsb_first(uint32_t which, uint32_t crc, const uint8_t *p, uint32_t len) {
+    const crc_table_t *t = crc_tables[which];
+    if (!t) {
+        while (len--) {
+            crc = crc_lsb_bits(table_polys[which], crc ^ *p++);
+        }
+        return crc;
+    }
+    for (; len >= 8; len -= 8, p += 8) {
+        uint32_t lo = crc ^ (p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24);
+        crc = (*t)[7][lo & 0xffu] ^ (*t)[6][(lo >> 8) & 0xffu] ^ (*t)[5][(lo >> 16) & 0xffu] ^ (*t)[4][lo >> 24] ^
+              (*t)[3][p[4]] ^ (*t)[2][p[5]] ^ (*t)[1][p[6]] ^ (*t)[0][p[7]];
+    }
+    while (len--) {
+        crc = (crc >> 8) ^ (*t)[0][(crc ^ *p++) & 0xffu];
+    }
+    return crc;
+}
+
+static void cpu_update(dma_csum_t *cs, const uint8_t *p, uint32_t len) {
+    uint32_t s = cs->state;
+    switch (algs[cs->alg].calc) {
+        case DMA_SNIFF_CTRL_CALC_VALUE_CRC32:
+            s = crc_msb_first(TABLE_CRC32, s, p, len);
+            break;
+        case DMA_SNIFF_CTRL_CALC_VALUE_CRC32R:
+            s = bit_reverse(crc_lsb_first(TABLE_CRC32R, bit_reverse(s), p, len));
+            break;
+        case DMA_SNIFF_CTRL_CALC_VALUE_CRC16:
+            s = crc_msb_first(TABLE_CRC16, s << 16, p, len) >> 16;
+            break;
+        case DMA_SNIFF_CTRL_CALC_VALUE_CRC16R:
+            s = bit_reverse(crc_lsb_first(TABLE_CRC16R, bit_reverse(s) >> 16, p, len)) >> 16;
+            break;
+        case DMA_SNIFF_CTRL_CALC_VALUE_EVEN:
+            // Only the parity of the accumulator matters
+            for (uint32_t i = 0; i < len; ++i) {
+                s ^= p[i];
+            }
+            break;
+        default:
+            for (uint32_t i = 0; i < len; ++i) {
+                s += (uint32_t)p[i] << (8 * ((cs->pos + i) & 3));
+            }
+            break;
+    }
+    cs->state = s;
+    cs->pos += len;
+    cs->cpu_bytes += len;
+}
+
+// ----------------------------------------------------------------------------
+// The DMA's part
+
+// The channel while there is work, else -1
+static int csum_chan = -1;
+// Streams with work, the one the sniffer is on first
+static dma_csum_t *queue_head;
+static dma_csum_t *queue_tail;
+static uint32_t dummy_dst;
+static bool irq_handler_added;
+
+static void enqueue(dma_csum_t *cs) {
+    cs->queue_next = NULL;
+    if (queue_tail) {
+        queue_tail->queue_next = cs;
+    } else {
+        queue_head = cs;
+    }
+    queue_tail = cs;
+}
+
+static void finish(dma_csum_t *cs) {
+    cs->busy = false;
+    if (cs->callback) {
+        cs->callback(cs, cs->user_data);
+    }
+}
+
+// Start the next chunk of the stream at the head of the queue, or release the
+// channel if there isn't one
+static void run_next(void) {
+    dma_csum_t *cs = queue_head;
+    if (!cs) {
+        dma_sniffer_disable();
+        dma_channel_set_irq0_enabled((uint)csum_chan, false);
+        dma_channel_unclaim((uint)csum_chan);
+        csum_chan = -1;
+        return;
+    }
+    const uint8_t *p = cs->next;
+    uint32_t n = cs->dma_left < DMA_CSUM_CHUNK_SIZE ? cs->dma_left : DMA_CSUM_CHUNK_SIZE;
+    cs->next += n;
+    cs->dma_left -= n;
+    cs->pos += n;
+    cs->dma_bytes += n;
+
+    // Words from the buffer to a dummy word, for the sniffer to see
+    dma_channel_config c = dma_channel_get_default_config((uint)csum_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_sniff_enable(&c, true);
+    dma_sniffer_enable((uint)csum_chan, algs[cs->alg].calc, false);
+    // The CRCs take each word MSB first, which is the last byte first. The
+    // reflected ones bit reverse it, so come out in byte order, but the others
+    // need the bytes swapped back.
+    const alg_info_t *a = &algs[cs->alg];
+    dma_sniffer_set_byte_swap_enabled(a->width && !a->reflected);
+    dma_sniffer_set_data_accumulator(cs->state);
+    dma_channel_configure((uint)csum_chan, &c, &dummy_dst, p, n / 4, true);
+}
+
+static void __not_in_flash_func(dma_csum_irq_handler)(void) {
+    if (csum_chan < 0 || !dma_channel_get_irq0_status((uint)csum_chan)) {
+        return;
+    }
+    dma_channel_acknowledge_irq0((uint)csum_chan);
+    dma_csum_t *cs = queue_head;
+    cs->state = dma_sniffer_get_data_accumulator();
+    queue_head = cs->queue_next;
+    if (!queue_head) {
+        queue_tail = NULL;
+    }
+    // To the back of the queue if it has more, so each stream gets a turn
+    bool done = !cs->dma_left;
+    if (done) {
+        cpu_update(cs, cs->next, cs->tail_len);
+    } else {
+        enqueue(cs);
+    }
+    run_next();
+    if (done) {
+        finish(cs);
+    }
+}
+
+static bool claim_channel(void) {
+    csum_chan = dma_claim_unused_channel(false);
+    if (csum_chan < 0) {
+        return false;
+    }
+    if (!irq_handler_added) {
+#if PICO_NO_HARDWARE
+        dma_model_add_region(&dummy_dst, sizeof(dummy_dst));
+#endif
+        irq_add_shared_handler(DMA_IRQ_0, dma_csum_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+        irq_handler_added = true;
+    }
+    // The accumulator is read back between chunks, so it has to read as it is
+    dma_sniffer_set_output_invert_enabled(false);
+    dma_sniffer_set_output_reverse_enabled(false);
+    dma_channel_set_irq0_enabled((uint)csum_chan, true);
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Streams
+
+const char *dma_csum_alg_name(dma_csum_alg_t alg) {
+    return algs[alg].name;
+}
+
+void dma_csum_init(dma_csum_t *cs, dma_csum_alg_t alg) {
+    const alg_info_t *a = &algs[alg];
+    cs->alg = alg;
+    cs->state = a->init;
+    cs->pos = 0;
+    cs->dma_bytes = 0;
+    cs->cpu_bytes = 0;
+    cs->busy = false;
+    if (a->width) {
+        make_table((a->width == 16 ? TABLE_CRC16 : TABLE_CRC32) + (a->reflected ? 1 : 0));
+    }
+}
+
+bool dma_csum_update_async(dma_csum_t *cs, const void *data, uint32_t len, dma_csum_callback_t callback,
+                           void *user_data) {
+    dma_csum_wait(cs);
+    const uint8_t *p = data;
+
+    // The processor does the bytes up to the first word boundary, and for
+    // SUM32 that has to be a word boundary of the stream too, or none of it
+    // can be done in words
+    uint32_t head = (uint32_t)-(uintptr_t)p & 3u;
+    if (cs->alg == DMA_CSUM_SUM32 && (((uintptr_t)p - cs->pos) & 3u)) {
+        head = len;
+    }
+    if (head > len) {
+        head = len;
+    }
+    cpu_update(cs, p, head);
+    p += head;
+    uint32_t words = (len - head) & ~3u;
+    uint32_t tail = len - head - words;
+
+    cs->callback = callback;
+    cs->user_data = user_data;
+    if (words) {
+        cs->next = p;
+        cs->dma_left = words;
+        cs->tail_len = tail;
+        cs->busy = true;
+        uint32_t save = save_and_disable_interrupts();
+        if (csum_chan >= 0 || claim_channel()) {
+            bool idle = !queue_head;
+            enqueue(cs);
+            if (idle) {
+                run_next();
+            }
+            restore_interrupts(save);
+            return true;
+        }
+        restore_interrupts(save);
+        cs->busy = false;
+    }
+    cpu_update(cs, p, words + tail);
+    finish(cs);
+    return false;
+}
+
+void dma_csum_update(dma_csum_t *cs, const void *data, uint32_t len) {
+    dma_csum_update_async(cs, data, len, NULL, NULL);
+    dma_csum_wait(cs);
+}
+
+void dma_csum_update_cpu(dma_csum_t *cs, const void *data, uint32_t len) {
+    dma_csum_wait(cs);
+    cpu_update(cs, data, len);
+}
+
+#if !PICO_NO_HARDWARE
+bool dma_csum_update_flash_async(dma_csum_t *cs, uint32_t flash_offs, uint32_t len, dma_csum_callback_t callback,
+                                 void *user_data) {
+    return dma_csum_update_async(cs, (const void *)(XIP_NOCACHE_NOALLOC_BASE + flash_offs), len, callback, user_data);
+}
+#endif
+
+bool dma_csum_is_busy(const dma_csum_t *cs) {
+    return cs->busy;
+}
+
+void dma_csum_wait(const dma_csum_t *cs) {
+    while (cs->busy) {
+        tight_loop_contents();
+    }
+}
+
+uint32_t dma_csum_get_result(const dma_csum_t *cs) {
+    const alg_info_t *a = &algs[cs->alg];
+    uint32_t s = cs->state;
+    if (a->calc == DMA_SNIFF_CTRL_CALC_VALUE_EVEN) {
+        return (uint32_t)__builtin_parity(s);
+    }
+    if (!a->width) {
+        return s;
+    }
+    if (a->reflected) {
+        s = bit_reverse(s) >> (32 - a->width);
+    }
+    return (s ^ a->xor_out) & (0xffffffffu >> (32 - a->width));
+}
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _DMA_CSUM_H
+#define _DMA_CSUM_H
+
+// Checksums of buffers and flash, calculated by the DMA sniffer in the
+// background.
+//
+// The sniffer watches the data one channel reads, and keeps a CRC, parity or
+// sum of it, so a channel which reads a buffer 32 bits at a time into a dummy
+// word checksums it at the speed of the bus. A dma_csum_t is one stream of
+// data: updates add to its checksum in order, and the result can be read
+// between them.
+//
+// There is only one sniffer, so streams take turns: an update is done in
+// chunks of up to DMA_CSUM_CHUNK_SIZE bytes, and the DMA_IRQ_0 handler saves
+// the accumulator after each one and moves on to the next stream with work,
+// round robin. A channel is claimed while there is work, and released when
+// there isn't. The bytes before the first word boundary, and after the last,
+// are done by the processor, as is all of an update when no channel is free.
+// The processor uses slice-by-8 tables, and keeps the same accumulator as the
+// sniffer, so the two can take turns on a stream.
+//
+// The sniffer's CRCs have fixed polynomials, so these are the CRC-32 and
+// CRC-16/CCITT variants which use them, with or without reflected data
+// (CRC-32C, for example, has a different polynomial, so isn't one of them).
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hardware/dma.h"
+
+#ifndef DMA_CSUM_CHUNK_SIZE
+#define DMA_CSUM_CHUNK_SIZE 16384u
+#endif
+
+typedef enum dma_csum_alg {
+    DMA_CSUM_CRC32,         // CRC-32 (zlib, Ethernet, PNG): reflected, init and final XOR 0xffffffff
+    DMA_CSUM_CRC32_BZIP2,   // CRC-32/BZIP2: as CRC-32, but not reflected
+    DMA_CSUM_CRC32_MPEG2,   // CRC-32/MPEG-2: not reflected, init 0xffffffff, no final XOR
+    DMA_CSUM_CRC16_CCITT,   // CRC-16/CCITT-FALSE: not reflected, init 0xffff
+    DMA_CSUM_CRC16_XMODEM,  // CRC-16/XMODEM: not reflected, init 0
+    DMA_CSUM_CRC16_KERMIT,  // CRC-16/KERMIT: reflected, init 0
+    DMA_CSUM_CRC16_X25,     // CRC-16/X-25: reflected, init and final XOR 0xffff
+    DMA_CSUM_PARITY,        // 1 if the data has an odd number of 1 bits
+    DMA_CSUM_SUM32,         // sum of the data as little endian words, the last padded with zeros
+    DMA_CSUM_ALG_COUNT
+} dma_csum_alg_t;
+
+typedef struct dma_csum dma_csum_t;
+
+typedef void (*dma_csum_callback_t)(dma_csum_t *cs, void *user_data);
+
+struct dma_csum {
+    dma_csum_alg_t alg;
+    // The sniffer's accumulator for the data so far
+    uint32_t state;
+    // Bytes so far, as the position within a word matters to SUM32
+    uint32_t pos;
+    // Bytes done by the DMA and by the processor
+    uint32_t dma_bytes;
+    uint32_t cpu_bytes;
+    volatile bool busy;
+
+    // The update in progress: words left for the DMA, then bytes for the
+    // processor
+    const uint8_t *next;
+    uint32_t dma_left;
+    uint32_t tail_len;
+    dma_csum_callback_t callback;
+    void *user_data;
+    dma_csum_t *queue_next;
+};
+
+const char *dma_csum_alg_name(dma_csum_alg_t alg);
+
+// Start a stream. Also makes the tables for the processor's part, so call it
+// from thread context first.
+void dma_csum_init(dma_csum_t *cs, dma_csum_alg_t alg);
+
+// Add len bytes to the stream. If the stream has an update in progress, waits
+// for it first (so don't call this from the callback of another update on
+// the same stream unless it has finished, which it has by the time its own
+// callback is called). callback, which may be NULL, is called when the update
+// is done: from DMA_IRQ_0, or before this returns if it was done by the
+// processor, in which case this returns false.
+bool dma_csum_update_async(dma_csum_t *cs, const void *data, uint32_t len, dma_csum_callback_t callback,
+                           void *user_data);
+
+// The same, but returns when it's done
+void dma_csum_update(dma_csum_t *cs, const void *data, uint32_t len);
+
+// Add len bytes using only the processor
+void dma_csum_update_cpu(dma_csum_t *cs, const void *data, uint32_t len);
+
+#if !PICO_NO_HARDWARE
+// Add len bytes of flash, from flash_offs, read through the uncached XIP
+// alias so as not to evict anything from the cache
+bool dma_csum_update_flash_async(dma_csum_t *cs, uint32_t flash_offs, uint32_t len, dma_csum_callback_t callback,
+                                 void *user_data);
+#endif
+
+bool dma_csum_is_busy(const dma_csum_t *cs);
+void dma_csum_wait(const dma_csum_t *cs);
+
+// The checksum of the data so far, with the algorithm's final reflection and
+// XOR applied
+uint32_t dma_csum_get_result(const dma_csum_t *cs);
+
+#endif
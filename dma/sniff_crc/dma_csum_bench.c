@@ -0,0 +1,318 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Check each checksum dma_csum.c calculates, on the DMA sniffer and on the
+// processor, then time both
+//
+// The checks compare the standard check values, then checksums of buffers of
+// many lengths and alignments, of streams fed in uneven pieces, of two
+// streams taking turns on the sniffer, and of a stream with no channel free,
+// with those of a plain bit at a time CRC. The timings are of a CRC-32 of a
+// buffer in RAM, and of a range of flash, in MB/s.
+//
+// On the host, dma_csum.c drives dma/dma_model, whose sniffer takes the bytes
+// of each word in the same order as the hardware, so the checks run in CI:
+//
+//   cc -DPICO_NO_HARDWARE=1 -I../dma_model/include dma_csum_bench.c dma_csum.c ../dma_model/dma_model.c
+//
+// and a wrong checksum gives a non-zero exit status. There the timings are
+// replaced by the number of bus transfers the model counts per byte, which
+// goes up if a change makes the DMA use narrower ones.
+
+#include <stdio.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#else
+#include "hardware/irq.h"
+#define count_of(a) (sizeof(a)/sizeof((a)[0]))
+#endif
+
+#include "dma_csum.h"
+
+#define BUF_SIZE 65536u
+
+// Everything the DMA reads, so the host can hand it to the model
+static struct {
+    uint8_t buf[BUF_SIZE];
+} mem __attribute__((aligned(4)));
+
+// The parameters of each algorithm, as in the usual catalogue, and its
+// checksum of "123456789"
+typedef struct spec {
+    uint32_t check;
+    uint8_t width;
+    bool reflected;
+    uint32_t poly;
+    uint32_t init;
+    uint32_t xor_out;
+} spec_t;
+
+static const spec_t specs[DMA_CSUM_ALG_COUNT] = {
+    [DMA_CSUM_CRC32] = {0xcbf43926u, 32, true, 0x04c11db7u, 0xffffffffu, 0xffffffffu},
+    [DMA_CSUM_CRC32_BZIP2] = {0xfc891918u, 32, false, 0x04c11db7u, 0xffffffffu, 0xffffffffu},
+    [DMA_CSUM_CRC32_MPEG2] = {0x0376e6e7u, 32, false, 0x04c11db7u, 0xffffffffu, 0},
+    [DMA_CSUM_CRC16_CCITT] = {0x29b1u, 16, false, 0x1021u, 0xffffu, 0},
+    [DMA_CSUM_CRC16_XMODEM] = {0x31c3u, 16, false, 0x1021u, 0, 0},
+    [DMA_CSUM_CRC16_KERMIT] = {0x2189u, 16, true, 0x1021u, 0, 0},
+    [DMA_CSUM_CRC16_X25] = {0x906eu, 16, true, 0x1021u, 0xffffu, 0xffffu},
+    [DMA_CSUM_PARITY] = {1},
+    [DMA_CSUM_SUM32] = {0x6c6a689fu},
+};
+
+static uint32_t failures;
+
+static void check(const char *what, dma_csum_alg_t alg, uint32_t len, uint32_t got, uint32_t expected) {
+    if (got != expected) {
+        printf("  %s, %s of %u bytes: 0x%08x, expected 0x%08x\n", what, dma_csum_alg_name(alg), (unsigned)len,
+               (unsigned)got, (unsigned)expected);
+        failures++;
+    }
+}
+
+static uint32_t reflect(uint32_t v, uint32_t bits) {
+    uint32_t r = 0;
+    for (uint32_t i = 0; i < bits; ++i, v >>= 1) {
+        r = (r << 1) | (v & 1);
+    }
+    return r;
+}
+
+// A bit at a time, straight from the parameters
+static uint32_t reference(dma_csum_alg_t alg, const uint8_t *p, uint32_t len) {
+    const spec_t *s = &specs[alg];
+    if (alg == DMA_CSUM_PARITY || alg == DMA_CSUM_SUM32) {
+        uint32_t v = 0;
+        for (uint32_t i = 0; i < len; ++i) {
+            v = alg == DMA_CSUM_PARITY ? v ^ p[i] : v + ((uint32_t)p[i] << (8 * (i & 3)));
+        }
+        return alg == DMA_CSUM_PARITY ? (uint32_t)__builtin_parity(v) : v;
+    }
+    uint32_t top = 1u << (s->width - 1);
+    uint32_t mask = top | (top - 1);
+    uint32_t crc = s->init;
+    for (uint32_t i = 0; i < len; ++i) {
+        uint32_t b = s->reflected ? reflect(p[i], 8) : p[i];
+        crc ^= b << (s->width - 8);
+        for (uint32_t j = 0; j < 8; ++j) {
+            crc = (crc & top ? (crc << 1) ^ s->poly : crc << 1) & mask;
+        }
+    }
+    if (s->reflected) {
+        crc = reflect(crc, s->width);
+    }
+    return crc ^ s->xor_out;
+}
+
+static uint32_t rand_state = 1;
+
+static uint32_t next_rand(void) {
+    rand_state = rand_state * 1103515245u + 12345u;
+    return rand_state >> 8;
+}
+
+static void fill_random(void) {
+    for (uint32_t i = 0; i < BUF_SIZE; ++i) {
+        mem.buf[i] = (uint8_t)next_rand();
+    }
+}
+
+static uint32_t dma_checksum(dma_csum_alg_t alg, const uint8_t *p, uint32_t len) {
+    dma_csum_t cs;
+    dma_csum_init(&cs, alg);
+    dma_csum_update(&cs, p, len);
+    return dma_csum_get_result(&cs);
+}
+
+static uint32_t cpu_checksum(dma_csum_alg_t alg, const uint8_t *p, uint32_t len) {
+    dma_csum_t cs;
+    dma_csum_init(&cs, alg);
+    dma_csum_update_cpu(&cs, p, len);
+    return dma_csum_get_result(&cs);
+}
+
+static void check_values(void) {
+    memcpy(mem.buf, "123456789", 9);
+    for (uint32_t a = 0; a < DMA_CSUM_ALG_COUNT; ++a) {
+        check("check value, DMA", a, 9, dma_checksum(a, mem.buf, 9), specs[a].check);
+        check("check value, CPU", a, 9, cpu_checksum(a, mem.buf, 9), specs[a].check);
+        check("check value, reference", a, 9, reference(a, mem.buf, 9), specs[a].check);
+    }
+}
+
+// Every alignment of the start and end, and lengths either side of the
+// chunk size
+static void check_buffers(void) {
+    static const uint32_t lens[] = {0, 1, 3, 4, 5, 7, 8, 9, 31, 64, 255, 1000, 4097,
+                                    DMA_CSUM_CHUNK_SIZE, DMA_CSUM_CHUNK_SIZE + 5, 2 * DMA_CSUM_CHUNK_SIZE + 11};
+    fill_random();
+    for (uint32_t a = 0; a < DMA_CSUM_ALG_COUNT; ++a) {
+        for (uint32_t l = 0; l < count_of(lens); ++l) {
+            for (uint32_t offset = 0; offset < 4; ++offset) {
+                const uint8_t *p = mem.buf + offset;
+                uint32_t expected = reference(a, p, lens[l]);
+                check("DMA", a, lens[l], dma_checksum(a, p, lens[l]), expected);
+                check("CPU", a, lens[l], cpu_checksum(a, p, lens[l]), expected);
+            }
+        }
+    }
+}
+
+// One stream in uneven pieces, some by the DMA and some by the processor
+static void check_streams(void) {
+    fill_random();
+    const uint32_t len = 20000;
+    for (uint32_t a = 0; a < DMA_CSUM_ALG_COUNT; ++a) {
+        dma_csum_t cs;
+        dma_csum_init(&cs, a);
+        for (uint32_t pos = 0, n; pos < len; pos += n) {
+            n = next_rand() % 700;
+            if (n > len - pos) {
+                n = len - pos;
+            }
+            if (next_rand() & 3) {
+                dma_csum_update(&cs, mem.buf + 1 + pos, n);
+            } else {
+                dma_csum_update_cpu(&cs, mem.buf + 1 + pos, n);
+            }
+        }
+        check("stream", a, len, dma_csum_get_result(&cs), reference(a, mem.buf + 1, len));
+    }
+}
+
+static void count_callback(dma_csum_t *cs, void *user_data) {
+    (void)cs;
+    *(volatile uint32_t *)user_data += 1;
+}
+
+// Two streams at once, each of several chunks, which take turns on the
+// sniffer. The interrupt is held off while they are started, so the second
+// is queued behind the first on the host too.
+static void check_turns(void) {
+    fill_random();
+    const uint32_t len = 3 * DMA_CSUM_CHUNK_SIZE + 6;
+    const uint8_t *p = mem.buf, *q = mem.buf + BUF_SIZE - len;
+    volatile uint32_t callbacks = 0;
+    dma_csum_t a, b;
+    dma_csum_init(&a, DMA_CSUM_CRC32);
+    dma_csum_init(&b, DMA_CSUM_CRC16_CCITT);
+    irq_set_enabled(DMA_IRQ_0, false);
+    bool a_dma = dma_csum_update_async(&a, p, len, count_callback, (void *)&callbacks);
+    bool b_dma = dma_csum_update_async(&b, q, len, count_callback, (void *)&callbacks);
+    irq_set_enabled(DMA_IRQ_0, true);
+    dma_csum_wait(&a);
+    dma_csum_wait(&b);
+    check("turns, first", a.alg, len, dma_csum_get_result(&a), reference(a.alg, p, len));
+    check("turns, second", b.alg, len, dma_csum_get_result(&b), reference(b.alg, q, len));
+    check("turns, callbacks", a.alg, len, callbacks, 2);
+    check("turns, by DMA", a.alg, len, a_dma && b_dma && a.dma_bytes == len - 2 && b.dma_bytes == len - 2, true);
+}
+
+// With every channel claimed, the processor does it all
+static void check_no_channel(void) {
+    fill_random();
+    uint32_t mask = 0;
+    for (int ch; (ch = dma_claim_unused_channel(false)) >= 0; ) {
+        mask |= 1u << ch;
+    }
+    const uint32_t len = 1000;
+    dma_csum_t cs;
+    dma_csum_init(&cs, DMA_CSUM_CRC32);
+    bool used_dma = dma_csum_update_async(&cs, mem.buf, len, NULL, NULL);
+    dma_unclaim_mask(mask);
+    check("no channel", cs.alg, len, dma_csum_get_result(&cs), reference(cs.alg, mem.buf, len));
+    check("no channel, by CPU", cs.alg, len, !used_dma && cs.cpu_bytes == len, true);
+}
+
+typedef struct csum_check {
+    const char *name;
+    void (*run)(void);
+} csum_check_t;
+
+static const csum_check_t checks[] = {
+    {"check values", check_values},
+    {"buffers", check_buffers},
+    {"streams", check_streams},
+    {"turns", check_turns},
+    {"no channel", check_no_channel},
+};
+
+#if !PICO_NO_HARDWARE
+#define BENCH_REPEATS 8
+#define FLASH_OFFSET 0
+
+typedef enum { BY_DMA, BY_CPU, BY_BIT } bench_how_t;
+
+static const char *const how_names[] = {"DMA sniffer", "slice-by-8", "bit at a time"};
+
+// MB/s for a CRC-32 of len bytes at p (or of flash from FLASH_OFFSET)
+static float bench(bench_how_t how, const uint8_t *p, uint32_t len, bool flash) {
+    uint32_t repeats = how == BY_BIT ? 1 : BENCH_REPEATS;
+    uint32_t start = time_us_32();
+    for (uint32_t i = 0; i < repeats; ++i) {
+        dma_csum_t cs;
+        dma_csum_init(&cs, DMA_CSUM_CRC32);
+        if (how == BY_BIT) {
+            reference(DMA_CSUM_CRC32, p, len);
+        } else if (how == BY_CPU) {
+            dma_csum_update_cpu(&cs, p, len);
+        } else if (flash) {
+            dma_csum_update_flash_async(&cs, FLASH_OFFSET, len, NULL, NULL);
+            dma_csum_wait(&cs);
+        } else {
+            dma_csum_update(&cs, p, len);
+        }
+    }
+    uint32_t us = time_us_32() - start;
+    return (float)len * (float)repeats / (float)us;
+}
+#endif
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+    printf("DMA sniffer checksums, system clock %u MHz\n", (unsigned)(clock_get_hz(clk_sys) / 1000000));
+#else
+    dma_model_add_region(&mem, sizeof(mem));
+    puts("DMA sniffer checksums, on the DMA model");
+#endif
+
+    for (uint32_t i = 0; i < count_of(checks); ++i) {
+        uint32_t before = failures;
+        checks[i].run();
+        printf("%-14s %s\n", checks[i].name, failures == before ? "ok" : "FAILED");
+    }
+
+#if !PICO_NO_HARDWARE
+    // The same bytes through the uncached alias, for the processor
+    const uint8_t *flash = (const uint8_t *)(XIP_NOCACHE_NOALLOC_BASE + FLASH_OFFSET);
+    printf("\nCRC-32 of %u KiB, MB/s:\n", BUF_SIZE / 1024);
+    printf("%-14s %10s %10s\n", "", "RAM", "flash");
+    for (bench_how_t how = BY_DMA; how <= BY_BIT; ++how) {
+        printf("%-14s %10.1f %10.1f\n", how_names[how], bench(how, mem.buf, BUF_SIZE, false),
+               bench(how, flash, BUF_SIZE, true));
+    }
+#else
+    uint64_t transfers = 0;
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch) {
+        transfers -= dma_model_get_transfers(ch);
+    }
+    dma_checksum(DMA_CSUM_CRC32, mem.buf, BUF_SIZE);
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch) {
+        transfers += dma_model_get_transfers(ch);
+    }
+    printf("\nCRC-32 of %u KiB: %.2f DMA bus transfers/byte\n", BUF_SIZE / 1024, (double)transfers / BUF_SIZE);
+    if (dma_model_get_errors()) {
+        printf("%u DMA bus errors\n", (unsigned)dma_model_get_errors());
+        failures++;
+    }
+#endif
+
+    printf("\n%s\n", failures ? "Checksum checks FAILED" : "All checksum checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,205 @@
+// Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "dvi_format.h"
+
+// Widest line dvi_check_expand() can check
+#define MAX_LINE_PIXELS 1280
+
+static const char *const format_names[DVI_FORMAT_COUNT] = {
+    [DVI_FORMAT_PAL1] = "1bpp palette",
+    [DVI_FORMAT_PAL2] = "2bpp palette",
+    [DVI_FORMAT_PAL4] = "4bpp palette",
+    [DVI_FORMAT_PAL8] = "8bpp palette",
+    [DVI_FORMAT_RGB332] = "RGB332",
+    [DVI_FORMAT_RGB565] = "RGB565",
+};
+
+static const uint8_t format_bpp[DVI_FORMAT_COUNT] = {
+    [DVI_FORMAT_PAL1] = 1,
+    [DVI_FORMAT_PAL2] = 2,
+    [DVI_FORMAT_PAL4] = 4,
+    [DVI_FORMAT_PAL8] = 8,
+    [DVI_FORMAT_RGB332] = 8,
+    [DVI_FORMAT_RGB565] = 16,
+};
+
+const char *dvi_format_name(dvi_format_t format) {
+    return format_names[format];
+}
+
+uint32_t dvi_format_bpp(dvi_format_t format) {
+    return format_bpp[format];
+}
+
+uint32_t dvi_fb_get_pixel(dvi_format_t format, const uint8_t *line, uint32_t x) {
+    uint32_t bpp = format_bpp[format];
+    if (bpp == 16) {
+        return ((const uint16_t *)line)[x];
+    }
+    uint32_t bit = x * bpp;
+    return (line[bit / 8] >> (bit % 8)) & ((1u << bpp) - 1);
+}
+
+void dvi_fb_put_pixel(dvi_format_t format, uint8_t *line, uint32_t x, uint32_t value) {
+    uint32_t bpp = format_bpp[format];
+    if (bpp == 16) {
+        ((uint16_t *)line)[x] = (uint16_t)value;
+        return;
+    }
+    uint32_t bit = x * bpp;
+    uint32_t mask = ((1u << bpp) - 1) << (bit % 8);
+    line[bit / 8] = (uint8_t)((line[bit / 8] & ~mask) | ((value << (bit % 8)) & mask));
+}
+
+static uint32_t rgb565_to_rgb888(uint32_t v) {
+    return ((v >> 11) & 0x1fu) << 19 | ((v >> 5) & 0x3fu) << 10 | (v & 0x1fu) << 3;
+}
+
+uint32_t dvi_reference_rgb888(dvi_format_t format, const uint16_t *palette, uint32_t value) {
+    switch (format) {
+        case DVI_FORMAT_RGB332:
+            return ((value >> 5) & 0x7u) << 21 | ((value >> 2) & 0x7u) << 13 | (value & 0x3u) << 6;
+        case DVI_FORMAT_RGB565:
+            return rgb565_to_rgb888(value);
+        default:
+            return rgb565_to_rgb888(palette[value]);
+    }
+}
+
+void dvi_expand_line(dvi_format_t format, const uint16_t *palette, const uint8_t *src, uint32_t src_width,
+                     uint32_t scale, void *dst) {
+    if (format == DVI_FORMAT_RGB332) {
+        uint8_t *out = dst;
+        for (uint32_t x = 0; x < src_width; ++x) {
+            for (uint32_t i = 0; i < scale; ++i) {
+                *out++ = src[x];
+            }
+        }
+        return;
+    }
+    uint16_t *out = dst;
+    if (format == DVI_FORMAT_RGB565) {
+        const uint16_t *in = (const uint16_t *)src;
+        for (uint32_t x = 0; x < src_width; ++x) {
+            for (uint32_t i = 0; i < scale; ++i) {
+                *out++ = in[x];
+            }
+        }
+        return;
+    }
+    // Indexed: look up each pixel of each byte in turn
+    const uint32_t bpp = format_bpp[format];
+    const uint32_t mask = (1u << bpp) - 1;
+    const uint32_t per_byte = 8 / bpp;
+    for (uint32_t x = 0; x < src_width; x += per_byte) {
+        uint32_t bits = *src++;
+        uint32_t n = src_width - x < per_byte ? src_width - x : per_byte;
+        for (uint32_t j = 0; j < n; ++j) {
+            uint16_t colour = palette[bits & mask];
+            bits >>= bpp;
+            for (uint32_t i = 0; i < scale; ++i) {
+                *out++ = colour;
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// HSTX TMDS data path
+
+void dvi_tmds_expand_for(dvi_format_t line_format, dvi_tmds_expand_t *e) {
+    if (line_format == DVI_FORMAT_RGB332) {
+        // Red from bits 7:5, green from 4:2, blue from 1:0; 4 pixels a word
+        *e = (dvi_tmds_expand_t) {
+            .nbits = {2, 3, 3},
+            .rot = {26, 29, 0},
+            .enc_shift = 8,
+            .enc_n_shifts = 4,
+        };
+    } else {
+        // Red from bits 15:11, green from 10:5, blue from 4:0; 2 pixels a word
+        *e = (dvi_tmds_expand_t) {
+            .nbits = {5, 6, 5},
+            .rot = {29, 3, 8},
+            .enc_shift = 16,
+            .enc_n_shifts = 2,
+        };
+    }
+}
+
+static inline uint32_t rotr(uint32_t v, uint32_t n) {
+    n %= 32;
+    return n ? (v >> n) | (v << (32 - n)) : v;
+}
+
+void dvi_tmds_expand_model(const dvi_tmds_expand_t *e, const uint32_t *words, uint32_t n_pixels, uint32_t *rgb888) {
+    uint32_t shifter = 0;
+    uint32_t shifts_left = 0;
+    for (uint32_t i = 0; i < n_pixels; ++i) {
+        if (!shifts_left) {
+            shifter = *words++;
+            shifts_left = e->enc_n_shifts;
+        }
+        uint32_t rgb = 0;
+        for (uint32_t lane = 0; lane < 3; ++lane) {
+            // Only the top nbits of the low byte reach the encoder; the bits
+            // below them are zero
+            uint32_t keep = (0xffu << (8 - e->nbits[lane])) & 0xffu;
+            rgb |= (rotr(shifter, e->rot[lane]) & keep) << (8 * lane);
+        }
+        rgb888[i] = rgb;
+        shifter = rotr(shifter, e->enc_shift);
+        shifts_left--;
+    }
+}
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        if (err) snprintf(err, err_size, __VA_ARGS__); \
+        return false; \
+    } \
+} while (0)
+
+bool dvi_check_expand(dvi_format_t format, uint32_t scale, const uint16_t *palette, const uint8_t *fb, uint32_t width,
+                      uint32_t height, char *err, size_t err_size) {
+    static uint32_t words[MAX_LINE_PIXELS / 2];
+    static uint32_t rgb[MAX_LINE_PIXELS];
+    const uint32_t out_width = width * scale;
+    const uint32_t stride = dvi_fb_stride(format, width);
+    CHECK(out_width <= MAX_LINE_PIXELS, "line of %u pixels is too long to check", (unsigned)out_width);
+    CHECK(!dvi_format_is_indexed(format) || palette, "%s needs a palette", format_names[format]);
+    dvi_tmds_expand_t e;
+    dvi_tmds_expand_for(dvi_format_line_format(format), &e);
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint8_t *line = fb + y * stride;
+        if (dvi_format_is_direct(format, scale)) {
+            memcpy(words, line, stride);
+        } else {
+            dvi_expand_line(format, palette, line, width, scale, words);
+        }
+        dvi_tmds_expand_model(&e, words, out_width, rgb);
+        for (uint32_t x = 0; x < out_width; ++x) {
+            uint32_t expected = dvi_reference_rgb888(format, palette, dvi_fb_get_pixel(format, line, x / scale));
+            CHECK(rgb[x] == expected, "%s line %u pixel %u sent as %06x, should be %06x", format_names[format],
+                  (unsigned)y, (unsigned)x, (unsigned)rgb[x], (unsigned)expected);
+        }
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Memory and bandwidth
+
+void dvi_fb_get_budget(const dvi_timing_t *t, dvi_format_t format, uint32_t width, uint32_t height, uint32_t scale,
+                       bool scanline_render, uint32_t n_line_bufs, dvi_fb_budget_t *budget) {
+    const bool direct = dvi_format_is_direct(format, scale) && !scanline_render;
+    const uint32_t line_bytes = width * scale * dvi_format_bpp(dvi_format_line_format(format)) / 8;
+    const uint64_t lines_per_s_milli = (uint64_t)height * scale * dvi_refresh_mhz(t);
+    budget->fb_bytes = dvi_fb_stride(format, width) * height;
+    budget->line_buf_bytes = direct ? 0 : n_line_bufs * line_bytes;
+    budget->hstx_bytes_per_s = (uint32_t)(lines_per_s_milli * line_bytes / 1000);
+    budget->expand_bytes_per_s = direct ? 0 : budget->hstx_bytes_per_s;
+}
@@ -0,0 +1,128 @@
+// Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+
+// Framebuffer pixel formats for DVI output, and what each costs in memory
+// and bandwidth.
+//
+// The HSTX TMDS encoder takes the red, green and blue bits for each pixel
+// straight from the data it is given, so it can send RGB332 or RGB565
+// framebuffers without any help. It can't look colours up in a palette, or
+// send the same pixel twice, so palette-indexed framebuffers (1, 2, 4 or 8
+// bits per pixel), and framebuffers shown at 2x scale, are expanded into RGB565
+// a line at a time by the processor (see dvi_scanline.h) and the HSTX sends
+// those lines instead. Vertical doubling is just drawing each framebuffer
+// line twice.
+//
+// In indexed formats with fewer than 8 bits per pixel, the first pixel is in
+// the least significant bits of each byte. Palettes are RGB565. Framebuffer
+// lines are padded to a whole number of 32-bit words.
+//
+// dvi_tmds_expand_model() follows the words sent to the HSTX through its TMDS
+// data path to the 8-bit red, green and blue values the encoders see, and
+// dvi_check_expand() compares those with dvi_reference_rgb888() for every
+// pixel of a framebuffer. The example checks its own framebuffer at startup;
+// dvi_format_check.c covers every format and scale, on the device or the host.
+
+#ifndef _DVI_FORMAT_H
+#define _DVI_FORMAT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dvi_timing.h"
+
+typedef enum {
+    DVI_FORMAT_PAL1,
+    DVI_FORMAT_PAL2,
+    DVI_FORMAT_PAL4,
+    DVI_FORMAT_PAL8,
+    DVI_FORMAT_RGB332,
+    DVI_FORMAT_RGB565,
+    DVI_FORMAT_COUNT
+} dvi_format_t;
+
+const char *dvi_format_name(dvi_format_t format);
+
+uint32_t dvi_format_bpp(dvi_format_t format);
+
+static inline bool dvi_format_is_indexed(dvi_format_t format) {
+    return format <= DVI_FORMAT_PAL8;
+}
+
+// Whether the HSTX can be sent the framebuffer's lines as they are, with no
+// expansion by the processor
+static inline bool dvi_format_is_direct(dvi_format_t format, uint32_t scale) {
+    return scale == 1 && (format == DVI_FORMAT_RGB332 || format == DVI_FORMAT_RGB565);
+}
+
+// The format of the lines the HSTX is sent: RGB332 framebuffers stay as they
+// are, and everything else is sent as RGB565
+static inline dvi_format_t dvi_format_line_format(dvi_format_t format) {
+    return format == DVI_FORMAT_RGB332 ? DVI_FORMAT_RGB332 : DVI_FORMAT_RGB565;
+}
+
+// Bytes per framebuffer line
+static inline uint32_t dvi_fb_stride(dvi_format_t format, uint32_t width) {
+    return (width * dvi_format_bpp(format) + 31) / 32 * 4;
+}
+
+uint32_t dvi_fb_get_pixel(dvi_format_t format, const uint8_t *line, uint32_t x);
+void dvi_fb_put_pixel(dvi_format_t format, uint8_t *line, uint32_t x, uint32_t value);
+
+// The colour a pixel value should be shown as, as 0xRRGGBB, with the bits the
+// format doesn't have set to zero
+uint32_t dvi_reference_rgb888(dvi_format_t format, const uint16_t *palette, uint32_t value);
+
+// Expand a framebuffer line of src_width pixels into the line format,
+// repeating each pixel `scale` times
+void dvi_expand_line(dvi_format_t format, const uint16_t *palette, const uint8_t *src, uint32_t src_width,
+                     uint32_t scale, void *dst);
+
+// ----------------------------------------------------------------------------
+// HSTX TMDS data path
+
+typedef struct dvi_tmds_expand {
+    // For lanes 0 (blue), 1 (green) and 2 (red): the number of bits, 1 to 8,
+    // taken from the top of the low byte after rotating right by rot
+    uint8_t nbits[3];
+    uint8_t rot[3];
+    // Right rotate of the shift register after each pixel, and pixels per
+    // 32-bit word
+    uint8_t enc_shift;
+    uint8_t enc_n_shifts;
+} dvi_tmds_expand_t;
+
+// Settings for sending lines of the given line format
+void dvi_tmds_expand_for(dvi_format_t line_format, dvi_tmds_expand_t *e);
+
+// The colours, as 0xRRGGBB, which n_pixels pixels of TMDS data in `words`
+// will be sent as
+void dvi_tmds_expand_model(const dvi_tmds_expand_t *e, const uint32_t *words, uint32_t n_pixels, uint32_t *rgb888);
+
+// Check every line of a framebuffer of width x height pixels, shown at the
+// given scale, comes out of the TMDS data path the colours it should be.
+// Returns true if all is well; otherwise, if err is not NULL, describes the
+// first problem found.
+bool dvi_check_expand(dvi_format_t format, uint32_t scale, const uint16_t *palette, const uint8_t *fb, uint32_t width,
+                      uint32_t height, char *err, size_t err_size);
+
+// ----------------------------------------------------------------------------
+// Memory and bandwidth
+
+typedef struct dvi_fb_budget {
+    // framebuffer size
+    uint32_t fb_bytes;
+    // scanline buffers, if lines are drawn one at a time
+    uint32_t line_buf_bytes;
+    // pixel data read by the DMA for the HSTX
+    uint32_t hstx_bytes_per_s;
+    // pixel data written by the processor drawing lines
+    uint32_t expand_bytes_per_s;
+} dvi_fb_budget_t;
+
+// Lines are drawn into n_line_bufs scanline buffers if the format needs
+// expanding, or if scanline_render is set for a format which doesn't
+void dvi_fb_get_budget(const dvi_timing_t *t, dvi_format_t format, uint32_t width, uint32_t height, uint32_t scale,
+                       bool scanline_render, uint32_t n_line_bufs, dvi_fb_budget_t *budget);
+
+#endif
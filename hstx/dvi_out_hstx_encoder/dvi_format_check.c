@@ -0,0 +1,157 @@
+// Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+
+// Check the framebuffer formats in dvi_format.c, for every format at 1x, 2x
+// and 4x scale: dvi_check_expand() is run over framebuffers of random pixels
+// with a random palette, at the widths the example uses and at widths which
+// end part way through a byte or word. The model of the TMDS data path is
+// itself checked against colours worked out by hand, as is the memory budget
+// of the example's default and smallest setups.
+//
+// The example only runs dvi_check_expand() at startup, for the one format it
+// was built with. The TMDS data path is modelled in C, so every format can be
+// covered on a PC without a display:
+//
+//   cc -DPICO_NO_HARDWARE=1 dvi_format_check.c dvi_format.c dvi_timing.c
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#define count_of(a) (sizeof(a)/sizeof((a)[0]))
+#endif
+
+#include "dvi_format.h"
+#include "dvi_timing.h"
+
+// As in dvi_out_hstx_encoder.c
+#define IMAGE_WIDTH 640
+#define N_SCANLINE_BUFS 4
+
+// Enough lines to vary the pixels, without needing a whole frame of memory
+#define FB_HEIGHT 8
+#define MAX_STRIDE (IMAGE_WIDTH * 2)
+
+static uint8_t fb[FB_HEIGHT * MAX_STRIDE];
+static uint16_t palette[256];
+
+static uint32_t failures;
+
+static void check(const char *what, bool ok) {
+    if (!ok) {
+        printf("  %s is wrong\n", what);
+        failures++;
+    }
+}
+
+static uint32_t rand_state;
+
+static uint32_t next_rand(void) {
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+}
+
+static void fill(dvi_format_t format, uint32_t width) {
+    const uint32_t stride = dvi_fb_stride(format, width);
+    const uint32_t mask = (uint32_t)((1ull << dvi_format_bpp(format)) - 1);
+    memset(fb, 0, sizeof(fb));
+    for (uint32_t y = 0; y < FB_HEIGHT; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            dvi_fb_put_pixel(format, &fb[y * stride], x, next_rand() & mask);
+        }
+    }
+}
+
+static void check_format(dvi_format_t format) {
+    static const uint32_t scales[] = {1, 2, 4};
+    for (uint32_t i = 0; i < count_of(scales); ++i) {
+        const uint32_t scale = scales[i];
+        // The example's width, and some which leave part of a byte or word
+        const uint32_t widths[] = {IMAGE_WIDTH / scale, 1, 37, 250 / scale};
+        for (uint32_t j = 0; j < count_of(widths); ++j) {
+            rand_state = 0x2468aceu + format * 77 + scale * 5 + j;
+            for (uint32_t k = 0; k < count_of(palette); ++k) {
+                palette[k] = (uint16_t)next_rand();
+            }
+            fill(format, widths[j]);
+            char err[128];
+            if (!dvi_check_expand(format, scale, palette, fb, widths[j], FB_HEIGHT, err, sizeof(err))) {
+                printf("  %ux, %u pixels: %s\n", (unsigned)scale, (unsigned)widths[j], err);
+                failures++;
+            }
+        }
+    }
+}
+
+// Saturated and single bit colours, worked out from the datasheet's
+// description of the TMDS encoder settings
+static void check_tmds_model(void) {
+    dvi_tmds_expand_t e;
+    uint32_t rgb[4];
+
+    dvi_tmds_expand_for(DVI_FORMAT_RGB565, &e);
+    static const uint32_t rgb565_words[] = {0x07e0f800u, 0x0821ffffu};
+    static const uint32_t rgb565_expected[] = {0xf80000u, 0x00fc00u, 0xf8fcf8u, 0x080408u};
+    dvi_tmds_expand_model(&e, rgb565_words, 4, rgb);
+    check("RGB565", !memcmp(rgb, rgb565_expected, sizeof(rgb)));
+
+    dvi_tmds_expand_for(DVI_FORMAT_RGB332, &e);
+    static const uint32_t rgb332_words[] = {0xff031ce0u};
+    static const uint32_t rgb332_expected[] = {0xe00000u, 0x00e000u, 0x0000c0u, 0xe0e0c0u};
+    dvi_tmds_expand_model(&e, rgb332_words, 4, rgb);
+    check("RGB332", !memcmp(rgb, rgb332_expected, sizeof(rgb)));
+}
+
+static void check_budget(void) {
+    const dvi_timing_t *t = &dvi_timings[DVI_MODE_640x480_60];
+    dvi_fb_budget_t b;
+
+    // The default: RGB332 sent straight from the framebuffer
+    dvi_fb_get_budget(t, DVI_FORMAT_RGB332, 640, 480, 1, false, N_SCANLINE_BUFS, &b);
+    check("RGB332 framebuffer", b.fb_bytes == 640 * 480);
+    check("RGB332 line buffers", b.line_buf_bytes == 0);
+    check("RGB332 expansion", b.expand_bytes_per_s == 0);
+    // 25.2 MHz over 800x525 is 60 frames a second
+    check("RGB332 bandwidth", b.hstx_bytes_per_s == 640 * 480 * 60);
+
+    // 1bpp at 2x, expanded to RGB565 lines of 640 pixels
+    dvi_fb_get_budget(t, DVI_FORMAT_PAL1, 320, 240, 2, false, N_SCANLINE_BUFS, &b);
+    check("1bpp framebuffer", b.fb_bytes == 320 / 8 * 240);
+    check("1bpp line buffers", b.line_buf_bytes == N_SCANLINE_BUFS * 640 * 2);
+    check("1bpp expansion", b.expand_bytes_per_s == b.hstx_bytes_per_s &&
+                            b.hstx_bytes_per_s == 640 * 2 * 480 * 60);
+
+    // RGB332 drawn a line at a time, as with SCANLINE_RENDER
+    dvi_fb_get_budget(t, DVI_FORMAT_RGB332, 640, 480, 1, true, N_SCANLINE_BUFS, &b);
+    check("RGB332 scanline framebuffer", b.fb_bytes == 640 * 480);
+    check("RGB332 scanline line buffers", b.line_buf_bytes == N_SCANLINE_BUFS * 640);
+    check("RGB332 scanline drawing", b.expand_bytes_per_s == 640 * 480 * 60);
+
+    // Lines padded to whole words
+    check("stride", dvi_fb_stride(DVI_FORMAT_PAL4, 9) == 8 && dvi_fb_stride(DVI_FORMAT_PAL1, 33) == 8 &&
+                    dvi_fb_stride(DVI_FORMAT_RGB565, 3) == 8);
+}
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+#endif
+    puts("DVI format checks");
+    for (dvi_format_t format = 0; format < DVI_FORMAT_COUNT; ++format) {
+        uint32_t before = failures;
+        check_format(format);
+        printf("%-14s %s\n", dvi_format_name(format), failures == before ? "ok" : "FAILED");
+    }
+    uint32_t before = failures;
+    check_tmds_model();
+    printf("%-14s %s\n", "TMDS model", failures == before ? "ok" : "FAILED");
+    before = failures;
+    check_budget();
+    printf("%-14s %s\n", "Budget", failures == before ? "ok" : "FAILED");
+    printf("\n%s\n", failures ? "DVI format checks FAILED" : "All DVI format checks passed");
+    return failures ? 1 : 0;
+}
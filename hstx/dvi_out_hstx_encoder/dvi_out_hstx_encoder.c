@@ -8,6 +8,12 @@
 // matches the Pico DVI Sock board, which can be soldered onto a Pico 2:
 // https://github.com/Wren6991/Pico-DVI-Sock
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
 #include "hardware/dma.h"
 #include "hardware/gpio.h"
 #include "hardware/irq.h"
@@ -17,87 +23,97 @@
 #include "hardware/structs/sio.h"
 #include "pico/multicore.h"
 #include "pico/sem.h"
+#include "hardware/vreg.h"
+
+#include "dvi_format.h"
+#include "dvi_scanline.h"
+#include "dvi_timing.h"
 
+// The image stays in flash, and is converted into the framebuffer at startup
+#define _IMG_ASSET_SECTION ".rodata"
 #include "mountains_640x480_rgb332.h"
-#define framebuf mountains_640x480
 
-// ----------------------------------------------------------------------------
-// DVI constants
-
-#define TMDS_CTRL_00 0x354u
-#define TMDS_CTRL_01 0x0abu
-#define TMDS_CTRL_10 0x154u
-#define TMDS_CTRL_11 0x2abu
-
-#define SYNC_V0_H0 (TMDS_CTRL_00 | (TMDS_CTRL_00 << 10) | (TMDS_CTRL_00 << 20))
-#define SYNC_V0_H1 (TMDS_CTRL_01 | (TMDS_CTRL_00 << 10) | (TMDS_CTRL_00 << 20))
-#define SYNC_V1_H0 (TMDS_CTRL_10 | (TMDS_CTRL_00 << 10) | (TMDS_CTRL_00 << 20))
-#define SYNC_V1_H1 (TMDS_CTRL_11 | (TMDS_CTRL_00 << 10) | (TMDS_CTRL_00 << 20))
-
-#define MODE_H_SYNC_POLARITY 0
-#define MODE_H_FRONT_PORCH   16
-#define MODE_H_SYNC_WIDTH    96
-#define MODE_H_BACK_PORCH    48
-#define MODE_H_ACTIVE_PIXELS 640
-
-#define MODE_V_SYNC_POLARITY 0
-#define MODE_V_FRONT_PORCH   10
-#define MODE_V_SYNC_WIDTH    2
-#define MODE_V_BACK_PORCH    33
-#define MODE_V_ACTIVE_LINES  480
-
-#define MODE_H_TOTAL_PIXELS ( \
-    MODE_H_FRONT_PORCH + MODE_H_SYNC_WIDTH + \
-    MODE_H_BACK_PORCH  + MODE_H_ACTIVE_PIXELS \
-)
-#define MODE_V_TOTAL_LINES  ( \
-    MODE_V_FRONT_PORCH + MODE_V_SYNC_WIDTH + \
-    MODE_V_BACK_PORCH  + MODE_V_ACTIVE_LINES \
-)
-
-#define HSTX_CMD_RAW         (0x0u << 12)
-#define HSTX_CMD_RAW_REPEAT  (0x1u << 12)
-#define HSTX_CMD_TMDS        (0x2u << 12)
-#define HSTX_CMD_TMDS_REPEAT (0x3u << 12)
-#define HSTX_CMD_NOP         (0xfu << 12)
+#define IMAGE_WIDTH  640
+#define IMAGE_HEIGHT 480
+
+// Framebuffer format, from dvi_format.h. RGB332 at 1x scale is sent straight
+// from the framebuffer; everything else is expanded to RGB565 a line at a
+// time on core 1.
+#ifndef FB_FORMAT
+#define FB_FORMAT DVI_FORMAT_RGB332
+#endif
+
+// 1, or 2 to show a framebuffer of half the width and height with each pixel
+// doubled in both directions. A 320x240 framebuffer at 4 bits per pixel takes
+// 38 KB, rather than 300 KB for the full size RGB332 image.
+#ifndef FB_SCALE
+#define FB_SCALE 1
+#endif
+
+// A full size RGB565 framebuffer would be 600 KB, more than the whole of SRAM
+static_assert(FB_FORMAT != DVI_FORMAT_RGB565 || FB_SCALE > 1, "RGB565 needs an FB_SCALE of 2 or more");
+
+#define FRAMEBUF_WIDTH  (IMAGE_WIDTH / FB_SCALE)
+#define FRAMEBUF_HEIGHT (IMAGE_HEIGHT / FB_SCALE)
+
+// Video mode, from the table in dvi_timing.c. The image is centred if the
+// mode is bigger than it.
+#ifndef DVI_MODE
+#define DVI_MODE DVI_MODE_640x480_60
+#endif
+
+// Draw each line on core 1 just before it is sent, into a small ring of line
+// buffers, rather than sending lines straight from the framebuffer. The demo
+// just copies from the framebuffer with a skewed scroll, but a tile or sprite
+// renderer, set with dvi_set_scanline_renderer(), could draw the whole image
+// this way without a framebuffer at all.
+// Formats which need expanding are always drawn this way, without the scroll.
+#ifndef SCANLINE_RENDER
+#define SCANLINE_RENDER 0
+#endif
+
+// Lines the renderer can get ahead of the display by, plus one for the line
+// being sent
+#define N_SCANLINE_BUFS 4
 
 // ----------------------------------------------------------------------------
 // HSTX command lists
 
-// Lists are padded with NOPs to be >= HSTX FIFO size, to avoid DMA rapidly
-// pingponging and tripping up the IRQs.
-
-static uint32_t vblank_line_vsync_off[] = {
-    HSTX_CMD_RAW_REPEAT | MODE_H_FRONT_PORCH,
-    SYNC_V1_H1,
-    HSTX_CMD_RAW_REPEAT | MODE_H_SYNC_WIDTH,
-    SYNC_V1_H0,
-    HSTX_CMD_RAW_REPEAT | (MODE_H_BACK_PORCH + MODE_H_ACTIVE_PIXELS),
-    SYNC_V1_H1,
-    HSTX_CMD_NOP
-};
-
-static uint32_t vblank_line_vsync_on[] = {
-    HSTX_CMD_RAW_REPEAT | MODE_H_FRONT_PORCH,
-    SYNC_V0_H1,
-    HSTX_CMD_RAW_REPEAT | MODE_H_SYNC_WIDTH,
-    SYNC_V0_H0,
-    HSTX_CMD_RAW_REPEAT | (MODE_H_BACK_PORCH + MODE_H_ACTIVE_PIXELS),
-    SYNC_V0_H1,
-    HSTX_CMD_NOP
-};
-
-static uint32_t vactive_line[] = {
-    HSTX_CMD_RAW_REPEAT | MODE_H_FRONT_PORCH,
-    SYNC_V1_H1,
-    HSTX_CMD_NOP,
-    HSTX_CMD_RAW_REPEAT | MODE_H_SYNC_WIDTH,
-    SYNC_V1_H0,
-    HSTX_CMD_NOP,
-    HSTX_CMD_RAW_REPEAT | MODE_H_BACK_PORCH,
-    SYNC_V1_H1,
-    HSTX_CMD_TMDS       | MODE_H_ACTIVE_PIXELS
-};
+// Built by dvi_build_cmdlists() for the chosen mode. Lists are padded with
+// NOPs to be >= HSTX FIFO size, to avoid DMA rapidly pingponging and tripping
+// up the IRQs.
+static dvi_cmdlists_t cmdlists;
+
+static const dvi_timing_t *mode;
+
+// First line of each part of the frame, and the first line after it
+static uint v_sync_start;
+static uint v_sync_end;
+static uint v_active_start;
+static uint v_image_start;
+static uint v_image_end;
+static uint v_total_lines;
+
+static uint8_t *framebuf;
+static uint fb_stride;
+// Offset of the part of each line which is shown, if the image is wider
+// than the mode
+static uint fb_src_offset;
+static uint16_t palette[256];
+
+// Words of pixel data per image line sent to the HSTX
+static uint line_words;
+
+// Long enough for a line of RGB565 at the full image width
+#define MAX_LINE_WORDS (IMAGE_WIDTH * 2 / sizeof(uint32_t))
+
+static bool scanline_render;
+static dvi_scanline_render_fn_t scanline_renderer;
+static void *scanline_renderer_data;
+static dvi_scanline_ring_t scanline_ring;
+static uint32_t scanline_bufs[N_SCANLINE_BUFS][MAX_LINE_WORDS];
+// Sent in place of lines which aren't ready in time
+static uint32_t black_line[MAX_LINE_WORDS];
 
 // ----------------------------------------------------------------------------
 // DMA logic
@@ -114,8 +130,9 @@ static bool dma_pong = false;
 static uint v_scanline = 2;
 
 // During the vertical active period, we take two IRQs per scanline: one to
-// post the command list, and another to post the pixels.
-static bool vactive_cmdlist_posted = false;
+// post the command list, and another to post the pixels, plus a third to post
+// the right hand border if the image is narrower than the mode.
+static uint vactive_part = 0;
 
 void __scratch_x("") dma_irq_handler() {
     // dma_pong indicates the channel that just finished, which is the one
@@ -125,24 +142,37 @@ void __scratch_x("") dma_irq_handler() {
     dma_hw->intr = 1u << ch_num;
     dma_pong = !dma_pong;
 
-    if (v_scanline >= MODE_V_FRONT_PORCH && v_scanline < (MODE_V_FRONT_PORCH + MODE_V_SYNC_WIDTH)) {
-        ch->read_addr = (uintptr_t)vblank_line_vsync_on;
-        ch->transfer_count = count_of(vblank_line_vsync_on);
-    } else if (v_scanline < MODE_V_FRONT_PORCH + MODE_V_SYNC_WIDTH + MODE_V_BACK_PORCH) {
-        ch->read_addr = (uintptr_t)vblank_line_vsync_off;
-        ch->transfer_count = count_of(vblank_line_vsync_off);
-    } else if (!vactive_cmdlist_posted) {
-        ch->read_addr = (uintptr_t)vactive_line;
-        ch->transfer_count = count_of(vactive_line);
-        vactive_cmdlist_posted = true;
+    if (v_scanline >= v_sync_start && v_scanline < v_sync_end) {
+        ch->read_addr = (uintptr_t)cmdlists.vblank_vsync_on.words;
+        ch->transfer_count = cmdlists.vblank_vsync_on.len;
+    } else if (v_scanline < v_active_start) {
+        ch->read_addr = (uintptr_t)cmdlists.vblank_vsync_off.words;
+        ch->transfer_count = cmdlists.vblank_vsync_off.len;
+    } else if (v_scanline < v_image_start || v_scanline >= v_image_end) {
+        ch->read_addr = (uintptr_t)cmdlists.vactive_blank.words;
+        ch->transfer_count = cmdlists.vactive_blank.len;
+    } else if (vactive_part == 0) {
+        ch->read_addr = (uintptr_t)cmdlists.vactive_head.words;
+        ch->transfer_count = cmdlists.vactive_head.len;
+        vactive_part = 1;
+    } else if (vactive_part == 1) {
+        if (scanline_render) {
+            const uint8_t *line = dvi_scanline_ring_take(&scanline_ring);
+            ch->read_addr = line ? (uintptr_t)line : (uintptr_t)black_line;
+        } else {
+            uint src_line = cmdlists.src_y + v_scanline - v_image_start;
+            ch->read_addr = (uintptr_t)&framebuf[src_line * fb_stride + fb_src_offset];
+        }
+        ch->transfer_count = line_words;
+        vactive_part = cmdlists.vactive_tail.len ? 2 : 0;
     } else {
-        ch->read_addr = (uintptr_t)&framebuf[(v_scanline - (MODE_V_TOTAL_LINES - MODE_V_ACTIVE_LINES)) * MODE_H_ACTIVE_PIXELS];
-        ch->transfer_count = MODE_H_ACTIVE_PIXELS / sizeof(uint32_t);
-        vactive_cmdlist_posted = false;
+        ch->read_addr = (uintptr_t)cmdlists.vactive_tail.words;
+        ch->transfer_count = cmdlists.vactive_tail.len;
+        vactive_part = 0;
     }
 
-    if (!vactive_cmdlist_posted) {
-        v_scanline = (v_scanline + 1) % MODE_V_TOTAL_LINES;
+    if (!vactive_part) {
+        v_scanline = (v_scanline + 1) % v_total_lines;
     }
 }
 
@@ -159,21 +189,164 @@ static __force_inline uint8_t colour_rgb332(uint8_t r, uint8_t g, uint8_t b) {
 
 void scroll_framebuffer(void);
 
+// Draw one line of the image. Formats the HSTX can take directly are copied,
+// scrolling each line a little further than the one above so the image is
+// sheared; the rest are expanded. All the modes are at least as wide as the
+// image, so src_x is always 0 for those.
+static void __not_in_flash_func(render_line)(uint32_t y, uint8_t *line, void *user_data) {
+    (void)user_data;
+    static uint frame;
+    if (y == 0) {
+        ++frame;
+    }
+    const uint width = cmdlists.image_width;
+    const uint8_t *src = &framebuf[(cmdlists.src_y + y) / FB_SCALE * fb_stride];
+    if (dvi_format_is_direct(FB_FORMAT, FB_SCALE)) {
+        const uint bytes_per_pixel = dvi_format_bpp(FB_FORMAT) / 8;
+        uint scroll = (frame + y / 4) % width * bytes_per_pixel;
+        uint width_bytes = width * bytes_per_pixel;
+        src += fb_src_offset;
+        memcpy(line, src + scroll, width_bytes - scroll);
+        memcpy(line + width_bytes - scroll, src, scroll);
+    } else {
+        dvi_expand_line(FB_FORMAT, palette, src, width / FB_SCALE, FB_SCALE, line);
+    }
+}
+
+// Have core 1 draw each image line with fn just before it is sent, rather
+// than sending lines from the framebuffer. Lines are cmdlists.image_width
+// pixels, in the line format for FB_FORMAT (see dvi_format.h). Call this
+// before the output starts.
+void dvi_set_scanline_renderer(dvi_scanline_render_fn_t fn, void *user_data) {
+    scanline_renderer = fn;
+    scanline_renderer_data = user_data;
+}
+
+static void core1_render_loop(void) {
+    while (true) {
+        if (!dvi_scanline_ring_render(&scanline_ring, scanline_renderer, scanline_renderer_data)) {
+            tight_loop_contents();
+        }
+    }
+}
+
+static uint16_t rgb332_to_rgb565(uint8_t p) {
+    uint r = p >> 5, g = (p >> 2) & 0x7u, b = p & 0x3u;
+    return (uint16_t)((r << 2 | r >> 1) << 11 | (g << 3 | g) << 5 | (b << 3 | b << 1 | b >> 1));
+}
+
+// Indexed formats with fewer than 8 bits per pixel show the image in grey,
+// with as many shades as they have colours. The 8 bit palette holds the 256
+// RGB332 colours.
+static uint32_t image_pixel(uint8_t p) {
+    switch (FB_FORMAT) {
+        case DVI_FORMAT_RGB332:
+        case DVI_FORMAT_PAL8:
+            return p;
+        case DVI_FORMAT_RGB565:
+            return rgb332_to_rgb565(p);
+        default: {
+            uint luma = ((p >> 5) * 77 * 255 / 7 + ((p >> 2) & 0x7u) * 150 * 255 / 7 + (p & 0x3u) * 29 * 255 / 3) >> 8;
+            return luma >> (8 - dvi_format_bpp(FB_FORMAT));
+        }
+    }
+}
+
+static void init_framebuffer(void) {
+    if (dvi_format_is_indexed(FB_FORMAT)) {
+        uint n_colours = 1u << dvi_format_bpp(FB_FORMAT);
+        for (uint i = 0; i < n_colours; ++i) {
+            if (FB_FORMAT == DVI_FORMAT_PAL8) {
+                palette[i] = rgb332_to_rgb565(i);
+            } else {
+                uint grey = i * 255 / (n_colours - 1);
+                palette[i] = (uint16_t)((grey >> 3) << 11 | (grey >> 2) << 5 | (grey >> 3));
+            }
+        }
+    }
+    fb_stride = dvi_fb_stride(FB_FORMAT, FRAMEBUF_WIDTH);
+    fb_src_offset = cmdlists.src_x * dvi_format_bpp(FB_FORMAT) / 8;
+    framebuf = calloc(FRAMEBUF_HEIGHT, fb_stride);
+    hard_assert(framebuf);
+    const uint8_t *img = (const uint8_t *)mountains_640x480;
+    for (uint y = 0; y < FRAMEBUF_HEIGHT; ++y) {
+        for (uint x = 0; x < FRAMEBUF_WIDTH; ++x) {
+            uint8_t p = img[y * FB_SCALE * IMAGE_WIDTH + x * FB_SCALE];
+            dvi_fb_put_pixel(FB_FORMAT, &framebuf[y * fb_stride], x, image_pixel(p));
+        }
+    }
+}
+
+// Run the system and HSTX clocks at 5x the pixel clock of the mode, and work
+// out where each part of the frame starts
+static void setup_mode(const dvi_timing_t *t) {
+    mode = t;
+    if (mode->sys_clock_khz > 150000) {
+        vreg_set_voltage(VREG_VOLTAGE_1_15);
+        busy_wait_us(1000);
+    }
+    set_sys_clock_khz(mode->sys_clock_khz, true);
+    clock_configure(clk_hstx, 0, CLOCKS_CLK_HSTX_CTRL_AUXSRC_VALUE_CLK_SYS,
+                    mode->sys_clock_khz * 1000, mode->sys_clock_khz * 1000);
+
+    dvi_build_cmdlists(mode, IMAGE_WIDTH, IMAGE_HEIGHT, &cmdlists);
+    line_words = cmdlists.image_width * dvi_format_bpp(dvi_format_line_format(FB_FORMAT)) / 32;
+    v_sync_start = mode->v_front_porch;
+    v_sync_end = v_sync_start + mode->v_sync_width;
+    v_active_start = v_sync_end + mode->v_back_porch;
+    v_image_start = v_active_start + cmdlists.image_y;
+    v_image_end = v_image_start + cmdlists.image_height;
+    v_total_lines = dvi_v_total_lines(mode);
+}
+
 int main(void) {
-    // Configure HSTX's TMDS encoder for RGB332
+    setup_mode(&dvi_timings[DVI_MODE]);
+    stdio_init_all();
+
+    char err[128];
+    if (!dvi_check_cmdlists(mode, &cmdlists, err, sizeof(err))) {
+        panic("Bad command lists for %s: %s", mode->name, err);
+    }
+    printf("DVI output %s, %u.%03u Hz, system clock %u kHz\n", mode->name,
+           (uint)(dvi_refresh_mhz(mode) / 1000), (uint)(dvi_refresh_mhz(mode) % 1000), (uint)mode->sys_clock_khz);
+
+    dvi_fb_budget_t budget;
+    dvi_fb_get_budget(mode, FB_FORMAT, FRAMEBUF_WIDTH, FRAMEBUF_HEIGHT, FB_SCALE, SCANLINE_RENDER, N_SCANLINE_BUFS,
+                      &budget);
+    printf("Framebuffer %dx%d %s at %dx: %u bytes, line buffers %u bytes\n", FRAMEBUF_WIDTH, FRAMEBUF_HEIGHT,
+           dvi_format_name(FB_FORMAT), FB_SCALE, (uint)budget.fb_bytes, (uint)budget.line_buf_bytes);
+    printf("Pixel data to HSTX %u KB/s, expanded by core 1 %u KB/s\n", (uint)(budget.hstx_bytes_per_s / 1024),
+           (uint)(budget.expand_bytes_per_s / 1024));
+
+    init_framebuffer();
+    // Formats which need expanding are always drawn a line at a time. Another
+    // renderer, e.g. of tiles and sprites, can be set here instead.
+    if (SCANLINE_RENDER || !dvi_format_is_direct(FB_FORMAT, FB_SCALE)) {
+        dvi_set_scanline_renderer(render_line, NULL);
+    }
+    scanline_render = scanline_renderer != NULL;
+    // Check the HSTX will be sent the right colours, by running every line
+    // through a model of its TMDS data path
+    if (!dvi_check_expand(FB_FORMAT, FB_SCALE, palette, framebuf, FRAMEBUF_WIDTH, FRAMEBUF_HEIGHT, err, sizeof(err))) {
+        panic("Bad pixel data: %s", err);
+    }
+
+    // Configure HSTX's TMDS encoder for the line format, RGB332 or RGB565
+    dvi_tmds_expand_t expand;
+    dvi_tmds_expand_for(dvi_format_line_format(FB_FORMAT), &expand);
     hstx_ctrl_hw->expand_tmds =
-        2  << HSTX_CTRL_EXPAND_TMDS_L2_NBITS_LSB |
-        0  << HSTX_CTRL_EXPAND_TMDS_L2_ROT_LSB   |
-        2  << HSTX_CTRL_EXPAND_TMDS_L1_NBITS_LSB |
-        29 << HSTX_CTRL_EXPAND_TMDS_L1_ROT_LSB   |
-        1  << HSTX_CTRL_EXPAND_TMDS_L0_NBITS_LSB |
-        26 << HSTX_CTRL_EXPAND_TMDS_L0_ROT_LSB;
-
-    // Pixels (TMDS) come in 4 8-bit chunks. Control symbols (RAW) are an
-    // entire 32-bit word.
+        (expand.nbits[2] - 1u) << HSTX_CTRL_EXPAND_TMDS_L2_NBITS_LSB |
+        expand.rot[2]          << HSTX_CTRL_EXPAND_TMDS_L2_ROT_LSB   |
+        (expand.nbits[1] - 1u) << HSTX_CTRL_EXPAND_TMDS_L1_NBITS_LSB |
+        expand.rot[1]          << HSTX_CTRL_EXPAND_TMDS_L1_ROT_LSB   |
+        (expand.nbits[0] - 1u) << HSTX_CTRL_EXPAND_TMDS_L0_NBITS_LSB |
+        expand.rot[0]          << HSTX_CTRL_EXPAND_TMDS_L0_ROT_LSB;
+
+    // Pixels (TMDS) come in 4 8-bit chunks, or 2 16-bit chunks. Control
+    // symbols (RAW) are an entire 32-bit word.
     hstx_ctrl_hw->expand_shift =
-        4 << HSTX_CTRL_EXPAND_SHIFT_ENC_N_SHIFTS_LSB |
-        8 << HSTX_CTRL_EXPAND_SHIFT_ENC_SHIFT_LSB |
+        expand.enc_n_shifts << HSTX_CTRL_EXPAND_SHIFT_ENC_N_SHIFTS_LSB |
+        expand.enc_shift    << HSTX_CTRL_EXPAND_SHIFT_ENC_SHIFT_LSB |
         1 << HSTX_CTRL_EXPAND_SHIFT_RAW_N_SHIFTS_LSB |
         0 << HSTX_CTRL_EXPAND_SHIFT_RAW_SHIFT_LSB;
 
@@ -187,10 +360,10 @@ int main(void) {
         2u << HSTX_CTRL_CSR_SHIFT_LSB |
         HSTX_CTRL_CSR_EN_BITS;
 
-    // Note we are leaving the HSTX clock at the SDK default of 125 MHz; since
-    // we shift out two bits per HSTX clock cycle, this gives us an output of
-    // 250 Mbps, which is very close to the bit clock for 480p 60Hz (252 MHz).
-    // If we want the exact rate then we'll have to reconfigure PLLs.
+    // The HSTX clock was set to 5x the pixel clock by setup_mode(); since we
+    // shift out two bits per HSTX clock cycle, this gives us the 10 bits per
+    // pixel clock that TMDS needs. For 480p 60Hz that's 126 MHz and 252 Mbps,
+    // very close to the standard bit clock of 251.75 Mbps.
 
     // HSTX outputs 0 through 7 appear on GPIO 12 through 19.
     // Pinout on Pico DVI sock:
@@ -234,19 +407,21 @@ int main(void) {
         DMACH_PING,
         &c,
         &hstx_fifo_hw->fifo,
-        vblank_line_vsync_off,
-        count_of(vblank_line_vsync_off),
+        cmdlists.vblank_vsync_off.words,
+        cmdlists.vblank_vsync_off.len,
         false
     );
     c = dma_channel_get_default_config(DMACH_PONG);
     channel_config_set_chain_to(&c, DMACH_PING);
     channel_config_set_dreq(&c, DREQ_HSTX);
+    // Line 1 is in the vertical sync for modes with a 1 line front porch
+    const dvi_cmdlist_t *line1 = v_sync_start <= 1 ? &cmdlists.vblank_vsync_on : &cmdlists.vblank_vsync_off;
     dma_channel_configure(
         DMACH_PONG,
         &c,
         &hstx_fifo_hw->fifo,
-        vblank_line_vsync_off,
-        count_of(vblank_line_vsync_off),
+        line1->words,
+        line1->len,
         false
     );
 
@@ -257,8 +432,29 @@ int main(void) {
 
     bus_ctrl_hw->priority = BUSCTRL_BUS_PRIORITY_DMA_W_BITS | BUSCTRL_BUS_PRIORITY_DMA_R_BITS;
 
+    if (scanline_render) {
+        dvi_scanline_ring_init(&scanline_ring, (uint8_t *)scanline_bufs, N_SCANLINE_BUFS, sizeof(scanline_bufs[0]),
+                               cmdlists.image_height);
+        multicore_launch_core1(core1_render_loop);
+    }
+
     dma_channel_start(DMACH_PING);
 
-    while (1)
-        __wfi();
+    if (!scanline_render) {
+        while (1)
+            __wfi();
+    }
+
+    // Lines dropped because the renderer didn't have them ready in time
+    uint32_t last_underruns = 0;
+    uint32_t last_late = 0;
+    while (1) {
+        sleep_ms(1000);
+        uint32_t underruns = scanline_ring.underruns;
+        uint32_t late = scanline_ring.late;
+        printf("Scanline render: %u underruns, %u late lines in the last second\n",
+               (uint)(underruns - last_underruns), (uint)(late - last_late));
+        last_underruns = underruns;
+        last_late = late;
+    }
 }
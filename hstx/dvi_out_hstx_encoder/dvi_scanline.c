@@ -0,0 +1,59 @@
+// Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+
+#include <stddef.h>
+
+#include "dvi_scanline.h"
+
+void dvi_scanline_ring_init(dvi_scanline_ring_t *ring, uint8_t *bufs, uint32_t n_bufs, uint32_t line_bytes,
+                            uint32_t height) {
+    ring->bufs = bufs;
+    ring->n_bufs = n_bufs;
+    ring->line_bytes = line_bytes;
+    ring->height = height;
+    ring->next_render = 0;
+    ring->rendered = 0;
+    ring->shown = 0;
+    ring->underruns = 0;
+    ring->late = 0;
+}
+
+uint8_t *dvi_scanline_ring_begin(dvi_scanline_ring_t *ring, uint32_t *y) {
+    uint32_t shown = ring->shown;
+    uint32_t seq = ring->next_render;
+    // Don't bother drawing lines the display has already gone past
+    if ((int32_t)(seq - shown) < 0) {
+        seq = shown;
+        ring->next_render = seq;
+    }
+    // Line shown - 1 may still be in use by the DMA
+    if (seq - shown >= ring->n_bufs - 1) {
+        return NULL;
+    }
+    *y = seq % ring->height;
+    return ring->bufs + (seq % ring->n_bufs) * ring->line_bytes;
+}
+
+void dvi_scanline_ring_end(dvi_scanline_ring_t *ring) {
+    uint32_t seq = ring->next_render;
+    // Checked before the line is marked as ready, so a line which is taken
+    // straight after isn't counted. A line the display passes in between is
+    // only counted as an underrun.
+    if ((int32_t)(seq - ring->shown) < 0) {
+        ring->late++;
+    }
+    // Make sure the pixels are written before the line is marked as ready
+    __sync_synchronize();
+    ring->rendered = seq + 1;
+    ring->next_render = seq + 1;
+}
+
+bool dvi_scanline_ring_render(dvi_scanline_ring_t *ring, dvi_scanline_render_fn_t fn, void *user_data) {
+    uint32_t y;
+    uint8_t *line = dvi_scanline_ring_begin(ring, &y);
+    if (!line) {
+        return false;
+    }
+    fn(y, line, user_data);
+    dvi_scanline_ring_end(ring);
+    return true;
+}
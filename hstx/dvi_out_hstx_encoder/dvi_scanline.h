@@ -0,0 +1,88 @@
+// Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+
+// A ring of scanline buffers, for generating the image a line at a time just
+// before it is sent ("racing the beam"), rather than from a whole frame in
+// memory.
+//
+// One side (the renderer, e.g. a loop on core 1) calls
+// dvi_scanline_ring_begin() to get the next free buffer and the image line to
+// draw in it, draws the line, then calls dvi_scanline_ring_end();
+// dvi_scanline_ring_render() does all three with a render function. The other
+// side (the DMA IRQ) calls dvi_scanline_ring_take() once for each image line,
+// in order, when it needs the pixels for that line.
+//
+// Lines are numbered in sequence from the first line of the first frame, so
+// the ring stays in step with the display across frames. If a line isn't
+// ready when it is taken it is an underrun, and the IRQ should send something
+// else (e.g. a black line) in its place. If the renderer finishes a line after
+// it was needed, that line is counted as late, and the renderer skips ahead to
+// the line the display is on.
+//
+// The buffer most recently taken may still be being read by the DMA, so the
+// renderer can be up to n_bufs - 1 lines ahead of the display.
+//
+// Each side only writes its own counters, so no locks are needed, and
+// dvi_scanline_sim.c can check the ring on the host.
+
+#ifndef _DVI_SCANLINE_H
+#define _DVI_SCANLINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct dvi_scanline_ring {
+    uint8_t *bufs;
+    uint32_t n_bufs;
+    // distance between buffers, a multiple of 4 for 32-bit DMA
+    uint32_t line_bytes;
+    // image lines per frame
+    uint32_t height;
+
+    // Written by the renderer: the line being drawn, and one past the last
+    // line finished
+    volatile uint32_t next_render;
+    volatile uint32_t rendered;
+    // Written by the display side: the line to be taken next
+    volatile uint32_t shown;
+
+    // Lines the display had to do without
+    volatile uint32_t underruns;
+    // Lines finished after the display had passed them
+    volatile uint32_t late;
+} dvi_scanline_ring_t;
+
+// n_bufs must be at least 2
+void dvi_scanline_ring_init(dvi_scanline_ring_t *ring, uint8_t *bufs, uint32_t n_bufs, uint32_t line_bytes,
+                            uint32_t height);
+
+// Get a buffer to draw the next line in, and its line number within the
+// frame. Returns NULL if the renderer is as far ahead as it can be.
+uint8_t *dvi_scanline_ring_begin(dvi_scanline_ring_t *ring, uint32_t *y);
+
+// The line from the last dvi_scanline_ring_begin() is finished
+void dvi_scanline_ring_end(dvi_scanline_ring_t *ring);
+
+// Draws image line y of the frame into line
+typedef void (*dvi_scanline_render_fn_t)(uint32_t y, uint8_t *line, void *user_data);
+
+// Draw the next line with fn, if there is a buffer free for it. Returns false
+// if the renderer is as far ahead as it can be.
+bool dvi_scanline_ring_render(dvi_scanline_ring_t *ring, dvi_scanline_render_fn_t fn, void *user_data);
+
+// Take the next line for display. Returns NULL if it isn't ready. This is
+// inline as it is called from the DMA IRQ.
+static inline const uint8_t *dvi_scanline_ring_take(dvi_scanline_ring_t *ring) {
+    uint32_t seq = ring->shown;
+    const uint8_t *buf = NULL;
+    if ((int32_t)(ring->rendered - seq) > 0) {
+        // Make sure we see the pixels which were written before `rendered`
+        __sync_synchronize();
+        buf = ring->bufs + (seq % ring->n_bufs) * ring->line_bytes;
+    } else {
+        ring->underruns++;
+    }
+    ring->shown = seq + 1;
+    return buf;
+}
+
+#endif
@@ -0,0 +1,212 @@
+// Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+
+// Check the scanline ring in dvi_scanline.c against a model of the display
+//
+// This plays out the DVI timing for a mode, taking each image line from the
+// ring at the point in the frame where the DMA IRQ would, while a model of
+// the render loop on core 1 draws lines into it. The renderer takes however
+// many system clock cycles each test says a line costs, so we can see how
+// much render time, and how deep a ring, each pattern of load needs before
+// lines are dropped.
+//
+// Each line drawn is tagged with its number, and every line taken is checked
+// to be the right one, so the ring never shows lines out of order however far
+// behind the renderer falls.
+//
+// The ring is plain C, so this runs on the host too, e.g. in CI:
+//
+//   cc -DPICO_NO_HARDWARE=1 dvi_scanline_sim.c dvi_scanline.c dvi_timing.c
+//
+// and a line shown out of order, or underruns where none are expected (or
+// none where they are), give a non-zero exit status.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#define count_of(a) (sizeof(a)/sizeof((a)[0]))
+#endif
+
+#include "dvi_scanline.h"
+#include "dvi_timing.h"
+
+#define MAX_BUFS 16
+#define LINE_BYTES 8
+#define FRAMES 10
+
+static uint8_t bufs[MAX_BUFS][LINE_BYTES];
+
+static uint32_t failures;
+
+typedef struct render_load {
+    const char *name;
+    // cycles to render line y, as a percentage of the line period
+    uint32_t (*cost_percent)(uint32_t y);
+} render_load_t;
+
+static uint32_t cost_half(uint32_t y) {
+    (void)y;
+    return 50;
+}
+
+static uint32_t cost_near_limit(uint32_t y) {
+    (void)y;
+    return 95;
+}
+
+// Mostly cheap, with an expensive line every so often, e.g. where lots of
+// sprites overlap
+static uint32_t cost_spiky(uint32_t y) {
+    return y % 16 == 0 ? 300 : 50;
+}
+
+// More render time than the display gives
+static uint32_t cost_overloaded(uint32_t y) {
+    (void)y;
+    return 125;
+}
+
+typedef struct sim_result {
+    uint32_t taken;
+    uint32_t shown;
+    uint32_t wrong;
+    uint32_t underruns;
+    uint32_t late;
+    uint32_t rendered;
+} sim_result_t;
+
+typedef struct sim {
+    const dvi_timing_t *t;
+    dvi_scanline_ring_t ring;
+    uint32_t v_image_start;
+    uint32_t height;
+    // sequence number and time of the next take
+    uint32_t take_seq;
+    uint64_t take_time;
+    sim_result_t result;
+} sim_t;
+
+static void tag(uint8_t *buf, uint32_t seq) {
+    memcpy(buf, &seq, sizeof(seq));
+}
+
+// Pixel clock at which image line `seq` (counting from the first line of the
+// first frame) is taken by the IRQ. The IRQ posts a line's pixels as the DMA
+// starts on the porches and sync of that line, which is at the start of the
+// line in this model.
+static uint64_t take_time(sim_t *s, uint32_t seq) {
+    uint32_t frame = seq / s->height;
+    uint32_t y = seq % s->height;
+    uint64_t line = (uint64_t)frame * dvi_v_total_lines(s->t) + s->v_image_start + y;
+    return line * dvi_h_total_pixels(s->t);
+}
+
+// Play the display side up to the given time
+static void take_until(sim_t *s, uint64_t now) {
+    while (s->take_time <= now && s->take_seq < FRAMES * s->height) {
+        const uint8_t *buf = dvi_scanline_ring_take(&s->ring);
+        s->result.taken++;
+        if (buf) {
+            uint32_t seq;
+            memcpy(&seq, buf, sizeof(seq));
+            s->result.shown++;
+            s->result.wrong += seq != s->take_seq;
+        }
+        s->take_seq++;
+        s->take_time = take_time(s, s->take_seq);
+    }
+}
+
+typedef struct render_ctx {
+    sim_t *s;
+    const render_load_t *load;
+    // The renderer's clock, in pixel clocks
+    uint64_t now;
+} render_ctx_t;
+
+// The render function core 1 would be given: it takes the load's time to
+// draw the line, while the display carries on, then tags it
+static void render_line(uint32_t y, uint8_t *line, void *user_data) {
+    render_ctx_t *r = user_data;
+    sim_t *s = r->s;
+    uint32_t seq = s->ring.next_render;
+    r->now += (uint64_t)dvi_h_total_pixels(s->t) * r->load->cost_percent(y) / 100;
+    take_until(s, r->now);
+    tag(line, seq);
+    s->result.rendered++;
+}
+
+static void run(const dvi_timing_t *t, uint32_t n_bufs, const render_load_t *load, sim_result_t *result) {
+    static sim_t s;
+    memset(&s, 0, sizeof(s));
+    s.t = t;
+    // A 640x480 image, centred in the mode
+    dvi_cmdlists_t lists;
+    dvi_build_cmdlists(t, 640, 480, &lists);
+    s.height = lists.image_height;
+    s.v_image_start = t->v_front_porch + t->v_sync_width + t->v_back_porch + lists.image_y;
+    s.take_time = take_time(&s, 0);
+    dvi_scanline_ring_init(&s.ring, &bufs[0][0], n_bufs, LINE_BYTES, s.height);
+
+    render_ctx_t r = {.s = &s, .load = load, .now = 0};
+    while (s.take_seq < FRAMES * s.height) {
+        take_until(&s, r.now);
+        if (!dvi_scanline_ring_render(&s.ring, render_line, &r)) {
+            // Spin until the display takes another line
+            r.now = s.take_time;
+        }
+    }
+    s.result.underruns = s.ring.underruns;
+    s.result.late = s.ring.late;
+    *result = s.result;
+}
+
+static bool check_result(const sim_result_t *r, bool expect_underruns) {
+    bool ok = r->wrong == 0 && r->shown + r->underruns == r->taken && (r->underruns != 0) == expect_underruns;
+    failures += !ok;
+    return ok;
+}
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+#endif
+    printf("DVI scanline ring check\n");
+
+    static const render_load_t loads[] = {
+        {"50% of a line", cost_half},
+        {"95% of a line", cost_near_limit},
+        {"50%, 300% every 16th line", cost_spiky},
+        {"125% of a line", cost_overloaded},
+    };
+    static const uint32_t depths[] = {2, 4, 8, 16};
+    // Render costs are relative to the line period, so the results only
+    // differ between modes by how much vertical blanking they have
+    static const dvi_mode_t modes[] = {DVI_MODE_640x480_60, DVI_MODE_800x600_60};
+    for (uint32_t m = 0; m < count_of(modes); m++) {
+        const dvi_timing_t *t = &dvi_timings[modes[m]];
+        printf("\n%s, %u frames, line period %u cycles:\n", t->name, FRAMES,
+               (unsigned)(dvi_h_total_pixels(t) * DVI_HSTX_CLKS_PER_PIXEL));
+        for (uint32_t l = 0; l < count_of(loads); l++) {
+            for (uint32_t d = 0; d < count_of(depths); d++) {
+                sim_result_t r;
+                run(t, depths[d], &loads[l], &r);
+                // A spike of 3 lines' render time is covered by a ring deep
+                // enough to have got 3 lines ahead in the cheap lines before
+                // it. A steady overload can't be covered by any depth.
+                bool expect_underruns = loads[l].cost_percent == cost_overloaded ||
+                                        (loads[l].cost_percent == cost_spiky && depths[d] < 8);
+                bool ok = check_result(&r, expect_underruns);
+                printf("  %-26s %2u buffers: %6u underruns, %6u late, %u out of order %s\n", loads[l].name,
+                       (unsigned)depths[d], (unsigned)r.underruns, (unsigned)r.late, (unsigned)r.wrong,
+                       ok ? "ok" : "FAILED");
+            }
+        }
+    }
+
+    printf("\n%s\n", failures ? "Scanline checks FAILED" : "All scanline checks passed");
+    return failures ? 1 : 0;
+}
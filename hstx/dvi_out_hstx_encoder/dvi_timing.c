@@ -0,0 +1,271 @@
+// Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+
+#include <stdio.h>
+
+#include "dvi_timing.h"
+
+// The system clock is set to 5x the pixel clock, or as near as the PLL can
+// get. Above 150 MHz this is an overclock, so the example raises the core
+// voltage for those modes.
+const dvi_timing_t dvi_timings[DVI_MODE_COUNT] = {
+    // 640x480 60 Hz, 25.2 MHz pixel clock (VESA DMT, standard 25.175 MHz)
+    [DVI_MODE_640x480_60] = {
+        .name = "640x480 60Hz",
+        .sys_clock_khz = 126000,
+        .h_sync_polarity = 0,
+        .h_front_porch = 16,
+        .h_sync_width = 96,
+        .h_back_porch = 48,
+        .h_active_pixels = 640,
+        .v_sync_polarity = 0,
+        .v_front_porch = 10,
+        .v_sync_width = 2,
+        .v_back_porch = 33,
+        .v_active_lines = 480,
+    },
+    // 800x480 60 Hz, 29.4 MHz pixel clock (CVT, standard 29.5 MHz), as used
+    // by many small HDMI panels
+    [DVI_MODE_800x480_60] = {
+        .name = "800x480 60Hz",
+        .sys_clock_khz = 147000,
+        .h_sync_polarity = 0,
+        .h_front_porch = 24,
+        .h_sync_width = 72,
+        .h_back_porch = 96,
+        .h_active_pixels = 800,
+        .v_sync_polarity = 1,
+        .v_front_porch = 3,
+        .v_sync_width = 7,
+        .v_back_porch = 10,
+        .v_active_lines = 480,
+    },
+    // 800x600 60 Hz, 40 MHz pixel clock (VESA DMT)
+    [DVI_MODE_800x600_60] = {
+        .name = "800x600 60Hz",
+        .sys_clock_khz = 200000,
+        .h_sync_polarity = 1,
+        .h_front_porch = 40,
+        .h_sync_width = 128,
+        .h_back_porch = 88,
+        .h_active_pixels = 800,
+        .v_sync_polarity = 1,
+        .v_front_porch = 1,
+        .v_sync_width = 4,
+        .v_back_porch = 23,
+        .v_active_lines = 600,
+    },
+    // 1280x720 30 Hz, 32 MHz pixel clock, with CVT reduced blanking. At 60 Hz
+    // this mode would need a 64 MHz pixel clock, which is out of reach.
+    [DVI_MODE_1280x720_30_RB] = {
+        .name = "1280x720 30Hz reduced blanking",
+        .sys_clock_khz = 160000,
+        .h_sync_polarity = 1,
+        .h_front_porch = 48,
+        .h_sync_width = 32,
+        .h_back_porch = 80,
+        .h_active_pixels = 1280,
+        .v_sync_polarity = 0,
+        .v_front_porch = 3,
+        .v_sync_width = 5,
+        .v_back_porch = 13,
+        .v_active_lines = 720,
+    },
+};
+
+// The control symbol for the given sync states (true meaning asserted)
+static uint32_t sync_symbol(const dvi_timing_t *t, bool vsync, bool hsync) {
+    static const uint32_t symbols[4] = {SYNC_V0_H0, SYNC_V0_H1, SYNC_V1_H0, SYNC_V1_H1};
+    bool v = vsync == t->v_sync_polarity;
+    bool h = hsync == t->h_sync_polarity;
+    return symbols[(v << 1) | h];
+}
+
+static inline void put(dvi_cmdlist_t *list, uint32_t word) {
+    list->words[list->len++] = word;
+}
+
+static void build_vblank(const dvi_timing_t *t, bool vsync, dvi_cmdlist_t *list) {
+    list->len = 0;
+    put(list, HSTX_CMD_RAW_REPEAT | t->h_front_porch);
+    put(list, sync_symbol(t, vsync, false));
+    put(list, HSTX_CMD_RAW_REPEAT | t->h_sync_width);
+    put(list, sync_symbol(t, vsync, true));
+    put(list, HSTX_CMD_RAW_REPEAT | (t->h_back_porch + t->h_active_pixels));
+    put(list, sync_symbol(t, vsync, false));
+    put(list, HSTX_CMD_NOP);
+}
+
+// Porches and sync for an active line, up to the start of the active pixels
+static void build_vactive_start(const dvi_timing_t *t, dvi_cmdlist_t *list) {
+    list->len = 0;
+    put(list, HSTX_CMD_RAW_REPEAT | t->h_front_porch);
+    put(list, sync_symbol(t, false, false));
+    put(list, HSTX_CMD_NOP);
+    put(list, HSTX_CMD_RAW_REPEAT | t->h_sync_width);
+    put(list, sync_symbol(t, false, true));
+    put(list, HSTX_CMD_NOP);
+    put(list, HSTX_CMD_RAW_REPEAT | t->h_back_porch);
+    put(list, sync_symbol(t, false, false));
+}
+
+// Black pixels, for the borders
+static inline void put_black(dvi_cmdlist_t *list, uint32_t pixels) {
+    if (pixels) {
+        put(list, HSTX_CMD_TMDS_REPEAT | pixels);
+        put(list, 0);
+    }
+}
+
+void dvi_build_cmdlists(const dvi_timing_t *t, uint32_t src_width, uint32_t src_height, dvi_cmdlists_t *lists) {
+    // Keep the image a whole number of words wide, and word aligned in the
+    // source, so it can be read by 32-bit DMA
+    lists->image_width = (src_width < t->h_active_pixels ? src_width : t->h_active_pixels) & ~3u;
+    lists->image_height = src_height < t->v_active_lines ? src_height : t->v_active_lines;
+    lists->image_x = (t->h_active_pixels - lists->image_width) / 2;
+    lists->image_y = (t->v_active_lines - lists->image_height) / 2;
+    lists->src_x = ((src_width - lists->image_width) / 2) & ~3u;
+    lists->src_y = (src_height - lists->image_height) / 2;
+
+    build_vblank(t, false, &lists->vblank_vsync_off);
+    build_vblank(t, true, &lists->vblank_vsync_on);
+
+    build_vactive_start(t, &lists->vactive_blank);
+    put_black(&lists->vactive_blank, t->h_active_pixels);
+
+    build_vactive_start(t, &lists->vactive_head);
+    put_black(&lists->vactive_head, lists->image_x);
+    put(&lists->vactive_head, HSTX_CMD_TMDS | lists->image_width);
+
+    lists->vactive_tail.len = 0;
+    uint32_t right = t->h_active_pixels - lists->image_x - lists->image_width;
+    if (right) {
+        put_black(&lists->vactive_tail, right);
+        // Padded like the vblank lists, so the DMA doesn't come straight back
+        while (lists->vactive_tail.len < lists->vblank_vsync_off.len) {
+            put(&lists->vactive_tail, HSTX_CMD_NOP);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Checking
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        if (err) snprintf(err, err_size, __VA_ARGS__); \
+        return false; \
+    } \
+} while (0)
+
+// Plays command lists back for one line, keeping track of the position
+typedef struct line_player {
+    const dvi_timing_t *t;
+    uint32_t line;
+    bool vsync;
+    bool active;
+    uint32_t x;
+} line_player_t;
+
+// Check a run of pixels, which are either data (if is_data) or the given
+// control symbol, against what should be at that point in the line
+static bool play_run(line_player_t *p, uint32_t count, bool is_data, uint32_t symbol, char *err, size_t err_size) {
+    const dvi_timing_t *t = p->t;
+    const uint32_t sync_start = t->h_front_porch;
+    const uint32_t sync_end = sync_start + t->h_sync_width;
+    const uint32_t active_start = sync_end + t->h_back_porch;
+    const uint32_t h_total = dvi_h_total_pixels(t);
+    uint32_t end = p->x + count;
+    CHECK(end <= h_total, "line %u: more than %u pixels", (unsigned)p->line, (unsigned)h_total);
+    // A run can't span the start or end of the sync pulse, or the start of
+    // the active pixels on an active line, as what's sent changes there
+    CHECK(!(p->x < sync_start && end > sync_start) && !(p->x < sync_end && end > sync_end) &&
+          !(p->active && p->x < active_start && end > active_start),
+          "line %u: run of %u pixels at %u spans a sync or active boundary", (unsigned)p->line,
+          (unsigned)count, (unsigned)p->x);
+    if (p->active && p->x >= active_start) {
+        CHECK(is_data, "line %u: control symbols at %u, in the active area", (unsigned)p->line, (unsigned)p->x);
+    } else {
+        bool hsync = p->x >= sync_start && p->x < sync_end;
+        CHECK(!is_data, "line %u: data at %u, outside the active area", (unsigned)p->line, (unsigned)p->x);
+        CHECK(symbol == sync_symbol(t, p->vsync, hsync), "line %u: wrong control symbol %08x at %u "
+              "(vsync %d, hsync %d)", (unsigned)p->line, (unsigned)symbol, (unsigned)p->x, p->vsync, hsync);
+    }
+    p->x = end;
+    return true;
+}
+
+// Play a command list. If image_width is non-zero, the list must end with a
+// TMDS command for that many pixels, which will come from the image.
+static bool play_list(line_player_t *p, const dvi_cmdlist_t *list, uint32_t image_width, char *err, size_t err_size) {
+    for (uint32_t i = 0; i < list->len; i++) {
+        uint32_t cmd = list->words[i] & 0xf000u;
+        uint32_t count = list->words[i] & 0x0fffu;
+        bool ok;
+        switch (cmd) {
+            case HSTX_CMD_NOP:
+                ok = true;
+                break;
+            case HSTX_CMD_RAW:
+                CHECK(i + count < list->len, "line %u: RAW command runs off the end of the list", (unsigned)p->line);
+                ok = true;
+                for (uint32_t j = 0; j < count && ok; j++) {
+                    ok = play_run(p, 1, false, list->words[++i], err, err_size);
+                }
+                break;
+            case HSTX_CMD_RAW_REPEAT:
+                CHECK(i + 1 < list->len, "line %u: RAW_REPEAT with no symbol", (unsigned)p->line);
+                ok = play_run(p, count, false, list->words[++i], err, err_size);
+                break;
+            case HSTX_CMD_TMDS_REPEAT:
+                CHECK(i + 1 < list->len, "line %u: TMDS_REPEAT with no data", (unsigned)p->line);
+                ++i;
+                ok = play_run(p, count, true, 0, err, err_size);
+                break;
+            case HSTX_CMD_TMDS:
+                CHECK(image_width && i == list->len - 1 && count == image_width,
+                      "line %u: TMDS command for %u pixels, with %u pixels of image data following",
+                      (unsigned)p->line, (unsigned)count, (unsigned)(i == list->len - 1 ? image_width : 0));
+                ok = play_run(p, count, true, 0, err, err_size);
+                break;
+            default:
+                CHECK(false, "line %u: unknown command %08x", (unsigned)p->line, (unsigned)list->words[i]);
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool dvi_check_cmdlists(const dvi_timing_t *t, const dvi_cmdlists_t *lists, char *err, size_t err_size) {
+    const uint32_t vsync_start = t->v_front_porch;
+    const uint32_t vsync_end = vsync_start + t->v_sync_width;
+    const uint32_t vactive_start = vsync_end + t->v_back_porch;
+    CHECK(lists->image_x + lists->image_width <= t->h_active_pixels &&
+          lists->image_y + lists->image_height <= t->v_active_lines, "image doesn't fit in the active area");
+    CHECK(lists->image_width % 4 == 0, "image width %u is not a whole number of words", (unsigned)lists->image_width);
+    for (uint32_t line = 0; line < dvi_v_total_lines(t); line++) {
+        line_player_t p = {
+            .t = t,
+            .line = line,
+            .vsync = line >= vsync_start && line < vsync_end,
+            .active = line >= vactive_start,
+        };
+        uint32_t y = line - vactive_start;
+        bool ok;
+        if (!p.active) {
+            ok = play_list(&p, p.vsync ? &lists->vblank_vsync_on : &lists->vblank_vsync_off, 0, err, err_size);
+        } else if (y < lists->image_y || y >= lists->image_y + lists->image_height) {
+            ok = play_list(&p, &lists->vactive_blank, 0, err, err_size);
+        } else {
+            ok = play_list(&p, &lists->vactive_head, lists->image_width, err, err_size) &&
+                 play_list(&p, &lists->vactive_tail, 0, err, err_size);
+        }
+        if (!ok) {
+            return false;
+        }
+        CHECK(p.x == dvi_h_total_pixels(t), "line %u: %u pixels, should be %u", (unsigned)line, (unsigned)p.x,
+              (unsigned)dvi_h_total_pixels(t));
+    }
+    return true;
+}
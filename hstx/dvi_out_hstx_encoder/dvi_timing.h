@@ -0,0 +1,137 @@
+// Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+
+// DVI video modes, and the HSTX command lists to generate them.
+//
+// Each scanline starts with the horizontal front porch, then the sync pulse,
+// the back porch and the active pixels. Each frame starts with the vertical
+// front porch, then the vertical sync, the back porch and the active lines.
+//
+// The image doesn't have to be the same size as the mode: it is centred, and
+// the rest of the active area is filled with black. So each active line is
+// made of up to three pieces, which are handed to the HSTX FIFO in turn:
+//
+//   vactive_head:   porches and sync, left border, TMDS command for the image
+//   image pixels:   image_width pixels, straight from the image
+//   vactive_tail:   right border, if any
+//
+// and active lines above and below the image are a single vactive_blank
+// list.
+//
+// dvi_check_cmdlists() plays a whole frame of command lists back the way the
+// HSTX command expander would, and checks the line lengths, the placement of
+// the sync pulses and data periods, and the TMDS control symbols.
+//
+// Nothing here writes to the HSTX, so dvi_format_check.c and
+// dvi_scanline_sim.c can use dvi_timings for their line lengths and frame
+// rates on the host as well.
+
+#ifndef _DVI_TIMING_H
+#define _DVI_TIMING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// ----------------------------------------------------------------------------
+// DVI constants
+
+#define TMDS_CTRL_00 0x354u
+#define TMDS_CTRL_01 0x0abu
+#define TMDS_CTRL_10 0x154u
+#define TMDS_CTRL_11 0x2abu
+
+#define SYNC_V0_H0 (TMDS_CTRL_00 | (TMDS_CTRL_00 << 10) | (TMDS_CTRL_00 << 20))
+#define SYNC_V0_H1 (TMDS_CTRL_01 | (TMDS_CTRL_00 << 10) | (TMDS_CTRL_00 << 20))
+#define SYNC_V1_H0 (TMDS_CTRL_10 | (TMDS_CTRL_00 << 10) | (TMDS_CTRL_00 << 20))
+#define SYNC_V1_H1 (TMDS_CTRL_11 | (TMDS_CTRL_00 << 10) | (TMDS_CTRL_00 << 20))
+
+#define HSTX_CMD_RAW         (0x0u << 12)
+#define HSTX_CMD_RAW_REPEAT  (0x1u << 12)
+#define HSTX_CMD_TMDS        (0x2u << 12)
+#define HSTX_CMD_TMDS_REPEAT (0x3u << 12)
+#define HSTX_CMD_NOP         (0xfu << 12)
+
+// The HSTX shifts out 2 bits per clock, so with 10 bits per TMDS symbol the
+// HSTX clock runs at 5x the pixel clock
+#define DVI_HSTX_CLKS_PER_PIXEL 5
+
+typedef struct dvi_timing {
+    const char *name;
+    // HSTX (and system) clock. The pixel clock is a fifth of this.
+    uint32_t sys_clock_khz;
+
+    // 1 for active-high sync, 0 for active-low
+    bool h_sync_polarity;
+    uint16_t h_front_porch;
+    uint16_t h_sync_width;
+    uint16_t h_back_porch;
+    uint16_t h_active_pixels;
+
+    bool v_sync_polarity;
+    uint16_t v_front_porch;
+    uint16_t v_sync_width;
+    uint16_t v_back_porch;
+    uint16_t v_active_lines;
+} dvi_timing_t;
+
+typedef enum {
+    DVI_MODE_640x480_60,
+    DVI_MODE_800x480_60,
+    DVI_MODE_800x600_60,
+    DVI_MODE_1280x720_30_RB,
+    DVI_MODE_COUNT
+} dvi_mode_t;
+
+extern const dvi_timing_t dvi_timings[DVI_MODE_COUNT];
+
+static inline uint32_t dvi_h_total_pixels(const dvi_timing_t *t) {
+    return t->h_front_porch + t->h_sync_width + t->h_back_porch + t->h_active_pixels;
+}
+
+static inline uint32_t dvi_v_total_lines(const dvi_timing_t *t) {
+    return t->v_front_porch + t->v_sync_width + t->v_back_porch + t->v_active_lines;
+}
+
+// Refresh rate in millihertz
+static inline uint32_t dvi_refresh_mhz(const dvi_timing_t *t) {
+    uint64_t pixel_clock_hz = (uint64_t)t->sys_clock_khz * 1000 / DVI_HSTX_CLKS_PER_PIXEL;
+    return (uint32_t)(pixel_clock_hz * 1000 / (dvi_h_total_pixels(t) * dvi_v_total_lines(t)));
+}
+
+// Long enough for the longest list, with NOP padding
+#define DVI_CMDLIST_MAX_WORDS 12
+
+typedef struct dvi_cmdlist {
+    uint32_t words[DVI_CMDLIST_MAX_WORDS];
+    uint32_t len;
+} dvi_cmdlist_t;
+
+typedef struct dvi_cmdlists {
+    dvi_cmdlist_t vblank_vsync_off;
+    dvi_cmdlist_t vblank_vsync_on;
+    dvi_cmdlist_t vactive_blank;
+    dvi_cmdlist_t vactive_head;
+    // empty if the image is as wide as the mode
+    dvi_cmdlist_t vactive_tail;
+
+    // Where the image goes in the active area, and which part of the source
+    // image is shown, if the source is bigger than the mode
+    uint32_t image_x;
+    uint32_t image_y;
+    uint32_t image_width;
+    uint32_t image_height;
+    uint32_t src_x;
+    uint32_t src_y;
+} dvi_cmdlists_t;
+
+// Build the command lists for a mode, showing an image of src_width x
+// src_height pixels. src_width should be a multiple of 4, so the image's rows
+// are a whole number of words.
+void dvi_build_cmdlists(const dvi_timing_t *t, uint32_t src_width, uint32_t src_height, dvi_cmdlists_t *lists);
+
+// Check the command lists generate the timing for the mode. Returns true if
+// all is well; otherwise, if err is not NULL, describes the first problem
+// found.
+bool dvi_check_cmdlists(const dvi_timing_t *t, const dvi_cmdlists_t *lists, char *err, size_t err_size);
+
+#endif
@@ -0,0 +1,164 @@
+// Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/structs/hstx_fifo.h"
+
+#include "hstx_lcd_dma.h"
+
+// CSn high, CASET and 4 bytes, RASET and 4 bytes, RAMWR
+#define HEADER_RECORDS 12
+
+// Each update is sent as segments of as many whole lines as fit in a buffer,
+// the first with the window setting commands in front, then a last segment
+// to raise CSn. Even segments are sent by channel 0 from buf[0], and odd by
+// channel 1 from buf[1].
+//
+// A segment has to take longer to send than the interrupt takes to prepare
+// the one after next, or the chain runs into a segment which isn't ready.
+// One line of a narrow rectangle (2 bytes, for w = 1) wouldn't, so lines are
+// packed together, making every segment at least HSTX_LCD_DMA_MAX_WIDTH
+// bytes, unless it is the last.
+static uint32_t bufs[2][HEADER_RECORDS + 2 * HSTX_LCD_DMA_MAX_WIDTH];
+static uint32_t trailer;
+
+static uint chans[2];
+// Control register values to chain to the other channel, or to stop
+static uint32_t ctrl_chain[2];
+static uint32_t ctrl_last[2];
+
+// The update in progress
+static const uint16_t *src;
+static uint src_stride;
+static uint win_x, win_y, win_w, win_h;
+static uint seg_lines, seg_count;
+static hstx_lcd_dma_callback_t done_callback;
+static void *done_arg;
+static uint segments_done;
+static volatile bool busy;
+
+static volatile uint32_t updates;
+static volatile uint32_t pixels;
+static volatile uint32_t irq_us;
+
+static uint32_t *put_cmd4(uint32_t *out, uint8_t cmd, uint start, uint end) {
+    *out++ = hstx_lcd_record(false, false, cmd);
+    *out++ = hstx_lcd_record(true, false, start >> 8);
+    *out++ = hstx_lcd_record(true, false, start & 0xff);
+    *out++ = hstx_lcd_record(true, false, end >> 8);
+    *out++ = hstx_lcd_record(true, false, end & 0xff);
+    return out;
+}
+
+// Fill the buffer for a segment, and point its channel at it
+static void __not_in_flash_func(prepare_segment)(uint seg) {
+    uint i = seg & 1;
+    dma_channel_hw_t *ch = &dma_hw->ch[chans[i]];
+    if (seg == seg_count) {
+        ch->read_addr = (uintptr_t)&trailer;
+        ch->transfer_count = 1;
+        ch->al1_ctrl = ctrl_last[i];
+        return;
+    }
+    uint32_t *out = bufs[i];
+    if (seg == 0) {
+        *out++ = hstx_lcd_record(false, true, 0);
+        out = put_cmd4(out, 0x2a, win_x, win_x + win_w - 1); // CASET
+        out = put_cmd4(out, 0x2b, win_y, win_y + win_h - 1); // RASET
+        *out++ = hstx_lcd_record(false, false, 0x2c);        // RAMWR
+    }
+    // With CSn low and DC high, a record is just the byte
+    uint line = seg * seg_lines;
+    uint end = MIN(line + seg_lines, win_h);
+    for (; line < end; ++line) {
+        const uint16_t *p = src + line * src_stride;
+        for (uint x = 0; x < win_w; ++x) {
+            *out++ = p[x] >> 8;
+            *out++ = p[x] & 0xff;
+        }
+    }
+    ch->read_addr = (uintptr_t)bufs[i];
+    ch->transfer_count = out - bufs[i];
+    ch->al1_ctrl = ctrl_chain[i];
+}
+
+static void __isr __not_in_flash_func(hstx_lcd_dma_handler)(void) {
+    uint32_t start = time_us_32();
+    // Segments finish in order, alternating between the channels
+    uint32_t mask;
+    while (busy && (dma_hw->ints0 & (mask = 1u << chans[segments_done & 1]))) {
+        dma_hw->ints0 = mask;
+        uint seg = segments_done++;
+        if (seg == seg_count) {
+            updates++;
+            pixels += win_w * win_h;
+            busy = false;
+            if (done_callback) {
+                done_callback(done_arg);
+            }
+        } else if (seg + 2 <= seg_count) {
+            // The other channel is sending segment seg + 1; this one is free
+            // for seg + 2
+            prepare_segment(seg + 2);
+        }
+    }
+    irq_us += time_us_32() - start;
+}
+
+void hstx_lcd_dma_init(void) {
+    trailer = hstx_lcd_record(false, true, 0);
+    for (uint i = 0; i < 2; ++i) {
+        chans[i] = dma_claim_unused_channel(true);
+    }
+    for (uint i = 0; i < 2; ++i) {
+        dma_channel_config c = dma_channel_get_default_config(chans[i]);
+        channel_config_set_dreq(&c, DREQ_HSTX);
+        channel_config_set_chain_to(&c, chans[i]);
+        ctrl_last[i] = channel_config_get_ctrl_value(&c);
+        channel_config_set_chain_to(&c, chans[i ^ 1]);
+        ctrl_chain[i] = channel_config_get_ctrl_value(&c);
+        dma_channel_configure(chans[i], &c, &hstx_fifo_hw->fifo, NULL, 0, false);
+        dma_channel_set_irq0_enabled(chans[i], true);
+    }
+    irq_set_exclusive_handler(DMA_IRQ_0, hstx_lcd_dma_handler);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+void hstx_lcd_dma_update(const uint16_t *fb, uint fb_width, uint x, uint y, uint w, uint h,
+                         hstx_lcd_dma_callback_t callback, void *arg) {
+    hard_assert(w > 0 && h > 0 && w <= HSTX_LCD_DMA_MAX_WIDTH);
+    hstx_lcd_dma_wait();
+    src = fb + y * fb_width + x;
+    src_stride = fb_width;
+    win_x = x;
+    win_y = y;
+    win_w = w;
+    win_h = h;
+    seg_lines = HSTX_LCD_DMA_MAX_WIDTH / w;
+    seg_count = (h + seg_lines - 1) / seg_lines;
+    done_callback = callback;
+    done_arg = arg;
+    segments_done = 0;
+    busy = true;
+    // The second segment is the one which raises CSn, if all the lines fit
+    // in the first
+    prepare_segment(0);
+    prepare_segment(1);
+    dma_start_channel_mask(1u << chans[0]);
+}
+
+bool hstx_lcd_dma_busy(void) {
+    return busy;
+}
+
+void hstx_lcd_dma_wait(void) {
+    while (busy) {
+        tight_loop_contents();
+    }
+}
+
+void hstx_lcd_dma_get_stats(hstx_lcd_dma_stats_t *stats) {
+    stats->updates = updates;
+    stats->pixels = pixels;
+    stats->irq_us = irq_us;
+}
@@ -0,0 +1,59 @@
+// Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+
+// Non-blocking updates of a rectangle of a ST7789 LCD driven by the HSTX.
+//
+// Each 32-bit HSTX record carries one byte, along with the CSn and DC levels
+// to send with it (see hstx_spi_lcd.c), so RGB565 pixels can't be sent to the
+// HSTX FIFO just as they are. Instead, two DMA channels take turns to send
+// lines of records, chained to each other so there is no gap between them,
+// and the DMA interrupt turns the next lines of the framebuffer into records
+// while the current ones are sent. That's two stores per pixel for the
+// processor, rather than waiting on the FIFO for every byte.
+//
+// An update sets the window (CASET/RASET) to the rectangle, sends RAMWR and
+// the pixels, then raises CSn, all from the DMA.
+
+#ifndef _HSTX_LCD_DMA_H
+#define _HSTX_LCD_DMA_H
+
+#include "pico/stdlib.h"
+
+// Widest rectangle which can be sent
+#define HSTX_LCD_DMA_MAX_WIDTH 240
+
+// One byte for the HSTX, with the CSn and DC levels to send it with
+static inline uint32_t hstx_lcd_record(bool dc, bool csn, uint8_t data) {
+    return (uint32_t)data |
+        (csn ? 0x0ff00000u : 0x00000000u) |
+        // Note DC gets inverted inside of HSTX:
+        (dc  ? 0x00000000u : 0x0003fc00u);
+}
+
+typedef void (*hstx_lcd_dma_callback_t)(void *arg);
+
+typedef struct hstx_lcd_dma_stats {
+    uint32_t updates;
+    uint32_t pixels;
+    // time spent in the DMA interrupt, preparing lines
+    uint32_t irq_us;
+} hstx_lcd_dma_stats_t;
+
+// Claim two DMA channels, and install the handler for DMA_IRQ_0. The HSTX
+// must already be set up, and the LCD initialised.
+void hstx_lcd_dma_init(void);
+
+// Start sending the w x h rectangle at (x, y) of a framebuffer fb_width
+// pixels wide to the same place on the LCD, and return. If an update is
+// already in progress, this waits for it to finish first. The rectangle of
+// the framebuffer mustn't be changed until the update has finished, which is
+// when callback (if not NULL) is called, from the DMA interrupt.
+void hstx_lcd_dma_update(const uint16_t *fb, uint fb_width, uint x, uint y, uint w, uint h,
+                         hstx_lcd_dma_callback_t callback, void *arg);
+
+bool hstx_lcd_dma_busy(void);
+
+void hstx_lcd_dma_wait(void);
+
+void hstx_lcd_dma_get_stats(hstx_lcd_dma_stats_t *stats);
+
+#endif
@@ -2,6 +2,11 @@
 
 // Drive a ST7789 SPI LCD using the HSTX. The SPI clock rate is fully
 // independent of (and can be faster than) the system clock.
+//
+// The LCD is set up by writing records to the HSTX FIFO from the processor,
+// then the pixels are sent from a framebuffer by DMA (see hstx_lcd_dma.h),
+// first redrawing the whole screen, then updating just the small rectangle
+// around a moving square. The frame rate of each is printed.
 
 // You'll need an LCD module for this example. It was tested with: WaveShare
 // 1.3 inch ST7789 module. Wire up the signals as per PIN_xxx defines below,
@@ -24,6 +29,8 @@
 #include "hardware/structs/hstx_ctrl.h"
 #include "hardware/structs/hstx_fifo.h"
 
+#include "hstx_lcd_dma.h"
+
 // These can be any permutation of HSTX-capable pins:
 #define PIN_DIN   12
 #define PIN_SCK   13
@@ -51,12 +58,7 @@ static inline void hstx_put_word(uint32_t data) {
 }
 
 static inline void lcd_put_dc_cs_data(bool dc, bool csn, uint8_t data) {
-	hstx_put_word(
-		(uint32_t)data |
-		(csn ? 0x0ff00000u : 0x00000000u) |
-		// Note DC gets inverted inside of HSTX:
-		(dc  ? 0x00000000u : 0x0003fc00u)
-	);
+	hstx_put_word(hstx_lcd_record(dc, csn, data));
 }
 
 static inline void lcd_start_cmd(uint8_t cmd) {
@@ -105,9 +107,108 @@ static inline void lcd_init(const uint8_t *init_seq) {
     }
 }
 
-static inline void lcd_start_pixels(void) {
-    uint8_t cmd = 0x2c; // RAMWR
-    lcd_write_cmd(&cmd, 1);
+// How long to run each part of the demo for
+#define PHASE_US 3000000
+
+#define SQUARE_SIZE 32
+
+static uint16_t framebuffers[2][SCREEN_HEIGHT][SCREEN_WIDTH];
+
+static inline uint16_t pattern(uint x, uint y, uint t) {
+    uint r = (x + t) & 0x1f;
+    uint b = (y - t) & 0x1f;
+    uint g = (x + y + (t >> 1)) & 0x3f;
+    return (r << 11) + (g << 5) + b;
+}
+
+static void draw_pattern(uint16_t (*fb)[SCREEN_WIDTH], uint x0, uint y0, uint w, uint h, uint t) {
+    for (uint y = y0; y < y0 + h; ++y) {
+        for (uint x = x0; x < x0 + w; ++x) {
+            fb[y][x] = pattern(x, y, t);
+        }
+    }
+}
+
+static void fill_rect(uint16_t (*fb)[SCREEN_WIDTH], uint x0, uint y0, uint w, uint h, uint16_t colour) {
+    for (uint y = y0; y < y0 + h; ++y) {
+        for (uint x = x0; x < x0 + w; ++x) {
+            fb[y][x] = colour;
+        }
+    }
+}
+
+static volatile uint32_t updates_done;
+
+// Called from the DMA interrupt
+static void update_done(void *arg) {
+    (void)arg;
+    updates_done++;
+}
+
+static void print_result(const char *name, uint32_t start_us, const hstx_lcd_dma_stats_t *start_stats) {
+    uint32_t elapsed_us = time_us_32() - start_us;
+    hstx_lcd_dma_stats_t stats;
+    hstx_lcd_dma_get_stats(&stats);
+    uint32_t updates = stats.updates - start_stats->updates;
+    uint32_t pixels = stats.pixels - start_stats->pixels;
+    printf("%s: %.1f updates/s, %u pixels each, %.1f%% of the time in the DMA IRQ\n", name,
+           updates * 1e6f / elapsed_us, (unsigned)(updates ? pixels / updates : 0),
+           (stats.irq_us - start_stats->irq_us) * 100.0f / elapsed_us);
+}
+
+// Redraw the whole screen every frame, drawing the next frame in one
+// framebuffer while the other is sent
+static void full_screen_updates(void) {
+    hstx_lcd_dma_stats_t start_stats;
+    hstx_lcd_dma_get_stats(&start_stats);
+    uint32_t start_us = time_us_32();
+    uint t = 0;
+    while (time_us_32() - start_us < PHASE_US) {
+        uint16_t (*fb)[SCREEN_WIDTH] = framebuffers[t & 1];
+        draw_pattern(fb, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, t);
+        // Waits for the last update, which sent the other framebuffer
+        hstx_lcd_dma_update(&fb[0][0], SCREEN_WIDTH, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, update_done, NULL);
+        ++t;
+    }
+    hstx_lcd_dma_wait();
+    print_result("Full screen", start_us, &start_stats);
+}
+
+// Bounce a square around over a still background, sending only the
+// rectangle covering where it was and where it is now
+static void dirty_rect_updates(void) {
+    uint16_t (*fb)[SCREEN_WIDTH] = framebuffers[0];
+    draw_pattern(fb, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 0);
+    hstx_lcd_dma_update(&fb[0][0], SCREEN_WIDTH, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, NULL, NULL);
+    hstx_lcd_dma_wait();
+
+    hstx_lcd_dma_stats_t start_stats;
+    hstx_lcd_dma_get_stats(&start_stats);
+    uint32_t start_us = time_us_32();
+    int x = 0, y = 0, dx = 2, dy = 3;
+    uint n = 0;
+    while (time_us_32() - start_us < PHASE_US) {
+        int new_x = x + dx, new_y = y + dy;
+        if (new_x < 0 || new_x > SCREEN_WIDTH - SQUARE_SIZE) {
+            dx = -dx;
+            new_x = x + dx;
+        }
+        if (new_y < 0 || new_y > SCREEN_HEIGHT - SQUARE_SIZE) {
+            dy = -dy;
+            new_y = y + dy;
+        }
+        // The framebuffer mustn't change under an update in progress
+        hstx_lcd_dma_wait();
+        draw_pattern(fb, x, y, SQUARE_SIZE, SQUARE_SIZE, 0);
+        fill_rect(fb, new_x, new_y, SQUARE_SIZE, SQUARE_SIZE, n++ & 0x40 ? 0xffff : 0xf800);
+        uint x0 = MIN(x, new_x), y0 = MIN(y, new_y);
+        uint x1 = MAX(x, new_x) + SQUARE_SIZE, y1 = MAX(y, new_y) + SQUARE_SIZE;
+        hstx_lcd_dma_update(&fb[0][0], SCREEN_WIDTH, x0, y0, x1 - x0, y1 - y0, update_done, NULL);
+        x = new_x;
+        y = new_y;
+    }
+    hstx_lcd_dma_wait();
+    print_result("Dirty rectangle", start_us, &start_stats);
 }
 
 int main() {
@@ -162,19 +263,11 @@ int main() {
 
     lcd_init(st7789_init_seq);
 
-    uint t = 0;
+    hstx_lcd_dma_init();
+
     while (true) {
-        lcd_start_pixels();
-        for (uint y = 0; y < SCREEN_HEIGHT; ++y) {
-            for (uint x = 0; x < SCREEN_WIDTH; ++x) {
-                uint r = (x + t) & 0x1f;
-                uint b = (y - t) & 0x1f;
-                uint g = (x + y + (t >> 1)) & 0x3f;
-                uint rgb = (r << 11) + (g << 5) + b;
-                lcd_put_data(rgb >> 8);
-                lcd_put_data(rgb & 0xff);
-            }
-        }
-        ++t;
+        full_screen_updates();
+        dirty_rect_updates();
+        printf("%u updates sent\n", (unsigned)updates_done);
     }
 }
@@ -0,0 +1,156 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "ssd1306_fb.h"
+
+#define SSD1306_SET_COL_ADDR        0x21
+#define SSD1306_SET_PAGE_ADDR       0x22
+
+// Control bytes: Co = 0, then D/C = 0 for a stream of commands, or 1 for data
+#define CONTROL_CMDS                0x00
+#define CONTROL_DATA                0x40
+
+// Bytes on the bus for each window, besides its data: the address and control
+// byte of both transactions, and 6 command bytes
+#define WINDOW_OVERHEAD             10
+
+static void mark_dirty(ssd1306_fb_t *fb, uint32_t page, uint32_t start_col, uint32_t end_col) {
+    if (fb->dirty_start[page] > fb->dirty_end[page]) {
+        fb->dirty_start[page] = (uint8_t)start_col;
+        fb->dirty_end[page] = (uint8_t)end_col;
+    } else {
+        if (start_col < fb->dirty_start[page]) {
+            fb->dirty_start[page] = (uint8_t)start_col;
+        }
+        if (end_col > fb->dirty_end[page]) {
+            fb->dirty_end[page] = (uint8_t)end_col;
+        }
+    }
+}
+
+static void mark_clean(ssd1306_fb_t *fb) {
+    for (uint32_t i = 0; i < fb->pages; ++i) {
+        fb->dirty_start[i] = 0xff;
+        fb->dirty_end[i] = 0;
+    }
+}
+
+void ssd1306_fb_init(ssd1306_fb_t *fb, uint8_t *buf, uint8_t width, uint8_t pages) {
+    assert(pages <= SSD1306_FB_MAX_PAGES);
+    memset(fb, 0, sizeof(*fb));
+    fb->buf = buf;
+    fb->width = width;
+    fb->pages = pages;
+    memset(buf, 0, (size_t)width * pages);
+    ssd1306_fb_mark_all_dirty(fb);
+}
+
+void ssd1306_fb_mark_all_dirty(ssd1306_fb_t *fb) {
+    for (uint32_t i = 0; i < fb->pages; ++i) {
+        fb->dirty_start[i] = 0;
+        fb->dirty_end[i] = fb->width - 1;
+    }
+}
+
+void ssd1306_fb_set_pixel(ssd1306_fb_t *fb, int x, int y, bool on) {
+    assert(x >= 0 && x < fb->width && y >= 0 && y < fb->pages * 8);
+    uint8_t *byte = &fb->buf[(y / 8) * fb->width + x];
+    uint8_t value = on ? *byte | 1u << (y % 8) : *byte & ~(1u << (y % 8));
+    if (value != *byte) {
+        *byte = value;
+        mark_dirty(fb, y / 8, x, x);
+    }
+}
+
+void ssd1306_fb_write(ssd1306_fb_t *fb, int col, int page, const uint8_t *data, size_t len) {
+    if (page < 0 || page >= fb->pages || col >= fb->width) {
+        return;
+    }
+    uint8_t *row = &fb->buf[page * fb->width];
+    for (size_t i = 0; i < len && col + (int)i < fb->width; ++i) {
+        int x = col + (int)i;
+        if (x >= 0 && row[x] != data[i]) {
+            row[x] = data[i];
+            mark_dirty(fb, page, x, x);
+        }
+    }
+}
+
+static inline uint32_t window_cost(uint32_t start_col, uint32_t end_col, uint32_t start_page, uint32_t end_page) {
+    return WINDOW_OVERHEAD + (end_col - start_col + 1) * (end_page - start_page + 1);
+}
+
+uint32_t ssd1306_fb_plan(const ssd1306_fb_t *fb, ssd1306_window_t *windows) {
+    uint32_t n = 0;
+    ssd1306_window_t *w = NULL;
+    for (uint32_t page = 0; page < fb->pages; ++page) {
+        uint32_t start = fb->dirty_start[page], end = fb->dirty_end[page];
+        if (start > end) {
+            continue;
+        }
+        if (w) {
+            // Join this page to the window above, along with any clean pages
+            // between them, if that's no more bytes than a window of its own
+            uint32_t joined_start = start < w->start_col ? start : w->start_col;
+            uint32_t joined_end = end > w->end_col ? end : w->end_col;
+            if (window_cost(joined_start, joined_end, w->start_page, page) <=
+                window_cost(w->start_col, w->end_col, w->start_page, w->end_page) +
+                window_cost(start, end, page, page)) {
+                w->start_col = (uint8_t)joined_start;
+                w->end_col = (uint8_t)joined_end;
+                w->end_page = (uint8_t)page;
+                continue;
+            }
+        }
+        w = &windows[n++];
+        *w = (ssd1306_window_t) {
+            .start_col = (uint8_t)start,
+            .end_col = (uint8_t)end,
+            .start_page = (uint8_t)page,
+            .end_page = (uint8_t)page,
+        };
+    }
+    return n;
+}
+
+size_t ssd1306_fb_build_flush(ssd1306_fb_t *fb, uint16_t *words) {
+    ssd1306_window_t windows[SSD1306_FB_MAX_PAGES];
+    uint32_t n = ssd1306_fb_plan(fb, windows);
+    uint16_t *out = words;
+    for (uint32_t i = 0; i < n; ++i) {
+        const ssd1306_window_t *w = &windows[i];
+        *out++ = CONTROL_CMDS;
+        *out++ = SSD1306_SET_COL_ADDR;
+        *out++ = w->start_col;
+        *out++ = w->end_col;
+        *out++ = SSD1306_SET_PAGE_ADDR;
+        *out++ = w->start_page;
+        *out++ = w->end_page | SSD1306_FB_DATA_CMD_STOP;
+
+        // The column address wraps back to start_col at the end of each page
+        *out++ = CONTROL_DATA;
+        for (uint32_t page = w->start_page; page <= w->end_page; ++page) {
+            const uint8_t *row = &fb->buf[page * fb->width];
+            for (uint32_t col = w->start_col; col <= w->end_col; ++col) {
+                *out++ = row[col];
+            }
+        }
+        out[-1] |= SSD1306_FB_DATA_CMD_STOP;
+    }
+    mark_clean(fb);
+
+    size_t count = (size_t)(out - words);
+    if (count) {
+        fb->flushes++;
+        fb->windows += n;
+        // An address byte for each of the two transactions per window
+        fb->bus_bytes += (uint32_t)count + 2 * n;
+    }
+    return count;
+}
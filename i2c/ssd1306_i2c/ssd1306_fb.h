@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _SSD1306_FB_H
+#define _SSD1306_FB_H
+
+// A framebuffer for the SSD1306 which keeps track of what has changed since it
+// was last sent to the display, so only that needs to be sent again.
+//
+// The framebuffer is laid out as the display RAM is in horizontal addressing
+// mode: page after page, each a byte per column holding 8 rows. For each page
+// we keep the range of columns which have changed. ssd1306_fb_build_flush()
+// turns those into as few SET_COL_ADDR/SET_PAGE_ADDR windows as it can,
+// joining the windows of nearby pages when that puts fewer bytes on the bus
+// than sending them separately, and writes out the I2C transactions to send
+// each window: one of commands setting the window, then one of data.
+//
+// Transactions are written as 16 bit values for the I2C DATA_CMD register,
+// with the STOP bit set on the last byte of each, so all of them can be sent
+// by one DMA transfer. Building them doesn't touch the I2C block, which
+// ssd1306_flush_sim.c relies on to check them on the host.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SSD1306_FB_MAX_PAGES 8
+
+// Bit 9 of the I2C DATA_CMD register: send a STOP after this byte
+#define SSD1306_FB_DATA_CMD_STOP 0x200u
+
+// Most values ssd1306_fb_build_flush() can write for a display this size: one
+// window per page, each with 7 command bytes and a control byte ahead of the
+// data
+#define SSD1306_FB_FLUSH_MAX_WORDS(width, pages) ((pages) * ((width) + 8))
+
+typedef struct ssd1306_fb {
+    // pages * width bytes
+    uint8_t *buf;
+    uint8_t width;
+    uint8_t pages;
+    // Changed columns of each page, dirty_start to dirty_end inclusive, none
+    // if dirty_start > dirty_end
+    uint8_t dirty_start[SSD1306_FB_MAX_PAGES];
+    uint8_t dirty_end[SSD1306_FB_MAX_PAGES];
+
+    // Totals over all flushes
+    uint32_t flushes;
+    uint32_t windows;
+    // Including the address byte of each transaction
+    uint32_t bus_bytes;
+} ssd1306_fb_t;
+
+typedef struct ssd1306_window {
+    uint8_t start_col;
+    uint8_t end_col;
+    uint8_t start_page;
+    uint8_t end_page;
+} ssd1306_window_t;
+
+// Clear the framebuffer, and mark all of it as changed, as we don't know
+// what's in the display RAM yet
+void ssd1306_fb_init(ssd1306_fb_t *fb, uint8_t *buf, uint8_t width, uint8_t pages);
+
+// Mark the whole framebuffer as changed, e.g. when the display RAM has been
+// written some other way
+void ssd1306_fb_mark_all_dirty(ssd1306_fb_t *fb);
+
+void ssd1306_fb_set_pixel(ssd1306_fb_t *fb, int x, int y, bool on);
+
+// Write len bytes to page `page`, from column `col`, clipped to the width
+void ssd1306_fb_write(ssd1306_fb_t *fb, int col, int page, const uint8_t *data, size_t len);
+
+static inline bool ssd1306_fb_is_dirty(const ssd1306_fb_t *fb) {
+    for (uint32_t i = 0; i < fb->pages; ++i) {
+        if (fb->dirty_start[i] <= fb->dirty_end[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Work out the windows to send, at most one per page, and return how many
+uint32_t ssd1306_fb_plan(const ssd1306_fb_t *fb, ssd1306_window_t *windows);
+
+// Write the transactions to send everything which has changed to `words`,
+// which must have room for SSD1306_FB_FLUSH_MAX_WORDS(width, pages), and mark
+// the framebuffer as sent. Returns the number of words written, 0 if nothing
+// has changed. The data is copied, so the framebuffer can be drawn on again
+// straight away.
+size_t ssd1306_fb_build_flush(ssd1306_fb_t *fb, uint16_t *words);
+
+#endif
@@ -0,0 +1,249 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Check the dirty tracking in ssd1306_fb.c against a model of the display
+//
+// Each test draws into a framebuffer, a frame at a time, and flushes it after
+// every frame. The I2C transactions written by each flush are split up at the
+// STOP bits and played into a model of the SSD1306, which runs the window
+// commands and writes the data to its RAM in horizontal addressing mode, as
+// the display would. After every frame the model's RAM must match the
+// framebuffer. The bytes put on the bus per frame are printed, along with
+// what redrawing the whole display every frame, as ssd1306_i2c.c used to,
+// would have taken.
+//
+// The flush only writes the transactions out, leaving the sending to the
+// caller, so the model can run in CI on the host too:
+//
+//   cc -DPICO_NO_HARDWARE=1 ssd1306_flush_sim.c ssd1306_fb.c
+//
+// where a frame the display would get wrong gives a non-zero exit status.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#define count_of(a) (sizeof(a)/sizeof((a)[0]))
+#endif
+
+#include "ssd1306_fb.h"
+
+#define WIDTH 128
+#define PAGES 8
+
+// 6 commands sent one at a time (address, control and command byte each),
+// then the address, control byte and whole framebuffer
+#define FULL_REDRAW_BUS_BYTES (6 * 3 + 2 + WIDTH * PAGES)
+
+static uint8_t fb_buf[WIDTH * PAGES];
+static uint16_t words[SSD1306_FB_FLUSH_MAX_WORDS(WIDTH, PAGES)];
+
+static uint32_t failures;
+
+typedef struct display_model {
+    uint8_t ram[PAGES][WIDTH];
+    uint8_t start_col, end_col, start_page, end_page;
+    uint8_t col, page;
+    uint32_t transactions;
+    uint32_t bus_bytes;
+} display_model_t;
+
+static display_model_t display;
+
+static void fail(const char *what) {
+    printf("  FAILED: %s\n", what);
+    failures++;
+}
+
+static void model_commands(display_model_t *d, const uint8_t *bytes, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        uint8_t cmd = bytes[i++];
+        if ((cmd == 0x21 || cmd == 0x22) && i + 2 <= len) {
+            uint8_t start = bytes[i++], end = bytes[i++];
+            if (cmd == 0x21) {
+                d->start_col = d->col = start;
+                d->end_col = end;
+            } else {
+                d->start_page = d->page = start;
+                d->end_page = end;
+            }
+        } else {
+            fail("unexpected command");
+            return;
+        }
+    }
+}
+
+static void model_data(display_model_t *d, const uint8_t *bytes, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        if (d->page >= PAGES || d->col >= WIDTH) {
+            fail("write outside the display");
+            return;
+        }
+        d->ram[d->page][d->col] = bytes[i];
+        if (d->col++ == d->end_col) {
+            d->col = d->start_col;
+            d->page = d->page == d->end_page ? d->start_page : d->page + 1;
+        }
+    }
+}
+
+// Split the values for DATA_CMD into transactions, and run each one
+static void model_play(display_model_t *d, const uint16_t *w, size_t count) {
+    static uint8_t bytes[SSD1306_FB_FLUSH_MAX_WORDS(WIDTH, PAGES)];
+    size_t len = 0;
+    for (size_t i = 0; i < count; ++i) {
+        bytes[len++] = (uint8_t)w[i];
+        if (w[i] & SSD1306_FB_DATA_CMD_STOP) {
+            d->transactions++;
+            d->bus_bytes += 1 + len;
+            if (bytes[0] == 0x00) {
+                model_commands(d, bytes + 1, len - 1);
+            } else if (bytes[0] == 0x40) {
+                model_data(d, bytes + 1, len - 1);
+            } else {
+                fail("unexpected control byte");
+            }
+            len = 0;
+        }
+    }
+    if (len) {
+        fail("transaction without a STOP");
+    }
+}
+
+typedef struct test {
+    const char *name;
+    uint32_t frames;
+    void (*draw)(ssd1306_fb_t *fb, uint32_t frame);
+} test_t;
+
+// As the end of ssd1306_i2c.c: sweep a line across the display, one step a frame
+static void draw_line_sweep(ssd1306_fb_t *fb, uint32_t frame) {
+    int x0 = (int)frame % WIDTH, x1 = WIDTH - 1 - x0;
+    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -(PAGES * 8 - 1), sy = 1;
+    int err = dx + dy;
+    int y0 = 0;
+    while (true) {
+        ssd1306_fb_set_pixel(fb, x0, y0, true);
+        if (x0 == x1 && y0 == PAGES * 8 - 1) {
+            break;
+        }
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+// A 16x16 square moving diagonally, across page boundaries
+static void draw_moving_box(ssd1306_fb_t *fb, uint32_t frame) {
+    static int last = -1;
+    for (int pass = 0; pass < 2; ++pass) {
+        int p = pass ? (int)frame * 3 % (PAGES * 8 - 16) : last;
+        if (p < 0) {
+            continue;
+        }
+        for (int y = p; y < p + 16; ++y) {
+            for (int x = p * 2; x < p * 2 + 16; ++x) {
+                ssd1306_fb_set_pixel(fb, x, y, pass);
+            }
+        }
+    }
+    last = (int)frame * 3 % (PAGES * 8 - 16);
+}
+
+// A counter in one corner, like a clock, with digits as 8x8 blocks
+static void draw_counter(ssd1306_fb_t *fb, uint32_t frame) {
+    for (uint32_t i = 0; i < 4; ++i) {
+        uint32_t digit = (frame >> (4 * i)) & 0xf;
+        uint8_t glyph[8];
+        for (uint32_t j = 0; j < 8; ++j) {
+            glyph[j] = (uint8_t)(digit * 17 + j);
+        }
+        ssd1306_fb_write(fb, WIDTH - 8 * (int)(i + 1), 0, glyph, sizeof(glyph));
+    }
+}
+
+// Single pixels scattered over the whole display, the worst case for windows
+static void draw_scatter(ssd1306_fb_t *fb, uint32_t frame) {
+    static uint32_t state = 1;
+    for (uint32_t i = 0; i < 6; ++i) {
+        state = state * 1103515245u + 12345u;
+        ssd1306_fb_set_pixel(fb, (int)((state >> 8) % WIDTH), (int)((state >> 20) % (PAGES * 8)), frame & 1);
+    }
+}
+
+static void draw_nothing(ssd1306_fb_t *fb, uint32_t frame) {
+    (void)fb;
+    (void)frame;
+}
+
+static const test_t tests[] = {
+    {"line sweep", WIDTH, draw_line_sweep},
+    {"moving box", 40, draw_moving_box},
+    {"counter", 300, draw_counter},
+    {"scattered pixels", 100, draw_scatter},
+    {"no change", 10, draw_nothing},
+};
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+#endif
+    ssd1306_fb_t fb;
+    ssd1306_fb_init(&fb, fb_buf, WIDTH, PAGES);
+    // Fill the model with junk, which the first flush should replace
+    memset(display.ram, 0xa5, sizeof(display.ram));
+    model_play(&display, words, ssd1306_fb_build_flush(&fb, words));
+    if (memcmp(display.ram, fb_buf, sizeof(fb_buf))) {
+        fail("first flush didn't write the whole display");
+    }
+
+    printf("%ux%u display, a full redraw is %u bytes on the bus\n", WIDTH, PAGES * 8, FULL_REDRAW_BUS_BYTES);
+    for (size_t t = 0; t < count_of(tests); ++t) {
+        const test_t *test = &tests[t];
+        uint32_t start_bytes = fb.bus_bytes, start_windows = fb.windows;
+        uint32_t start_failures = failures;
+        for (uint32_t frame = 0; frame < test->frames; ++frame) {
+            test->draw(&fb, frame);
+            size_t count = ssd1306_fb_build_flush(&fb, words);
+            if (count > count_of(words)) {
+                fail("flush overran its buffer");
+            }
+            model_play(&display, words, count);
+            if (ssd1306_fb_is_dirty(&fb)) {
+                fail("still dirty after a flush");
+            }
+            if (memcmp(display.ram, fb_buf, sizeof(fb_buf))) {
+                printf("  frame %u: ", (unsigned)frame);
+                fail("display differs from the framebuffer");
+                break;
+            }
+        }
+        uint32_t bytes = fb.bus_bytes - start_bytes;
+        printf("%-16s %3u frames: %6.1f bytes per frame (%4.1f%% of a full redraw), %4.2f windows per frame %s\n",
+               test->name, (unsigned)test->frames, (double)bytes / test->frames,
+               100.0 * bytes / test->frames / FULL_REDRAW_BUS_BYTES, (double)(fb.windows - start_windows) / test->frames,
+               failures == start_failures ? "ok" : "FAILED");
+    }
+    if (display.bus_bytes != fb.bus_bytes) {
+        fail("bus byte count doesn't match the transactions sent");
+    }
+
+    printf("\n%s\n", failures ? "SSD1306 flush checks FAILED" : "All SSD1306 flush checks passed");
+    return failures ? 1 : 0;
+}
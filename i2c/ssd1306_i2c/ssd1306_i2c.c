@@ -11,8 +11,10 @@
 #include "pico/stdlib.h"
 #include "pico/binary_info.h"
 #include "hardware/i2c.h"
+#include "hardware/dma.h"
 #include "raspberry26x32.h"
 #include "ssd1306_font.h"
+#include "ssd1306_fb.h"
 
 /* Example code to talk to an SSD1306-based OLED display
 
@@ -33,6 +35,10 @@
    display board
    3.3v (pin 36) -> VCC on display board
    GND (pin 38)  -> GND on display board
+
+   Text and lines are drawn into a framebuffer which keeps track of what has
+   changed (see ssd1306_fb.h), and only that is sent to the display, by DMA,
+   so drawing can carry on while the last change is being sent.
 */
 
 // Define the size of the display we have attached. This can vary, make sure you
@@ -101,7 +107,49 @@ void calc_render_area_buflen(struct render_area *area) {
 
 #ifdef i2c_default
 
+static int flush_dma_chan = -1;
+static uint16_t flush_words[SSD1306_FB_FLUSH_MAX_WORDS(SSD1306_WIDTH, SSD1306_NUM_PAGES)];
+
+void SSD1306_flush_init() {
+    // Each value written to DATA_CMD is a byte to send, plus a STOP bit at
+    // the end of each transaction
+    flush_dma_chan = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(flush_dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_dreq(&c, i2c_get_dreq(i2c_default, true));
+    dma_channel_configure(flush_dma_chan, &c, &i2c_get_hw(i2c_default)->data_cmd, flush_words, 0, false);
+}
+
+void SSD1306_flush_wait() {
+    if (flush_dma_chan < 0)
+        return;
+    dma_channel_wait_for_finish_blocking(flush_dma_chan);
+    // then for the last bytes to leave the FIFO
+    i2c_hw_t *hw = i2c_get_hw(i2c_default);
+    while (!(hw->status & I2C_IC_STATUS_TFE_BITS) || (hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS))
+        tight_loop_contents();
+}
+
+void SSD1306_flush(ssd1306_fb_t *fb) {
+    // send whatever has changed in the framebuffer since the last flush, and
+    // return without waiting for it to be sent. The framebuffer can be
+    // drawn on straight away, as the changes are copied into flush_words.
+    SSD1306_flush_wait();
+    size_t count = ssd1306_fb_build_flush(fb, flush_words);
+    if (!count)
+        return;
+
+    i2c_hw_t *hw = i2c_get_hw(i2c_default);
+    hw->enable = 0;
+    hw->tar = SSD1306_I2C_ADDR;
+    hw->enable = 1;
+    dma_channel_transfer_from_buffer_now(flush_dma_chan, flush_words, count);
+}
+
 void SSD1306_send_cmd(uint8_t cmd) {
+    // don't get mixed up with a flush in progress
+    SSD1306_flush_wait();
+
     // I2C write process expects a control byte followed by data
     // this "data" can be a command or data to follow up a command
     // Co = 1, D/C = 0 => the driver expects a command
@@ -115,6 +163,8 @@ void SSD1306_send_cmd_list(uint8_t *buf, int num) {
 }
 
 void SSD1306_send_buf(uint8_t buf[], int buflen) {
+    SSD1306_flush_wait();
+
     // in horizontal addressing mode, the column address pointer auto-increments
     // and then wraps around to the next page, so we can send the entire frame
     // buffer in one gooooooo!
@@ -212,33 +262,17 @@ void render(uint8_t *buf, struct render_area *area) {
     SSD1306_send_buf(buf, area->buflen);
 }
 
-static void SetPixel(uint8_t *buf, int x,int y, bool on) {
+static void SetPixel(ssd1306_fb_t *fb, int x,int y, bool on) {
     assert(x >= 0 && x < SSD1306_WIDTH && y >=0 && y < SSD1306_HEIGHT);
 
-    // The calculation to determine the correct bit to set depends on which address
-    // mode we are in. This code assumes horizontal
-
     // The video ram on the SSD1306 is split up in to 8 rows, one bit per pixel.
     // Each row is 128 long by 8 pixels high, each byte vertically arranged, so byte 0 is x=0, y=0->7,
-    // byte 1 is x = 1, y=0->7 etc
-
-    // This code could be optimised, but is like this for clarity. The compiler
-    // should do a half decent job optimising it anyway.
-
-    const int BytesPerRow = SSD1306_WIDTH ; // x pixels, 1bpp, but each row is 8 pixel high, so (x / 8) * 8
-
-    int byte_idx = (y / 8) * BytesPerRow + x;
-    uint8_t byte = buf[byte_idx];
-
-    if (on)
-        byte |=  1 << (y % 8);
-    else
-        byte &= ~(1 << (y % 8));
-
-    buf[byte_idx] = byte;
+    // byte 1 is x = 1, y=0->7 etc. ssd1306_fb_set_pixel() also notes the column
+    // of the row as changed, if it was.
+    ssd1306_fb_set_pixel(fb, x, y, on);
 }
 // Basic Bresenhams.
-static void DrawLine(uint8_t *buf, int x0, int y0, int x1, int y1, bool on) {
+static void DrawLine(ssd1306_fb_t *fb, int x0, int y0, int x1, int y1, bool on) {
 
     int dx =  abs(x1-x0);
     int sx = x0<x1 ? 1 : -1;
@@ -248,7 +282,7 @@ static void DrawLine(uint8_t *buf, int x0, int y0, int x1, int y1, bool on) {
     int e2;
 
     while (true) {
-        SetPixel(buf, x0, y0, on);
+        SetPixel(fb, x0, y0, on);
         if (x0 == x1 && y0 == y1)
             break;
         e2 = 2*err;
@@ -274,7 +308,7 @@ static inline int GetFontIndex(uint8_t ch) {
     else return  0; // Not got that char so space.
 }
 
-static void WriteChar(uint8_t *buf, int16_t x, int16_t y, uint8_t ch) {
+static void WriteChar(ssd1306_fb_t *fb, int16_t x, int16_t y, uint8_t ch) {
     if (x > SSD1306_WIDTH - 8 || y > SSD1306_HEIGHT - 8)
         return;
 
@@ -283,20 +317,17 @@ static void WriteChar(uint8_t *buf, int16_t x, int16_t y, uint8_t ch) {
 
     ch = toupper(ch);
     int idx = GetFontIndex(ch);
-    int fb_idx = y * 128 + x;
 
-    for (int i=0;i<8;i++) {
-        buf[fb_idx++] = font[idx * 8 + i];
-    }
+    ssd1306_fb_write(fb, x, y, &font[idx * 8], 8);
 }
 
-static void WriteString(uint8_t *buf, int16_t x, int16_t y, char *str) {
+static void WriteString(ssd1306_fb_t *fb, int16_t x, int16_t y, char *str) {
     // Cull out any string off the screen
     if (x > SSD1306_WIDTH - 8 || y > SSD1306_HEIGHT - 8)
         return;
 
     while (*str) {
-        WriteChar(buf, x, y, *str++);
+        WriteChar(fb, x, y, *str++);
         x+=8;
     }
 }
@@ -328,21 +359,13 @@ int main() {
 
     // run through the complete initialization process
     SSD1306_init();
+    SSD1306_flush_init();
 
-    // Initialize render area for entire frame (SSD1306_WIDTH pixels by SSD1306_NUM_PAGES pages)
-    struct render_area frame_area = {
-        start_col: 0,
-        end_col : SSD1306_WIDTH - 1,
-        start_page : 0,
-        end_page : SSD1306_NUM_PAGES - 1
-        };
-
-    calc_render_area_buflen(&frame_area);
-
-    // zero the entire display
+    // zero the entire display: a new framebuffer is all marked as changed
     uint8_t buf[SSD1306_BUF_LEN];
-    memset(buf, 0, SSD1306_BUF_LEN);
-    render(buf, &frame_area);
+    ssd1306_fb_t fb;
+    ssd1306_fb_init(&fb, buf, SSD1306_WIDTH, SSD1306_NUM_PAGES);
+    SSD1306_flush(&fb);
 
     // intro sequence: flash the screen 3 times
     for (int i = 0; i < 3; i++) {
@@ -388,12 +411,16 @@ restart:
         "    PICO"
     };
 
+    // the raspberries and scrolling have changed the display RAM behind the
+    // framebuffer's back, so send all of it
+    ssd1306_fb_mark_all_dirty(&fb);
+
     int y = 0;
     for (uint i = 0 ;i < count_of(text); i++) {
-        WriteString(buf, 5, y, text[i]);
+        WriteString(&fb, 5, y, text[i]);
         y+=8;
     }
-    render(buf, &frame_area);
+    SSD1306_flush(&fb);
 
     // Test the display invert function
     sleep_ms(3000);
@@ -401,19 +428,28 @@ restart:
     sleep_ms(3000);
     SSD1306_send_cmd(SSD1306_SET_NORM_DISP);
 
+    // Only the pixels each line changes are sent. A whole frame would be the
+    // 6 window commands, sent one at a time, and the whole framebuffer.
+    uint32_t start_bytes = fb.bus_bytes, start_flushes = fb.flushes;
+    uint32_t full_frame_bytes = 6 * 3 + 2 + SSD1306_BUF_LEN;
     bool pix = true;
     for (int i = 0; i < 2;i++) {
         for (int x = 0;x < SSD1306_WIDTH;x++) {
-            DrawLine(buf, x, 0,  SSD1306_WIDTH - 1 - x, SSD1306_HEIGHT - 1, pix);
-            render(buf, &frame_area);
+            DrawLine(&fb, x, 0,  SSD1306_WIDTH - 1 - x, SSD1306_HEIGHT - 1, pix);
+            SSD1306_flush(&fb);
         }
 
         for (int y = SSD1306_HEIGHT-1; y >= 0 ;y--) {
-            DrawLine(buf, 0, y, SSD1306_WIDTH - 1, SSD1306_HEIGHT - 1 - y, pix);
-            render(buf, &frame_area);
+            DrawLine(&fb, 0, y, SSD1306_WIDTH - 1, SSD1306_HEIGHT - 1 - y, pix);
+            SSD1306_flush(&fb);
         }
         pix = false;
     }
+    uint32_t frames = fb.flushes - start_flushes;
+    if (frames) {
+        printf("Lines: %u bytes on the bus per frame, against %u for the whole frame\n",
+               (unsigned)((fb.bus_bytes - start_bytes) / frames), (unsigned)full_frame_bytes);
+    }
 
     goto restart;
 
@@ -0,0 +1,239 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdint.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#define __not_in_flash_func(func_name) func_name
+#endif
+
+#include "hardware/interp.h"
+
+#include "blit.h"
+
+// The interpolators give byte offsets rather than addresses (BASE2 is 0),
+// which costs nothing on the device, as loads take a register offset, and
+// keeps addresses out of 32 bit registers on a 64 bit host.
+
+// ----------------------------------------------------------------------------
+// Affine and perspective texture mapping
+
+// Lane 0 gives the offset of the element's column, and lane 1 of its row,
+// both scaled by the element size. ADD_RAW makes each POP add BASE0/1 to the
+// whole of ACCUM0/1, stepping u and v.
+void blit_affine_setup(interp_hw_t *interp, uint32_t frac_bits, uint32_t width_bits, uint32_t height_bits,
+                       uint32_t size_bits) {
+    interp_config cfg = interp_default_config();
+    interp_config_set_add_raw(&cfg, true);
+    interp_config_set_shift(&cfg, frac_bits - size_bits);
+    interp_config_set_mask(&cfg, size_bits, size_bits + width_bits - 1);
+    interp_set_config(interp, 0, &cfg);
+    interp_config_set_shift(&cfg, frac_bits - size_bits - width_bits);
+    interp_config_set_mask(&cfg, size_bits + width_bits, size_bits + width_bits + height_bits - 1);
+    interp_set_config(interp, 1, &cfg);
+    interp_set_base(interp, 2, 0);
+}
+
+static inline void affine_setup(const blit_texture_t *tex) {
+    blit_affine_setup(interp0, 16, tex->width_bits, tex->height_bits, 1);
+}
+
+static inline void affine_run(const uint16_t *pixels, uint16_t *out, uint32_t u, uint32_t v, int32_t du, int32_t dv,
+                              uint32_t count) {
+    blit_affine_start(interp0, u, v, du, dv);
+    const uint8_t *base = (const uint8_t *)pixels;
+    for (uint32_t i = 0; i < count; ++i) {
+        out[i] = *(const uint16_t *)(base + interp_pop_full_result(interp0));
+    }
+}
+
+static inline void affine_run_c(const blit_texture_t *tex, uint16_t *out, uint32_t u, uint32_t v, int32_t du,
+                                int32_t dv, uint32_t count) {
+    const uint32_t u_mask = (1u << tex->width_bits) - 1;
+    const uint32_t v_mask = (1u << tex->height_bits) - 1;
+    for (uint32_t i = 0; i < count; ++i) {
+        out[i] = tex->pixels[((v >> 16) & v_mask) << tex->width_bits | ((u >> 16) & u_mask)];
+        u += (uint32_t)du;
+        v += (uint32_t)dv;
+    }
+}
+
+void __not_in_flash_func(blit_affine_span)(const blit_texture_t *tex, uint16_t *out, uint32_t u, uint32_t v,
+                                           int32_t du, int32_t dv, uint32_t count) {
+    affine_setup(tex);
+    affine_run(tex->pixels, out, u, v, du, dv, count);
+}
+
+void blit_affine_span_c(const blit_texture_t *tex, uint16_t *out, uint32_t u, uint32_t v, int32_t du, int32_t dv,
+                        uint32_t count) {
+    affine_run_c(tex, out, u, v, du, dv, count);
+}
+
+// u and v in 16.16 at pixel i of the span
+static inline void perspective_point(const blit_perspective_t *p, uint32_t i, uint32_t *u, uint32_t *v) {
+    int64_t w = (int64_t)p->w + (int64_t)i * p->dw;
+    *u = (uint32_t)(((int64_t)p->uw + (int64_t)i * p->duw) * 65536 / w);
+    *v = (uint32_t)(((int64_t)p->vw + (int64_t)i * p->dvw) * 65536 / w);
+}
+
+// The steps across a run of n pixels from (u0, v0) to (u1, v1)
+static inline void perspective_steps(uint32_t u0, uint32_t v0, uint32_t u1, uint32_t v1, uint32_t n, int32_t *du,
+                                     int32_t *dv) {
+    *du = (int32_t)(u1 - u0) / (int32_t)n;
+    *dv = (int32_t)(v1 - v0) / (int32_t)n;
+}
+
+void __not_in_flash_func(blit_perspective_span)(const blit_texture_t *tex, uint16_t *out, const blit_perspective_t *p,
+                                                uint32_t count) {
+    affine_setup(tex);
+    uint32_t u0, v0, u1, v1;
+    perspective_point(p, 0, &u0, &v0);
+    for (uint32_t i = 0; i < count; i += BLIT_PERSPECTIVE_RUN) {
+        uint32_t n = count - i < BLIT_PERSPECTIVE_RUN ? count - i : BLIT_PERSPECTIVE_RUN;
+        int32_t du, dv;
+        perspective_point(p, i + n, &u1, &v1);
+        perspective_steps(u0, v0, u1, v1, n, &du, &dv);
+        affine_run(tex->pixels, out + i, u0, v0, du, dv, n);
+        u0 = u1;
+        v0 = v1;
+    }
+}
+
+void blit_perspective_span_c(const blit_texture_t *tex, uint16_t *out, const blit_perspective_t *p, uint32_t count) {
+    uint32_t u0, v0, u1, v1;
+    perspective_point(p, 0, &u0, &v0);
+    for (uint32_t i = 0; i < count; i += BLIT_PERSPECTIVE_RUN) {
+        uint32_t n = count - i < BLIT_PERSPECTIVE_RUN ? count - i : BLIT_PERSPECTIVE_RUN;
+        int32_t du, dv;
+        perspective_point(p, i + n, &u1, &v1);
+        perspective_steps(u0, v0, u1, v1, n, &du, &dv);
+        affine_run_c(tex, out + i, u0, v0, du, dv, n);
+        u0 = u1;
+        v0 = v1;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Alpha blend
+
+// Lane 1 holds alpha, and each channel is blended by writing bg and fg to
+// BASE0 and BASE1 together, then reading the blend from PEEK1. Lane 1 is
+// signed, which makes the blend a signed interpolation between BASE0 and
+// BASE1, rounding down as blend_channel() does: the datasheet doesn't say
+// what an unsigned blend gives when BASE1 < BASE0. The channels are at most
+// 6 bits, so their signed and unsigned values are the same.
+void __not_in_flash_func(blit_blend_span)(uint16_t *out, const uint16_t *fg, const uint16_t *bg, uint8_t alpha,
+                                          uint32_t count) {
+    interp_config cfg = interp_default_config();
+    interp_config_set_blend(&cfg, true);
+    interp_set_config(interp0, 0, &cfg);
+    cfg = interp_default_config();
+    interp_config_set_signed(&cfg, true);
+    interp_set_config(interp0, 1, &cfg);
+    interp_set_accumulator(interp0, 1, alpha);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t f = fg[i], b = bg[i];
+        interp_set_base_both(interp0, (f & 0xf800) << 5 | (b & 0xf800) >> 11);
+        uint32_t r = interp_peek_lane_result(interp0, 1);
+        interp_set_base_both(interp0, (f & 0x07e0) << 11 | (b & 0x07e0) >> 5);
+        uint32_t g = interp_peek_lane_result(interp0, 1);
+        interp_set_base_both(interp0, (f & 0x001f) << 16 | (b & 0x001f));
+        uint32_t bl = interp_peek_lane_result(interp0, 1);
+        out[i] = (uint16_t)(r << 11 | g << 5 | bl);
+    }
+}
+
+// Rounding down (>> of a negative value is an arithmetic shift with GCC and
+// Clang), as the interpolator does
+static inline uint32_t blend_channel(uint32_t f, uint32_t b, uint32_t alpha) {
+    return (uint32_t)((int32_t)b + ((((int32_t)f - (int32_t)b) * (int32_t)alpha) >> 8));
+}
+
+void blit_blend_span_c(uint16_t *out, const uint16_t *fg, const uint16_t *bg, uint8_t alpha, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t f = fg[i], b = bg[i];
+        uint32_t r = blend_channel(f >> 11, b >> 11, alpha);
+        uint32_t g = blend_channel((f >> 5) & 0x3f, (b >> 5) & 0x3f, alpha);
+        uint32_t bl = blend_channel(f & 0x1f, b & 0x1f, alpha);
+        out[i] = (uint16_t)(r << 11 | g << 5 | bl);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Clamp to palette
+
+// Lane 0 of interp1 shifts the value, sign extends it from its new top bit,
+// and clamps it between BASE0 and BASE1
+void __not_in_flash_func(blit_clamp_palette_span)(uint16_t *out, const int32_t *in, uint32_t shift,
+                                                  const uint16_t *palette, uint32_t n_colours, uint32_t count) {
+    interp_config cfg = interp_default_config();
+    interp_config_set_clamp(&cfg, true);
+    interp_config_set_shift(&cfg, shift);
+    interp_config_set_mask(&cfg, 0, 31 - shift);
+    interp_config_set_signed(&cfg, true);
+    interp_set_config(interp1, 0, &cfg);
+    interp_set_base(interp1, 0, 0);
+    interp_set_base(interp1, 1, n_colours - 1);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        interp_set_accumulator(interp1, 0, (uint32_t)in[i]);
+        out[i] = palette[interp_peek_lane_result(interp1, 0)];
+    }
+}
+
+void blit_clamp_palette_span_c(uint16_t *out, const int32_t *in, uint32_t shift, const uint16_t *palette,
+                               uint32_t n_colours, uint32_t count) {
+    const int32_t max = (int32_t)n_colours - 1;
+    for (uint32_t i = 0; i < count; ++i) {
+        int32_t index = in[i] >> shift;
+        out[i] = palette[index < 0 ? 0 : index > max ? max : index];
+    }
+}
+
+// ----------------------------------------------------------------------------
+// RGB565 expand
+
+#define EXPAND5(x) (uint8_t)((x) << 3 | (x) >> 2)
+#define EXPAND6(x) (uint8_t)((x) << 2 | (x) >> 4)
+#define REPEAT4(f, n) f(n), f(n + 1), f(n + 2), f(n + 3)
+#define REPEAT16(f, n) REPEAT4(f, n), REPEAT4(f, n + 4), REPEAT4(f, n + 8), REPEAT4(f, n + 12)
+
+static const uint8_t expand5[32] = {REPEAT16(EXPAND5, 0), REPEAT16(EXPAND5, 16)};
+static const uint8_t expand6[64] = {REPEAT16(EXPAND6, 0), REPEAT16(EXPAND6, 16), REPEAT16(EXPAND6, 32),
+                                    REPEAT16(EXPAND6, 48)};
+
+// One write of the pixel to ACCUM0 gives red from lane 0, and green from lane
+// 1 through its cross input
+void __not_in_flash_func(blit_expand_rgb565_span)(uint32_t *out, const uint16_t *in, uint32_t count) {
+    interp_config cfg = interp_default_config();
+    interp_config_set_shift(&cfg, 11);
+    interp_config_set_mask(&cfg, 0, 4);
+    interp_set_config(interp0, 0, &cfg);
+    interp_config_set_shift(&cfg, 5);
+    interp_config_set_mask(&cfg, 0, 5);
+    interp_config_set_cross_input(&cfg, true);
+    interp_set_config(interp0, 1, &cfg);
+    interp_set_base(interp0, 0, 0);
+    interp_set_base(interp0, 1, 0);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t c = in[i];
+        interp_set_accumulator(interp0, 0, c);
+        uint32_t r = expand5[interp_peek_lane_result(interp0, 0)];
+        uint32_t g = expand6[interp_peek_lane_result(interp0, 1)];
+        out[i] = r << 16 | g << 8 | expand5[c & 0x1f];
+    }
+}
+
+void blit_expand_rgb565_span_c(uint32_t *out, const uint16_t *in, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t c = in[i];
+        out[i] = (uint32_t)expand5[c >> 11] << 16 | (uint32_t)expand6[(c >> 5) & 0x3f] << 8 | expand5[c & 0x1f];
+    }
+}
@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _BLIT_H
+#define _BLIT_H
+
+// Span kernels for 2D graphics, using the interpolators.
+//
+// Each kernel works on a span of pixels, e.g. part of a line, and comes in two
+// versions: blit_xxx() using the interpolators of the calling core, and
+// blit_xxx_c() in plain C, one pixel at a time, which gives the same results
+// and is what blit_xxx() is checked and benchmarked against.
+//
+// blit_xxx() sets up the interpolators it uses each time it is called, so
+// kernels can be mixed freely, but the interpolators can't be used by
+// anything else on the same core (e.g. an interrupt handler) while a kernel is
+// running, unless it saves and restores them.
+//
+// When built with PICO_NO_HARDWARE (on the host), blit_xxx() runs on the
+// software model of the interpolators in interp/interp_model, so its results
+// can still be checked against blit_xxx_c().
+//
+// Pixels are RGB565, except where stated.
+
+#include <stdint.h>
+
+#include "hardware/interp.h"
+
+// Set up lanes 0 and 1 of interp so that each POP_FULL gives the byte offset
+// of element (u, v) of a (1 << width_bits) by (1 << height_bits) array of
+// (1 << size_bits) byte elements, wrapping at the edges, and steps u and v.
+// u and v have frac_bits fractional bits. BASE2 is 0, so add the offset to
+// the array's address. The affine kernels here, the scanline compositor and
+// the st7789_lcd example all use this.
+void blit_affine_setup(interp_hw_t *interp, uint32_t frac_bits, uint32_t width_bits, uint32_t height_bits,
+                       uint32_t size_bits);
+
+// Start at (u, v), stepping by (du, dv) on each POP
+static inline void blit_affine_start(interp_hw_t *interp, uint32_t u, uint32_t v, int32_t du, int32_t dv) {
+    interp_set_accumulator(interp, 0, u);
+    interp_set_base(interp, 0, (uint32_t)du);
+    interp_set_accumulator(interp, 1, v);
+    interp_set_base(interp, 1, (uint32_t)dv);
+}
+
+typedef struct blit_texture {
+    // (1 << width_bits) x (1 << height_bits) pixels, wrapping at the edges
+    const uint16_t *pixels;
+    uint8_t width_bits;
+    uint8_t height_bits;
+} blit_texture_t;
+
+// Affine texture mapping: pixel i of the span is the texel at (u + i * du,
+// v + i * dv), in 16.16 fixed point. Uses interp0.
+void blit_affine_span(const blit_texture_t *tex, uint16_t *out, uint32_t u, uint32_t v, int32_t du, int32_t dv,
+                      uint32_t count);
+void blit_affine_span_c(const blit_texture_t *tex, uint16_t *out, uint32_t u, uint32_t v, int32_t du, int32_t dv,
+                        uint32_t count);
+
+// Perspective correct texture mapping. u/w, v/w and 1/w are linear across
+// the screen, so pixel i of the span is the texel at
+//
+//   (uw + i * duw) / (w + i * dw), (vw + i * dvw) / (w + i * dw)
+//
+// where uw and vw are in texels, scaled up by w. w must stay positive over
+// the span. The division is done exactly every BLIT_PERSPECTIVE_RUN pixels,
+// and the texture is mapped affinely in between. Uses interp0.
+typedef struct blit_perspective {
+    int32_t uw;
+    int32_t vw;
+    int32_t w;
+    int32_t duw;
+    int32_t dvw;
+    int32_t dw;
+} blit_perspective_t;
+
+#define BLIT_PERSPECTIVE_RUN_BITS 4
+#define BLIT_PERSPECTIVE_RUN (1u << BLIT_PERSPECTIVE_RUN_BITS)
+
+void blit_perspective_span(const blit_texture_t *tex, uint16_t *out, const blit_perspective_t *p, uint32_t count);
+void blit_perspective_span_c(const blit_texture_t *tex, uint16_t *out, const blit_perspective_t *p, uint32_t count);
+
+// Blend fg over bg, alpha / 256 of the way from bg to fg, rounding each
+// channel down. Uses the blend mode of interp0.
+void blit_blend_span(uint16_t *out, const uint16_t *fg, const uint16_t *bg, uint8_t alpha, uint32_t count);
+void blit_blend_span_c(uint16_t *out, const uint16_t *fg, const uint16_t *bg, uint8_t alpha, uint32_t count);
+
+// Colour values by palette: in[i] >> shift (an arithmetic shift), clamped to
+// 0..n_colours - 1, picks the colour of pixel i, e.g. to show a height field
+// or the sum of some light sources. Uses the clamp mode of interp1.
+void blit_clamp_palette_span(uint16_t *out, const int32_t *in, uint32_t shift, const uint16_t *palette,
+                             uint32_t n_colours, uint32_t count);
+void blit_clamp_palette_span_c(uint16_t *out, const int32_t *in, uint32_t shift, const uint16_t *palette,
+                               uint32_t n_colours, uint32_t count);
+
+// Expand RGB565 to 0x00RRGGBB, repeating the top bits of each channel in the
+// bits below, so full scale stays full scale. Uses interp0.
+void blit_expand_rgb565_span(uint32_t *out, const uint16_t *in, uint32_t count);
+void blit_expand_rgb565_span_c(uint32_t *out, const uint16_t *in, uint32_t count);
+
+#endif
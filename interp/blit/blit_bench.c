@@ -0,0 +1,191 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Check each kernel in blit.c against its plain C version, and time both
+//
+// Each kernel is run on a number of spans with different parameters, once
+// using the interpolators and once in plain C, and the two outputs must be
+// the same. Each span is timed in processor clock cycles, and the totals
+// printed as pixels per cycle.
+//
+// On the host, the kernels run on interp/interp_model:
+//
+//   cc -DPICO_NO_HARDWARE=1 -I../interp_model/include blit_bench.c blit.c ../interp_model/interp_model.c
+//
+// and any difference gives a non-zero exit status. Rather than cycles, the
+// model counts each kernel's interpolator register accesses, the part of its
+// device time the interpolators account for.
+
+#include <stdio.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "cycle_counter.h"
+#else
+#include <stdbool.h>
+#include "hardware/interp.h"
+#define count_of(a) (sizeof(a)/sizeof((a)[0]))
+#endif
+
+#include "blit.h"
+
+#define SPAN 256
+#define SPANS 64
+
+#define TEX_BITS 6
+#define N_COLOURS 64
+
+static uint16_t texture[1u << (2 * TEX_BITS)];
+static const blit_texture_t tex = {
+    .pixels = texture,
+    .width_bits = TEX_BITS,
+    .height_bits = TEX_BITS,
+};
+static uint16_t fg[SPAN];
+static uint16_t bg[SPAN];
+static int32_t values[SPAN];
+static uint16_t palette[N_COLOURS];
+
+// Big enough for a span of 32 bit pixels
+static uint32_t out_interp[SPAN];
+static uint32_t out_c[SPAN];
+
+static uint32_t rand_state = 1;
+
+// Host and device rand() differ, and we want the same spans on both
+static uint32_t next_rand(void) {
+    rand_state = rand_state * 1103515245u + 12345u;
+    return rand_state >> 8;
+}
+
+static int32_t rand_range(int32_t lo, int32_t hi) {
+    return lo + (int32_t)(next_rand() % (uint32_t)(hi - lo + 1));
+}
+
+// The parameters of each span are made from its number, so the interp and C
+// runs of a span get the same ones
+static void run_affine(uint32_t span, bool interp, void *out) {
+    rand_state = span + 1;
+    uint32_t u = next_rand(), v = next_rand();
+    int32_t du = rand_range(-0x30000, 0x30000), dv = rand_range(-0x30000, 0x30000);
+    (interp ? blit_affine_span : blit_affine_span_c)(&tex, out, u, v, du, dv, SPAN);
+}
+
+static void run_perspective(uint32_t span, bool interp, void *out) {
+    rand_state = span + 1;
+    blit_perspective_t p;
+    p.w = rand_range(0x8000, 0x20000);
+    // Keep w positive across the span
+    p.dw = rand_range(-p.w / (2 * SPAN), p.w / (2 * SPAN));
+    p.uw = rand_range(-64, 64) * (p.w >> 4);
+    p.vw = rand_range(-64, 64) * (p.w >> 4);
+    p.duw = rand_range(-0x4000, 0x4000);
+    p.dvw = rand_range(-0x4000, 0x4000);
+    (interp ? blit_perspective_span : blit_perspective_span_c)(&tex, out, &p, SPAN);
+}
+
+static void run_blend(uint32_t span, bool interp, void *out) {
+    uint8_t alpha = (uint8_t)(span * 37);
+    (interp ? blit_blend_span : blit_blend_span_c)(out, fg, bg, alpha, SPAN);
+}
+
+static void run_clamp_palette(uint32_t span, bool interp, void *out) {
+    uint32_t shift = 4 + span % 4;
+    (interp ? blit_clamp_palette_span : blit_clamp_palette_span_c)(out, values, shift, palette, N_COLOURS, SPAN);
+}
+
+static void run_expand(uint32_t span, bool interp, void *out) {
+    (interp ? blit_expand_rgb565_span : blit_expand_rgb565_span_c)(out, span & 1 ? fg : bg, SPAN);
+}
+
+typedef struct kernel {
+    const char *name;
+    void (*run)(uint32_t span, bool interp, void *out);
+    // bytes per output pixel
+    uint32_t out_bytes;
+} kernel_t;
+
+static const kernel_t kernels[] = {
+    {"affine", run_affine, 2},
+    {"perspective", run_perspective, 2},
+    {"blend", run_blend, 2},
+    {"clamp palette", run_clamp_palette, 2},
+    {"expand rgb565", run_expand, 4},
+};
+
+static void init_data(void) {
+    for (uint32_t i = 0; i < count_of(texture); ++i) {
+        texture[i] = (uint16_t)(next_rand() ^ i);
+    }
+    for (uint32_t i = 0; i < SPAN; ++i) {
+        fg[i] = (uint16_t)next_rand();
+        bg[i] = (uint16_t)next_rand();
+        values[i] = rand_range(-0x1000, 0x2000);
+    }
+    for (uint32_t i = 0; i < N_COLOURS; ++i) {
+        palette[i] = (uint16_t)(i * 0x0421);
+    }
+}
+
+// Run a span, returning the cycles it took (on the host, the cycles spent on
+// interpolator register accesses)
+static uint32_t timed_run(const kernel_t *k, uint32_t span, bool interp, void *out) {
+#if !PICO_NO_HARDWARE
+    uint32_t start = cycle_counter();
+    k->run(span, interp, out);
+    return cycles_since(start);
+#else
+    interp_model_reset_cycles();
+    k->run(span, interp, out);
+    return (uint32_t)interp_model_get_cycles();
+#endif
+}
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+    cycle_counter_init();
+    printf("Blit kernels, %u spans of %u pixels, system clock %u MHz\n", SPANS, SPAN,
+           (unsigned)(clock_get_hz(clk_sys) / 1000000));
+#else
+    printf("Blit kernels, %u spans of %u pixels, on the host (interpolator accesses only)\n", SPANS, SPAN);
+#endif
+    init_data();
+
+    uint32_t failures = 0;
+    for (uint32_t i = 0; i < count_of(kernels); ++i) {
+        const kernel_t *k = &kernels[i];
+        uint64_t cycles_interp = 0, cycles_c = 0;
+        uint32_t mismatches = 0;
+        for (uint32_t span = 0; span < SPANS; ++span) {
+            cycles_interp += timed_run(k, span, true, out_interp);
+            cycles_c += timed_run(k, span, false, out_c);
+            if (memcmp(out_interp, out_c, SPAN * k->out_bytes)) {
+                if (!mismatches) {
+                    printf("  %s: span %u differs from the C version\n", k->name, (unsigned)span);
+                }
+                mismatches++;
+            }
+        }
+        failures += mismatches;
+#if !PICO_NO_HARDWARE
+        // The spans' parameters are made inside the timed part, which is the
+        // same small cost for both
+        double pixels = (double)SPAN * SPANS;
+        printf("%-14s interp %.3f px/cycle, C %.3f px/cycle, %.2fx %s\n", k->name, pixels / (double)cycles_interp,
+               pixels / (double)cycles_c, (double)cycles_c / (double)cycles_interp, mismatches ? "MISMATCH" : "ok");
+#else
+        (void)cycles_c;
+        printf("%-14s interp %.2f accesses/px %s\n", k->name, (double)cycles_interp / (SPAN * SPANS),
+               mismatches ? "MISMATCH" : "ok");
+#endif
+    }
+
+    printf("\n%s\n", failures ? "Blit checks FAILED" : "All blit checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _CYCLE_COUNTER_H
+#define _CYCLE_COUNTER_H
+
+// Processor clock cycle counter for timing the kernels, and the scanline
+// compositor which draws with them; dma/memcpy times its copies with it too.
+// On Arm this is SysTick, which only has 24 bits, so nothing timed can take
+// longer than 16M cycles. Hazard3 has no SysTick, and counts in mcycle
+// instead.
+
+#include "pico/stdlib.h"
+#ifndef __riscv
+#include "hardware/structs/systick.h"
+#endif
+
+#ifdef __riscv
+// Hazard3 comes out of reset with mcycle stopped
+static inline void cycle_counter_init(void) {
+    asm volatile ("csrci mcountinhibit, 0x1");
+}
+
+static inline uint32_t cycle_counter(void) {
+    uint32_t cycles;
+    asm volatile ("csrr %0, mcycle" : "=r" (cycles));
+    return cycles;
+}
+
+static inline uint32_t cycles_since(uint32_t start) {
+    return cycle_counter() - start;
+}
+#else
+// SysTick counts down, once per processor clock cycle
+static inline void cycle_counter_init(void) {
+    systick_hw->rvr = 0x00ffffff;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;
+}
+
+static inline uint32_t cycle_counter(void) {
+    return systick_hw->cvr;
+}
+
+static inline uint32_t cycles_since(uint32_t start) {
+    return (start - cycle_counter()) & 0x00ffffff;
+}
+#endif
+
+#endif
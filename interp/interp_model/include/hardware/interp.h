@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _HARDWARE_INTERP_H
+#define _HARDWARE_INTERP_H
+
+// A software model of the interpolators, for building interpolator code on
+// the host, e.g. to check and benchmark it in CI.
+//
+// This stands in for the SDK's hardware/interp.h, with the same types and
+// functions, so the code under test is the same as on the device; build with
+// interp_model/include on the include path and interp_model.c alongside it.
+// Each lane shifts, masks and sign extends its input as the hardware does,
+// and the blend (interp0) and clamp (interp1) modes, cross input and cross
+// result, ADD_RAW, FORCE_MSB and the POP/PEEK results all follow the RP2040
+// datasheet. There is one pair of interpolators, as for a single core.
+//
+// The model counts the interpolator register accesses made through these
+// functions. Each is a single cycle on the device, so the count is the time
+// a kernel spends talking to the interpolators, whatever the host's speed.
+//
+// Writes to ACCUM, BASE and CTRL through the register struct (e.g.
+// interp0->accum[0] = x) work, but aren't counted. Reading PEEK, POP or
+// ACCUMx_ADD, and writing BASE_1AND0 or ACCUMx_ADD, must go through the
+// functions, as a read or write of a plain struct member has no side effects.
+// Likewise BASE2 and the full result are 32 bits, so on a 64 bit host use them
+// for offsets rather than addresses.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    uint32_t accum[2];
+    uint32_t base[3];
+    uint32_t pop[3];
+    uint32_t peek[3];
+    uint32_t ctrl[2];
+    uint32_t add_raw[2];
+    uint32_t base01;
+} interp_hw_t;
+
+typedef struct {
+    uint32_t accum[2];
+    uint32_t base[3];
+    uint32_t ctrl[2];
+} interp_hw_save_t;
+
+extern interp_hw_t interp_model_hw[2];
+
+#define interp0 (&interp_model_hw[0])
+#define interp1 (&interp_model_hw[1])
+
+// CTRL_LANEx fields, as in hardware/regs/sio.h
+#define SIO_INTERP0_CTRL_LANE0_SHIFT_LSB         0
+#define SIO_INTERP0_CTRL_LANE0_SHIFT_BITS        0x0000001fu
+#define SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB      5
+#define SIO_INTERP0_CTRL_LANE0_MASK_LSB_BITS     0x000003e0u
+#define SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB      10
+#define SIO_INTERP0_CTRL_LANE0_MASK_MSB_BITS     0x00007c00u
+#define SIO_INTERP0_CTRL_LANE0_SIGNED_BITS       0x00008000u
+#define SIO_INTERP0_CTRL_LANE0_CROSS_INPUT_BITS  0x00010000u
+#define SIO_INTERP0_CTRL_LANE0_CROSS_RESULT_BITS 0x00020000u
+#define SIO_INTERP0_CTRL_LANE0_ADD_RAW_BITS      0x00040000u
+#define SIO_INTERP0_CTRL_LANE0_FORCE_MSB_LSB     19
+#define SIO_INTERP0_CTRL_LANE0_FORCE_MSB_BITS    0x00180000u
+#define SIO_INTERP0_CTRL_LANE0_BLEND_BITS        0x00200000u
+#define SIO_INTERP1_CTRL_LANE0_CLAMP_BITS        0x00400000u
+#define SIO_INTERP0_CTRL_LANE0_OVERF0_BITS       0x00800000u
+#define SIO_INTERP0_CTRL_LANE0_OVERF1_BITS       0x01000000u
+#define SIO_INTERP0_CTRL_LANE0_OVERF_BITS        0x02000000u
+
+typedef struct {
+    uint32_t ctrl;
+} interp_config;
+
+static inline unsigned int interp_index(interp_hw_t *interp) {
+    return interp == interp1 ? 1 : 0;
+}
+
+void interp_claim_lane(interp_hw_t *interp, unsigned int lane);
+void interp_claim_lane_mask(interp_hw_t *interp, unsigned int lane_mask);
+void interp_unclaim_lane(interp_hw_t *interp, unsigned int lane);
+void interp_unclaim_lane_mask(interp_hw_t *interp, unsigned int lane_mask);
+bool interp_lane_is_claimed(interp_hw_t *interp, unsigned int lane);
+
+static inline void interp_config_set_shift(interp_config *c, unsigned int shift) {
+    c->ctrl = (c->ctrl & ~SIO_INTERP0_CTRL_LANE0_SHIFT_BITS) |
+              ((shift << SIO_INTERP0_CTRL_LANE0_SHIFT_LSB) & SIO_INTERP0_CTRL_LANE0_SHIFT_BITS);
+}
+
+static inline void interp_config_set_mask(interp_config *c, unsigned int mask_lsb, unsigned int mask_msb) {
+    c->ctrl = (c->ctrl & ~(SIO_INTERP0_CTRL_LANE0_MASK_LSB_BITS | SIO_INTERP0_CTRL_LANE0_MASK_MSB_BITS)) |
+              ((mask_lsb << SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB) & SIO_INTERP0_CTRL_LANE0_MASK_LSB_BITS) |
+              ((mask_msb << SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB) & SIO_INTERP0_CTRL_LANE0_MASK_MSB_BITS);
+}
+
+static inline void interp_config_set_cross_input(interp_config *c, bool cross_input) {
+    c->ctrl = (c->ctrl & ~SIO_INTERP0_CTRL_LANE0_CROSS_INPUT_BITS) |
+              (cross_input ? SIO_INTERP0_CTRL_LANE0_CROSS_INPUT_BITS : 0);
+}
+
+static inline void interp_config_set_cross_result(interp_config *c, bool cross_result) {
+    c->ctrl = (c->ctrl & ~SIO_INTERP0_CTRL_LANE0_CROSS_RESULT_BITS) |
+              (cross_result ? SIO_INTERP0_CTRL_LANE0_CROSS_RESULT_BITS : 0);
+}
+
+static inline void interp_config_set_signed(interp_config *c, bool _signed) {
+    c->ctrl = (c->ctrl & ~SIO_INTERP0_CTRL_LANE0_SIGNED_BITS) | (_signed ? SIO_INTERP0_CTRL_LANE0_SIGNED_BITS : 0);
+}
+
+static inline void interp_config_set_add_raw(interp_config *c, bool add_raw) {
+    c->ctrl = (c->ctrl & ~SIO_INTERP0_CTRL_LANE0_ADD_RAW_BITS) | (add_raw ? SIO_INTERP0_CTRL_LANE0_ADD_RAW_BITS : 0);
+}
+
+static inline void interp_config_set_blend(interp_config *c, bool blend) {
+    c->ctrl = (c->ctrl & ~SIO_INTERP0_CTRL_LANE0_BLEND_BITS) | (blend ? SIO_INTERP0_CTRL_LANE0_BLEND_BITS : 0);
+}
+
+static inline void interp_config_set_clamp(interp_config *c, bool clamp) {
+    c->ctrl = (c->ctrl & ~SIO_INTERP1_CTRL_LANE0_CLAMP_BITS) | (clamp ? SIO_INTERP1_CTRL_LANE0_CLAMP_BITS : 0);
+}
+
+static inline void interp_config_set_force_bits(interp_config *c, unsigned int bits) {
+    c->ctrl = (c->ctrl & ~SIO_INTERP0_CTRL_LANE0_FORCE_MSB_BITS) |
+              ((bits << SIO_INTERP0_CTRL_LANE0_FORCE_MSB_LSB) & SIO_INTERP0_CTRL_LANE0_FORCE_MSB_BITS);
+}
+
+static inline interp_config interp_default_config(void) {
+    interp_config c = {0};
+    // Just pass through everything
+    interp_config_set_mask(&c, 0, 31);
+    return c;
+}
+
+// Blend is ignored except on lane 0 of interp0, and clamp except on lane 0 of
+// interp1, as those bits don't exist elsewhere
+void interp_set_config(interp_hw_t *interp, unsigned int lane, interp_config *config);
+void interp_set_force_bits(interp_hw_t *interp, unsigned int lane, unsigned int bits);
+
+// The saved CTRL_LANE0 has the OVERF flags of the moment it was saved
+void interp_save(interp_hw_t *interp, interp_hw_save_t *saver);
+void interp_restore(interp_hw_t *interp, interp_hw_save_t *saver);
+
+void interp_set_base(interp_hw_t *interp, unsigned int lane, uint32_t val);
+uint32_t interp_get_base(interp_hw_t *interp, unsigned int lane);
+// Low 16 bits to BASE0, high 16 bits to BASE1, each sign extended if that
+// lane is signed
+void interp_set_base_both(interp_hw_t *interp, uint32_t val);
+
+void interp_set_accumulator(interp_hw_t *interp, unsigned int lane, uint32_t val);
+uint32_t interp_get_accumulator(interp_hw_t *interp, unsigned int lane);
+void interp_add_accumulater(interp_hw_t *interp, unsigned int lane, uint32_t val);
+// The lane's shift and mask value, without BASE added
+uint32_t interp_get_raw(interp_hw_t *interp, unsigned int lane);
+
+uint32_t interp_peek_lane_result(interp_hw_t *interp, unsigned int lane);
+uint32_t interp_pop_lane_result(interp_hw_t *interp, unsigned int lane);
+uint32_t interp_peek_full_result(interp_hw_t *interp);
+uint32_t interp_pop_full_result(interp_hw_t *interp);
+
+// Not in the SDK: the number of register accesses (device cycles) since the
+// count was last reset, over both interpolators
+uint64_t interp_model_get_cycles(void);
+void interp_model_reset_cycles(void);
+
+#endif
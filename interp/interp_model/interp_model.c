@@ -0,0 +1,269 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "hardware/interp.h"
+
+#define CTRL_SHIFT_BITS        SIO_INTERP0_CTRL_LANE0_SHIFT_BITS
+#define CTRL_SHIFT_LSB         SIO_INTERP0_CTRL_LANE0_SHIFT_LSB
+#define CTRL_MASK_LSB_BITS     SIO_INTERP0_CTRL_LANE0_MASK_LSB_BITS
+#define CTRL_MASK_LSB_LSB      SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB
+#define CTRL_MASK_MSB_BITS     SIO_INTERP0_CTRL_LANE0_MASK_MSB_BITS
+#define CTRL_MASK_MSB_LSB      SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB
+#define CTRL_SIGNED_BITS       SIO_INTERP0_CTRL_LANE0_SIGNED_BITS
+#define CTRL_CROSS_INPUT_BITS  SIO_INTERP0_CTRL_LANE0_CROSS_INPUT_BITS
+#define CTRL_CROSS_RESULT_BITS SIO_INTERP0_CTRL_LANE0_CROSS_RESULT_BITS
+#define CTRL_ADD_RAW_BITS      SIO_INTERP0_CTRL_LANE0_ADD_RAW_BITS
+#define CTRL_FORCE_MSB_BITS    SIO_INTERP0_CTRL_LANE0_FORCE_MSB_BITS
+#define CTRL_FORCE_MSB_LSB     SIO_INTERP0_CTRL_LANE0_FORCE_MSB_LSB
+#define CTRL_BLEND_BITS        SIO_INTERP0_CTRL_LANE0_BLEND_BITS
+#define CTRL_CLAMP_BITS        SIO_INTERP1_CTRL_LANE0_CLAMP_BITS
+#define CTRL_OVERF0_BITS       SIO_INTERP0_CTRL_LANE0_OVERF0_BITS
+#define CTRL_OVERF1_BITS       SIO_INTERP0_CTRL_LANE0_OVERF1_BITS
+#define CTRL_OVERF_BITS        SIO_INTERP0_CTRL_LANE0_OVERF_BITS
+
+// The bits of CTRL_LANEx which can be written
+#define CTRL_WRITE_BITS        0x007fffffu
+
+interp_hw_t interp_model_hw[2];
+
+static uint64_t cycles;
+static uint8_t claimed_lanes;
+
+uint64_t interp_model_get_cycles(void) {
+    return cycles;
+}
+
+void interp_model_reset_cycles(void) {
+    cycles = 0;
+}
+
+// ----------------------------------------------------------------------------
+// Claiming
+
+static uint32_t claim_bit(interp_hw_t *interp, unsigned int lane) {
+    return 1u << (interp_index(interp) * 2 + lane);
+}
+
+void interp_claim_lane(interp_hw_t *interp, unsigned int lane) {
+    claimed_lanes |= claim_bit(interp, lane);
+}
+
+void interp_claim_lane_mask(interp_hw_t *interp, unsigned int lane_mask) {
+    if (lane_mask & 1) interp_claim_lane(interp, 0);
+    if (lane_mask & 2) interp_claim_lane(interp, 1);
+}
+
+void interp_unclaim_lane(interp_hw_t *interp, unsigned int lane) {
+    claimed_lanes &= ~claim_bit(interp, lane);
+}
+
+void interp_unclaim_lane_mask(interp_hw_t *interp, unsigned int lane_mask) {
+    if (lane_mask & 1) interp_unclaim_lane(interp, 0);
+    if (lane_mask & 2) interp_unclaim_lane(interp, 1);
+}
+
+bool interp_lane_is_claimed(interp_hw_t *interp, unsigned int lane) {
+    return claimed_lanes & claim_bit(interp, lane);
+}
+
+// ----------------------------------------------------------------------------
+// The lanes
+
+static uint32_t lane_input(const interp_hw_t *interp, unsigned int lane) {
+    return interp->accum[interp->ctrl[lane] & CTRL_CROSS_INPUT_BITS ? lane ^ 1 : lane];
+}
+
+static unsigned int lane_mask_msb(const interp_hw_t *interp, unsigned int lane) {
+    return (interp->ctrl[lane] & CTRL_MASK_MSB_BITS) >> CTRL_MASK_MSB_LSB;
+}
+
+static uint32_t lane_shifted(const interp_hw_t *interp, unsigned int lane) {
+    return lane_input(interp, lane) >> ((interp->ctrl[lane] & CTRL_SHIFT_BITS) >> CTRL_SHIFT_LSB);
+}
+
+// Shift, mask and sign extend
+static uint32_t lane_shift_mask(const interp_hw_t *interp, unsigned int lane) {
+    uint32_t ctrl = interp->ctrl[lane];
+    unsigned int lsb = (ctrl & CTRL_MASK_LSB_BITS) >> CTRL_MASK_LSB_LSB;
+    unsigned int msb = lane_mask_msb(interp, lane);
+    uint32_t mask = msb < lsb ? 0 : (0xffffffffu >> (31 - msb)) & (0xffffffffu << lsb);
+    uint32_t value = lane_shifted(interp, lane) & mask;
+    if ((ctrl & CTRL_SIGNED_BITS) && (value >> msb & 1u)) {
+        value |= 0xffffffffu << msb;
+    }
+    return value;
+}
+
+// Set if any bits of the shifted input above the mask are set
+static bool lane_overflow(const interp_hw_t *interp, unsigned int lane) {
+    unsigned int msb = lane_mask_msb(interp, lane);
+    return msb < 31 && (lane_shifted(interp, lane) >> (msb + 1));
+}
+
+// The three results, before FORCE_MSB
+static void lane_results(const interp_hw_t *interp, uint32_t result[3]) {
+    uint32_t sm0 = lane_shift_mask(interp, 0);
+    uint32_t sm1 = lane_shift_mask(interp, 1);
+    uint32_t ctrl0 = interp->ctrl[0], ctrl1 = interp->ctrl[1];
+    if (ctrl0 & CTRL_BLEND_BITS) {
+        // Lerp from BASE0 to BASE1 by the low 8 bits of lane 1, rounding
+        // down, signed or not as lane 1 is
+        uint32_t alpha = sm1 & 0xffu;
+        int64_t from, to;
+        if (ctrl1 & CTRL_SIGNED_BITS) {
+            from = (int32_t)interp->base[0];
+            to = (int32_t)interp->base[1];
+        } else {
+            from = interp->base[0];
+            to = interp->base[1];
+        }
+        result[0] = alpha;
+        result[1] = (uint32_t)(from + (((to - from) * (int64_t)alpha) >> 8));
+        result[2] = interp->base[2] + sm0;
+        return;
+    }
+    if (ctrl0 & CTRL_CLAMP_BITS) {
+        uint32_t lo = interp->base[0], hi = interp->base[1];
+        uint32_t v = sm0;
+        if (ctrl0 & CTRL_SIGNED_BITS) {
+            v = (int32_t)v < (int32_t)lo ? lo : (int32_t)v > (int32_t)hi ? hi : v;
+        } else {
+            v = v < lo ? lo : v > hi ? hi : v;
+        }
+        result[0] = v;
+    } else {
+        result[0] = interp->base[0] + (ctrl0 & CTRL_ADD_RAW_BITS ? lane_input(interp, 0) : sm0);
+    }
+    result[1] = interp->base[1] + (ctrl1 & CTRL_ADD_RAW_BITS ? lane_input(interp, 1) : sm1);
+    result[2] = interp->base[2] + sm0 + sm1;
+}
+
+static uint32_t force_msb(const interp_hw_t *interp, unsigned int lane, uint32_t value) {
+    return value | ((interp->ctrl[lane] & CTRL_FORCE_MSB_BITS) >> CTRL_FORCE_MSB_LSB) << 28;
+}
+
+static void pop(interp_hw_t *interp, const uint32_t result[3]) {
+    interp->accum[0] = result[interp->ctrl[0] & CTRL_CROSS_RESULT_BITS ? 1 : 0];
+    interp->accum[1] = result[interp->ctrl[1] & CTRL_CROSS_RESULT_BITS ? 0 : 1];
+}
+
+// ----------------------------------------------------------------------------
+// Register accesses, one cycle each
+
+void interp_set_config(interp_hw_t *interp, unsigned int lane, interp_config *config) {
+    uint32_t ctrl = config->ctrl & CTRL_WRITE_BITS;
+    if (lane || interp != interp0) {
+        ctrl &= ~CTRL_BLEND_BITS;
+    }
+    if (lane || interp != interp1) {
+        ctrl &= ~CTRL_CLAMP_BITS;
+    }
+    interp->ctrl[lane] = ctrl;
+    cycles++;
+}
+
+void interp_set_force_bits(interp_hw_t *interp, unsigned int lane, unsigned int bits) {
+    // The SDK sets the bits with an atomic alias, which is a single write
+    interp->ctrl[lane] |= (bits << CTRL_FORCE_MSB_LSB) & CTRL_FORCE_MSB_BITS;
+    cycles++;
+}
+
+void interp_save(interp_hw_t *interp, interp_hw_save_t *saver) {
+    saver->accum[0] = interp->accum[0];
+    saver->accum[1] = interp->accum[1];
+    saver->base[0] = interp->base[0];
+    saver->base[1] = interp->base[1];
+    saver->base[2] = interp->base[2];
+    saver->ctrl[0] = interp->ctrl[0];
+    saver->ctrl[1] = interp->ctrl[1];
+    bool overf0 = lane_overflow(interp, 0), overf1 = lane_overflow(interp, 1);
+    saver->ctrl[0] |= (overf0 ? CTRL_OVERF0_BITS : 0) | (overf1 ? CTRL_OVERF1_BITS : 0) |
+                      (overf0 || overf1 ? CTRL_OVERF_BITS : 0);
+    cycles += 7;
+}
+
+void interp_restore(interp_hw_t *interp, interp_hw_save_t *saver) {
+    interp->accum[0] = saver->accum[0];
+    interp->accum[1] = saver->accum[1];
+    interp->base[0] = saver->base[0];
+    interp->base[1] = saver->base[1];
+    interp->base[2] = saver->base[2];
+    // The OVERF flags are read only
+    interp->ctrl[0] = saver->ctrl[0] & CTRL_WRITE_BITS;
+    interp->ctrl[1] = saver->ctrl[1] & CTRL_WRITE_BITS;
+    cycles += 7;
+}
+
+void interp_set_base(interp_hw_t *interp, unsigned int lane, uint32_t val) {
+    interp->base[lane] = val;
+    cycles++;
+}
+
+uint32_t interp_get_base(interp_hw_t *interp, unsigned int lane) {
+    cycles++;
+    return interp->base[lane];
+}
+
+void interp_set_base_both(interp_hw_t *interp, uint32_t val) {
+    for (unsigned int lane = 0; lane < 2; ++lane) {
+        uint32_t half = (val >> (16 * lane)) & 0xffffu;
+        if ((interp->ctrl[lane] & CTRL_SIGNED_BITS) && (half & 0x8000u)) {
+            half |= 0xffff0000u;
+        }
+        interp->base[lane] = half;
+    }
+    cycles++;
+}
+
+void interp_set_accumulator(interp_hw_t *interp, unsigned int lane, uint32_t val) {
+    interp->accum[lane] = val;
+    cycles++;
+}
+
+uint32_t interp_get_accumulator(interp_hw_t *interp, unsigned int lane) {
+    cycles++;
+    return interp->accum[lane];
+}
+
+void interp_add_accumulater(interp_hw_t *interp, unsigned int lane, uint32_t val) {
+    interp->accum[lane] += val;
+    cycles++;
+}
+
+uint32_t interp_get_raw(interp_hw_t *interp, unsigned int lane) {
+    cycles++;
+    return lane_shift_mask(interp, lane);
+}
+
+uint32_t interp_peek_lane_result(interp_hw_t *interp, unsigned int lane) {
+    uint32_t result[3];
+    lane_results(interp, result);
+    cycles++;
+    return force_msb(interp, lane, result[lane]);
+}
+
+uint32_t interp_pop_lane_result(interp_hw_t *interp, unsigned int lane) {
+    uint32_t result[3];
+    lane_results(interp, result);
+    pop(interp, result);
+    cycles++;
+    return force_msb(interp, lane, result[lane]);
+}
+
+uint32_t interp_peek_full_result(interp_hw_t *interp) {
+    uint32_t result[3];
+    lane_results(interp, result);
+    cycles++;
+    return result[2];
+}
+
+uint32_t interp_pop_full_result(interp_hw_t *interp) {
+    uint32_t result[3];
+    lane_results(interp, result);
+    pop(interp, result);
+    cycles++;
+    return result[2];
+}
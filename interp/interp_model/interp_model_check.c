@@ -0,0 +1,280 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Run the examples from hello_interp, and check the results
+//
+// Where hello_interp prints what the interpolators give, this works out what
+// they should give, and compares. On the device that checks the examples;
+// built on the host against the software model of the interpolators, it
+// checks the model, e.g. in CI:
+//
+//   cc -DPICO_NO_HARDWARE=1 -Iinclude interp_model_check.c interp_model.c
+//
+// Either way it exits with a non-zero status if any result is wrong. Running
+// it on the device is how to tell whether the model still matches silicon.
+//
+// The results go through the hardware/interp.h functions rather than the
+// registers, and BASE2 holds offsets rather than addresses, so the same code
+// runs on both.
+
+#include <stdio.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#define count_of(a) (sizeof(a)/sizeof((a)[0]))
+#endif
+
+#include "hardware/interp.h"
+
+static uint32_t failures;
+
+static void check(const char *what, uint32_t index, uint32_t got, uint32_t expected) {
+    if (got != expected) {
+        printf("  %s %u: got 0x%08x, expected 0x%08x\n", what, (unsigned)index, (unsigned)got, (unsigned)expected);
+        failures++;
+    }
+}
+
+static void times_table(void) {
+    interp_config cfg = interp_default_config();
+    interp_set_config(interp0, 0, &cfg);
+    interp_set_accumulator(interp0, 0, 0);
+    interp_set_base(interp0, 0, 9);
+
+    // Each POP gives BASE0 + ACCUM0, and writes it back to ACCUM0
+    for (uint32_t i = 0; i < 10; ++i) {
+        check("times table", i, interp_pop_lane_result(interp0, 0), 9 * (i + 1));
+    }
+}
+
+static void moving_mask(void) {
+    static const uint32_t unsigned_nibbles[8] = {
+        0x0000000d, 0x000000c0, 0x00000b00, 0x0000a000, 0x00040000, 0x00300000, 0x02000000, 0x10000000,
+    };
+    static const uint32_t signed_nibbles[8] = {
+        0xfffffffd, 0xffffffc0, 0xfffffb00, 0xffffa000, 0x00040000, 0x00300000, 0x02000000, 0x10000000,
+    };
+    interp_config cfg = interp_default_config();
+    interp_set_accumulator(interp0, 0, 0x1234abcd);
+    for (uint32_t i = 0; i < 8; ++i) {
+        interp_config_set_mask(&cfg, i * 4, i * 4 + 3);
+        interp_set_config(interp0, 0, &cfg);
+        check("mask", i, interp_get_raw(interp0, 0), unsigned_nibbles[i]);
+    }
+    interp_config_set_signed(&cfg, true);
+    for (uint32_t i = 0; i < 8; ++i) {
+        interp_config_set_mask(&cfg, i * 4, i * 4 + 3);
+        interp_set_config(interp0, 0, &cfg);
+        check("signed mask", i, interp_get_raw(interp0, 0), signed_nibbles[i]);
+    }
+}
+
+static void cross_lanes(void) {
+    interp_config cfg = interp_default_config();
+    interp_config_set_cross_result(&cfg, true);
+    interp_set_config(interp0, 0, &cfg);
+    interp_set_config(interp0, 1, &cfg);
+    interp_set_accumulator(interp0, 0, 123);
+    interp_set_accumulator(interp0, 1, 456);
+    interp_set_base(interp0, 0, 1);
+    interp_set_base(interp0, 1, 0);
+
+    // Each POP swaps the accumulators, adding 1 to the one coming from lane 0
+    uint32_t a0 = 123, a1 = 456;
+    for (uint32_t i = 0; i < 10; ++i) {
+        check("cross peek0", i, interp_peek_lane_result(interp0, 0), a0 + 1);
+        check("cross pop1", i, interp_pop_lane_result(interp0, 1), a1);
+        uint32_t t = a0 + 1;
+        a0 = a1;
+        a1 = t;
+    }
+}
+
+static void blend_setup(bool lane1_signed) {
+    interp_config cfg = interp_default_config();
+    interp_config_set_blend(&cfg, true);
+    interp_set_config(interp0, 0, &cfg);
+    cfg = interp_default_config();
+    interp_config_set_signed(&cfg, lane1_signed);
+    interp_set_config(interp0, 1, &cfg);
+}
+
+static void simple_blend(void) {
+    static const int32_t blend1[7] = {500, 582, 666, 748, 832, 914, 998};
+    static const int32_t blend2[7] = {-1000, -672, -336, -8, 328, 656, 992};
+
+    blend_setup(false);
+    interp_set_base(interp0, 0, 500);
+    interp_set_base(interp0, 1, 1000);
+    for (uint32_t i = 0; i <= 6; ++i) {
+        interp_set_accumulator(interp0, 1, 255 * i / 6);
+        check("blend 1", i, interp_peek_lane_result(interp0, 1), (uint32_t)blend1[i]);
+    }
+
+    blend_setup(true);
+    interp_set_base(interp0, 0, (uint32_t)-1000);
+    interp_set_base(interp0, 1, 1000);
+    for (uint32_t i = 0; i <= 6; ++i) {
+        interp_set_accumulator(interp0, 1, 255 * i / 6);
+        check("blend 2 signed", i, interp_peek_lane_result(interp0, 1), (uint32_t)blend2[i]);
+    }
+
+    blend_setup(false);
+    interp_set_accumulator(interp0, 1, 128);
+    interp_set_base_both(interp0, 0x30005000);
+    check("blend 3", 0, interp_peek_lane_result(interp0, 1), 0x4000);
+    interp_set_base_both(interp0, 0xe000f000);
+    check("blend 3", 1, interp_peek_lane_result(interp0, 1), 0xe800);
+}
+
+static void clamp(void) {
+    interp_config cfg = interp_default_config();
+    interp_config_set_clamp(&cfg, true);
+    interp_config_set_shift(&cfg, 2);
+    interp_config_set_mask(&cfg, 0, 29);
+    interp_config_set_signed(&cfg, true);
+    interp_set_config(interp1, 0, &cfg);
+    interp_set_base(interp1, 0, 0);
+    interp_set_base(interp1, 1, 255);
+
+    for (int32_t i = -1024; i <= 1024; i += 256) {
+        interp_set_accumulator(interp1, 0, (uint32_t)i);
+        int32_t expected = i >> 2 < 0 ? 0 : i >> 2 > 255 ? 255 : i >> 2;
+        check("clamp", (uint32_t)(i + 1024) / 256, interp_peek_lane_result(interp1, 0), (uint32_t)expected);
+    }
+}
+
+static void linear_interpolation(void) {
+    static const int16_t samples[] = {0, 10, -20, -1000, 500};
+    const uint32_t uv_fractional_bits = 12;
+
+    // Lane 0 gives the offset of the first sample of the pair, and lane 1,
+    // through its cross input, the fraction between them
+    interp_config cfg = interp_default_config();
+    interp_config_set_shift(&cfg, uv_fractional_bits - 1);
+    interp_config_set_mask(&cfg, 1, 32 - uv_fractional_bits);
+    interp_config_set_blend(&cfg, true);
+    interp_set_config(interp0, 0, &cfg);
+    cfg = interp_default_config();
+    interp_config_set_shift(&cfg, uv_fractional_bits - 8);
+    interp_config_set_signed(&cfg, true);
+    interp_config_set_cross_input(&cfg, true);
+    interp_set_config(interp0, 1, &cfg);
+
+    const uint32_t step = (1u << uv_fractional_bits) / 4;
+    interp_set_accumulator(interp0, 0, 0);
+    interp_set_base(interp0, 2, 0);
+    for (uint32_t i = 0; i < 16; ++i) {
+        uint32_t offset = interp_peek_full_result(interp0);
+        check("lerp offset", i, offset, i / 4 * 2);
+        const int16_t *pair = (const int16_t *)((const uint8_t *)samples + offset);
+        interp_set_base(interp0, 0, (uint32_t)pair[0]);
+        interp_set_base(interp0, 1, (uint32_t)pair[1]);
+        int32_t alpha = (int32_t)(i % 4 * 64);
+        int32_t expected = pair[0] + (((pair[1] - pair[0]) * alpha) >> 8);
+        check("lerp", i, interp_peek_lane_result(interp0, 1), (uint32_t)expected);
+        interp_add_accumulater(interp0, 0, step);
+    }
+}
+
+static void texture_mapping(void) {
+    static const uint8_t texture[] = {
+        0x00, 0x01, 0x02, 0x03,
+        0x10, 0x11, 0x12, 0x13,
+        0x20, 0x21, 0x22, 0x23,
+        0x30, 0x31, 0x32, 0x33,
+    };
+    // 4x4 texture, 16 fractional bits
+    interp_config cfg = interp_default_config();
+    interp_config_set_add_raw(&cfg, true);
+    interp_config_set_shift(&cfg, 16);
+    interp_config_set_mask(&cfg, 0, 1);
+    interp_set_config(interp0, 0, &cfg);
+    interp_config_set_shift(&cfg, 16 - 2);
+    interp_config_set_mask(&cfg, 2, 3);
+    interp_set_config(interp0, 1, &cfg);
+    interp_set_base(interp0, 2, 0);
+
+    const uint32_t du = 65536 / 2, dv = 65536 / 3;
+    interp_set_accumulator(interp0, 0, 0);
+    interp_set_base(interp0, 0, du);
+    interp_set_accumulator(interp0, 1, 0);
+    interp_set_base(interp0, 1, dv);
+    for (uint32_t i = 0; i < 12; ++i) {
+        uint32_t u = i * du >> 16, v = i * dv >> 16;
+        check("texture", i, texture[interp_pop_full_result(interp0)], texture[(v & 3) * 4 + (u & 3)]);
+    }
+}
+
+static void force_bits(void) {
+    interp_config cfg = interp_default_config();
+    interp_set_config(interp1, 1, &cfg);
+    interp_set_base(interp1, 1, 0);
+    interp_set_accumulator(interp1, 1, 0x1234);
+    interp_set_force_bits(interp1, 1, 2);
+    // FORCE_MSB sets bits 29:28 of what is read, but not of the accumulator
+    check("force bits", 0, interp_pop_lane_result(interp1, 1), 0x20001234);
+    check("force bits", 1, interp_get_accumulator(interp1, 1), 0x1234);
+}
+
+static void save_restore(void) {
+    interp_config cfg = interp_default_config();
+    interp_config_set_shift(&cfg, 4);
+    interp_config_set_mask(&cfg, 0, 7);
+    interp_set_config(interp0, 0, &cfg);
+    interp_set_config(interp0, 1, &cfg);
+    interp_set_accumulator(interp0, 0, 0x1230);
+    interp_set_accumulator(interp0, 1, 0x40);
+    interp_set_base(interp0, 2, 0x1000);
+
+    interp_hw_save_t saved;
+    interp_save(interp0, &saved);
+    // 0x1230 >> 4 = 0x123 doesn't fit in mask bits 0..7, but 0x40 >> 4 does
+    check("overflow flags", 0, saved.ctrl[0] & 0x03800000, 0x02800000);
+
+    cfg = interp_default_config();
+    interp_set_config(interp0, 0, &cfg);
+    interp_set_accumulator(interp0, 0, 0);
+    interp_set_base(interp0, 2, 0);
+    interp_restore(interp0, &saved);
+    check("save and restore", 0, interp_peek_full_result(interp0), 0x1000 + 0x23 + 0x04);
+}
+
+typedef struct example {
+    const char *name;
+    void (*run)(void);
+} example_t;
+
+static const example_t examples[] = {
+    {"times table", times_table},
+    {"moving mask", moving_mask},
+    {"cross lanes", cross_lanes},
+    {"simple blend", simple_blend},
+    {"clamp", clamp},
+    {"linear interpolation", linear_interpolation},
+    {"texture mapping", texture_mapping},
+    {"force bits", force_bits},
+    {"save and restore", save_restore},
+};
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+    puts("Interpolator checks, on the device");
+#else
+    puts("Interpolator checks, on the software model");
+#endif
+
+    for (uint32_t i = 0; i < count_of(examples); ++i) {
+        uint32_t before = failures;
+        examples[i].run();
+        printf("%-21s %s\n", examples[i].name, failures == before ? "ok" : "FAILED");
+    }
+
+    printf("\n%s\n", failures ? "Interpolator checks FAILED" : "All interpolator checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,225 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <math.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#define __not_in_flash_func(func_name) func_name
+#endif
+
+#include "hardware/interp.h"
+
+#include "blit.h"
+#include "compositor.h"
+
+void compositor_layer_set_scroll(compositor_layer_t *layer, int32_t x, int32_t y) {
+    layer->u = (uint32_t)x << 16;
+    layer->v = (uint32_t)y << 16;
+    layer->du_dx = 1u << 16;
+    layer->dv_dx = 0;
+    layer->du_dy = 0;
+    layer->dv_dy = 1u << 16;
+}
+
+static inline uint32_t to_fixed(float f) {
+    return (uint32_t)(int32_t)lroundf(f * 65536.0f);
+}
+
+void compositor_layer_set_rotozoom(compositor_layer_t *layer, float cu, float cv, float cx, float cy, float angle,
+                                   float scale) {
+    float c = cosf(angle) / scale;
+    float s = sinf(angle) / scale;
+    layer->du_dx = to_fixed(c);
+    layer->dv_dx = to_fixed(-s);
+    layer->du_dy = to_fixed(s);
+    layer->dv_dy = to_fixed(c);
+    layer->u = to_fixed(cu - cx * c - cy * s);
+    layer->v = to_fixed(cv + cx * s - cy * c);
+}
+
+// ----------------------------------------------------------------------------
+// Sprites
+
+// The columns of sprite s on the screen, clipped to it. Returns false if the
+// sprite isn't on line y.
+static bool sprite_span(const compositor_scene_t *scene, const compositor_sprite_t *s, uint32_t y, int32_t *x0,
+                        int32_t *x1) {
+    if (!s->visible || (int32_t)y < s->y || (int32_t)y >= s->y + s->height) {
+        return false;
+    }
+    *x0 = s->x < 0 ? 0 : s->x;
+    *x1 = s->x + s->width > scene->width ? scene->width : s->x + s->width;
+    return *x0 < *x1;
+}
+
+static uint32_t max_sprites(const compositor_scene_t *scene) {
+    uint32_t n = scene->max_sprites_per_line;
+    return n && n < COMPOSITOR_MAX_SPRITES_PER_LINE ? n : COMPOSITOR_MAX_SPRITES_PER_LINE;
+}
+
+void compositor_prepare_frame(compositor_scene_t *scene) {
+    const uint32_t limit = max_sprites(scene);
+    scene->sprite_lines_dropped = 0;
+    for (uint32_t y = 0; y < scene->height; ++y) {
+        uint32_t count = 0;
+        uint32_t pixels = 0;
+        for (uint32_t i = 0; i < scene->n_sprites; ++i) {
+            int32_t x0, x1;
+            if (!sprite_span(scene, &scene->sprites[i], y, &x0, &x1)) {
+                continue;
+            }
+            uint32_t w = (uint32_t)(x1 - x0);
+            if (count == limit || (scene->max_sprite_pixels_per_line && pixels + w > scene->max_sprite_pixels_per_line)) {
+                scene->sprite_lines_dropped++;
+                continue;
+            }
+            scene->line_sprites[y][count++] = (uint8_t)i;
+            pixels += w;
+        }
+        scene->line_sprite_count[y] = (uint8_t)count;
+    }
+}
+
+static void __not_in_flash_func(draw_sprite_span)(const compositor_scene_t *scene, const compositor_sprite_t *s,
+                                                  uint32_t y, uint16_t *out) {
+    int32_t x0 = 0, x1 = 0;
+    sprite_span(scene, s, y, &x0, &x1);
+    const uint8_t *row = s->pixels + (y - s->y) * s->width;
+    const uint16_t *palette = s->palette;
+    if (s->hflip) {
+        const uint8_t *src = row + s->width - 1 - (x0 - s->x);
+        for (int32_t x = x0; x < x1; ++x) {
+            uint8_t c = *src--;
+            if (c) {
+                out[x] = palette[c];
+            }
+        }
+    } else {
+        const uint8_t *src = row + (x0 - s->x);
+        for (int32_t x = x0; x < x1; ++x) {
+            uint8_t c = *src++;
+            if (c) {
+                out[x] = palette[c];
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Tilemap layers
+
+// interp0 gives the offset of the tile number in the map, with the tile
+// coordinates as the integer part of u and v, and interp1 the offset of the
+// pixel in the tile. Both step u and v across the line.
+static void __not_in_flash_func(layer_span)(const compositor_layer_t *l, uint32_t u, uint32_t v, uint32_t count,
+                                            uint16_t *out) {
+    const uint32_t tb = l->tile_bits;
+    blit_affine_setup(interp0, 16 + tb, l->map_width_bits, l->map_height_bits, 0);
+    blit_affine_setup(interp1, 16, tb, tb, 0);
+    blit_affine_start(interp0, u, v, (int32_t)l->du_dx, (int32_t)l->dv_dx);
+    blit_affine_start(interp1, u, v, (int32_t)l->du_dx, (int32_t)l->dv_dx);
+
+    const uint8_t *map = l->map;
+    const uint8_t *tiles = l->tiles;
+    const uint16_t *palette = l->palette;
+    if (l->transparent) {
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t tile = map[interp_pop_full_result(interp0)];
+            uint8_t c = tiles[(tile << (2 * tb)) + interp_pop_full_result(interp1)];
+            if (c) {
+                out[i] = palette[c];
+            }
+        }
+    } else {
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t tile = map[interp_pop_full_result(interp0)];
+            out[i] = palette[tiles[(tile << (2 * tb)) + interp_pop_full_result(interp1)]];
+        }
+    }
+}
+
+void __not_in_flash_func(compositor_render_line)(const compositor_scene_t *scene, uint32_t y, uint16_t *out) {
+    const uint32_t width = scene->width;
+    uint32_t fill = scene->background | (uint32_t)scene->background << 16;
+    uint32_t *out32 = (uint32_t *)out;
+    for (uint32_t i = 0; i < width / 2; ++i) {
+        out32[i] = fill;
+    }
+    if (width & 1) {
+        out[width - 1] = scene->background;
+    }
+
+    for (uint32_t i = 0; i < scene->n_layers; ++i) {
+        const compositor_layer_t *l = &scene->layers[i];
+        layer_span(l, l->u + y * l->du_dy, l->v + y * l->dv_dy, width, out);
+    }
+
+    // Back to front, so sprite 0 ends up in front
+    for (uint32_t i = scene->line_sprite_count[y]; i > 0; --i) {
+        draw_sprite_span(scene, &scene->sprites[scene->line_sprites[y][i - 1]], y, out);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Reference
+
+static bool layer_pixel(const compositor_layer_t *l, uint32_t x, uint32_t y, uint16_t *colour) {
+    uint32_t u = l->u + x * l->du_dx + y * l->du_dy;
+    uint32_t v = l->v + x * l->dv_dx + y * l->dv_dy;
+    uint32_t tile_size = 1u << l->tile_bits;
+    uint32_t map_x = (u >> 16) / tile_size % (1u << l->map_width_bits);
+    uint32_t map_y = (v >> 16) / tile_size % (1u << l->map_height_bits);
+    uint32_t tile = l->map[map_y * (1u << l->map_width_bits) + map_x];
+    uint8_t c = l->tiles[tile * tile_size * tile_size + (v >> 16) % tile_size * tile_size + (u >> 16) % tile_size];
+    if (l->transparent && !c) {
+        return false;
+    }
+    *colour = l->palette[c];
+    return true;
+}
+
+void compositor_render_line_reference(const compositor_scene_t *scene, uint32_t y, uint16_t *out) {
+    // Work out which sprites make it onto this line, as compositor_prepare_frame() does
+    const uint32_t limit = max_sprites(scene);
+    const compositor_sprite_t *on_line[COMPOSITOR_MAX_SPRITES_PER_LINE];
+    uint32_t count = 0;
+    uint32_t pixels = 0;
+    for (uint32_t i = 0; i < scene->n_sprites; ++i) {
+        int32_t x0, x1;
+        if (sprite_span(scene, &scene->sprites[i], y, &x0, &x1) && count < limit &&
+            (!scene->max_sprite_pixels_per_line || pixels + (x1 - x0) <= scene->max_sprite_pixels_per_line)) {
+            on_line[count++] = &scene->sprites[i];
+            pixels += x1 - x0;
+        }
+    }
+
+    for (uint32_t x = 0; x < scene->width; ++x) {
+        uint16_t colour = scene->background;
+        for (uint32_t i = 0; i < scene->n_layers; ++i) {
+            layer_pixel(&scene->layers[i], x, y, &colour);
+        }
+        // Front to back, stopping at the first opaque pixel
+        for (uint32_t i = 0; i < count; ++i) {
+            const compositor_sprite_t *s = on_line[i];
+            int32_t sx = (int32_t)x - s->x;
+            if (sx < 0 || sx >= s->width) {
+                continue;
+            }
+            if (s->hflip) {
+                sx = s->width - 1 - sx;
+            }
+            uint8_t c = s->pixels[(y - s->y) * s->width + sx];
+            if (c) {
+                colour = s->palette[c];
+                break;
+            }
+        }
+        out[x] = colour;
+    }
+}
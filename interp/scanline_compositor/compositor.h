@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _COMPOSITOR_H
+#define _COMPOSITOR_H
+
+// Scanline compositor for tilemap layers and sprites.
+//
+// Each line of RGB565 output is drawn on its own, just before it is needed,
+// so there is no framebuffer: a line at a time is enough to feed a DVI or LCD
+// scanline output. The line is filled with the background colour, then each
+// tilemap layer is drawn over it in turn, then the sprites on that line.
+//
+// Tilemap layers are made of square 8 bit per pixel tiles, looked up through
+// a map of tile numbers which wraps at the edges. Each layer has an affine
+// transform from screen to map coordinates, so it can be scrolled, or rotated
+// and scaled. The interpolators do the address arithmetic: interp0 turns the
+// map coordinates into the offset of the tile number, and interp1 into the
+// offset of the pixel within the tile, stepping across the line in lockstep,
+// set up by blit_affine_setup() from interp/blit. Both interpolators on the
+// calling core are used.
+//
+// Sprites are 8 bit per pixel images, drawn in front of all layers, with
+// sprite 0 in front. Like sprite hardware, each line has a list of the
+// sprites on it, built once per frame by compositor_prepare_frame(), and a
+// limit on how many sprites and sprite pixels it can have, to bound the time
+// each line takes. Sprites over the limit are left off that line, lowest
+// priority first.
+//
+// Colour 0 of sprites, and of transparent layers, is transparent. Palettes
+// are RGB565.
+//
+// compositor_render_line_reference() draws the same line one pixel at a time,
+// with none of the above, to check compositor_render_line() against.
+//
+// Layers use both interpolators of the calling core, through hardware/interp.h
+// only, so interp/interp_model can take their place when there is no Pico.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define COMPOSITOR_MAX_SPRITES_PER_LINE 16
+
+typedef struct compositor_layer {
+    // Tile pixels, tile after tile, (1 << tile_bits) pixels square
+    const uint8_t *tiles;
+    // Tile numbers, (1 << map_width_bits) by (1 << map_height_bits). The
+    // tile and map sizes are at least 2.
+    const uint8_t *map;
+    const uint16_t *palette;
+    uint8_t tile_bits;
+    uint8_t map_width_bits;
+    uint8_t map_height_bits;
+    bool transparent;
+    // Map coordinates, in pixels, of the top left of the screen, and how much
+    // they change per pixel across and per line down, all in 16.16 fixed
+    // point. Set with compositor_layer_set_scroll() or
+    // compositor_layer_set_rotozoom().
+    uint32_t u;
+    uint32_t v;
+    uint32_t du_dx;
+    uint32_t dv_dx;
+    uint32_t du_dy;
+    uint32_t dv_dy;
+} compositor_layer_t;
+
+typedef struct compositor_sprite {
+    // width * height pixels
+    const uint8_t *pixels;
+    const uint16_t *palette;
+    int16_t x;
+    int16_t y;
+    uint16_t width;
+    uint16_t height;
+    bool hflip;
+    bool visible;
+} compositor_sprite_t;
+
+typedef struct compositor_scene {
+    uint16_t width;
+    uint16_t height;
+    uint16_t background;
+    compositor_layer_t *layers;
+    uint32_t n_layers;
+    compositor_sprite_t *sprites;
+    uint32_t n_sprites;
+    // Per line limits: at most this many sprites (up to
+    // COMPOSITOR_MAX_SPRITES_PER_LINE), covering at most this many pixels,
+    // or 0 for no limit on pixels
+    uint8_t max_sprites_per_line;
+    uint16_t max_sprite_pixels_per_line;
+
+    // Per line sprite lists, `height` entries each, built by
+    // compositor_prepare_frame()
+    uint8_t (*line_sprites)[COMPOSITOR_MAX_SPRITES_PER_LINE];
+    uint8_t *line_sprite_count;
+    // Sprite lines left off by the last compositor_prepare_frame()
+    uint32_t sprite_lines_dropped;
+} compositor_scene_t;
+
+void compositor_layer_set_scroll(compositor_layer_t *layer, int32_t x, int32_t y);
+
+// Rotate the layer by `angle` radians and scale it by `scale` about the map
+// point (cu, cv), which is shown at the screen point (cx, cy)
+void compositor_layer_set_rotozoom(compositor_layer_t *layer, float cu, float cv, float cx, float cy, float angle,
+                                   float scale);
+
+// Build the per line sprite lists, once the sprites have been moved for the
+// next frame
+void compositor_prepare_frame(compositor_scene_t *scene);
+
+// Draw line y into out, scene->width pixels
+void compositor_render_line(const compositor_scene_t *scene, uint32_t y, uint16_t *out);
+
+void compositor_render_line_reference(const compositor_scene_t *scene, uint32_t y, uint16_t *out);
+
+#endif
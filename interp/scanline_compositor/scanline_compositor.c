@@ -0,0 +1,246 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Composite a scene of two tilemap layers and a crowd of sprites, a line at a
+// time, and check every line against the reference renderer
+//
+// The back layer scrolls, the front layer rotates and zooms, and the sprites
+// bounce around, with more of them bunched on some lines than the per line
+// limits allow. Each line is timed, and the cycles per line compared with the
+// time a scanline output gives us to draw one.
+//
+// On the host the compositor runs on interp/interp_model, so the same checks
+// can run in CI:
+//
+//   cc -DPICO_NO_HARDWARE=1 -I../interp_model/include -I../blit scanline_compositor.c compositor.c ../blit/blit.c ../interp_model/interp_model.c -lm
+//
+// and a line which differs from the reference gives a non-zero exit status.
+// Each frame's checksum is printed, so runs can be compared.
+
+#include <stdio.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "cycle_counter.h"
+#endif
+
+#include "compositor.h"
+
+#define WIDTH 320
+#define HEIGHT 240
+#define FRAMES 16
+
+#define TILE_BITS 3
+#define TILE_SIZE (1 << TILE_BITS)
+#define N_TILES 16
+
+#define N_SPRITES 32
+#define SPRITE_SIZE 16
+
+// A 320 pixel line doubled up to 640x480 DVI, at 126 MHz, is shown for two
+// line periods of 800 pixel clocks, 5 system clocks each
+#define LINE_BUDGET_CYCLES 8000
+
+static uint8_t back_tiles[N_TILES][TILE_SIZE][TILE_SIZE];
+static uint8_t front_tiles[N_TILES][TILE_SIZE][TILE_SIZE];
+static uint8_t back_map[32][64];
+static uint8_t front_map[32][32];
+static uint8_t ball[SPRITE_SIZE][SPRITE_SIZE];
+static uint16_t back_palette[256];
+static uint16_t front_palette[256];
+static uint16_t sprite_palette[256];
+
+static compositor_layer_t layers[2];
+static compositor_sprite_t sprites[N_SPRITES];
+static uint8_t line_sprites[HEIGHT][COMPOSITOR_MAX_SPRITES_PER_LINE];
+static uint8_t line_sprite_count[HEIGHT];
+
+static compositor_scene_t scene = {
+    .width = WIDTH,
+    .height = HEIGHT,
+    .background = 0x0010,
+    .layers = layers,
+    .n_layers = 2,
+    .sprites = sprites,
+    .n_sprites = N_SPRITES,
+    .max_sprites_per_line = 8,
+    .max_sprite_pixels_per_line = 96,
+    .line_sprites = line_sprites,
+    .line_sprite_count = line_sprite_count,
+};
+
+static uint16_t line[WIDTH];
+static uint16_t expected[WIDTH];
+
+static uint32_t rand_state = 1;
+
+// Host and device rand() differ, and we want the same scene on both
+static uint32_t next_rand(void) {
+    rand_state = rand_state * 1103515245u + 12345u;
+    return rand_state >> 8;
+}
+
+static uint16_t rgb565(uint32_t r, uint32_t g, uint32_t b) {
+    return (uint16_t)((r >> 3) << 11 | (g >> 2) << 5 | (b >> 3));
+}
+
+static void init_scene(void) {
+    for (uint32_t t = 0; t < N_TILES; ++t) {
+        for (uint32_t y = 0; y < TILE_SIZE; ++y) {
+            for (uint32_t x = 0; x < TILE_SIZE; ++x) {
+                back_tiles[t][y][x] = (uint8_t)(t * 16 + ((x ^ y) & 7) + (x == 0 || y == 0 ? 8 : 0));
+                // Rings, with colour 0 around and inside them
+                uint32_t dx = 2 * x + 1 - TILE_SIZE, dy = 2 * y + 1 - TILE_SIZE;
+                uint32_t r2 = dx * dx + dy * dy;
+                bool ring = t && r2 >= 16 && r2 < 4 * t + 24;
+                front_tiles[t][y][x] = ring ? (uint8_t)(t * 16 + y) : 0;
+            }
+        }
+    }
+    for (uint32_t y = 0; y < 32; ++y) {
+        for (uint32_t x = 0; x < 64; ++x) {
+            back_map[y][x] = next_rand() % N_TILES;
+        }
+        for (uint32_t x = 0; x < 32; ++x) {
+            front_map[y][x] = (x + y) % 3 ? 0 : next_rand() % N_TILES;
+        }
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        back_palette[i] = rgb565(i & 0xf0, 64 + (i & 0x0f) * 8, 128);
+        front_palette[i] = rgb565(255 - (i & 0xf0), (i & 0x0f) * 16, 255);
+        sprite_palette[i] = rgb565(255, i, i / 2);
+    }
+    for (uint32_t y = 0; y < SPRITE_SIZE; ++y) {
+        for (uint32_t x = 0; x < SPRITE_SIZE; ++x) {
+            uint32_t dx = 2 * x + 1 - SPRITE_SIZE, dy = 2 * y + 1 - SPRITE_SIZE;
+            uint32_t r2 = dx * dx + dy * dy;
+            ball[y][x] = r2 < SPRITE_SIZE * SPRITE_SIZE ? (uint8_t)(255 - r2 / 4 + x) : 0;
+        }
+    }
+
+    layers[0] = (compositor_layer_t) {
+        .tiles = &back_tiles[0][0][0],
+        .map = &back_map[0][0],
+        .palette = back_palette,
+        .tile_bits = TILE_BITS,
+        .map_width_bits = 6,
+        .map_height_bits = 5,
+    };
+    layers[1] = (compositor_layer_t) {
+        .tiles = &front_tiles[0][0][0],
+        .map = &front_map[0][0],
+        .palette = front_palette,
+        .tile_bits = TILE_BITS,
+        .map_width_bits = 5,
+        .map_height_bits = 5,
+        .transparent = true,
+    };
+    for (uint32_t i = 0; i < N_SPRITES; ++i) {
+        sprites[i] = (compositor_sprite_t) {
+            .pixels = &ball[0][0],
+            .palette = sprite_palette,
+            .width = SPRITE_SIZE,
+            .height = SPRITE_SIZE,
+            .hflip = i & 1,
+            .visible = true,
+        };
+    }
+}
+
+// Bounce back and forth between lo and hi
+static int32_t bounce(int32_t t, int32_t lo, int32_t hi) {
+    int32_t span = hi - lo;
+    t %= 2 * span;
+    return lo + (t < span ? t : 2 * span - t);
+}
+
+static void animate(uint32_t frame) {
+    compositor_layer_set_scroll(&layers[0], (int32_t)(frame * 3), (int32_t)(frame / 2));
+    compositor_layer_set_rotozoom(&layers[1], 128.0f, 128.0f, WIDTH / 2.0f, HEIGHT / 2.0f, (float)frame * 0.1f,
+                                  1.0f + (float)(frame % 8) * 0.125f);
+    // Half the sprites in a tight band, to go over the per line limits
+    for (uint32_t i = 0; i < N_SPRITES; ++i) {
+        int32_t t = (int32_t)(frame * (2 + i % 5) + i * 37);
+        sprites[i].x = (int16_t)bounce(t, -SPRITE_SIZE / 2, WIDTH - SPRITE_SIZE / 2);
+        sprites[i].y = (int16_t)(i < N_SPRITES / 2 ? 100 + (int32_t)(i % 4) * 3 : bounce(t * 3 / 2, -8, HEIGHT - 8));
+    }
+}
+
+static uint32_t fnv1a(uint32_t hash, const void *data, size_t len) {
+    const uint8_t *p = data;
+    for (size_t i = 0; i < len; ++i) {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+    return hash;
+}
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+    cycle_counter_init();
+    printf("Scanline compositor, %ux%u, system clock %u MHz\n", WIDTH, HEIGHT,
+           (unsigned)(clock_get_hz(clk_sys) / 1000000));
+#else
+    printf("Scanline compositor, %ux%u, on the host (not timed)\n", WIDTH, HEIGHT);
+#endif
+    printf("%u sprites, at most %u sprites and %u sprite pixels per line, budget %u cycles per line\n", N_SPRITES,
+           scene.max_sprites_per_line, scene.max_sprite_pixels_per_line, LINE_BUDGET_CYCLES);
+
+    init_scene();
+    uint32_t failures = 0;
+    for (uint32_t frame = 0; frame < FRAMES; ++frame) {
+        animate(frame);
+        compositor_prepare_frame(&scene);
+
+        uint32_t hash = 2166136261u;
+        uint32_t mismatches = 0;
+        uint32_t min_cycles = UINT32_MAX, max_cycles = 0, over_budget = 0;
+        uint64_t total_cycles = 0;
+        for (uint32_t y = 0; y < HEIGHT; ++y) {
+#if !PICO_NO_HARDWARE
+            uint32_t start = cycle_counter();
+            compositor_render_line(&scene, y, line);
+            uint32_t cycles = cycles_since(start);
+            min_cycles = cycles < min_cycles ? cycles : min_cycles;
+            max_cycles = cycles > max_cycles ? cycles : max_cycles;
+            over_budget += cycles > LINE_BUDGET_CYCLES;
+            total_cycles += cycles;
+#else
+            compositor_render_line(&scene, y, line);
+#endif
+            compositor_render_line_reference(&scene, y, expected);
+            if (memcmp(line, expected, sizeof(line))) {
+                if (!mismatches) {
+                    for (uint32_t x = 0; x < WIDTH; ++x) {
+                        if (line[x] != expected[x]) {
+                            printf("  line %u pixel %u is %04x, should be %04x\n", (unsigned)y, (unsigned)x, line[x],
+                                   expected[x]);
+                            break;
+                        }
+                    }
+                }
+                mismatches++;
+            }
+            hash = fnv1a(hash, line, sizeof(line));
+        }
+        failures += mismatches;
+
+        printf("Frame %2u: checksum %08x, %u sprite lines dropped", (unsigned)frame, (unsigned)hash,
+               (unsigned)scene.sprite_lines_dropped);
+#if !PICO_NO_HARDWARE
+        printf(", cycles per line %u min %u avg %u max, %u lines over budget", (unsigned)min_cycles,
+               (unsigned)(total_cycles / HEIGHT), (unsigned)max_cycles, (unsigned)over_budget);
+#else
+        (void)min_cycles; (void)max_cycles; (void)over_budget; (void)total_cycles;
+#endif
+        printf(" %s\n", mismatches ? "MISMATCH" : "ok");
+    }
+
+    printf("\n%s\n", failures ? "Compositor checks FAILED" : "All compositor checks passed");
+    return failures ? 1 : 0;
+}
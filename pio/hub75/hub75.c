@@ -5,12 +5,17 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "pico/stdlib.h"
+#include "hardware/clocks.h"
 #include "hardware/gpio.h"
 #include "hardware/pio.h"
 #include "hub75.pio.h"
 
+#include "hub75_fb.h"
+#include "hub75_planes.h"
 #include "mountains_128x64_rgb565.h"
 
 #define DATA_BASE_PIN 0
@@ -24,6 +29,24 @@
 #define WIDTH 128
 #define HEIGHT 64
 
+// Refresh the panel with DMA, from a framebuffer which is packed into bit
+// planes up front, rather than from the processor one pixel at a time
+#ifndef HUB75_DMA_REFRESH
+#define HUB75_DMA_REFRESH 1
+#endif
+
+// Bit planes to display. Fewer planes gives a higher refresh rate, at the
+// cost of colour depth.
+#define N_PLANES 8
+
+// Output enable pulse width for the least significant bit plane, in system
+// clock cycles. Each plane after that is shown for twice as long.
+#define BCM_BASE_CYCLES 100
+
+// Maximum pixel clock for DMA refresh. The CPU refresh is limited to much
+// less than this by the cost of sending each pixel 8 times.
+#define DATA_CLK_HZ 20000000
+
 static inline uint32_t gamma_correct_565_888(uint16_t pix) {
     uint32_t r_gamma = pix & 0xf800u;
     r_gamma *= r_gamma;
@@ -34,6 +57,157 @@ static inline uint32_t gamma_correct_565_888(uint16_t pix) {
     return (b_gamma >> 2 << 16) | (g_gamma >> 14 << 8) | (r_gamma >> 24 << 0);
 }
 
+#if HUB75_DMA_REFRESH
+
+// Number of panels chained together. The image is scrolled across all of
+// them.
+#ifndef N_PANELS
+#define N_PANELS 1
+#endif
+
+#define FB_WIDTH (WIDTH * N_PANELS)
+
+// Do the gamma correction and bit plane conversion on core 1, so core 0 can
+// get on with drawing the next frame
+#ifndef CONVERT_ON_CORE1
+#define CONVERT_ON_CORE1 1
+#endif
+
+// Pack the planes one bit at a time, to check hub75_planes_pack()
+static void planes_pack_reference(const uint32_t *rgb, uint32_t *out) {
+    const uint rows = HEIGHT / 2;
+    for (uint row = 0; row < rows; ++row) {
+        for (uint p = 0; p < N_PLANES; ++p) {
+            uint bit = 8 - N_PLANES + p;
+            *out++ = WIDTH - 1;
+            for (uint x = 0; x < WIDTH; x += 4) {
+                uint32_t word = 0;
+                for (uint i = 0; i < 4; ++i) {
+                    uint32_t top = rgb[row * WIDTH + x + i];
+                    uint32_t bottom = rgb[(row + rows) * WIDTH + x + i];
+                    uint32_t pixel = ((top >> bit) & 1u) |
+                                     ((top >> (bit + 8)) & 1u) << 1 |
+                                     ((top >> (bit + 16)) & 1u) << 2 |
+                                     ((bottom >> bit) & 1u) << 3 |
+                                     ((bottom >> (bit + 8)) & 1u) << 4 |
+                                     ((bottom >> (bit + 16)) & 1u) << 5;
+                    word |= pixel << (8 * i);
+                }
+                *out++ = word;
+            }
+        }
+    }
+}
+
+// Check the packers against the reference, and time converting one panel's
+// worth of image from RGB565: gamma correcting each pixel as the CPU refresh
+// does then packing the planes, versus the lookup tables hub75_fb uses
+static void check_planes_pack(void) {
+    const uint rows = HEIGHT / 2;
+    const uint32_t frame_words = hub75_planes_frame_words(WIDTH, rows, N_PLANES);
+    const uint16_t *img = (const uint16_t*)mountains_128x64;
+    uint32_t *gc_image = malloc(WIDTH * HEIGHT * sizeof(uint32_t));
+    uint32_t *expected = malloc(frame_words * sizeof(uint32_t));
+    uint32_t *planes = malloc(frame_words * sizeof(uint32_t));
+    static hub75_planes_gamma_t gamma;
+    hard_assert(gc_image && expected && planes);
+
+    for (uint i = 0; i < WIDTH * HEIGHT; ++i) {
+        gc_image[i] = gamma_correct_565_888(img[i]);
+    }
+    planes_pack_reference(gc_image, expected);
+
+    uint32_t start = time_us_32();
+    for (uint i = 0; i < WIDTH * HEIGHT; ++i) {
+        gc_image[i] = gamma_correct_565_888(img[i]);
+    }
+    hub75_planes_pack(gc_image, WIDTH, rows, N_PLANES, planes);
+    uint32_t pack_us = time_us_32() - start;
+    bool pack_ok = !memcmp(planes, expected, frame_words * sizeof(uint32_t));
+
+    hub75_planes_gamma_init(&gamma, gamma_correct_565_888);
+    memset(planes, 0, frame_words * sizeof(uint32_t));
+    start = time_us_32();
+    hub75_planes_pack_rows_565(img, WIDTH, rows, N_PLANES, &gamma, 0, rows, planes);
+    uint32_t pack_565_us = time_us_32() - start;
+    bool pack_565_ok = !memcmp(planes, expected, frame_words * sizeof(uint32_t));
+
+    printf("Converting a %dx%d frame to %d planes: gamma then pack %u us (%s), lookup tables %u us (%s)\n",
+           WIDTH, HEIGHT, N_PLANES, (uint)pack_us, pack_ok ? "ok" : "MISMATCH",
+           (uint)pack_565_us, pack_565_ok ? "ok" : "MISMATCH");
+    free(planes);
+    free(expected);
+    free(gc_image);
+}
+
+// Draw the image scrolled left by `scroll` pixels, repeated across the chain
+static void draw_frame(uint16_t *fb, uint scroll) {
+    const uint16_t *img = (const uint16_t*)mountains_128x64;
+    for (uint y = 0; y < HEIGHT; ++y) {
+        for (uint x = 0; x < FB_WIDTH; ++x) {
+            fb[y * FB_WIDTH + x] = img[y * WIDTH + (x + scroll) % WIDTH];
+        }
+    }
+}
+
+int main() {
+    stdio_init_all();
+
+    check_planes_pack();
+
+    hub75_fb_config_t config = {
+            .pio = pio0,
+            .sm_data = 0,
+            .sm_row = 1,
+            .data_base_pin = DATA_BASE_PIN,
+            .clk_pin = CLK_PIN,
+            .rowsel_base_pin = ROWSEL_BASE_PIN,
+            .rowsel_n_pins = ROWSEL_N_PINS,
+            .strobe_pin = STROBE_PIN,
+            .width = FB_WIDTH,
+            .height = HEIGHT,
+            .n_planes = N_PLANES,
+            .bcm_base_cycles = BCM_BASE_CYCLES,
+            .data_clk_hz = DATA_CLK_HZ,
+            .to_rgb888 = gamma_correct_565_888,
+            .convert_on_core1 = CONVERT_ON_CORE1,
+    };
+    hub75_fb_init(&config);
+    printf("DMA refresh: %d panel%s, %d planes, conversion on core %d\n", N_PANELS, N_PANELS > 1 ? "s" : "",
+           N_PLANES, CONVERT_ON_CORE1);
+
+    uint sys_mhz = clock_get_hz(clk_sys) / 1000000;
+    hub75_fb_stats_t last;
+    hub75_fb_get_stats(&last);
+    uint64_t last_us = time_us_64();
+    uint scroll = 0;
+    while (1) {
+        draw_frame(hub75_fb_back_buffer(), scroll);
+        scroll = (scroll + 1) % WIDTH;
+        hub75_fb_swap();
+
+        uint64_t now_us = time_us_64();
+        if (now_us - last_us >= 1000000) {
+            hub75_fb_stats_t now;
+            hub75_fb_get_stats(&now);
+            uint32_t n = now.frames - last.frames;
+            uint64_t elapsed_us = now_us - last_us;
+            // The output enable pulses add up to on_cycles per frame. The
+            // rest of the time goes on latching, and on waiting for the data
+            // state machine when a row takes longer to shift in than the
+            // previous plane is shown for.
+            uint64_t on_permille = (uint64_t)now.on_cycles * n * 1000 / (elapsed_us * sys_mhz);
+            printf("Refresh %u Hz, duty cycle %u.%u%%, %u frames/s, conversion %u us\n",
+                   (uint)(n * 1000000ull / elapsed_us), (uint)(on_permille / 10), (uint)(on_permille % 10),
+                   (uint)((now.swaps - last.swaps) * 1000000ull / elapsed_us), (uint)now.convert_us);
+            last = now;
+            last_us = now_us;
+        }
+    }
+}
+
+#else
+
 int main() {
     stdio_init_all();
 
@@ -76,3 +250,5 @@ int main() {
     }
 
 }
+
+#endif
@@ -0,0 +1,192 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdlib.h>
+
+#include "pico/multicore.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hub75.pio.h"
+
+#include "hub75_fb.h"
+#include "hub75_planes.h"
+
+static hub75_fb_config_t fb_config;
+static uint rows;
+static uint32_t frame_words;
+
+static hub75_planes_gamma_t gamma_lut;
+
+// RGB565 buffers the application draws into. Only draw[0] is used unless
+// converting on core 1.
+static uint16_t *draw[2];
+static uint draw_index;
+// Whether core 1 is converting a frame we haven't had the ack for yet
+static bool convert_pending;
+
+static uint32_t *planes[2];
+static uint32_t *row_words;
+
+// The data control channel copies this into the data channel's read address
+// at the start of each refresh pass. Only dma_handler() writes it, after
+// noting the value the pass which has just started has read.
+static const uint32_t *volatile planes_read_addr;
+static const uint32_t *row_words_read_addr;
+// Planes to show from the next refresh pass on
+static const uint32_t *volatile planes_pending;
+// Planes being shown by the current refresh pass
+static const uint32_t *volatile planes_displayed;
+
+static uint data_chan;
+static uint data_ctrl_chan;
+static uint row_chan;
+static uint row_ctrl_chan;
+
+static volatile uint32_t frames;
+static volatile uint32_t swaps;
+static volatile uint32_t convert_us;
+
+void __isr hub75_fb_dma_handler() {
+    dma_hw->ints0 = 1u << data_chan;
+    frames++;
+    // The data channel has finished a pass, and the control channel has
+    // already restarted it from planes_read_addr. It won't be read again
+    // until the end of this pass, so this is where to switch buffers.
+    planes_displayed = planes_read_addr;
+    planes_read_addr = planes_pending;
+}
+
+// Convert a frame into the plane buffer which isn't on display, and wait for
+// the DMA to switch over to it
+static void convert_and_show(const uint16_t *src) {
+    uint32_t *dst = planes[planes_displayed == planes[0]];
+    uint32_t start = time_us_32();
+    hub75_planes_pack_rows_565(src, fb_config.width, rows, fb_config.n_planes, &gamma_lut, 0, rows, dst);
+    convert_us = time_us_32() - start;
+    planes_pending = dst;
+    while (planes_displayed != dst) {
+        tight_loop_contents();
+    }
+    swaps++;
+}
+
+static void core1_convert_loop(void) {
+    while (true) {
+        uint index = multicore_fifo_pop_blocking();
+        convert_and_show(draw[index]);
+        multicore_fifo_push_blocking(index);
+    }
+}
+
+// Stream the planes to the data state machine, and the row words to the row
+// state machine, over and over. Each has a control channel which resets its
+// read address when it finishes, so the processor isn't involved at all.
+static void dma_init(PIO pio, uint sm_data, uint sm_row) {
+    data_chan = dma_claim_unused_channel(true);
+    data_ctrl_chan = dma_claim_unused_channel(true);
+    row_chan = dma_claim_unused_channel(true);
+    row_ctrl_chan = dma_claim_unused_channel(true);
+
+    dma_channel_config c = dma_channel_get_default_config(data_chan);
+    channel_config_set_dreq(&c, pio_get_dreq(pio, sm_data, true));
+    channel_config_set_chain_to(&c, data_ctrl_chan);
+    dma_channel_configure(data_chan, &c, &pio->txf[sm_data], NULL, frame_words, false);
+
+    c = dma_channel_get_default_config(row_chan);
+    channel_config_set_dreq(&c, pio_get_dreq(pio, sm_row, true));
+    channel_config_set_chain_to(&c, row_ctrl_chan);
+    dma_channel_configure(row_chan, &c, &pio->txf[sm_row], NULL, rows * fb_config.n_planes, false);
+
+    c = dma_channel_get_default_config(data_ctrl_chan);
+    channel_config_set_read_increment(&c, false);
+    dma_channel_configure(data_ctrl_chan, &c, &dma_hw->ch[data_chan].al3_read_addr_trig, &planes_read_addr, 1,
+                          false);
+
+    c = dma_channel_get_default_config(row_ctrl_chan);
+    channel_config_set_read_increment(&c, false);
+    dma_channel_configure(row_ctrl_chan, &c, &dma_hw->ch[row_chan].al3_read_addr_trig, &row_words_read_addr, 1,
+                          false);
+
+    // One interrupt per refresh pass, to count them and swap buffers
+    dma_channel_set_irq0_enabled(data_chan, true);
+    irq_set_exclusive_handler(DMA_IRQ_0, hub75_fb_dma_handler);
+    irq_set_enabled(DMA_IRQ_0, true);
+
+    dma_start_channel_mask((1u << data_ctrl_chan) | (1u << row_ctrl_chan));
+}
+
+void hub75_fb_init(const hub75_fb_config_t *config) {
+    fb_config = *config;
+    rows = config->height / 2;
+    hard_assert(rows <= (1u << config->rowsel_n_pins));
+    hard_assert(config->width % 4 == 0);
+    hard_assert(config->n_planes >= 1 && config->n_planes <= HUB75_PLANES_MAX);
+    frame_words = hub75_planes_frame_words(config->width, rows, config->n_planes);
+
+    hub75_planes_gamma_init(&gamma_lut, config->to_rgb888);
+
+    uint n_draw = config->convert_on_core1 ? 2 : 1;
+    for (uint i = 0; i < n_draw; ++i) {
+        draw[i] = calloc(config->width * config->height, sizeof(uint16_t));
+        hard_assert(draw[i]);
+    }
+    for (uint i = 0; i < 2; ++i) {
+        planes[i] = malloc(frame_words * sizeof(uint32_t));
+        hard_assert(planes[i]);
+    }
+    row_words = malloc(rows * config->n_planes * sizeof(uint32_t));
+    hard_assert(row_words);
+    hub75_planes_row_words(rows, config->n_planes, config->bcm_base_cycles, row_words);
+    row_words_read_addr = row_words;
+
+    // Start off showing a blank frame
+    hub75_planes_pack_rows_565(draw[0], config->width, rows, config->n_planes, &gamma_lut, 0, rows, planes[0]);
+    planes_read_addr = planes_pending = planes_displayed = planes[0];
+
+    // Two system clocks per pixel clock
+    uint sys_hz = clock_get_hz(clk_sys);
+    uint data_div = (sys_hz + 2 * config->data_clk_hz - 1) / (2 * config->data_clk_hz);
+
+    PIO pio = config->pio;
+    uint data_prog_offs = pio_add_program(pio, &hub75_data_planes_program);
+    uint row_prog_offs = pio_add_program(pio, &hub75_row_planes_program);
+    hub75_data_planes_program_init(pio, config->sm_data, data_prog_offs, config->data_base_pin, config->clk_pin,
+                                   (float)data_div);
+    hub75_row_planes_program_init(pio, config->sm_row, row_prog_offs, config->rowsel_base_pin,
+                                  config->rowsel_n_pins, config->strobe_pin);
+    dma_init(pio, config->sm_data, config->sm_row);
+
+    if (config->convert_on_core1) {
+        multicore_launch_core1(core1_convert_loop);
+    }
+}
+
+uint16_t *hub75_fb_back_buffer(void) {
+    return draw[draw_index];
+}
+
+void hub75_fb_swap(void) {
+    if (!fb_config.convert_on_core1) {
+        convert_and_show(draw[0]);
+        return;
+    }
+    // Wait for the previous frame, so the buffer it was drawn in is free to
+    // draw the next one in
+    if (convert_pending) {
+        multicore_fifo_pop_blocking();
+    }
+    multicore_fifo_push_blocking(draw_index);
+    convert_pending = true;
+    draw_index ^= 1;
+}
+
+void hub75_fb_get_stats(hub75_fb_stats_t *stats) {
+    stats->frames = frames;
+    stats->swaps = swaps;
+    stats->convert_us = convert_us;
+    stats->on_cycles = hub75_planes_on_cycles(rows, fb_config.n_planes, fb_config.bcm_base_cycles);
+}
@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _HUB75_FB_H
+#define _HUB75_FB_H
+
+// Double buffered framebuffer for HUB75 panels, refreshed by DMA.
+//
+// The application draws RGB565 pixels into the back buffer, then calls
+// hub75_fb_swap(). That converts the back buffer, once, into gamma corrected
+// bit planes (see hub75_planes.h) in whichever of the two plane buffers isn't
+// on display, and switches the DMA over to it at the end of the current
+// refresh pass, so a frame is never shown half old and half new.
+//
+// If convert_on_core1 is set, the conversion runs on core 1 and
+// hub75_fb_swap() returns straight away, handing the application a second
+// back buffer to draw the next frame into. It only waits if the previous
+// conversion hasn't finished yet. This uses the inter-core FIFO, so core 1
+// can't be used for anything else.
+//
+// Several panels can be chained, data out to data in, by making the width
+// the total width of the chain. The chain is treated as one wide panel.
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+typedef struct hub75_fb_config {
+    PIO pio;
+    uint sm_data;
+    uint sm_row;
+    uint data_base_pin;
+    uint clk_pin;
+    uint rowsel_base_pin;
+    uint rowsel_n_pins;
+    // LATCH, with OEn on the next pin
+    uint strobe_pin;
+    // total width of the chain of panels, a multiple of 4
+    uint width;
+    uint height;
+    // 1 to 8
+    uint n_planes;
+    // output enable pulse width of the least significant plane, in system
+    // clock cycles
+    uint bcm_base_cycles;
+    // maximum pixel clock
+    uint data_clk_hz;
+    // RGB565 to RGB888 (red in the least significant byte), with gamma
+    // correction. This is only used to build a lookup table.
+    uint32_t (*to_rgb888)(uint16_t);
+    bool convert_on_core1;
+} hub75_fb_config_t;
+
+typedef struct hub75_fb_stats {
+    // refresh passes started
+    uint32_t frames;
+    // frames which have been swapped onto the display
+    uint32_t swaps;
+    // time the last conversion to bit planes took
+    uint32_t convert_us;
+    // output enable cycles per refresh pass
+    uint32_t on_cycles;
+} hub75_fb_stats_t;
+
+// Allocate the buffers, and start refreshing the panel with a blank frame
+void hub75_fb_init(const hub75_fb_config_t *config);
+
+// The buffer to draw the next frame into, width * height pixels. The top
+// half of the display is driven by R0 G0 B0, and the bottom half by R1 G1 B1.
+uint16_t *hub75_fb_back_buffer(void);
+
+// Show the back buffer from the next refresh pass on
+void hub75_fb_swap(void);
+
+void hub75_fb_get_stats(hub75_fb_stats_t *stats);
+
+#endif
@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "hub75_planes.h"
+
+// Spread the 4 bits of n out to bits 0, 8, 16 and 24. The copies of n made by
+// the multiply don't overlap, so there are no carries.
+static inline uint32_t spread4(uint32_t n) {
+    return (n * 0x00204081u) & 0x01010101u;
+}
+
+// Transpose a 4x4 matrix of bytes, so byte j of w[i] ends up in byte i of w[j]
+static inline void transpose4x4_bytes(uint32_t w[4]) {
+    uint32_t t;
+    t = ((w[0] >> 8) ^ w[1]) & 0x00ff00ffu;
+    w[0] ^= t << 8;
+    w[1] ^= t;
+    t = ((w[2] >> 8) ^ w[3]) & 0x00ff00ffu;
+    w[2] ^= t << 8;
+    w[3] ^= t;
+    t = ((w[0] >> 16) ^ w[2]) & 0x0000ffffu;
+    w[0] ^= t << 16;
+    w[2] ^= t;
+    t = ((w[1] >> 16) ^ w[3]) & 0x0000ffffu;
+    w[1] ^= t << 16;
+    w[3] ^= t;
+}
+
+// Write out 4 pixels' worth of planes, given lo[i] and hi[i] with pixel i's
+// pixel clock byte for planes 0-3 and 4-7, one plane per byte
+static inline void put_pixels(uint32_t lo[4], uint32_t hi[4], uint32_t n_planes, uint32_t plane_words,
+                              uint32_t *out) {
+    // After this, lo[p] has plane p for the 4 pixels, one per byte
+    transpose4x4_bytes(lo);
+    transpose4x4_bytes(hi);
+    // The planes we keep are the top n_planes bits of each channel
+    const uint32_t first_plane = HUB75_PLANES_MAX - n_planes;
+    for (uint32_t p = 0; p < n_planes; p++) {
+        uint32_t bit = first_plane + p;
+        out[p * plane_words] = bit < 4 ? lo[bit] : hi[bit - 4];
+    }
+}
+
+static inline void put_headers(uint32_t width, uint32_t n_planes, uint32_t plane_words, uint32_t *out) {
+    for (uint32_t p = 0; p < n_planes; p++) {
+        out[p * plane_words] = width - 1;
+    }
+}
+
+void hub75_planes_pack_rows(const uint32_t *rgb, uint32_t width, uint32_t rows, uint32_t n_planes,
+                            uint32_t first_row, uint32_t n_rows, uint32_t *planes) {
+    const uint32_t plane_words = 1 + width / 4;
+    for (uint32_t row = first_row; row < first_row + n_rows; row++) {
+        const uint32_t *top = rgb + row * width;
+        const uint32_t *bottom = rgb + (row + rows) * width;
+        uint32_t *out = planes + row * n_planes * plane_words;
+        put_headers(width, n_planes, plane_words, out);
+        for (uint32_t x = 0; x < width; x += 4) {
+            uint32_t lo[4], hi[4];
+            for (uint32_t i = 0; i < 4; i++) {
+                uint32_t t = top[x + i];
+                uint32_t b = bottom[x + i];
+                lo[i] = spread4(t & 0xfu) |
+                        spread4((t >> 8) & 0xfu) << 1 |
+                        spread4((t >> 16) & 0xfu) << 2 |
+                        spread4(b & 0xfu) << 3 |
+                        spread4((b >> 8) & 0xfu) << 4 |
+                        spread4((b >> 16) & 0xfu) << 5;
+                hi[i] = spread4((t >> 4) & 0xfu) |
+                        spread4((t >> 12) & 0xfu) << 1 |
+                        spread4((t >> 20) & 0xfu) << 2 |
+                        spread4((b >> 4) & 0xfu) << 3 |
+                        spread4((b >> 12) & 0xfu) << 4 |
+                        spread4((b >> 20) & 0xfu) << 5;
+            }
+            put_pixels(lo, hi, n_planes, plane_words, out + 1 + x / 4);
+        }
+    }
+}
+
+void hub75_planes_pack(const uint32_t *rgb, uint32_t width, uint32_t rows, uint32_t n_planes, uint32_t *planes) {
+    hub75_planes_pack_rows(rgb, width, rows, n_planes, 0, rows, planes);
+}
+
+static inline void spread_channel(uint32_t value, uint32_t channel, uint32_t out[2]) {
+    out[0] = spread4(value & 0xfu) << channel;
+    out[1] = spread4((value >> 4) & 0xfu) << channel;
+}
+
+void hub75_planes_gamma_init(hub75_planes_gamma_t *gamma, uint32_t (*to_rgb888)(uint16_t)) {
+    for (uint32_t v = 0; v < 32; v++) {
+        spread_channel(to_rgb888((uint16_t)(v << 11)) & 0xffu, 0, gamma->r[v]);
+        spread_channel((to_rgb888((uint16_t)v) >> 16) & 0xffu, 2, gamma->b[v]);
+    }
+    for (uint32_t v = 0; v < 64; v++) {
+        spread_channel((to_rgb888((uint16_t)(v << 5)) >> 8) & 0xffu, 1, gamma->g[v]);
+    }
+}
+
+void hub75_planes_pack_rows_565(const uint16_t *rgb565, uint32_t width, uint32_t rows, uint32_t n_planes,
+                                const hub75_planes_gamma_t *gamma, uint32_t first_row, uint32_t n_rows,
+                                uint32_t *planes) {
+    const uint32_t plane_words = 1 + width / 4;
+    for (uint32_t row = first_row; row < first_row + n_rows; row++) {
+        const uint16_t *top = rgb565 + row * width;
+        const uint16_t *bottom = rgb565 + (row + rows) * width;
+        uint32_t *out = planes + row * n_planes * plane_words;
+        put_headers(width, n_planes, plane_words, out);
+        for (uint32_t x = 0; x < width; x += 4) {
+            uint32_t lo[4], hi[4];
+            for (uint32_t i = 0; i < 4; i++) {
+                const uint32_t *tr = gamma->r[top[x + i] >> 11];
+                const uint32_t *tg = gamma->g[(top[x + i] >> 5) & 0x3fu];
+                const uint32_t *tb = gamma->b[top[x + i] & 0x1fu];
+                const uint32_t *br = gamma->r[bottom[x + i] >> 11];
+                const uint32_t *bg = gamma->g[(bottom[x + i] >> 5) & 0x3fu];
+                const uint32_t *bb = gamma->b[bottom[x + i] & 0x1fu];
+                lo[i] = tr[0] | tg[0] | tb[0] | (br[0] | bg[0] | bb[0]) << 3;
+                hi[i] = tr[1] | tg[1] | tb[1] | (br[1] | bg[1] | bb[1]) << 3;
+            }
+            put_pixels(lo, hi, n_planes, plane_words, out + 1 + x / 4);
+        }
+    }
+}
+
+void hub75_planes_row_words(uint32_t rows, uint32_t n_planes, uint32_t base_cycles, uint32_t *words) {
+    for (uint32_t row = 0; row < rows; row++) {
+        for (uint32_t p = 0; p < n_planes; p++) {
+            *words++ = row | ((base_cycles << p) - 1) << 5;
+        }
+    }
+}
+
+uint32_t hub75_planes_on_cycles(uint32_t rows, uint32_t n_planes, uint32_t base_cycles) {
+    // The planes add up to (2^n_planes - 1) times the base
+    return rows * ((1u << n_planes) - 1) * base_cycles;
+}
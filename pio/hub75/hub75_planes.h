@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _HUB75_PLANES_H
+#define _HUB75_PLANES_H
+
+// Bit plane framebuffer for DMA refresh of a HUB75 panel.
+//
+// The panel shows one bit of each colour at a time, so to refresh it from DMA
+// the framebuffer is stored the way it's sent: for each scan row, for each bit
+// plane, a header word (the number of pixels in the row, minus 1) followed by
+// width / 4 data words. Each data byte is one pixel clock, with R0 G0 B0 R1
+// G1 B1 (the upper and lower halves of the screen) in bits 0 to 5, and the
+// first pixel in the least significant byte. This is what the
+// hub75_data_planes program in hub75.pio expects.
+//
+// The row state machine gets one word for each row and plane: the row select
+// in the low 5 bits, and the output enable pulse width (minus 1) above that.
+// Plane p is shown for base_cycles << p, so the planes are weighted in
+// ascending powers of 2 (binary code modulation).
+//
+// Fewer than 8 planes can be used, to trade colour depth for refresh rate, in
+// which case the least significant bits are dropped.
+//
+// RGB565 images can be converted directly, with the gamma correction and the
+// spreading of each channel's bits out to one per plane done by table lookup,
+// so the conversion is cheap enough to run once per frame. hub75.c checks
+// it at startup against packing the planes one bit at a time.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define HUB75_PLANES_MAX 8
+
+// Number of words in a packed frame. width must be a multiple of 4.
+static inline uint32_t hub75_planes_frame_words(uint32_t width, uint32_t rows, uint32_t n_planes) {
+    return rows * n_planes * (1 + width / 4);
+}
+
+// Pack an image of width x (2 * rows) pixels into bit planes. Pixels are
+// RGB888 with red in the least significant byte (as gamma_correct_565_888() in
+// hub75.c produces). Scan row y shows image rows y and y + rows.
+void hub75_planes_pack(const uint32_t *rgb, uint32_t width, uint32_t rows, uint32_t n_planes, uint32_t *planes);
+
+// As hub75_planes_pack(), but only for scan rows first_row to first_row +
+// n_rows - 1, so the work can be split up
+void hub75_planes_pack_rows(const uint32_t *rgb, uint32_t width, uint32_t rows, uint32_t n_planes,
+                            uint32_t first_row, uint32_t n_rows, uint32_t *planes);
+
+// Gamma corrected bits for each RGB565 channel value: for each plane, the
+// channel's bit is at bit 8 * plane (+ 1 for green, + 2 for blue), with
+// planes 0-3 in lo and 4-7 in hi.
+typedef struct hub75_planes_gamma {
+    uint32_t r[32][2];
+    uint32_t g[64][2];
+    uint32_t b[32][2];
+} hub75_planes_gamma_t;
+
+// Build the gamma tables from a function which converts an RGB565 pixel to
+// RGB888, with red in the least significant byte
+void hub75_planes_gamma_init(hub75_planes_gamma_t *gamma, uint32_t (*to_rgb888)(uint16_t));
+
+// As hub75_planes_pack_rows(), but from an RGB565 image, gamma correcting
+// with the given tables
+void hub75_planes_pack_rows_565(const uint16_t *rgb565, uint32_t width, uint32_t rows, uint32_t n_planes,
+                                const hub75_planes_gamma_t *gamma, uint32_t first_row, uint32_t n_rows,
+                                uint32_t *planes);
+
+// Fill in the rows * n_planes words for the row state machine
+void hub75_planes_row_words(uint32_t rows, uint32_t n_planes, uint32_t base_cycles, uint32_t *words);
+
+// Number of cycles the output is enabled for in each frame, for working out
+// the duty cycle
+uint32_t hub75_planes_on_cycles(uint32_t rows, uint32_t n_planes, uint32_t base_cycles);
+
+#endif
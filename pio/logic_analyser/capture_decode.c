@@ -0,0 +1,311 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "capture_decode.h"
+
+// 1-Wire timings, in microseconds (standard speed)
+#define ONEWIRE_RESET_MIN_US 400
+#define ONEWIRE_ZERO_MIN_US 15
+#define ONEWIRE_PRESENCE_MAX_DELAY_US 75
+
+void capture_view_init(capture_view_t *view, const uint32_t *words, uint32_t n_samples, uint32_t pin_count) {
+    view->words = words;
+    view->n_samples = n_samples;
+    view->pin_count = pin_count;
+    view->samples_per_word = 32 / pin_count;
+    view->unused_bits = 32 - view->samples_per_word * pin_count;
+    view->sample_mask = pin_count >= 32 ? 0xffffffffu : (1u << pin_count) - 1;
+    // Multiplying a pin mask by this copies it into every sample slot
+    view->replicate = 0;
+    for (uint32_t i = 0; i < view->samples_per_word; ++i) {
+        view->replicate |= 1u << (i * pin_count);
+    }
+    view->idle = view->sample_mask;
+}
+
+uint32_t capture_view_next_edge(const capture_view_t *view, uint32_t pin_mask, uint32_t from) {
+    if (from >= view->n_samples) {
+        return view->n_samples;
+    }
+    const uint32_t pin_count = view->pin_count;
+    const uint32_t unused_bits = view->unused_bits;
+    const uint32_t slot_mask = (pin_mask & view->sample_mask) * view->replicate << unused_bits;
+    const uint32_t first_slot_mask = view->sample_mask << unused_bits;
+    uint32_t word_index = from / view->samples_per_word;
+    uint32_t end_word = (view->n_samples + view->samples_per_word - 1) / view->samples_per_word;
+    // Ignore samples before `from` in the first word
+    uint32_t start_mask = ~((1u << (unused_bits + (from % view->samples_per_word) * pin_count)) - 1);
+    // Before the very first sample, the pins were idle
+    uint32_t prev_word = word_index ? view->words[word_index - 1] : view->idle << (32 - pin_count);
+    for (; word_index < end_word; ++word_index) {
+        uint32_t word = view->words[word_index];
+        // Line each sample up with the one before it: the last sample of the
+        // previous word goes in the first slot
+        uint32_t last_sample = prev_word >> (32 - pin_count);
+        uint32_t shifted = pin_count >= 32 ? last_sample
+                                           : ((word << pin_count) & ~first_slot_mask) | (last_sample << unused_bits);
+        uint32_t diff = (word ^ shifted) & slot_mask & start_mask;
+        if (diff) {
+            uint32_t sample = word_index * view->samples_per_word +
+                              ((uint32_t)__builtin_ctz(diff) - unused_bits) / pin_count;
+            return sample < view->n_samples ? sample : view->n_samples;
+        }
+        prev_word = word;
+        start_mask = ~0u;
+    }
+    return view->n_samples;
+}
+
+static inline bool add_event(capture_event_t *events, size_t *n, size_t max_events, uint32_t sample, uint8_t type,
+                             uint8_t flags, uint8_t data, uint8_t data2) {
+    if (*n >= max_events) {
+        return false;
+    }
+    capture_event_t *e = &events[(*n)++];
+    e->sample = sample;
+    e->type = type;
+    e->flags = flags;
+    e->data = data;
+    e->data2 = data2;
+    return true;
+}
+
+// Centre of bit `bit` of a frame starting at `start`, with the start bit
+// being bit 0
+static inline uint32_t bit_centre(uint32_t start, uint32_t samples_per_bit, uint32_t bit) {
+    return start + (uint32_t)(((uint64_t)(2 * bit + 1) * samples_per_bit) >> 17);
+}
+
+size_t capture_decode_uart(const capture_view_t *view, const capture_uart_config_t *config,
+                           capture_event_t *events, size_t max_events) {
+    size_t n = 0;
+    uint32_t pin_mask = 1u << config->pin;
+    uint32_t parity_bits = config->parity != CAPTURE_UART_PARITY_NONE;
+    uint32_t stop_bit = 1 + config->data_bits + parity_bits;
+    uint32_t sample = 0;
+    for (;;) {
+        uint32_t start = capture_view_next_edge(view, pin_mask, sample);
+        if (start >= view->n_samples) {
+            break;
+        }
+        sample = start + 1;
+        if (capture_view_pin(view, start, config->pin)) {
+            // Rising edge; can't be a start bit
+            continue;
+        }
+        uint32_t stop_centre = bit_centre(start, config->samples_per_bit, stop_bit);
+        if (stop_centre >= view->n_samples) {
+            break;
+        }
+        if (capture_view_pin(view, bit_centre(start, config->samples_per_bit, 0), config->pin)) {
+            // Glitch
+            continue;
+        }
+        uint32_t data = 0;
+        for (uint32_t bit = 0; bit < config->data_bits; ++bit) {
+            data |= (uint32_t)capture_view_pin(view, bit_centre(start, config->samples_per_bit, bit + 1), config->pin) << bit;
+        }
+        uint8_t flags = 0;
+        if (parity_bits) {
+            uint32_t ones = (uint32_t)__builtin_popcount(data) +
+                            capture_view_pin(view, bit_centre(start, config->samples_per_bit, 1 + config->data_bits), config->pin);
+            if ((ones & 1u) != (config->parity == CAPTURE_UART_PARITY_ODD)) {
+                flags |= CAPTURE_EVENT_FLAG_PARITY_ERROR;
+            }
+        }
+        if (!capture_view_pin(view, stop_centre, config->pin)) {
+            flags |= CAPTURE_EVENT_FLAG_FRAMING_ERROR;
+        }
+        if (!add_event(events, &n, max_events, start, CAPTURE_EVENT_UART_BYTE, flags, (uint8_t)data, 0)) {
+            break;
+        }
+        // The next start bit can begin as soon as the stop bit has been seen
+        sample = stop_centre;
+    }
+    return n;
+}
+
+size_t capture_decode_spi(const capture_view_t *view, const capture_spi_config_t *config,
+                          capture_event_t *events, size_t max_events) {
+    size_t n = 0;
+    bool has_cs = config->cs != CAPTURE_DECODE_PIN_NONE;
+    bool has_miso = config->miso != CAPTURE_DECODE_PIN_NONE;
+    uint32_t pin_mask = (1u << config->sck) | (has_cs ? 1u << config->cs : 0);
+    // Modes 0 and 3 sample on the rising edge, 1 and 2 on the falling edge
+    bool sample_on_rising = ((config->mode >> 1) & 1u) == (config->mode & 1u);
+    // SCK idles at CPOL
+    capture_view_t v = *view;
+    v.idle = (v.idle & ~(1u << config->sck)) | ((config->mode >> 1) & 1u) << config->sck;
+    view = &v;
+    uint32_t prev = view->idle;
+    bool selected = !has_cs || !((prev >> config->cs) & 1u);
+    uint32_t bits = 0;
+    uint32_t mosi = 0;
+    uint32_t miso = 0;
+    uint32_t word_start = 0;
+    uint32_t sample = 0;
+    for (;;) {
+        sample = capture_view_next_edge(view, pin_mask, sample);
+        if (sample >= view->n_samples) {
+            break;
+        }
+        uint32_t cur = capture_view_sample(view, sample);
+        uint32_t changed = cur ^ prev;
+        if (has_cs && ((changed >> config->cs) & 1u)) {
+            selected = !((cur >> config->cs) & 1u);
+            uint8_t flags = 0;
+            if (!selected && bits) {
+                // Deselected part way through a word
+                flags = CAPTURE_EVENT_FLAG_INCOMPLETE;
+                if (!add_event(events, &n, max_events, word_start, CAPTURE_EVENT_SPI_WORD, flags, (uint8_t)mosi, (uint8_t)miso)) {
+                    break;
+                }
+            }
+            bits = mosi = miso = 0;
+            if (!add_event(events, &n, max_events, sample, selected ? CAPTURE_EVENT_SPI_SELECT : CAPTURE_EVENT_SPI_DESELECT,
+                           0, 0, 0)) {
+                break;
+            }
+        }
+        if (selected && ((changed >> config->sck) & 1u) && ((cur >> config->sck) & 1u) == sample_on_rising) {
+            uint32_t mosi_bit = (cur >> config->mosi) & 1u;
+            uint32_t miso_bit = has_miso ? (cur >> config->miso) & 1u : 0;
+            if (!bits) {
+                word_start = sample;
+            }
+            if (config->msb_first) {
+                mosi = mosi << 1 | mosi_bit;
+                miso = miso << 1 | miso_bit;
+            } else {
+                mosi |= mosi_bit << bits;
+                miso |= miso_bit << bits;
+            }
+            if (++bits == config->bits_per_word) {
+                if (!add_event(events, &n, max_events, word_start, CAPTURE_EVENT_SPI_WORD, 0, (uint8_t)mosi, (uint8_t)miso)) {
+                    break;
+                }
+                bits = mosi = miso = 0;
+            }
+        }
+        prev = cur;
+        ++sample;
+    }
+    return n;
+}
+
+size_t capture_decode_i2c(const capture_view_t *view, const capture_i2c_config_t *config,
+                          capture_event_t *events, size_t max_events) {
+    size_t n = 0;
+    uint32_t scl_bit = 1u << config->scl;
+    uint32_t sda_bit = 1u << config->sda;
+    uint32_t prev = view->idle;
+    bool in_transfer = false;
+    bool address_byte = false;
+    uint32_t bits = 0;
+    uint32_t byte = 0;
+    uint32_t byte_start = 0;
+    uint32_t sample = 0;
+    for (;;) {
+        sample = capture_view_next_edge(view, scl_bit | sda_bit, sample);
+        if (sample >= view->n_samples) {
+            break;
+        }
+        uint32_t cur = capture_view_sample(view, sample);
+        uint32_t changed = cur ^ prev;
+        if (changed & scl_bit) {
+            if ((cur & scl_bit) && in_transfer) {
+                // Data is valid while SCL is high
+                uint32_t bit = (cur & sda_bit) != 0;
+                if (bits < 8) {
+                    if (!bits) {
+                        byte_start = sample;
+                    }
+                    byte = byte << 1 | bit;
+                    ++bits;
+                } else {
+                    uint8_t type = address_byte ? CAPTURE_EVENT_I2C_ADDRESS : CAPTURE_EVENT_I2C_DATA;
+                    uint8_t flags = bit ? CAPTURE_EVENT_FLAG_NAK : 0;
+                    if (!add_event(events, &n, max_events, byte_start, type, flags, (uint8_t)byte, 0)) {
+                        break;
+                    }
+                    address_byte = false;
+                    bits = byte = 0;
+                }
+            }
+        } else if ((cur & scl_bit) && (prev & scl_bit)) {
+            // SDA changing while SCL is high is a start or stop condition
+            bool start = !(cur & sda_bit);
+            if (!add_event(events, &n, max_events, sample, start ? CAPTURE_EVENT_I2C_START : CAPTURE_EVENT_I2C_STOP,
+                           0, 0, 0)) {
+                break;
+            }
+            in_transfer = start;
+            address_byte = start;
+            bits = byte = 0;
+        }
+        prev = cur;
+        ++sample;
+    }
+    return n;
+}
+
+size_t capture_decode_onewire(const capture_view_t *view, const capture_onewire_config_t *config,
+                              capture_event_t *events, size_t max_events) {
+    size_t n = 0;
+    uint32_t pin_mask = 1u << config->pin;
+    uint32_t reset_min = (uint32_t)(((uint64_t)ONEWIRE_RESET_MIN_US * config->samples_per_us) >> 16);
+    uint32_t zero_min = (uint32_t)(((uint64_t)ONEWIRE_ZERO_MIN_US * config->samples_per_us) >> 16);
+    uint32_t presence_max_delay = (uint32_t)(((uint64_t)ONEWIRE_PRESENCE_MAX_DELAY_US * config->samples_per_us) >> 16);
+    bool after_reset = false;
+    uint32_t reset_end = 0;
+    uint32_t bits = 0;
+    uint32_t byte = 0;
+    uint32_t byte_start = 0;
+    uint32_t sample = 0;
+    for (;;) {
+        // Every slot starts with the bus being pulled low
+        uint32_t fall = capture_view_next_edge(view, pin_mask, sample);
+        if (fall >= view->n_samples) {
+            break;
+        }
+        if (capture_view_pin(view, fall, config->pin)) {
+            sample = fall + 1;
+            continue;
+        }
+        uint32_t rise = capture_view_next_edge(view, pin_mask, fall + 1);
+        if (rise >= view->n_samples) {
+            break;
+        }
+        sample = rise + 1;
+        uint32_t low = rise - fall;
+        bool ok;
+        if (low >= reset_min) {
+            ok = add_event(events, &n, max_events, fall, CAPTURE_EVENT_ONEWIRE_RESET, 0, 0, 0);
+            after_reset = true;
+            reset_end = rise;
+            bits = byte = 0;
+        } else if (after_reset && fall - reset_end <= presence_max_delay && low >= zero_min) {
+            ok = add_event(events, &n, max_events, fall, CAPTURE_EVENT_ONEWIRE_PRESENCE, 0, 0, 0);
+            after_reset = false;
+        } else {
+            after_reset = false;
+            uint32_t bit = low < zero_min;
+            if (!bits) {
+                byte_start = fall;
+            }
+            byte |= bit << bits;
+            ok = add_event(events, &n, max_events, fall, CAPTURE_EVENT_ONEWIRE_BIT, 0, (uint8_t)bit, 0);
+            if (ok && ++bits == 8) {
+                ok = add_event(events, &n, max_events, byte_start, CAPTURE_EVENT_ONEWIRE_BYTE, 0, (uint8_t)byte, 0);
+                bits = byte = 0;
+            }
+        }
+        if (!ok) {
+            break;
+        }
+    }
+    return n;
+}
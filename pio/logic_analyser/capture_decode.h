@@ -0,0 +1,144 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _CAPTURE_DECODE_H
+#define _CAPTURE_DECODE_H
+
+// Protocol decoders for logic analyser captures.
+//
+// These work directly on the packed capture format written by the `in pins,
+// n` program (32 / pin_count samples per word, left-justified, oldest sample
+// in the lowest used bits), and turn it into arrays of compact events.
+//
+// Rather than looking at every sample, the decoders search for the next edge
+// on the pins they care about a whole word at a time, by comparing each word
+// with a copy of itself shifted along by one sample. Only samples at edges,
+// and at the bit centres of asynchronous protocols, are examined
+// individually, so the cost depends mostly on how busy the bus is.
+//
+// Pins are given as indices into the capture (0 is the capture's pin_base),
+// not GPIO numbers.
+//
+// A capture armed on an edge starts with that edge, so the decoders take the
+// pins to have been at their idle levels before sample 0: high by default,
+// as for a UART, I2C or 1-Wire bus and an SPI chip select. The SPI decoder
+// takes SCK's idle level from the mode.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CAPTURE_DECODE_PIN_NONE 0xffu
+
+typedef struct capture_view {
+    const uint32_t *words;
+    uint32_t n_samples;
+    uint32_t pin_count;
+    uint32_t samples_per_word;
+    uint32_t unused_bits;
+    uint32_t sample_mask;
+    uint32_t replicate;
+    // The pin states before sample 0
+    uint32_t idle;
+} capture_view_t;
+
+enum capture_event_type {
+    CAPTURE_EVENT_UART_BYTE,
+    CAPTURE_EVENT_SPI_SELECT,
+    CAPTURE_EVENT_SPI_WORD,      // data is MOSI, data2 is MISO
+    CAPTURE_EVENT_SPI_DESELECT,
+    CAPTURE_EVENT_I2C_START,
+    CAPTURE_EVENT_I2C_ADDRESS,   // data is the address byte, including R/W in bit 0
+    CAPTURE_EVENT_I2C_DATA,
+    CAPTURE_EVENT_I2C_STOP,
+    CAPTURE_EVENT_ONEWIRE_RESET,
+    CAPTURE_EVENT_ONEWIRE_PRESENCE,
+    CAPTURE_EVENT_ONEWIRE_BIT,
+    CAPTURE_EVENT_ONEWIRE_BYTE,
+};
+
+#define CAPTURE_EVENT_FLAG_FRAMING_ERROR 0x01u
+#define CAPTURE_EVENT_FLAG_PARITY_ERROR  0x02u
+#define CAPTURE_EVENT_FLAG_NAK           0x04u
+#define CAPTURE_EVENT_FLAG_INCOMPLETE    0x08u
+
+typedef struct capture_event {
+    // Sample index where the frame, word or condition started
+    uint32_t sample;
+    uint8_t type;
+    uint8_t flags;
+    uint8_t data;
+    uint8_t data2;
+} capture_event_t;
+
+enum capture_uart_parity {
+    CAPTURE_UART_PARITY_NONE,
+    CAPTURE_UART_PARITY_EVEN,
+    CAPTURE_UART_PARITY_ODD,
+};
+
+typedef struct capture_uart_config {
+    uint8_t pin;
+    uint8_t data_bits;          // 5 to 8
+    uint8_t parity;             // enum capture_uart_parity
+    uint32_t samples_per_bit;   // 16.16 fixed point
+} capture_uart_config_t;
+
+typedef struct capture_spi_config {
+    uint8_t sck;
+    uint8_t mosi;
+    uint8_t miso;               // or CAPTURE_DECODE_PIN_NONE
+    uint8_t cs;                 // active low, or CAPTURE_DECODE_PIN_NONE
+    uint8_t mode;               // 0 to 3, as in CPOL << 1 | CPHA
+    uint8_t bits_per_word;      // 1 to 8
+    bool msb_first;
+} capture_spi_config_t;
+
+typedef struct capture_i2c_config {
+    uint8_t scl;
+    uint8_t sda;
+} capture_i2c_config_t;
+
+typedef struct capture_onewire_config {
+    uint8_t pin;
+    uint32_t samples_per_us;    // 16.16 fixed point
+} capture_onewire_config_t;
+
+void capture_view_init(capture_view_t *view, const uint32_t *words, uint32_t n_samples, uint32_t pin_count);
+
+// Set the pin states before sample 0, with the lowest pin in bit 0
+static inline void capture_view_set_idle(capture_view_t *view, uint32_t idle) {
+    view->idle = idle & view->sample_mask;
+}
+
+// Return the pin states for one sample, with the lowest pin in bit 0
+static inline uint32_t capture_view_sample(const capture_view_t *view, uint32_t sample) {
+    uint32_t word = view->words[sample / view->samples_per_word];
+    uint32_t shift = view->unused_bits + (sample % view->samples_per_word) * view->pin_count;
+    return (word >> shift) & view->sample_mask;
+}
+
+static inline bool capture_view_pin(const capture_view_t *view, uint32_t sample, uint32_t pin) {
+    return (capture_view_sample(view, sample) >> pin) & 1u;
+}
+
+// Return the first sample at or after `from` where any of the pins in
+// pin_mask differ from the previous sample (or for sample 0, the idle
+// levels), or n_samples if there isn't one
+uint32_t capture_view_next_edge(const capture_view_t *view, uint32_t pin_mask, uint32_t from);
+
+// Each decoder writes at most max_events events, and returns the number
+// written
+size_t capture_decode_uart(const capture_view_t *view, const capture_uart_config_t *config,
+                           capture_event_t *events, size_t max_events);
+size_t capture_decode_spi(const capture_view_t *view, const capture_spi_config_t *config,
+                          capture_event_t *events, size_t max_events);
+size_t capture_decode_i2c(const capture_view_t *view, const capture_i2c_config_t *config,
+                          capture_event_t *events, size_t max_events);
+size_t capture_decode_onewire(const capture_view_t *view, const capture_onewire_config_t *config,
+                              capture_event_t *events, size_t max_events);
+
+#endif
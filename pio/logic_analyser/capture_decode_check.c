@@ -0,0 +1,218 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Check the decoders in capture_decode.c against made up captures which, like
+// a capture armed on an edge, start at the first edge: a UART start bit, an
+// I2C start condition, an SPI chip select and a 1-Wire reset at sample 0.
+//
+// The captures are built in arrays, so the decoders can be tried on a PC:
+//
+//   cc -DPICO_NO_HARDWARE=1 capture_decode_check.c capture_decode.c
+//
+// A byte decoded wrongly, or a missed start or stop, fails the run.
+
+#include <stdio.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#define count_of(a) (sizeof(a)/sizeof((a)[0]))
+#endif
+
+#include "capture_decode.h"
+
+#define MAX_WORDS 1024
+
+static const char message[] = "Hello, logic analyser!";
+#define MESSAGE_LEN (sizeof(message) - 1)
+
+static uint32_t words[MAX_WORDS];
+static uint32_t n_samples;
+static uint32_t pin_count;
+static uint32_t state;
+static capture_event_t events[256];
+
+static uint32_t failures;
+
+static void check(const char *what, bool ok) {
+    if (!ok) {
+        printf("  %s is wrong\n", what);
+        failures++;
+    }
+}
+
+// Samples are packed as by `in pins, n`: left-justified, oldest lowest
+static void synth_start(uint32_t pins) {
+    memset(words, 0, sizeof(words));
+    n_samples = 0;
+    pin_count = pins;
+}
+
+static void synth_hold(uint32_t new_state, uint32_t samples) {
+    const uint32_t spw = 32 / pin_count;
+    const uint32_t unused = 32 - spw * pin_count;
+    state = new_state;
+    for (uint32_t i = 0; i < samples; ++i, ++n_samples) {
+        words[n_samples / spw] |= state << (unused + (n_samples % spw) * pin_count);
+    }
+}
+
+static void synth_pin(uint32_t pin, uint32_t value, uint32_t samples) {
+    synth_hold((state & ~(1u << pin)) | (value << pin), samples);
+}
+
+static void view_init(capture_view_t *view) {
+    capture_view_init(view, words, n_samples, pin_count);
+}
+
+// The data of the events of one type, as a string
+static bool events_spell_message(size_t n_events, uint8_t type) {
+    char got[64];
+    size_t n = 0;
+    for (size_t i = 0; i < n_events && n < sizeof(got) - 1; ++i) {
+        if (events[i].type == type) {
+            got[n++] = events[i].flags & ~CAPTURE_EVENT_FLAG_NAK ? '?' : (char)events[i].data;
+        }
+    }
+    got[n] = 0;
+    if (strcmp(got, message)) {
+        printf("  decoded \"%s\"\n", got);
+        return false;
+    }
+    return true;
+}
+
+// 8N1 at 16 samples per bit on a single pin, as logic_analyser_decode.c
+// captures it
+static void check_uart(void) {
+    synth_start(1);
+    state = 1;
+    for (uint32_t i = 0; i < MESSAGE_LEN; ++i) {
+        synth_pin(0, 0, 16);
+        for (uint32_t bit = 0; bit < 8; ++bit) {
+            synth_pin(0, ((uint8_t)message[i] >> bit) & 1u, 16);
+        }
+        synth_pin(0, 1, 16);
+    }
+    capture_view_t view;
+    view_init(&view);
+    check("first edge", capture_view_next_edge(&view, 1, 0) == 0);
+    capture_uart_config_t config = {.pin = 0, .data_bits = 8, .parity = CAPTURE_UART_PARITY_NONE,
+                                    .samples_per_bit = 16 << 16};
+    size_t n = capture_decode_uart(&view, &config, events, count_of(events));
+    check("bytes", events_spell_message(n, CAPTURE_EVENT_UART_BYTE));
+    check("first byte's sample", n && events[0].sample == 0);
+
+    // A line which idled low would have had no start bit at sample 0
+    capture_view_set_idle(&view, 0);
+    check("first edge, idle low", capture_view_next_edge(&view, 1, 0) > 0);
+}
+
+// Mode 1 (SCK idles low, data sampled on the falling edge), LSB first, with
+// SCK on pin 0, MOSI 1, MISO 2 and CS 3, selected at sample 0
+static void check_spi(void) {
+    synth_start(4);
+    state = 0;
+    for (uint32_t i = 0; i < MESSAGE_LEN; ++i) {
+        uint8_t c = (uint8_t)message[i];
+        for (uint32_t bit = 0; bit < 8; ++bit) {
+            synth_pin(0, 1, 2);
+            synth_hold((state & ~0x6u) | ((c >> bit) & 1u) << 1 | ((~c >> bit) & 1u) << 2, 2);
+            synth_pin(0, 0, 2);
+        }
+    }
+    synth_pin(3, 1, 4);
+    capture_view_t view;
+    view_init(&view);
+    capture_spi_config_t config = {.sck = 0, .mosi = 1, .miso = 2, .cs = 3, .mode = 1, .bits_per_word = 8,
+                                   .msb_first = false};
+    size_t n = capture_decode_spi(&view, &config, events, count_of(events));
+    check("select at sample 0", n && events[0].type == CAPTURE_EVENT_SPI_SELECT && events[0].sample == 0);
+    check("words", events_spell_message(n, CAPTURE_EVENT_SPI_WORD));
+    check("deselect", n && events[n - 1].type == CAPTURE_EVENT_SPI_DESELECT);
+}
+
+// SCL on pin 0 and SDA on pin 1, with SDA already low at sample 0: a start
+// condition, an address and the message
+static void check_i2c(void) {
+    synth_start(4);
+    state = 0x3;
+    synth_pin(1, 0, 4);
+    synth_pin(0, 0, 4);
+    for (uint32_t i = 0; i <= MESSAGE_LEN; ++i) {
+        uint8_t byte = i ? (uint8_t)message[i - 1] : 0x42 << 1;
+        for (int bit = 7; bit >= 0; --bit) {
+            synth_pin(1, (byte >> bit) & 1u, 2);
+            synth_pin(0, 1, 4);
+            synth_pin(0, 0, 2);
+        }
+        synth_pin(1, i == MESSAGE_LEN, 2);
+        synth_pin(0, 1, 4);
+        synth_pin(0, 0, 2);
+    }
+    synth_pin(1, 0, 2);
+    synth_pin(0, 1, 4);
+    synth_pin(1, 1, 4);
+    capture_view_t view;
+    view_init(&view);
+    capture_i2c_config_t config = {.scl = 0, .sda = 1};
+    size_t n = capture_decode_i2c(&view, &config, events, count_of(events));
+    check("start at sample 0", n && events[0].type == CAPTURE_EVENT_I2C_START && events[0].sample == 0);
+    check("address", n > 1 && events[1].type == CAPTURE_EVENT_I2C_ADDRESS && events[1].data == 0x42 << 1);
+    check("data", events_spell_message(n, CAPTURE_EVENT_I2C_DATA));
+    check("stop", n && events[n - 1].type == CAPTURE_EVENT_I2C_STOP);
+}
+
+// One sample per microsecond, with the reset pulse already going at sample 0
+static void check_onewire(void) {
+    synth_start(1);
+    state = 0;
+    synth_pin(0, 0, 480);
+    synth_pin(0, 1, 40);
+    synth_pin(0, 0, 120);
+    synth_pin(0, 1, 300);
+    for (uint32_t i = 0; i < MESSAGE_LEN; ++i) {
+        for (uint32_t bit = 0; bit < 8; ++bit) {
+            bool one = ((uint8_t)message[i] >> bit) & 1u;
+            synth_pin(0, 0, one ? 6 : 60);
+            synth_pin(0, 1, one ? 64 : 10);
+        }
+    }
+    capture_view_t view;
+    view_init(&view);
+    capture_onewire_config_t config = {.pin = 0, .samples_per_us = 1 << 16};
+    size_t n = capture_decode_onewire(&view, &config, events, count_of(events));
+    check("reset at sample 0", n && events[0].type == CAPTURE_EVENT_ONEWIRE_RESET && events[0].sample == 0);
+    check("presence", n > 1 && events[1].type == CAPTURE_EVENT_ONEWIRE_PRESENCE);
+    check("bytes", events_spell_message(n, CAPTURE_EVENT_ONEWIRE_BYTE));
+}
+
+typedef struct decode_check {
+    const char *name;
+    void (*run)(void);
+} decode_check_t;
+
+static const decode_check_t checks[] = {
+    {"UART", check_uart},
+    {"SPI", check_spi},
+    {"I2C", check_i2c},
+    {"1-Wire", check_onewire},
+};
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+#endif
+    puts("Capture decoder checks");
+    for (uint32_t i = 0; i < count_of(checks); ++i) {
+        uint32_t before = failures;
+        checks[i].run();
+        printf("%-8s %s\n", checks[i].name, failures == before ? "ok" : "FAILED");
+    }
+    printf("\n%s\n", failures ? "Capture decoder checks FAILED" : "All capture decoder checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,256 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+
+#include "capture_export.h"
+
+// VCD identifiers are single printable characters, one per pin
+#define VCD_FIRST_ID '!'
+
+// Text for each nibble of a bit plane, lowest bit (earliest sample) first
+static const char nibble_text[16][4] = {
+        {'_', '_', '_', '_'}, {'-', '_', '_', '_'}, {'_', '-', '_', '_'}, {'-', '-', '_', '_'},
+        {'_', '_', '-', '_'}, {'-', '_', '-', '_'}, {'_', '-', '-', '_'}, {'-', '-', '-', '_'},
+        {'_', '_', '_', '-'}, {'-', '_', '_', '-'}, {'_', '-', '_', '-'}, {'-', '-', '_', '-'},
+        {'_', '_', '-', '-'}, {'-', '_', '-', '-'}, {'_', '-', '-', '-'}, {'-', '-', '-', '-'},
+};
+
+void capture_transpose32(uint32_t rows[32]) {
+    // Swap the off-diagonal 16x16 blocks, then the off-diagonal 8x8 blocks
+    // within each of those, and so on down to single bits. m selects the low
+    // half of each group of 2j bits.
+    uint32_t m = 0x0000ffffu;
+    for (uint32_t j = 16; j; j >>= 1, m ^= m << j) {
+        for (uint32_t k = 0; k < 32; k = (k + j + 1) & ~j) {
+            uint32_t t = ((rows[k] >> j) ^ rows[k + j]) & m;
+            rows[k] ^= t << j;
+            rows[k + j] ^= t;
+        }
+    }
+}
+
+uint32_t capture_planes_block(const uint32_t *buf, uint32_t pin_count, uint32_t n_samples, uint32_t block,
+                              uint32_t *planes) {
+    uint32_t first = block * 32;
+    uint32_t valid = first >= n_samples ? 0 : n_samples - first;
+    if (valid > 32) {
+        valid = 32;
+    }
+    uint32_t valid_mask = valid >= 32 ? 0xffffffffu : (1u << valid) - 1;
+    if (pin_count == 1) {
+        // Already a bit plane
+        planes[0] = valid ? buf[block] & valid_mask : 0;
+        return valid;
+    }
+    uint32_t rows[32];
+    if (pin_count == 32) {
+        // One sample per word, so the words are already the rows
+        memcpy(rows, buf + first, valid * sizeof(uint32_t));
+    } else if (valid) {
+        const uint32_t samples_per_word = 32 / pin_count;
+        const uint32_t unused_bits = 32 - samples_per_word * pin_count;
+        const uint32_t sample_mask = (1u << pin_count) - 1;
+        const uint32_t *word = buf + first / samples_per_word;
+        uint32_t slot = first % samples_per_word;
+        uint32_t bits = *word >> (unused_bits + slot * pin_count);
+        for (uint32_t i = 0; i < valid; ++i) {
+            // Only load the next word when there's a sample in it, so we
+            // never read past the end of the capture
+            if (slot == samples_per_word) {
+                slot = 0;
+                bits = *++word >> unused_bits;
+            }
+            rows[i] = bits & sample_mask;
+            bits >>= pin_count;
+            ++slot;
+        }
+    }
+    for (uint32_t i = valid; i < 32; ++i) {
+        rows[i] = 0;
+    }
+    capture_transpose32(rows);
+    memcpy(planes, rows, pin_count * sizeof(uint32_t));
+    return valid;
+}
+
+void capture_export_init(capture_export_t *exp, uint32_t pin_base, uint32_t pin_count,
+                         capture_export_write_fn write, void *write_ctx) {
+    exp->write = write;
+    exp->write_ctx = write_ctx;
+    exp->pin_base = pin_base;
+    exp->pin_count = pin_count;
+    exp->sample_period_ps = 0;
+    exp->samples = 0;
+    exp->state = 0;
+    exp->used = 0;
+}
+
+void capture_export_flush(capture_export_t *exp) {
+    if (exp->used) {
+        exp->write(exp->write_ctx, exp->chunk, exp->used);
+        exp->used = 0;
+    }
+}
+
+// Return space for len bytes (no more than the chunk size) in the chunk
+// buffer. The caller adds len to exp->used once it has filled it in.
+static inline char *reserve(capture_export_t *exp, size_t len) {
+    if (exp->used + len > CAPTURE_EXPORT_CHUNK_BYTES) {
+        capture_export_flush(exp);
+    }
+    return exp->chunk + exp->used;
+}
+
+static void put(capture_export_t *exp, const char *data, size_t len) {
+    while (len) {
+        size_t n = CAPTURE_EXPORT_CHUNK_BYTES - exp->used;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(exp->chunk + exp->used, data, n);
+        exp->used += n;
+        data += n;
+        len -= n;
+        if (exp->used == CAPTURE_EXPORT_CHUNK_BYTES) {
+            capture_export_flush(exp);
+        }
+    }
+}
+
+static inline void put_string(capture_export_t *exp, const char *s) {
+    put(exp, s, strlen(s));
+}
+
+static void put_decimal(capture_export_t *exp, uint64_t value, uint32_t min_digits) {
+    char digits[20];
+    uint32_t n = 0;
+    // Timestamps usually fit in 32 bits, and 32-bit division is much cheaper
+    while (value >> 32) {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    }
+    uint32_t value32 = (uint32_t)value;
+    do {
+        digits[n++] = (char)('0' + value32 % 10);
+        value32 /= 10;
+    } while (value32 || n < min_digits);
+    char *p = reserve(exp, n);
+    for (uint32_t i = 0; i < n; ++i) {
+        p[i] = digits[n - 1 - i];
+    }
+    exp->used += n;
+}
+
+// Write the first `count` samples of a bit plane as text
+static void put_plane_text(capture_export_t *exp, uint32_t plane, uint32_t count) {
+    char *p = reserve(exp, count);
+    exp->used += count;
+    for (; count >= 4; count -= 4, plane >>= 4, p += 4) {
+        memcpy(p, nibble_text[plane & 0xfu], 4);
+    }
+    for (; count; --count, plane >>= 1) {
+        *p++ = plane & 1u ? '-' : '_';
+    }
+}
+
+void capture_export_text(capture_export_t *exp, const uint32_t *buf, uint32_t n_samples) {
+    const uint32_t blocks_per_row = CAPTURE_EXPORT_TEXT_WIDTH / 32;
+    uint32_t planes[CAPTURE_EXPORT_TEXT_WIDTH / 32][32];
+    uint32_t valid[CAPTURE_EXPORT_TEXT_WIDTH / 32];
+    for (uint32_t row_start = 0; row_start < n_samples; row_start += CAPTURE_EXPORT_TEXT_WIDTH) {
+        if (row_start) {
+            put(exp, "\n", 1);
+        }
+        for (uint32_t b = 0; b < blocks_per_row; ++b) {
+            valid[b] = capture_planes_block(buf, exp->pin_count, n_samples, row_start / 32 + b, planes[b]);
+        }
+        for (uint32_t pin = 0; pin < exp->pin_count; ++pin) {
+            put_decimal(exp, exp->pin_base + pin, 2);
+            put(exp, ": ", 2);
+            for (uint32_t b = 0; b < blocks_per_row && valid[b]; ++b) {
+                put_plane_text(exp, planes[b][pin], valid[b]);
+            }
+            put(exp, "\n", 1);
+        }
+    }
+    capture_export_flush(exp);
+}
+
+void capture_export_vcd_begin(capture_export_t *exp, uint32_t sample_period_ps) {
+    exp->sample_period_ps = sample_period_ps;
+    exp->samples = 0;
+    exp->state = 0;
+    put_string(exp, "$timescale 1 ps $end\n$scope module logic_analyser $end\n");
+    for (uint32_t pin = 0; pin < exp->pin_count; ++pin) {
+        put_string(exp, "$var wire 1 ");
+        put(exp, (char[]){VCD_FIRST_ID + (char)pin, ' '}, 2);
+        put_string(exp, "gpio");
+        put_decimal(exp, exp->pin_base + pin, 1);
+        put_string(exp, " $end\n");
+    }
+    put_string(exp, "$upscope $end\n$enddefinitions $end\n");
+}
+
+static inline void put_value_change(capture_export_t *exp, uint32_t pin, uint32_t value) {
+    char *p = reserve(exp, 3);
+    p[0] = (char)('0' + value);
+    p[1] = (char)(VCD_FIRST_ID + pin);
+    p[2] = '\n';
+    exp->used += 3;
+}
+
+void capture_export_vcd_samples(capture_export_t *exp, const uint32_t *buf, uint32_t n_samples) {
+    const uint32_t pin_count = exp->pin_count;
+    uint32_t planes[32];
+    uint32_t changes[32];
+    for (uint32_t block = 0; block * 32 < n_samples; ++block) {
+        uint32_t valid = capture_planes_block(buf, pin_count, n_samples, block, planes);
+        uint32_t valid_mask = valid >= 32 ? 0xffffffffu : (1u << valid) - 1;
+        if (!exp->samples && !block) {
+            // Initial values. Starting from the first sample's state means it
+            // doesn't show up as a change below.
+            put_string(exp, "#0\n$dumpvars\n");
+            for (uint32_t pin = 0; pin < pin_count; ++pin) {
+                exp->state |= (planes[pin] & 1u) << pin;
+                put_value_change(exp, pin, planes[pin] & 1u);
+            }
+            put_string(exp, "$end\n");
+        }
+        // Compare each sample with the one before, for 32 samples at once
+        uint32_t any_change = 0;
+        for (uint32_t pin = 0; pin < pin_count; ++pin) {
+            uint32_t prev = (planes[pin] << 1) | ((exp->state >> pin) & 1u);
+            changes[pin] = (planes[pin] ^ prev) & valid_mask;
+            any_change |= changes[pin];
+        }
+        uint64_t block_sample = exp->samples + block * 32;
+        while (any_change) {
+            uint32_t i = (uint32_t)__builtin_ctz(any_change);
+            any_change &= any_change - 1;
+            put(exp, "#", 1);
+            put_decimal(exp, (block_sample + i) * exp->sample_period_ps, 1);
+            put(exp, "\n", 1);
+            for (uint32_t pin = 0; pin < pin_count; ++pin) {
+                if ((changes[pin] >> i) & 1u) {
+                    put_value_change(exp, pin, (planes[pin] >> i) & 1u);
+                }
+            }
+        }
+        exp->state = 0;
+        for (uint32_t pin = 0; pin < pin_count; ++pin) {
+            exp->state |= ((planes[pin] >> (valid - 1)) & 1u) << pin;
+        }
+    }
+    exp->samples += n_samples;
+}
+
+void capture_export_vcd_end(capture_export_t *exp) {
+    put(exp, "#", 1);
+    put_decimal(exp, exp->samples * exp->sample_period_ps, 1);
+    put(exp, "\n", 1);
+    capture_export_flush(exp);
+}
@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _CAPTURE_EXPORT_H
+#define _CAPTURE_EXPORT_H
+
+// Text and VCD output for logic analyser captures.
+//
+// The capture format (32 / pin_count samples per word, left-justified, oldest
+// sample in the lowest used bits) interleaves the pins, which is awkward for
+// output: the text view wants one pin at a time, and VCD wants to know which
+// pins changed at each sample. So captures are first turned into bit planes,
+// 32 samples at a time: the samples are gathered into 32 rows of pin states,
+// and a 32x32 bit transpose turns those into one word per pin, with sample i
+// in bit i. Edges can then be found for all 32 samples of a pin at once.
+//
+// Output is built up in a chunk buffer, and handed to a write function when
+// the buffer fills, so stdio (or a USB CDC connection) sees a few large
+// writes rather than one call per sample.
+//
+// The VCD output can be loaded into GTKWave, or into PulseView and the rest of
+// sigrok. It only records changes, so the output size depends on how busy
+// the pins are rather than the capture length.
+//
+// The write function is the only way out, so logic_analyser_export.c can
+// time the export into RAM, without stdio in the measurement.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef CAPTURE_EXPORT_CHUNK_BYTES
+#define CAPTURE_EXPORT_CHUNK_BYTES 512
+#endif
+
+// Number of samples in each row of text output. Longer captures are split
+// over several rows, so each group of 32 samples only needs transposing once.
+#ifndef CAPTURE_EXPORT_TEXT_WIDTH
+#define CAPTURE_EXPORT_TEXT_WIDTH 128
+#endif
+
+typedef void (*capture_export_write_fn)(void *ctx, const char *data, size_t len);
+
+typedef struct capture_export {
+    capture_export_write_fn write;
+    void *write_ctx;
+    uint32_t pin_base;
+    uint32_t pin_count;
+    uint32_t sample_period_ps;
+    // Samples passed to capture_export_vcd_samples() so far, and the pin
+    // states at the last of them
+    uint64_t samples;
+    uint32_t state;
+    size_t used;
+    char chunk[CAPTURE_EXPORT_CHUNK_BYTES];
+} capture_export_t;
+
+// Transpose a 32x32 bit matrix in place, so bit j of rows[i] ends up in bit i
+// of rows[j]
+void capture_transpose32(uint32_t rows[32]);
+
+// Convert samples 32 * block to 32 * block + 31 of a capture into bit planes:
+// bit i of planes[pin] is that pin's value in sample 32 * block + i. planes
+// must have room for pin_count words. Samples at or beyond n_samples read as
+// 0. Returns the number of valid samples in the block.
+uint32_t capture_planes_block(const uint32_t *buf, uint32_t pin_count, uint32_t n_samples, uint32_t block,
+                              uint32_t *planes);
+
+// pin_base is only used to label the output
+void capture_export_init(capture_export_t *exp, uint32_t pin_base, uint32_t pin_count,
+                         capture_export_write_fn write, void *write_ctx);
+
+// Write out whatever is left in the chunk buffer
+void capture_export_flush(capture_export_t *exp);
+
+// Render a capture as text, one line per pin, in the same format as the
+// original print_capture_buf():
+//   16: __--__--__--__--__--__--
+//   17: ____----____----____----
+// and flush the output.
+void capture_export_text(capture_export_t *exp, const uint32_t *buf, uint32_t n_samples);
+
+// Start a VCD file, with the given time between samples (in picoseconds)
+void capture_export_vcd_begin(capture_export_t *exp, uint32_t sample_period_ps);
+
+// Add samples to the VCD file. This can be called repeatedly to stream a
+// capture a block at a time, as long as each buffer starts on a word
+// boundary (as capture_ring blocks do).
+void capture_export_vcd_samples(capture_export_t *exp, const uint32_t *buf, uint32_t n_samples);
+
+// Finish the VCD file with a timestamp for the end of the capture, and flush
+// the output
+void capture_export_vcd_end(capture_export_t *exp);
+
+#endif
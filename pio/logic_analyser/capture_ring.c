@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "capture_ring.h"
+
+void capture_ring_init(capture_ring_t *ring, uint32_t *buf, uint32_t block_words, uint32_t block_count,
+                       uint32_t pin_count, uint32_t pre_trigger_samples, uint32_t post_trigger_samples) {
+    ring->buf = buf;
+    ring->block_words = block_words;
+    ring->block_count = block_count;
+    ring->pin_count = pin_count;
+    // Matches bits_packed_per_word(): each FIFO word holds a whole number of
+    // samples, left-justified
+    ring->samples_per_word = 32 / pin_count;
+    ring->samples_per_block = ring->samples_per_word * block_words;
+    ring->pre_trigger_samples = pre_trigger_samples;
+    ring->post_trigger_samples = post_trigger_samples;
+    ring->blocks_written = 0;
+    ring->overruns = 0;
+    ring->blocks_consumed = 0;
+    ring->triggered = false;
+    ring->trigger_sample = 0;
+    ring->window_start = 0;
+    ring->window_end = 0;
+}
+
+// First block which hasn't been (and isn't about to be) overwritten. The DMA
+// owns blocks_written (being filled) and blocks_written + 1 (queued), and the
+// queued block has already displaced blocks_written + 1 - block_count.
+static uint32_t oldest_retained_block(const capture_ring_t *ring, uint32_t blocks_written) {
+    uint32_t in_flight_end = blocks_written + 2;
+    return in_flight_end > ring->block_count ? in_flight_end - ring->block_count : 0;
+}
+
+uint32_t *capture_ring_block_done(capture_ring_t *ring) {
+    uint32_t written = ring->blocks_written + 1;
+    ring->blocks_written = written;
+    // The channel which just finished is now queued behind the other one, so
+    // it will fill the block after the one currently being written, which
+    // displaces one more block. Before the trigger this is just old history
+    // falling off the end of the ring. Afterwards, if the block is in the
+    // window and hasn't been consumed, the consumer has fallen behind.
+    uint32_t oldest = oldest_retained_block(ring, written);
+    if (oldest && ring->triggered) {
+        uint32_t lost = oldest - 1;
+        uint64_t first = (uint64_t)lost * ring->samples_per_block;
+        if (lost >= ring->blocks_consumed && first < ring->window_end &&
+            first + ring->samples_per_block > ring->window_start) {
+            ring->overruns++;
+        }
+    }
+    return capture_ring_block_addr(ring, written + 1);
+}
+
+void capture_ring_trigger(capture_ring_t *ring, uint64_t trigger_sample) {
+    if (ring->triggered) {
+        return;
+    }
+    uint64_t start = trigger_sample >= ring->pre_trigger_samples ? trigger_sample - ring->pre_trigger_samples : 0;
+    // We can't deliver pre-trigger history which has already been overwritten
+    uint32_t oldest = oldest_retained_block(ring, ring->blocks_written);
+    uint64_t oldest_sample = (uint64_t)oldest * ring->samples_per_block;
+    if (start < oldest_sample) {
+        start = oldest_sample;
+    }
+    ring->trigger_sample = trigger_sample;
+    ring->window_start = start;
+    ring->window_end = trigger_sample + ring->post_trigger_samples;
+    ring->blocks_consumed = (uint32_t)(start / ring->samples_per_block);
+    ring->triggered = true;
+}
+
+bool capture_ring_sample_retained(const capture_ring_t *ring, uint64_t sample) {
+    uint32_t written = ring->blocks_written;
+    uint64_t block = sample / ring->samples_per_block;
+    return block >= oldest_retained_block(ring, written) && block <= written;
+}
+
+uint32_t capture_ring_get_sample(const capture_ring_t *ring, uint64_t sample) {
+    uint32_t ring_words = ring->block_words * ring->block_count;
+    uint32_t word = ring->buf[(sample / ring->samples_per_word) % ring_words];
+    // Samples are shifted in from the MSB end, so the oldest sample in each
+    // word is the lowest one, after any unused LSBs
+    uint32_t record_size_bits = ring->samples_per_word * ring->pin_count;
+    uint32_t shift = 32 - record_size_bits + (uint32_t)(sample % ring->samples_per_word) * ring->pin_count;
+    uint32_t mask = ring->pin_count >= 32 ? 0xffffffffu : (1u << ring->pin_count) - 1;
+    return (word >> shift) & mask;
+}
+
+bool capture_ring_peek(const capture_ring_t *ring, capture_block_t *block) {
+    if (!ring->triggered) {
+        return false;
+    }
+    uint32_t written = ring->blocks_written;
+    uint32_t seq = ring->blocks_consumed;
+    uint32_t oldest = oldest_retained_block(ring, written);
+    if (seq < oldest) {
+        seq = oldest;
+    }
+    if (seq >= written) {
+        return false;
+    }
+    uint64_t first = (uint64_t)seq * ring->samples_per_block;
+    uint64_t end = first + ring->samples_per_block;
+    if (first >= ring->window_end) {
+        return false;
+    }
+    if (first < ring->window_start) {
+        first = ring->window_start;
+    }
+    if (end > ring->window_end) {
+        end = ring->window_end;
+    }
+    block->seq = seq;
+    block->words = capture_ring_block_addr(ring, seq);
+    block->sample_offset = (uint32_t)(first - (uint64_t)seq * ring->samples_per_block);
+    block->first_sample = first;
+    block->sample_count = (uint32_t)(end - first);
+    return true;
+}
+
+void capture_ring_release(capture_ring_t *ring, const capture_block_t *block) {
+    ring->blocks_consumed = block->seq + 1;
+}
+
+bool capture_ring_capture_complete(const capture_ring_t *ring) {
+    return ring->triggered && (uint64_t)ring->blocks_written * ring->samples_per_block >= ring->window_end;
+}
+
+bool capture_ring_drained(const capture_ring_t *ring) {
+    return ring->triggered && (uint64_t)ring->blocks_consumed * ring->samples_per_block >= ring->window_end;
+}
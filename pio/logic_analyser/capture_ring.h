@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _CAPTURE_RING_H
+#define _CAPTURE_RING_H
+
+// Block bookkeeping for streaming logic analyser capture.
+//
+// The capture buffer is split into block_count blocks of block_words words.
+// Two DMA channels, chained to each other, take turns filling consecutive
+// blocks. Every time a channel finishes a block, it is re-pointed at the
+// block two places ahead, so the ring is filled continuously with no gaps.
+//
+// Blocks are identified by a monotonic sequence number, and samples by a
+// monotonic 64-bit index (sample 0 being the first sample captured after
+// arming). Until the trigger is seen the ring just keeps the most recent
+// history; once the trigger position is known, the blocks covering
+// [trigger - pre_trigger_samples, trigger + post_trigger_samples) are handed
+// to the consumer in order, clipped to that window.
+//
+// Each count has a single writer. The DMA IRQ only advances blocks_written,
+// and the consumer (perhaps on the other core) only advances
+// blocks_consumed, so neither needs a lock. If the DMA laps the consumer,
+// blocks_consumed is left behind, and peek skips to the oldest block which
+// hasn't been overwritten.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct capture_ring {
+    uint32_t *buf;
+    uint32_t block_words;
+    uint32_t block_count;
+    uint32_t pin_count;
+    uint32_t samples_per_word;
+    uint32_t samples_per_block;
+    uint32_t pre_trigger_samples;
+    uint32_t post_trigger_samples;
+    // Written by the DMA IRQ
+    volatile uint32_t blocks_written;
+    // Blocks in the window overwritten before the consumer got to them
+    volatile uint32_t overruns;
+    // Written by the consumer. May be behind the oldest retained block.
+    volatile uint32_t blocks_consumed;
+    volatile bool triggered;
+    uint64_t trigger_sample;
+    uint64_t window_start;
+    uint64_t window_end;
+} capture_ring_t;
+
+// A completed block, or the part of it that falls inside the capture window
+typedef struct capture_block {
+    uint32_t seq;
+    const uint32_t *words;
+    // Index of the first sample of the block which is inside the window, and
+    // the absolute index of that sample
+    uint32_t sample_offset;
+    uint64_t first_sample;
+    uint32_t sample_count;
+} capture_block_t;
+
+// buf must hold block_words * block_count words. block_count must be at
+// least 3: two blocks are always owned by the DMA, and the consumer needs at
+// least one more.
+void capture_ring_init(capture_ring_t *ring, uint32_t *buf, uint32_t block_words, uint32_t block_count,
+                       uint32_t pin_count, uint32_t pre_trigger_samples, uint32_t post_trigger_samples);
+
+static inline uint32_t *capture_ring_block_addr(const capture_ring_t *ring, uint32_t seq) {
+    return ring->buf + (seq % ring->block_count) * ring->block_words;
+}
+
+// Call from the DMA IRQ when the channel writing the oldest in-flight block
+// completes. Returns the address that channel should be re-pointed at.
+uint32_t *capture_ring_block_done(capture_ring_t *ring);
+
+// Record the trigger position. Call it from the consumer, with the DMA IRQ
+// masked, as it sets where the consumer starts.
+void capture_ring_trigger(capture_ring_t *ring, uint64_t trigger_sample);
+
+// Number of samples the DMA has written to memory, given how many words of
+// the current block are already written
+static inline uint64_t capture_ring_samples_written(const capture_ring_t *ring, uint32_t words_into_block) {
+    return ((uint64_t)ring->blocks_written * ring->block_words + words_into_block) * ring->samples_per_word;
+}
+
+// True if sample is still held in the ring (it may be in a block owned by
+// the DMA, in which case it is only valid if it has already been written)
+bool capture_ring_sample_retained(const capture_ring_t *ring, uint64_t sample);
+
+// Return the pin states for one sample, with the lowest pin in bit 0
+uint32_t capture_ring_get_sample(const capture_ring_t *ring, uint64_t sample);
+
+// Get the next completed block in the window, in order, skipping any which
+// have been overwritten. Returns false if there isn't one yet (or the
+// trigger hasn't been seen).
+bool capture_ring_peek(const capture_ring_t *ring, capture_block_t *block);
+
+// Give the block returned by capture_ring_peek back to the DMA
+void capture_ring_release(capture_ring_t *ring, const capture_block_t *block);
+
+// True once every block covering the window has been written by the DMA
+bool capture_ring_capture_complete(const capture_ring_t *ring);
+
+// True once every block covering the window has also been released
+bool capture_ring_drained(const capture_ring_t *ring);
+
+#endif
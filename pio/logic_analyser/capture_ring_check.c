@@ -0,0 +1,186 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Check the block bookkeeping in capture_ring.c: that blocks reach the
+// consumer in order and clipped to the window around the trigger, that the
+// window is cut short when pre-trigger history has already gone, and that a
+// consumer which falls behind skips the overwritten blocks, which are
+// counted as overruns.
+//
+// The DMA is played by a loop filling one block at a time, with each sample
+// set to its own index, so no PIO or DMA is needed to build it on a PC:
+//
+//   cc -DPICO_NO_HARDWARE=1 capture_ring_check.c capture_ring.c
+//
+// A block delivered twice, out of order or outside the window fails the run.
+
+#include <stdio.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#define count_of(a) (sizeof(a)/sizeof((a)[0]))
+#endif
+
+#include "capture_ring.h"
+
+// 8 pins, so 4 samples per word and 16 per block
+#define PIN_COUNT 8
+#define BLOCK_WORDS 4
+#define BLOCK_COUNT 6
+#define SAMPLES_PER_BLOCK (BLOCK_WORDS * 32 / PIN_COUNT)
+
+static uint32_t buf[BLOCK_WORDS * BLOCK_COUNT];
+static capture_ring_t ring;
+static bool dma_stopped;
+
+static uint32_t failures;
+
+static void check(const char *what, bool ok) {
+    if (!ok) {
+        printf("  %s is wrong\n", what);
+        failures++;
+    }
+}
+
+static void start(uint32_t pre_trigger_samples, uint32_t post_trigger_samples) {
+    capture_ring_init(&ring, buf, BLOCK_WORDS, BLOCK_COUNT, PIN_COUNT, pre_trigger_samples, post_trigger_samples);
+    dma_stopped = false;
+}
+
+// Fill the block being written, and finish it as the DMA IRQ would
+static void dma_block(void) {
+    if (dma_stopped) {
+        return;
+    }
+    uint32_t seq = ring.blocks_written;
+    uint32_t *words = capture_ring_block_addr(&ring, seq);
+    for (uint32_t i = 0; i < SAMPLES_PER_BLOCK; ++i) {
+        uint32_t sample = seq * SAMPLES_PER_BLOCK + i;
+        if (!(i % 4)) {
+            words[i / 4] = 0;
+        }
+        words[i / 4] |= (sample & 0xffu) << (i % 4 * PIN_COUNT);
+    }
+    capture_ring_block_done(&ring);
+    dma_stopped = capture_ring_capture_complete(&ring);
+}
+
+static void dma_blocks(uint32_t n) {
+    while (n--) {
+        dma_block();
+    }
+}
+
+// Consume the whole window, checking the blocks are in order and hold the
+// right samples, and return the first sample delivered
+static uint64_t consume(uint64_t expect_end) {
+    uint64_t first = UINT64_MAX, next = 0;
+    bool in_order = true, samples_ok = true;
+    capture_block_t block;
+    for (uint32_t i = 0; i < 1000 && !capture_ring_drained(&ring); ++i) {
+        if (!capture_ring_peek(&ring, &block)) {
+            dma_block();
+            continue;
+        }
+        if (first == UINT64_MAX) {
+            first = next = block.first_sample;
+        }
+        in_order &= block.first_sample == next &&
+                    block.first_sample == (uint64_t)block.seq * SAMPLES_PER_BLOCK + block.sample_offset;
+        for (uint32_t j = 0; j < block.sample_count; ++j) {
+            uint32_t k = block.sample_offset + j;
+            uint32_t sample = (block.words[k / 4] >> (k % 4 * PIN_COUNT)) & 0xffu;
+            samples_ok &= sample == ((block.first_sample + j) & 0xffu) &&
+                          capture_ring_get_sample(&ring, block.first_sample + j) == sample;
+        }
+        next = block.first_sample + block.sample_count;
+        capture_ring_release(&ring, &block);
+    }
+    check("drained", capture_ring_drained(&ring));
+    check("block order", in_order);
+    check("samples", samples_ok);
+    check("window end", next == expect_end);
+    return first;
+}
+
+// Trigger with plenty of history in the ring: the window is exactly
+// pre_trigger_samples before the trigger to post_trigger_samples after
+static void check_window(void) {
+    start(20, 40);
+    dma_blocks(10);
+    capture_ring_trigger(&ring, 130);
+    check("trigger sample", ring.trigger_sample == 130);
+    check("window start", ring.window_start == 110);
+    capture_block_t block;
+    check("first block", capture_ring_peek(&ring, &block) && block.seq == 110 / SAMPLES_PER_BLOCK &&
+                         block.sample_offset == 110 % SAMPLES_PER_BLOCK);
+    check("first sample", consume(170) == 110);
+    check("overruns", ring.overruns == 0);
+}
+
+// Trigger before pre_trigger_samples have been captured: the window starts
+// with sample 0
+static void check_early_trigger(void) {
+    start(20, 40);
+    dma_blocks(1);
+    capture_ring_trigger(&ring, 5);
+    check("window start", ring.window_start == 0);
+    check("first sample", consume(45) == 0);
+    check("overruns", ring.overruns == 0);
+}
+
+// Ask for more history than the ring holds: the window starts at the oldest
+// block which hasn't been overwritten
+static void check_history_lost(void) {
+    start(200, 40);
+    dma_blocks(20);
+    uint32_t oldest = 20 + 2 - BLOCK_COUNT;
+    capture_ring_trigger(&ring, 330);
+    check("window start", ring.window_start == (uint64_t)oldest * SAMPLES_PER_BLOCK);
+    check("first sample", consume(370) == (uint64_t)oldest * SAMPLES_PER_BLOCK);
+    check("overruns", ring.overruns == 0);
+}
+
+// Let the DMA lap the consumer: it is left to skip to the oldest block still
+// in the ring, rather than being moved on by the IRQ, and each block lost is
+// one overrun
+static void check_overrun(void) {
+    start(0, 20 * SAMPLES_PER_BLOCK);
+    capture_ring_trigger(&ring, 0);
+    dma_blocks(12);
+    uint32_t oldest = 12 + 2 - BLOCK_COUNT;
+    check("blocks consumed", ring.blocks_consumed == 0);
+    check("overruns", ring.overruns == oldest);
+    check("first sample", consume(20 * SAMPLES_PER_BLOCK) == (uint64_t)oldest * SAMPLES_PER_BLOCK);
+    check("overruns after", ring.overruns == oldest);
+}
+
+typedef struct ring_check {
+    const char *name;
+    void (*run)(void);
+} ring_check_t;
+
+static const ring_check_t checks[] = {
+    {"Window", check_window},
+    {"Early trigger", check_early_trigger},
+    {"History lost", check_history_lost},
+    {"Overrun", check_overrun},
+};
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+#endif
+    puts("Capture ring checks");
+    for (uint32_t i = 0; i < count_of(checks); ++i) {
+        uint32_t before = failures;
+        checks[i].run();
+        printf("%-14s %s\n", checks[i].name, failures == before ? "ok" : "FAILED");
+    }
+    printf("\n%s\n", failures ? "Capture ring checks FAILED" : "All capture ring checks passed");
+    return failures ? 1 : 0;
+}
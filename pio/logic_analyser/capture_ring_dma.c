@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#include "capture_ring_dma.h"
+
+static capture_ring_t *ring;
+static uint dma_irq_index;
+static uint dma_chan[2];
+// Index of the channel which is filling the oldest in-flight block
+static uint dma_chan_current;
+
+static void dma_irq_handler(void) {
+    // Blocks always complete in order, so only look at the channel which owns
+    // the oldest block. If we were slow to get here, both may be done.
+    while (dma_irqn_get_channel_status(dma_irq_index, dma_chan[dma_chan_current])) {
+        uint chan = dma_chan[dma_chan_current];
+        dma_irqn_acknowledge_channel(dma_irq_index, chan);
+        uint32_t *next = capture_ring_block_done(ring);
+        if (capture_ring_capture_complete(ring)) {
+            // Everything we need is in the ring; stop before it gets
+            // overwritten. Disable the channels first, so that aborting one
+            // can't chain to the other (RP2040-E13).
+            hw_clear_bits(&dma_channel_hw_addr(dma_chan[0])->al1_ctrl, DMA_CH0_CTRL_TRIG_EN_BITS);
+            hw_clear_bits(&dma_channel_hw_addr(dma_chan[1])->al1_ctrl, DMA_CH0_CTRL_TRIG_EN_BITS);
+            dma_channel_abort(dma_chan[0]);
+            dma_channel_abort(dma_chan[1]);
+            dma_irqn_set_channel_mask_enabled(dma_irq_index, (1u << dma_chan[0]) | (1u << dma_chan[1]), false);
+            return;
+        }
+        // Don't trigger: this channel restarts when the other one chains to it
+        dma_channel_set_write_addr(chan, next, false);
+        dma_chan_current ^= 1;
+    }
+}
+
+void capture_ring_dma_init(capture_ring_t *r, uint irq_index) {
+    ring = r;
+    dma_irq_index = irq_index;
+    dma_chan[0] = dma_claim_unused_channel(true);
+    dma_chan[1] = dma_claim_unused_channel(true);
+    irq_set_exclusive_handler(dma_get_irq_num(irq_index), dma_irq_handler);
+    irq_set_enabled(dma_get_irq_num(irq_index), true);
+}
+
+void capture_ring_dma_setup(PIO pio, uint sm) {
+    for (uint i = 0; i < 2; ++i) {
+        dma_channel_config c = dma_channel_get_default_config(dma_chan[i]);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_dreq(&c, pio_get_dreq(pio, sm, false));
+        channel_config_set_chain_to(&c, dma_chan[i ^ 1]);
+        dma_channel_configure(dma_chan[i], &c,
+            capture_ring_block_addr(ring, i), // Destination pointer
+            &pio->rxf[sm],                   // Source pointer
+            ring->block_words,               // Number of transfers
+            false                            // Don't start yet
+        );
+    }
+    dma_chan_current = 0;
+    dma_irqn_acknowledge_channel(dma_irq_index, dma_chan[0]);
+    dma_irqn_acknowledge_channel(dma_irq_index, dma_chan[1]);
+    dma_irqn_set_channel_mask_enabled(dma_irq_index, (1u << dma_chan[0]) | (1u << dma_chan[1]), true);
+}
+
+void capture_ring_dma_start(void) {
+    dma_channel_start(dma_chan[0]);
+}
@@ -0,0 +1,32 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _CAPTURE_RING_DMA_H
+#define _CAPTURE_RING_DMA_H
+
+// The two chained DMA channels which fill a capture_ring_t from a capture
+// state machine's RX FIFO, and their interrupt handler. Each channel is
+// re-pointed at the block two places ahead as soon as it finishes, and both
+// are stopped once the capture window is complete.
+//
+// There is one of these, as there is one handler.
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+#include "capture_ring.h"
+
+// Claim two channels and install the handler on DMA_IRQ_<irq_index>
+void capture_ring_dma_init(capture_ring_t *ring, uint irq_index);
+
+// Point the channels at the first two blocks of the ring, reading from the
+// state machine's RX FIFO, ready to start
+void capture_ring_dma_setup(PIO pio, uint sm);
+
+// Start the first channel; it won't see any data until the state machine runs
+void capture_ring_dma_start(void);
+
+#endif
@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "capture_rle.h"
+
+void capture_rle_encoder_init(capture_rle_encoder_t *enc, uint32_t pin_count) {
+    enc->pin_count = pin_count;
+    enc->samples_per_word = 32 / pin_count;
+    enc->unused_bits = 32 - enc->samples_per_word * pin_count;
+    enc->state_mask = pin_count >= 32 ? 0xffffffffu : (1u << pin_count) - 1;
+    // Multiplying a pin state by this copies it into every sample slot
+    enc->replicate = 0;
+    for (uint32_t i = 0; i < enc->samples_per_word; ++i) {
+        enc->replicate |= 1u << (i * pin_count);
+    }
+    enc->max_run = pin_count <= 16 ? (uint64_t)1 << (32 - pin_count) : (uint64_t)1 << 32;
+    enc->started = false;
+    enc->state = 0;
+    enc->state_word = 0;
+    enc->run = 0;
+}
+
+static inline uint32_t *put_record(const capture_rle_encoder_t *enc, uint32_t *out, uint64_t run, uint32_t state) {
+    if (enc->pin_count <= 16) {
+        *out++ = (uint32_t)(run - 1) << enc->pin_count | state;
+    } else {
+        *out++ = (uint32_t)(run - 1);
+        *out++ = state;
+    }
+    return out;
+}
+
+static inline void set_state(capture_rle_encoder_t *enc, uint32_t state) {
+    enc->state = state;
+    enc->state_word = (state * enc->replicate) << enc->unused_bits;
+}
+
+size_t capture_rle_encode(capture_rle_encoder_t *enc, const uint32_t *words, size_t n_words, uint32_t *out) {
+    uint32_t *out_start = out;
+    if (n_words && !enc->started) {
+        set_state(enc, (words[0] >> enc->unused_bits) & enc->state_mask);
+        enc->started = true;
+    }
+    uint32_t pin_count = enc->pin_count;
+    uint32_t unused_bits = enc->unused_bits;
+    for (size_t i = 0; i < n_words; ++i) {
+        uint32_t word = words[i];
+        uint32_t diff = word ^ enc->state_word;
+        uint32_t pos = 0;
+        while (diff) {
+            // Index of the first sample which differs from the current state
+            uint32_t next = ((uint32_t)__builtin_ctz(diff) - unused_bits) / pin_count;
+            uint64_t run = enc->run + (next - pos);
+            while (run > enc->max_run) {
+                out = put_record(enc, out, enc->max_run, enc->state);
+                run -= enc->max_run;
+            }
+            if (run) {
+                out = put_record(enc, out, run, enc->state);
+            }
+            uint32_t shift = unused_bits + next * pin_count;
+            set_state(enc, (word >> shift) & enc->state_mask);
+            enc->run = 0;
+            pos = next;
+            // Only look at samples from here on
+            diff = (word ^ enc->state_word) & ~((1u << shift) - 1);
+        }
+        enc->run += enc->samples_per_word - pos;
+        if (enc->run > enc->max_run) {
+            out = put_record(enc, out, enc->max_run, enc->state);
+            enc->run -= enc->max_run;
+        }
+    }
+    return (size_t)(out - out_start);
+}
+
+size_t capture_rle_flush(capture_rle_encoder_t *enc, uint32_t *out) {
+    if (!enc->run) {
+        return 0;
+    }
+    put_record(enc, out, enc->run, enc->state);
+    enc->run = 0;
+    return capture_rle_record_words(enc->pin_count);
+}
+
+static inline const uint32_t *get_record(uint32_t pin_count, const uint32_t *records, uint64_t *run, uint32_t *state) {
+    if (pin_count <= 16) {
+        uint32_t record = *records++;
+        *run = (uint64_t)(record >> pin_count) + 1;
+        *state = record & ((1u << pin_count) - 1);
+    } else {
+        *run = (uint64_t)*records++ + 1;
+        *state = *records++;
+    }
+    return records;
+}
+
+size_t capture_rle_decode(uint32_t pin_count, const uint32_t *records, size_t n_record_words, uint32_t *out,
+                          size_t out_words) {
+    capture_rle_encoder_t layout;
+    capture_rle_encoder_init(&layout, pin_count);
+    const uint32_t *end = records + n_record_words;
+    size_t n = 0;
+    uint32_t word = 0;
+    uint32_t pos = 0;
+    while (records < end && n < out_words) {
+        uint64_t run;
+        uint32_t state;
+        records = get_record(pin_count, records, &run, &state);
+        // Finish off any partial word a sample at a time...
+        while (run && pos) {
+            word |= state << (layout.unused_bits + pos * pin_count);
+            --run;
+            if (++pos == layout.samples_per_word) {
+                out[n++] = word;
+                word = 0;
+                pos = 0;
+                if (n == out_words) {
+                    return n;
+                }
+            }
+        }
+        // ...then whole words at once
+        uint32_t state_word = (state * layout.replicate) << layout.unused_bits;
+        while (run >= layout.samples_per_word && n < out_words) {
+            out[n++] = state_word;
+            run -= layout.samples_per_word;
+        }
+        if (n == out_words) {
+            return n;
+        }
+        for (; run; --run) {
+            word |= state << (layout.unused_bits + pos * pin_count);
+            ++pos;
+        }
+    }
+    if (pos && n < out_words) {
+        out[n++] = word;
+    }
+    return n;
+}
+
+size_t capture_rle_transitions(uint32_t pin_count, const uint32_t *records, size_t n_record_words,
+                               capture_rle_transition_t *out, size_t max_transitions) {
+    const uint32_t *end = records + n_record_words;
+    uint64_t sample = 0;
+    size_t n = 0;
+    while (records < end && n < max_transitions) {
+        uint64_t run;
+        uint32_t state;
+        records = get_record(pin_count, records, &run, &state);
+        // A run may have been split because it was too long for one record
+        if (!n || out[n - 1].state != state) {
+            out[n].sample = sample;
+            out[n].state = state;
+            ++n;
+        }
+        sample += run;
+    }
+    return n;
+}
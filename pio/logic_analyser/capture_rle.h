@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _CAPTURE_RLE_H
+#define _CAPTURE_RLE_H
+
+// Run-length compression of logic analyser captures.
+//
+// The input is the raw capture format written by the `in pins, n` program:
+// each 32-bit word holds 32 / pin_count samples, left-justified, with the
+// oldest sample in the lowest used bits. The output is a list of records,
+// each giving a pin state and the number of consecutive samples it was held
+// for. With up to 16 pins a record is one word:
+//
+//   (run_length - 1) << pin_count | pin_state
+//
+// and with more pins it is two words, run_length - 1 followed by pin_state.
+// Summing the run lengths gives the timestamp (in samples) of each
+// transition.
+//
+// Words which don't contain a transition are handled with a single compare,
+// so mostly idle captures are compressed at close to memory speed.
+//
+// capture_rle_check.c round-trips captures through the encoder and decoder.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct capture_rle_encoder {
+    uint32_t pin_count;
+    uint32_t samples_per_word;
+    uint32_t unused_bits;
+    uint32_t state_mask;
+    uint32_t replicate;
+    uint64_t max_run;
+    bool started;
+    uint32_t state;
+    uint32_t state_word;
+    uint64_t run;
+} capture_rle_encoder_t;
+
+typedef struct capture_rle_transition {
+    uint64_t sample;
+    uint32_t state;
+} capture_rle_transition_t;
+
+static inline uint32_t capture_rle_record_words(uint32_t pin_count) {
+    return pin_count <= 16 ? 1 : 2;
+}
+
+// Worst case output size for n_words of input, which is every sample being
+// different from the last (plus one record for the flush)
+static inline size_t capture_rle_max_encoded_words(uint32_t pin_count, size_t n_words) {
+    return (n_words * (32 / pin_count) + 1) * capture_rle_record_words(pin_count);
+}
+
+void capture_rle_encoder_init(capture_rle_encoder_t *enc, uint32_t pin_count);
+
+// Compress n_words of capture data. out must have room for
+// capture_rle_max_encoded_words(). Returns the number of words written. The
+// current run is carried over to the next call.
+size_t capture_rle_encode(capture_rle_encoder_t *enc, const uint32_t *words, size_t n_words, uint32_t *out);
+
+// Write out the current run. Returns the number of words written.
+size_t capture_rle_flush(capture_rle_encoder_t *enc, uint32_t *out);
+
+// Expand records back into the raw capture format. Returns the number of
+// words written, which is at most out_words; a trailing partial word is
+// zero-padded.
+size_t capture_rle_decode(uint32_t pin_count, const uint32_t *records, size_t n_record_words, uint32_t *out,
+                          size_t out_words);
+
+// Convert records to a list of (sample index, new pin state) pairs, starting
+// with the initial state at sample 0. Returns the number of transitions
+// written, which is at most max_transitions.
+size_t capture_rle_transitions(uint32_t pin_count, const uint32_t *records, size_t n_record_words,
+                               capture_rle_transition_t *out, size_t max_transitions);
+
+#endif
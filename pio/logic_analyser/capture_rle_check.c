@@ -0,0 +1,202 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Round-trip checks for capture_rle.c: compress made up captures in uneven
+// chunks, as the compress example does a block at a time, then expand the
+// records again and compare them with the raw samples. This is done for pin
+// counts which do and don't divide 32, with one and two word records, for
+// idle, regular, bursty and noisy signals. Runs too long for one record are
+// checked separately.
+//
+// The encoder works on words already in RAM, so the round trips can be run
+// on a PC too:
+//
+//   cc -DPICO_NO_HARDWARE=1 capture_rle_check.c capture_rle.c
+//
+// Any sample that doesn't come back as it went in fails the run.
+
+#include <stdio.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#define count_of(a) (sizeof(a)/sizeof((a)[0]))
+#endif
+
+#include "capture_rle.h"
+
+#define N_WORDS 512
+// Enough for a transition on every sample of a single pin capture
+#define MAX_RECORD_WORDS (N_WORDS * 32 + 1)
+
+static uint32_t raw[N_WORDS];
+static uint32_t records[MAX_RECORD_WORDS];
+static uint32_t decoded[N_WORDS];
+static capture_rle_transition_t transitions[64];
+
+static uint32_t failures;
+
+static void check(const char *what, bool ok) {
+    if (!ok) {
+        printf("  %s is wrong\n", what);
+        failures++;
+    }
+}
+
+static uint32_t rand_state;
+
+static uint32_t next_rand(void) {
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+}
+
+enum signal {
+    SIGNAL_IDLE,
+    SIGNAL_PERIODIC,
+    SIGNAL_BURSTS,
+    SIGNAL_NOISE,
+};
+
+// Fill raw with a capture of pin_count pins, packed as by `in pins, n`
+static void make_capture(uint32_t pin_count, enum signal signal) {
+    uint32_t spw = 32 / pin_count;
+    uint32_t unused_bits = 32 - spw * pin_count;
+    uint32_t mask = pin_count >= 32 ? 0xffffffffu : (1u << pin_count) - 1;
+    uint32_t state = 0x5a5a5a5au & mask;
+    uint32_t run = 0;
+    rand_state = 0x12345678u + pin_count;
+    for (uint32_t i = 0, sample = 0; i < N_WORDS; ++i) {
+        uint32_t word = 0;
+        for (uint32_t j = 0; j < spw; ++j, ++sample) {
+            switch (signal) {
+            case SIGNAL_IDLE:
+                break;
+            case SIGNAL_PERIODIC:
+                if (sample % 7 == 0) {
+                    state = ~state & mask;
+                }
+                break;
+            case SIGNAL_BURSTS:
+                if (!run) {
+                    // Alternate between busy stretches and long quiet ones
+                    run = next_rand() % 2 ? next_rand() % 4 + 1 : next_rand() % 300;
+                    state = next_rand() & mask;
+                }
+                --run;
+                break;
+            case SIGNAL_NOISE:
+                state = next_rand() & mask;
+                break;
+            }
+            word |= state << (unused_bits + j * pin_count);
+        }
+        raw[i] = word;
+    }
+}
+
+// Compress raw in chunks of varying size, carrying the run over between them
+static size_t encode_capture(uint32_t pin_count) {
+    static const uint32_t chunk_words[] = {1, 7, 64, 3, 100};
+    capture_rle_encoder_t enc;
+    capture_rle_encoder_init(&enc, pin_count);
+    size_t n = 0;
+    for (uint32_t i = 0, c = 0; i < N_WORDS; c = (c + 1) % count_of(chunk_words)) {
+        uint32_t words = chunk_words[c] < N_WORDS - i ? chunk_words[c] : N_WORDS - i;
+        n += capture_rle_encode(&enc, raw + i, words, records + n);
+        i += words;
+    }
+    return n + capture_rle_flush(&enc, records + n);
+}
+
+// The first transitions, found the slow way
+static bool transitions_match(uint32_t pin_count, size_t n_transitions) {
+    uint32_t spw = 32 / pin_count;
+    uint32_t unused_bits = 32 - spw * pin_count;
+    uint32_t mask = pin_count >= 32 ? 0xffffffffu : (1u << pin_count) - 1;
+    size_t n = 0;
+    for (uint32_t sample = 0; sample < N_WORDS * spw && n < count_of(transitions); ++sample) {
+        uint32_t state = (raw[sample / spw] >> (unused_bits + sample % spw * pin_count)) & mask;
+        if (!n || state != transitions[n - 1].state) {
+            if (n == n_transitions || transitions[n].sample != sample || transitions[n].state != state) {
+                return false;
+            }
+            ++n;
+        }
+    }
+    return n == n_transitions;
+}
+
+static void check_round_trip(uint32_t pin_count) {
+    static const char *const signal_names[] = {"idle", "periodic", "bursts", "noise"};
+    for (uint32_t signal = 0; signal < count_of(signal_names); ++signal) {
+        make_capture(pin_count, signal);
+        size_t n_records = encode_capture(pin_count);
+        if (n_records > capture_rle_max_encoded_words(pin_count, N_WORDS)) {
+            printf("  %s: %u record words is more than the worst case\n", signal_names[signal],
+                   (unsigned)n_records);
+            failures++;
+        }
+        memset(decoded, 0xa5, sizeof(decoded));
+        size_t n = capture_rle_decode(pin_count, records, n_records, decoded, N_WORDS);
+        if (n != N_WORDS || memcmp(decoded, raw, sizeof(raw))) {
+            printf("  %s: decoded capture is wrong\n", signal_names[signal]);
+            failures++;
+        }
+        size_t n_transitions = capture_rle_transitions(pin_count, records, n_records, transitions,
+                                                       count_of(transitions));
+        if (!transitions_match(pin_count, n_transitions)) {
+            printf("  %s: transitions are wrong\n", signal_names[signal]);
+            failures++;
+        }
+    }
+}
+
+// 16 pins leave 16 bits for the run length, so an idle stretch of more than
+// 65536 samples has to be split between records, even across chunks
+static void check_long_run(void) {
+    const uint32_t pin_count = 16;
+    const uint32_t chunks = 100;
+    make_capture(pin_count, SIGNAL_IDLE);
+    capture_rle_encoder_t enc;
+    capture_rle_encoder_init(&enc, pin_count);
+    size_t n = 0;
+    for (uint32_t i = 0; i < chunks; ++i) {
+        n += capture_rle_encode(&enc, raw, N_WORDS, records + n);
+    }
+    n += capture_rle_flush(&enc, records + n);
+    uint32_t samples = chunks * N_WORDS * 2;
+    check("record count", n == (samples + 65535) / 65536);
+    uint64_t total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        total += (records[i] >> pin_count) + 1;
+    }
+    check("total samples", total == samples);
+    check("transitions", capture_rle_transitions(pin_count, records, n, transitions, count_of(transitions)) == 1 &&
+                         transitions[0].sample == 0 && transitions[0].state == (raw[0] & 0xffffu));
+    check("decoded start", capture_rle_decode(pin_count, records, n, decoded, N_WORDS) == N_WORDS &&
+                           !memcmp(decoded, raw, sizeof(raw)));
+}
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+#endif
+    puts("Capture RLE checks");
+    static const uint32_t pin_counts[] = {1, 2, 3, 5, 8, 12, 16, 17, 32};
+    for (uint32_t i = 0; i < count_of(pin_counts); ++i) {
+        uint32_t before = failures;
+        check_round_trip(pin_counts[i]);
+        printf("%2u pins   %s\n", (unsigned)pin_counts[i], failures == before ? "ok" : "FAILED");
+    }
+    uint32_t before = failures;
+    check_long_run();
+    printf("Long run  %s\n", failures == before ? "ok" : "FAILED");
+    printf("\n%s\n", failures ? "Capture RLE checks FAILED" : "All capture RLE checks passed");
+    return failures ? 1 : 0;
+}
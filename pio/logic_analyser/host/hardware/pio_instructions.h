@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _HARDWARE_PIO_INSTRUCTIONS_H
+#define _HARDWARE_PIO_INSTRUCTIONS_H
+
+// The instruction encoders trigger_program.c uses from the SDK's
+// hardware/pio_instructions.h, for building it on the host. Put this
+// directory on the include path instead of the SDK's.
+//
+// The encodings are the RP2040's, which the RP2350 shares for these
+// instructions. trigger_program_check.c compares the programs built with them
+// against encodings written out by hand, so a mistake here would show up as
+// well.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+
+enum pio_src_dest {
+    pio_pins = 0u,
+    pio_x = 1u,
+    pio_y = 2u,
+    pio_null = 3u,
+    pio_pindirs = 4u,
+    pio_exec_mov = 4u,
+    pio_status = 5u,
+    pio_pc = 5u,
+    pio_isr = 6u,
+    pio_osr = 7u,
+    pio_exec_out = 7u,
+};
+
+static inline uint16_t _pio_encode_instr_and_args(uint16_t instr_bits, uint arg1, uint arg2) {
+    return instr_bits | (uint16_t)((arg1 & 7u) << 5) | (uint16_t)(arg2 & 0x1fu);
+}
+
+static inline uint16_t pio_encode_jmp(uint addr) {
+    return _pio_encode_instr_and_args(0x0000, 0, addr);
+}
+
+static inline uint16_t pio_encode_jmp_x_dec(uint addr) {
+    return _pio_encode_instr_and_args(0x0000, 2, addr);
+}
+
+static inline uint16_t pio_encode_jmp_x_ne_y(uint addr) {
+    return _pio_encode_instr_and_args(0x0000, 5, addr);
+}
+
+static inline uint16_t pio_encode_wait_gpio(bool polarity, uint gpio) {
+    return _pio_encode_instr_and_args(0x2000, polarity ? 4 : 0, gpio);
+}
+
+static inline uint16_t pio_encode_wait_irq(bool polarity, bool relative, uint irq) {
+    return _pio_encode_instr_and_args(0x2000, (polarity ? 4 : 0) | 2, (relative ? 0x10 : 0) | irq);
+}
+
+static inline uint16_t pio_encode_in(enum pio_src_dest src, uint count) {
+    return _pio_encode_instr_and_args(0x4000, src, count);
+}
+
+static inline uint16_t pio_encode_out(enum pio_src_dest dest, uint count) {
+    return _pio_encode_instr_and_args(0x6000, dest, count);
+}
+
+static inline uint16_t pio_encode_push(bool if_full, bool block) {
+    return _pio_encode_instr_and_args(0x8000, (if_full ? 2 : 0) | (block ? 1 : 0), 0);
+}
+
+static inline uint16_t pio_encode_pull(bool if_empty, bool block) {
+    return _pio_encode_instr_and_args(0x8000, 4 | (if_empty ? 2 : 0) | (block ? 1 : 0), 0);
+}
+
+static inline uint16_t pio_encode_mov(enum pio_src_dest dest, enum pio_src_dest src) {
+    return _pio_encode_instr_and_args(0xa000, dest, src);
+}
+
+static inline uint16_t pio_encode_mov_not(enum pio_src_dest dest, enum pio_src_dest src) {
+    return _pio_encode_instr_and_args(0xa000, dest, (1u << 3) | src);
+}
+
+static inline uint16_t pio_encode_irq_set(bool relative, uint irq) {
+    return _pio_encode_instr_and_args(0xc000, 0, (relative ? 0x10 : 0) | irq);
+}
+
+#endif
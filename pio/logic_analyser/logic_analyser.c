@@ -7,8 +7,13 @@
 // PIO logic analyser example
 //
 // This program captures samples from a group of pins, at a fixed rate, once a
-// trigger condition is detected (level condition on one pin). The samples are
-// transferred to a capture buffer using the system DMA.
+// trigger condition is detected. The samples are transferred to a capture
+// buffer using the system DMA.
+//
+// The trigger condition is described by a table of stages (see
+// trigger_program.h), which is turned into a program for a second state
+// machine. When it matches, it sets a PIO IRQ flag which the capture state
+// machine is waiting on. The capture starts two cycles after the match.
 //
 // 1 to 32 pins can be captured, at a sample rate no greater than system clock
 // frequency.
@@ -21,6 +26,10 @@
 #include "hardware/dma.h"
 #include "hardware/structs/bus_ctrl.h"
 
+#include "capture_export.h"
+#include "logic_analyser_common.h"
+#include "trigger_program.h"
+
 // Some logic to analyse:
 #include "hardware/structs/pwm.h"
 
@@ -28,48 +37,30 @@ const uint CAPTURE_PIN_BASE = 16;
 const uint CAPTURE_PIN_COUNT = 2;
 const uint CAPTURE_N_SAMPLES = 96;
 
-static inline uint bits_packed_per_word(uint pin_count) {
-    // If the number of pins to be sampled divides the shift register size, we
-    // can use the full SR and FIFO width, and push when the input shift count
-    // exactly reaches 32. If not, we have to push earlier, so we use the FIFO
-    // a little less efficiently.
-    const uint SHIFT_REG_WIDTH = 32;
-    return SHIFT_REG_WIDTH - (SHIFT_REG_WIDTH % pin_count);
-}
-
-void logic_analyser_init(PIO pio, uint sm, uint pin_base, uint pin_count, float div) {
-    // Load a program to capture n pins. This is just a single `in pins, n`
-    // instruction with a wrap.
-    uint16_t capture_prog_instr = pio_encode_in(pio_pins, pin_count);
-    struct pio_program capture_prog = {
-            .instructions = &capture_prog_instr,
-            .length = 1,
-            .origin = -1
-    };
-    uint offset = pio_add_program(pio, &capture_prog);
-
-    // Configure state machine to loop over this `in` instruction forever,
-    // with autopush enabled.
-    pio_sm_config c = pio_get_default_sm_config();
-    sm_config_set_in_pins(&c, pin_base);
-    sm_config_set_wrap(&c, offset, offset);
-    sm_config_set_clkdiv(&c, div);
-    // Note that we may push at a < 32 bit threshold if pin_count does not
-    // divide 32. We are using shift-to-right, so the sample data ends up
-    // left-justified in the FIFO in this case, with some zeroes at the LSBs.
-    sm_config_set_in_shift(&c, true, true, bits_packed_per_word(pin_count));
-    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_RX);
-    pio_sm_init(pio, sm, offset, &c);
-}
+// PIO IRQ flag the capture state machine waits on. The trigger program also
+// sets PIO_TRIGGER_IRQ_FLAG, which nothing uses here.
+#define PIO_TRIGGER_SYNC_FLAG 4
+#define PIO_TRIGGER_IRQ_FLAG 0
 
 void logic_analyser_arm(PIO pio, uint sm, uint dma_chan, uint32_t *capture_buf, size_t capture_size_words,
-                        uint trigger_pin, bool trigger_level) {
+                        uint trigger_sm, uint trigger_offset, const trigger_program_t *trigger_prog) {
     pio_sm_set_enabled(pio, sm, false);
+    pio_sm_set_enabled(pio, trigger_sm, false);
     // Need to clear _input shift counter_, as well as FIFO, because there may be
     // partial ISR contents left over from a previous run. sm_restart does this.
     pio_sm_clear_fifos(pio, sm);
     pio_sm_restart(pio, sm);
 
+    // Restart the trigger program, and give it its pattern and count words
+    pio_sm_clear_fifos(pio, trigger_sm);
+    pio_sm_restart(pio, trigger_sm);
+    pio_sm_exec(pio, trigger_sm, pio_encode_jmp(trigger_offset));
+    for (uint i = 0; i < trigger_prog->fifo_word_count; ++i) {
+        pio_sm_put(pio, trigger_sm, trigger_prog->fifo_words[i]);
+    }
+    pio_interrupt_clear(pio, PIO_TRIGGER_SYNC_FLAG);
+    pio_interrupt_clear(pio, PIO_TRIGGER_IRQ_FLAG);
+
     dma_channel_config c = dma_channel_get_default_config(dma_chan);
     channel_config_set_read_increment(&c, false);
     channel_config_set_write_increment(&c, true);
@@ -82,29 +73,27 @@ void logic_analyser_arm(PIO pio, uint sm, uint dma_chan, uint32_t *capture_buf,
         true                // Start immediately
     );
 
-    pio_sm_exec(pio, sm, pio_encode_wait_gpio(trigger_level, trigger_pin));
-    pio_sm_set_enabled(pio, sm, true);
+    // Stall the capture until the trigger program sets the sync flag. This
+    // also clears the flag again.
+    pio_sm_exec(pio, sm, pio_encode_wait_irq(true, false, PIO_TRIGGER_SYNC_FLAG));
+    pio_enable_sm_mask_in_sync(pio, (1u << sm) | (1u << trigger_sm));
+}
+
+static void stdout_write(__unused void *ctx, const char *data, size_t len) {
+    fwrite(data, 1, len, stdout);
 }
 
 void print_capture_buf(const uint32_t *buf, uint pin_base, uint pin_count, uint32_t n_samples) {
     // Display the capture buffer in text form, like this:
-    // 00: __--__--__--__--__--__--
-    // 01: ____----____----____----
+    // 16: __--__--__--__--__--__--
+    // 17: ____----____----____----
+    // capture_export.c turns each 32 samples into one word per pin with a bit
+    // transpose, and hands the text to stdio in large chunks, rather than
+    // making a printf() call for every sample of every pin.
+    static capture_export_t exporter;
     printf("Capture:\n");
-    // Each FIFO record may be only partially filled with bits, depending on
-    // whether pin_count is a factor of 32.
-    uint record_size_bits = bits_packed_per_word(pin_count);
-    for (uint pin = 0; pin < pin_count; ++pin) {
-        printf("%02d: ", pin + pin_base);
-        for (uint32_t sample = 0; sample < n_samples; ++sample) {
-            uint bit_index = pin + sample * pin_count;
-            uint word_index = bit_index / record_size_bits;
-            // Data is left-justified in each FIFO entry, hence the (32 - record_size_bits) offset
-            uint word_mask = 1u << (bit_index % record_size_bits + 32 - record_size_bits);
-            printf(buf[word_index] & word_mask ? "-" : "_");
-        }
-        printf("\n");
-    }
+    capture_export_init(&exporter, pin_base, pin_count, stdout_write, NULL);
+    capture_export_text(&exporter, buf, n_samples);
 }
 
 int main() {
@@ -127,12 +116,24 @@ int main() {
 
     PIO pio = pio0;
     uint sm = 0;
+    uint trigger_sm = 1;
     uint dma_chan = 0;
 
     logic_analyser_init(pio, sm, CAPTURE_PIN_BASE, CAPTURE_PIN_COUNT, 1.f);
 
+    // Trigger when the first pin goes high
+    const trigger_stage_t trigger_stages[] = {
+            {.type = TRIGGER_LEVEL, .pin = CAPTURE_PIN_BASE, .value = 1},
+    };
+    trigger_program_t trigger_prog;
+    if (!trigger_program_build(&trigger_prog, trigger_stages, count_of(trigger_stages), CAPTURE_PIN_BASE,
+                               PIO_TRIGGER_SYNC_FLAG, PIO_TRIGGER_IRQ_FLAG)) {
+        panic("Trigger program doesn't fit");
+    }
+    uint trigger_offset = logic_analyser_trigger_init(pio, trigger_sm, &trigger_prog, CAPTURE_PIN_BASE, 1.f);
+
     printf("Arming trigger\n");
-    logic_analyser_arm(pio, sm, dma_chan, capture_buf, buf_size_words, CAPTURE_PIN_BASE, true);
+    logic_analyser_arm(pio, sm, dma_chan, capture_buf, buf_size_words, trigger_sm, trigger_offset, &trigger_prog);
 
     printf("Starting PWM example\n");
     // PWM example: -----------------------------------------------------------
@@ -0,0 +1,40 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _LOGIC_ANALYSER_COMMON_H
+#define _LOGIC_ANALYSER_COMMON_H
+
+// The capture and trigger state machines shared by the logic analyser
+// examples, and arming a single buffer capture on a pin level, for the
+// examples which don't need a trigger program.
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+#include "trigger_program.h"
+
+static inline uint bits_packed_per_word(uint pin_count) {
+    // If the number of pins to be sampled divides the shift register size, we
+    // can use the full SR and FIFO width, and push when the input shift count
+    // exactly reaches 32. If not, we have to push earlier, so we use the FIFO
+    // a little less efficiently.
+    const uint SHIFT_REG_WIDTH = 32;
+    return SHIFT_REG_WIDTH - (SHIFT_REG_WIDTH % pin_count);
+}
+
+// Load the capture program, and set up sm to run it at clock divisor div
+void logic_analyser_init(PIO pio, uint sm, uint pin_base, uint pin_count, float div);
+
+// Load a trigger program built by trigger_program_build(), and set up sm to
+// run it alongside the capture state machine. Returns the program's offset.
+uint logic_analyser_trigger_init(PIO pio, uint sm, const trigger_program_t *prog, uint pin_base, float div);
+
+// Capture capture_size_words words into capture_buf with one DMA channel,
+// starting when trigger_pin is at trigger_level
+void logic_analyser_arm_on_pin(PIO pio, uint sm, uint dma_chan, uint32_t *capture_buf, size_t capture_size_words,
+                               uint trigger_pin, bool trigger_level);
+
+#endif
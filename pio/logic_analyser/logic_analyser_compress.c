@@ -0,0 +1,220 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// PIO logic analyser example, with run-length compression
+//
+// Captures are often mostly idle, so storing every raw sample wastes a lot of
+// memory. This version streams samples into a small ring buffer (as in
+// logic_analyser_stream.c), and core 1 compresses each block into run-length
+// records as soon as the DMA has filled it. The raw data for the whole
+// capture would be many times larger than the RP2040's SRAM.
+//
+// Before capturing, the encoder is benchmarked on both cores so you can see
+// what input sample rate it can sustain for idle and busy signals.
+
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/bus_ctrl.h"
+
+#include "capture_ring.h"
+#include "capture_ring_dma.h"
+#include "logic_analyser_common.h"
+#include "capture_rle.h"
+
+// Some logic to analyse:
+#include "hardware/structs/pwm.h"
+
+#define CAPTURE_PIN_BASE 16
+#define CAPTURE_PIN_COUNT 2
+#define CAPTURE_SAMPLE_RATE_HZ 10000000
+// One second of samples; the raw capture would be 2.5 MB
+#define CAPTURE_N_SAMPLES 10000000
+
+#define CAPTURE_BLOCK_WORDS 256
+#define CAPTURE_BLOCK_COUNT 8
+#define RLE_BUF_WORDS 16384
+
+#define BENCHMARK_WORDS 4096
+#define BENCHMARK_CHUNK_WORDS 64
+#define BENCHMARK_REPEATS 16
+
+#define DMA_IRQ_TO_USE 0
+
+static uint32_t capture_buf[CAPTURE_BLOCK_WORDS * CAPTURE_BLOCK_COUNT];
+static capture_ring_t ring;
+static uint32_t rle_buf[RLE_BUF_WORDS];
+static volatile size_t rle_words;
+static volatile bool rle_truncated;
+static volatile bool rle_done;
+
+void logic_analyser_stream_start(PIO pio, uint sm) {
+    pio_sm_set_enabled(pio, sm, false);
+    pio_sm_clear_fifos(pio, sm);
+    pio_sm_restart(pio, sm);
+
+    capture_ring_dma_setup(pio, sm);
+
+    // No trigger: the capture window starts with the first sample
+    capture_ring_trigger(&ring, 0);
+
+    capture_ring_dma_start();
+    pio_sm_set_enabled(pio, sm, true);
+}
+
+static void core1_compress(void) {
+    capture_rle_encoder_t enc;
+    capture_rle_encoder_init(&enc, CAPTURE_PIN_COUNT);
+    size_t block_max_words = capture_rle_max_encoded_words(CAPTURE_PIN_COUNT, CAPTURE_BLOCK_WORDS);
+    capture_block_t block;
+    while (!capture_ring_drained(&ring)) {
+        if (!capture_ring_peek(&ring, &block)) {
+            continue;
+        }
+        if (rle_words + block_max_words > RLE_BUF_WORDS) {
+            // Out of room (very busy signal); keep draining but stop encoding
+            rle_truncated = true;
+        } else {
+            // The window starts and ends on block boundaries, so blocks are
+            // always whole words
+            const uint32_t *words = block.words + block.sample_offset / ring.samples_per_word;
+            uint32_t n_words = block.sample_count / ring.samples_per_word;
+            rle_words += capture_rle_encode(&enc, words, n_words, rle_buf + rle_words);
+        }
+        capture_ring_release(&ring, &block);
+    }
+    if (!rle_truncated) {
+        rle_words += capture_rle_flush(&enc, rle_buf + rle_words);
+    }
+    rle_done = true;
+}
+
+// Synthetic input for the benchmark: transitions every `period` samples, or
+// never if period is 0
+static uint32_t bench_input[BENCHMARK_WORDS];
+// Room for the worst case of a transition on every sample of a chunk
+static uint32_t bench_output[BENCHMARK_CHUNK_WORDS * 32 + 2];
+
+static void fill_bench_input(uint32_t period) {
+    uint32_t spw = 32 / CAPTURE_PIN_COUNT;
+    uint32_t unused_bits = 32 - spw * CAPTURE_PIN_COUNT;
+    uint32_t sample = 0;
+    for (uint i = 0; i < BENCHMARK_WORDS; ++i) {
+        uint32_t word = 0;
+        for (uint32_t j = 0; j < spw; ++j, ++sample) {
+            uint32_t state = period ? (sample / period) & ((1u << CAPTURE_PIN_COUNT) - 1) : 0;
+            word |= state << (unused_bits + j * CAPTURE_PIN_COUNT);
+        }
+        bench_input[i] = word;
+    }
+}
+
+// Returns the sustainable input rate in samples per second
+static uint32_t benchmark_encode(void) {
+    capture_rle_encoder_t enc;
+    capture_rle_encoder_init(&enc, CAPTURE_PIN_COUNT);
+    uint64_t start = time_us_64();
+    for (uint i = 0; i < BENCHMARK_REPEATS; ++i) {
+        for (uint j = 0; j < BENCHMARK_WORDS; j += BENCHMARK_CHUNK_WORDS) {
+            capture_rle_encode(&enc, bench_input + j, BENCHMARK_CHUNK_WORDS, bench_output);
+        }
+    }
+    uint64_t elapsed_us = time_us_64() - start;
+    uint64_t samples = (uint64_t)BENCHMARK_REPEATS * BENCHMARK_WORDS * (32 / CAPTURE_PIN_COUNT);
+    return (uint32_t)(samples * 1000000 / elapsed_us);
+}
+
+static void core1_benchmark(void) {
+    multicore_fifo_push_blocking(benchmark_encode());
+}
+
+static void run_benchmarks(void) {
+    // Transition periods in samples; 0 is a completely idle line
+    static const uint32_t periods[] = {0, 1000, 100, 10, 1};
+    printf("Encoder throughput (%d pins):\n", CAPTURE_PIN_COUNT);
+    for (uint i = 0; i < count_of(periods); ++i) {
+        fill_bench_input(periods[i]);
+        uint32_t core0_rate = benchmark_encode();
+        multicore_reset_core1();
+        multicore_launch_core1(core1_benchmark);
+        uint32_t core1_rate = multicore_fifo_pop_blocking();
+        if (periods[i]) {
+            printf("  transition every %4u samples: ", periods[i]);
+        } else {
+            printf("  idle:                          ");
+        }
+        printf("core 0 %3u.%u Msamples/s, core 1 %3u.%u Msamples/s\n",
+               core0_rate / 1000000, (core0_rate / 100000) % 10,
+               core1_rate / 1000000, (core1_rate / 100000) % 10);
+    }
+    multicore_reset_core1();
+}
+
+int main() {
+    stdio_init_all();
+    printf("PIO logic analyser compression example\n");
+
+    run_benchmarks();
+
+    // Round the capture up to whole blocks, so the encoder always sees whole words
+    uint32_t samples_per_block = CAPTURE_BLOCK_WORDS * (32 / CAPTURE_PIN_COUNT);
+    uint32_t n_samples = (CAPTURE_N_SAMPLES + samples_per_block - 1) / samples_per_block * samples_per_block;
+    capture_ring_init(&ring, capture_buf, CAPTURE_BLOCK_WORDS, CAPTURE_BLOCK_COUNT, CAPTURE_PIN_COUNT, 0, n_samples);
+
+    bus_ctrl_hw->priority = BUSCTRL_BUS_PRIORITY_DMA_W_BITS | BUSCTRL_BUS_PRIORITY_DMA_R_BITS;
+
+    PIO pio = pio0;
+    uint sm = pio_claim_unused_sm(pio, true);
+    capture_ring_dma_init(&ring, DMA_IRQ_TO_USE);
+
+    float div = (float)clock_get_hz(clk_sys) / CAPTURE_SAMPLE_RATE_HZ;
+    logic_analyser_init(pio, sm, CAPTURE_PIN_BASE, CAPTURE_PIN_COUNT, div);
+
+
+    printf("Starting PWM example\n");
+    // PWM example: -----------------------------------------------------------
+    gpio_set_function(CAPTURE_PIN_BASE, GPIO_FUNC_PWM);
+    gpio_set_function(CAPTURE_PIN_BASE + 1, GPIO_FUNC_PWM);
+    // Count at 1 MHz, wrapping every 1000 counts, so the period is 1 ms
+    pwm_hw->slice[0].top = 999;
+    pwm_hw->slice[0].div = (clock_get_hz(clk_sys) / 1000000) << PWM_CH0_DIV_INT_LSB;
+    // Channel A has duty cycle 1/4 and channel B 3/4
+    pwm_hw->slice[0].cc =
+            (250 << PWM_CH0_CC_A_LSB) |
+            (750 << PWM_CH0_CC_B_LSB);
+    pwm_hw->slice[0].csr = PWM_CH0_CSR_EN_BITS;
+    // ------------------------------------------------------------------------
+
+    printf("Capturing %u samples at %u Hz\n", n_samples, CAPTURE_SAMPLE_RATE_HZ);
+    multicore_launch_core1(core1_compress);
+    logic_analyser_stream_start(pio, sm);
+    while (!rle_done) {
+        tight_loop_contents();
+    }
+    pio_sm_set_enabled(pio, sm, false);
+
+    uint32_t raw_bytes = n_samples / (32 / CAPTURE_PIN_COUNT) * sizeof(uint32_t);
+    uint32_t rle_bytes = rle_words * sizeof(uint32_t);
+    printf("Raw capture %u bytes, compressed %u bytes (%u:1)%s, %u overruns\n", raw_bytes, rle_bytes,
+           rle_bytes ? raw_bytes / rle_bytes : 0, rle_truncated ? " TRUNCATED" : "", ring.overruns);
+
+    static capture_rle_transition_t transitions[16];
+    size_t n = capture_rle_transitions(CAPTURE_PIN_COUNT, rle_buf, rle_words, transitions, count_of(transitions));
+    printf("First transitions:\n");
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t t_ns = transitions[i].sample * 1000000000ull / CAPTURE_SAMPLE_RATE_HZ;
+        printf("  %10llu ns: ", t_ns);
+        for (uint pin = 0; pin < CAPTURE_PIN_COUNT; ++pin) {
+            printf("%02d=%c ", CAPTURE_PIN_BASE + pin, transitions[i].state & (1u << pin) ? '1' : '0');
+        }
+        printf("\n");
+    }
+}
@@ -0,0 +1,276 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// PIO logic analyser example, with protocol decoding
+//
+// This captures the output of the UART, triggered by the first start bit,
+// and decodes the capture with capture_decode.c rather than printing it bit
+// by bit. No wiring is needed: PIO can sample a pin which is being driven by
+// another peripheral.
+//
+// It then benchmarks each of the decoders (UART, SPI, I2C and 1-Wire) on a
+// synthesised capture, checking the decoded data as it goes, and prints the
+// throughput in MB/s of capture data.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/clocks.h"
+#include "hardware/uart.h"
+
+#include "capture_decode.h"
+#include "logic_analyser_common.h"
+
+#define CAPTURE_PIN_BASE 4
+#define CAPTURE_PIN_COUNT 1
+#define CAPTURE_N_SAMPLES 8192
+
+#define UART_ID uart1
+#define UART_TX_PIN 4
+#define UART_BAUD 115200
+#define UART_OVERSAMPLE 16
+
+// Synthesised captures for the benchmark use 4 pins, so 8 samples per word
+#define BENCH_PIN_COUNT 4
+#define BENCH_WORDS 16384
+#define BENCH_MAX_EVENTS 8192
+
+static const char message[] = "Hello, logic analyser!";
+
+// ----------------------------------------------------------------------------
+// Synthesised captures for the benchmark
+
+static uint32_t bench_buf[BENCH_WORDS];
+static capture_event_t bench_events[BENCH_MAX_EVENTS];
+static uint32_t synth_samples;
+static uint32_t synth_state;
+
+static void synth_hold(uint32_t state, uint32_t samples) {
+    const uint32_t spw = 32 / BENCH_PIN_COUNT;
+    synth_state = state;
+    for (uint32_t i = 0; i < samples; ++i, ++synth_samples) {
+        if (synth_samples % spw == 0) {
+            bench_buf[synth_samples / spw] = 0;
+        }
+        bench_buf[synth_samples / spw] |= state << ((synth_samples % spw) * BENCH_PIN_COUNT);
+    }
+}
+
+static void synth_pin(uint pin, uint value, uint32_t samples) {
+    synth_hold((synth_state & ~(1u << pin)) | (value << pin), samples);
+}
+
+static bool synth_room(uint32_t samples) {
+    return synth_samples + samples < BENCH_WORDS * (32 / BENCH_PIN_COUNT);
+}
+
+static inline uint8_t message_byte(uint i) {
+    return (uint8_t)message[i % (sizeof(message) - 1)];
+}
+
+// 8N1 on pin 0, 16 samples per bit; returns the number of bytes
+static uint synth_uart(void) {
+    uint n = 0;
+    synth_samples = 0;
+    synth_hold(0xf, 32);
+    while (synth_room(11 * 16)) {
+        uint8_t c = message_byte(n++);
+        synth_pin(0, 0, 16);
+        for (uint bit = 0; bit < 8; ++bit) {
+            synth_pin(0, (c >> bit) & 1u, 16);
+        }
+        synth_pin(0, 1, 16 + n % 8);
+    }
+    return n;
+}
+
+// Mode 0, MSB first: SCK on pin 0, MOSI 1, MISO 2, CS 3
+static uint synth_spi(void) {
+    uint n = 0;
+    synth_samples = 0;
+    synth_hold(0x8, 16);
+    while (synth_room(8 * 6 + 16)) {
+        uint8_t mosi = message_byte(n++);
+        uint8_t miso = ~mosi;
+        synth_pin(3, 0, 3);
+        for (int bit = 7; bit >= 0; --bit) {
+            synth_hold((synth_state & 0x8) | ((mosi >> bit) & 1u) << 1 | ((miso >> bit) & 1u) << 2, 3);
+            synth_pin(0, 1, 3);
+        }
+        synth_pin(0, 0, 2);
+        synth_pin(3, 1, 5);
+    }
+    return n;
+}
+
+// SCL on pin 0, SDA on pin 1: address then three data bytes per transfer
+static uint synth_i2c(void) {
+    uint n = 0;
+    synth_samples = 0;
+    synth_hold(0x3, 16);
+    while (synth_room(4 * 9 * 8 + 32)) {
+        synth_pin(1, 0, 4);
+        synth_pin(0, 0, 4);
+        for (uint i = 0; i < 4; ++i) {
+            uint8_t byte = i ? message_byte(n++) : 0x42 << 1;
+            for (int bit = 7; bit >= 0; --bit) {
+                synth_pin(1, (byte >> bit) & 1u, 2);
+                synth_pin(0, 1, 4);
+                synth_pin(0, 0, 2);
+            }
+            // ACK, or NAK for the last byte
+            synth_pin(1, i == 3, 2);
+            synth_pin(0, 1, 4);
+            synth_pin(0, 0, 2);
+        }
+        synth_pin(1, 0, 2);
+        synth_pin(0, 1, 4);
+        synth_pin(1, 1, 10);
+    }
+    return n;
+}
+
+// Pin 0 at 1 sample per microsecond: reset, presence, then four bytes
+static uint synth_onewire(void) {
+    uint n = 0;
+    synth_samples = 0;
+    synth_hold(0xf, 100);
+    while (synth_room(940 + 4 * 8 * 70)) {
+        synth_pin(0, 0, 480);
+        synth_pin(0, 1, 40);
+        synth_pin(0, 0, 120);
+        synth_pin(0, 1, 300);
+        for (uint i = 0; i < 4; ++i) {
+            uint8_t byte = message_byte(n++);
+            for (uint bit = 0; bit < 8; ++bit) {
+                bool one = (byte >> bit) & 1u;
+                synth_pin(0, 0, one ? 6 : 60);
+                synth_pin(0, 1, one ? 64 : 10);
+            }
+        }
+    }
+    return n;
+}
+
+static uint count_data_events(size_t n_events, uint8_t type) {
+    uint n = 0;
+    for (size_t i = 0; i < n_events; ++i) {
+        if (bench_events[i].type == type) {
+            if (bench_events[i].data != message_byte(n) || (bench_events[i].flags & ~CAPTURE_EVENT_FLAG_NAK)) {
+                return 0;
+            }
+            ++n;
+        }
+    }
+    return n;
+}
+
+static void report(const char *name, uint expected, uint decoded, uint64_t elapsed_us, uint repeats) {
+    uint32_t bytes = synth_samples / (32 / BENCH_PIN_COUNT) * sizeof(uint32_t);
+    uint32_t kb_per_s = (uint32_t)((uint64_t)bytes * repeats * 1000 / 1024 / elapsed_us);
+    printf("  %-7s %5u bytes %s, %4u.%02u MB/s\n", name, decoded, decoded == expected ? "ok    " : "FAILED",
+           kb_per_s / 1024, (kb_per_s % 1024) * 100 / 1024);
+}
+
+#define BENCH_REPEATS 8
+
+static void run_benchmarks(void) {
+    capture_view_t view;
+    size_t n_events = 0;
+    uint64_t start;
+    uint expected;
+
+    printf("Decoder throughput (%u KB captures, %d pins):\n", (uint)sizeof(bench_buf) / 1024, BENCH_PIN_COUNT);
+
+    expected = synth_uart();
+    capture_view_init(&view, bench_buf, synth_samples, BENCH_PIN_COUNT);
+    capture_uart_config_t uart_config = {.pin = 0, .data_bits = 8, .parity = CAPTURE_UART_PARITY_NONE,
+                                         .samples_per_bit = 16 << 16};
+    start = time_us_64();
+    for (uint i = 0; i < BENCH_REPEATS; ++i) {
+        n_events = capture_decode_uart(&view, &uart_config, bench_events, BENCH_MAX_EVENTS);
+    }
+    report("UART", expected, count_data_events(n_events, CAPTURE_EVENT_UART_BYTE), time_us_64() - start, BENCH_REPEATS);
+
+    expected = synth_spi();
+    capture_view_init(&view, bench_buf, synth_samples, BENCH_PIN_COUNT);
+    capture_spi_config_t spi_config = {.sck = 0, .mosi = 1, .miso = 2, .cs = 3, .mode = 0, .bits_per_word = 8,
+                                       .msb_first = true};
+    start = time_us_64();
+    for (uint i = 0; i < BENCH_REPEATS; ++i) {
+        n_events = capture_decode_spi(&view, &spi_config, bench_events, BENCH_MAX_EVENTS);
+    }
+    report("SPI", expected, count_data_events(n_events, CAPTURE_EVENT_SPI_WORD), time_us_64() - start, BENCH_REPEATS);
+
+    expected = synth_i2c();
+    capture_view_init(&view, bench_buf, synth_samples, BENCH_PIN_COUNT);
+    capture_i2c_config_t i2c_config = {.scl = 0, .sda = 1};
+    start = time_us_64();
+    for (uint i = 0; i < BENCH_REPEATS; ++i) {
+        n_events = capture_decode_i2c(&view, &i2c_config, bench_events, BENCH_MAX_EVENTS);
+    }
+    report("I2C", expected, count_data_events(n_events, CAPTURE_EVENT_I2C_DATA), time_us_64() - start, BENCH_REPEATS);
+
+    expected = synth_onewire();
+    capture_view_init(&view, bench_buf, synth_samples, BENCH_PIN_COUNT);
+    capture_onewire_config_t onewire_config = {.pin = 0, .samples_per_us = 1 << 16};
+    start = time_us_64();
+    for (uint i = 0; i < BENCH_REPEATS; ++i) {
+        n_events = capture_decode_onewire(&view, &onewire_config, bench_events, BENCH_MAX_EVENTS);
+    }
+    report("1-Wire", expected, count_data_events(n_events, CAPTURE_EVENT_ONEWIRE_BYTE), time_us_64() - start,
+           BENCH_REPEATS);
+}
+
+// ----------------------------------------------------------------------------
+
+int main() {
+    stdio_init_all();
+    printf("PIO logic analyser decode example\n");
+
+    uint total_sample_bits = CAPTURE_N_SAMPLES * CAPTURE_PIN_COUNT;
+    total_sample_bits += bits_packed_per_word(CAPTURE_PIN_COUNT) - 1;
+    uint buf_size_words = total_sample_bits / bits_packed_per_word(CAPTURE_PIN_COUNT);
+    uint32_t *capture_buf = malloc(buf_size_words * sizeof(uint32_t));
+    hard_assert(capture_buf);
+
+    PIO pio = pio0;
+    uint sm = pio_claim_unused_sm(pio, true);
+    uint dma_chan = dma_claim_unused_channel(true);
+
+    // Sample the UART output at 16x the baud rate
+    uart_init(UART_ID, UART_BAUD);
+    gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART);
+    float div = (float)clock_get_hz(clk_sys) / (UART_BAUD * UART_OVERSAMPLE);
+    logic_analyser_init(pio, sm, CAPTURE_PIN_BASE, CAPTURE_PIN_COUNT, div);
+
+    // Trigger on the first start bit
+    printf("Arming trigger\n");
+    logic_analyser_arm_on_pin(pio, sm, dma_chan, capture_buf, buf_size_words, UART_TX_PIN, false);
+    uart_puts(UART_ID, message);
+    dma_channel_wait_for_finish_blocking(dma_chan);
+
+    capture_view_t view;
+    capture_view_init(&view, capture_buf, CAPTURE_N_SAMPLES, CAPTURE_PIN_COUNT);
+    capture_uart_config_t uart_config = {
+            .pin = UART_TX_PIN - CAPTURE_PIN_BASE,
+            .data_bits = 8,
+            .parity = CAPTURE_UART_PARITY_NONE,
+            .samples_per_bit = UART_OVERSAMPLE << 16
+    };
+    capture_event_t events[64];
+    size_t n_events = capture_decode_uart(&view, &uart_config, events, count_of(events));
+    printf("Decoded %u UART bytes: \"", (uint)n_events);
+    for (size_t i = 0; i < n_events; ++i) {
+        putchar(events[i].flags ? '?' : events[i].data);
+    }
+    printf("\"\n");
+
+    run_benchmarks();
+}
@@ -0,0 +1,218 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// PIO logic analyser example, with text and VCD output
+//
+// This captures two PWM outputs, as logic_analyser.c does, and prints the
+// capture using capture_export.c: first as text, then as a VCD file which can
+// be pasted into GTKWave or PulseView.
+//
+// It then compares the cost of rendering a 1M sample capture one bit at a
+// time (as print_capture_buf() used to) with the bit plane version, for a few
+// pin counts. The output goes to RAM rather than stdio, so this only measures
+// the CPU time. Over stdio the per-bit version also pays for a printf() call
+// per character, which is timed separately for the live capture.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/clocks.h"
+
+#include "capture_export.h"
+#include "logic_analyser_common.h"
+
+// Some logic to analyse:
+#include "hardware/structs/pwm.h"
+
+#define CAPTURE_PIN_BASE 16
+#define CAPTURE_PIN_COUNT 2
+#define CAPTURE_N_SAMPLES 256
+
+// The benchmark buffer is reused until this many samples have been rendered
+#define BENCH_N_SAMPLES (1u << 20)
+#define BENCH_WORDS 8192
+
+// The original print_capture_buf(), with the output character function passed
+// in so it can also be pointed at RAM
+static void render_capture_per_bit(const uint32_t *buf, uint pin_base, uint pin_count, uint32_t n_samples,
+                                   void (*put_char)(char)) {
+    uint record_size_bits = bits_packed_per_word(pin_count);
+    for (uint pin = 0; pin < pin_count; ++pin) {
+        put_char((char)('0' + (pin + pin_base) / 10));
+        put_char((char)('0' + (pin + pin_base) % 10));
+        put_char(':');
+        put_char(' ');
+        for (uint32_t sample = 0; sample < n_samples; ++sample) {
+            uint bit_index = pin + sample * pin_count;
+            uint word_index = bit_index / record_size_bits;
+            // Data is left-justified in each FIFO entry, hence the (32 - record_size_bits) offset
+            uint word_mask = 1u << (bit_index % record_size_bits + 32 - record_size_bits);
+            put_char(buf[word_index] & word_mask ? '-' : '_');
+        }
+        put_char('\n');
+    }
+}
+
+static void stdout_put_char(char c) {
+    printf("%c", c);
+}
+
+static void stdout_write(__unused void *ctx, const char *data, size_t len) {
+    fwrite(data, 1, len, stdout);
+}
+
+// RAM output for the benchmark. If buf is NULL, the output is only counted.
+typedef struct ram_sink {
+    char *buf;
+    size_t size;
+    size_t len;
+} ram_sink_t;
+
+static ram_sink_t ram_sink;
+
+static void ram_put_char(char c) {
+    if (ram_sink.len < ram_sink.size) {
+        ram_sink.buf[ram_sink.len] = c;
+    }
+    ram_sink.len++;
+}
+
+static void ram_write(void *ctx, const char *data, size_t len) {
+    ram_sink_t *sink = (ram_sink_t *)ctx;
+    if (sink->len + len <= sink->size) {
+        memcpy(sink->buf + sink->len, data, len);
+    }
+    sink->len += len;
+}
+
+// Called through a pointer, as a stand-in for printf()
+static void (*volatile bench_put_char)(char) = ram_put_char;
+
+static uint32_t bench_buf[BENCH_WORDS];
+static capture_export_t exporter;
+
+// Square waves of a different period on each pin
+static uint32_t synth_capture(uint pin_count) {
+    uint32_t samples_per_word = bits_packed_per_word(pin_count) / pin_count;
+    uint32_t unused_bits = 32 - bits_packed_per_word(pin_count);
+    uint32_t n_samples = BENCH_WORDS * samples_per_word;
+    memset(bench_buf, 0, sizeof(bench_buf));
+    for (uint32_t sample = 0; sample < n_samples; ++sample) {
+        for (uint pin = 0; pin < pin_count; ++pin) {
+            uint32_t half_period = 3 + 5 * pin;
+            uint32_t bit = (sample / half_period) & 1u;
+            bench_buf[sample / samples_per_word] |=
+                    bit << (unused_bits + (sample % samples_per_word) * pin_count + pin);
+        }
+    }
+    return n_samples;
+}
+
+static bool check_text(uint pin_count) {
+    // The first row of text should match the per-bit version exactly
+    static char expected[32 * (CAPTURE_EXPORT_TEXT_WIDTH + 5)];
+    static char actual[sizeof(expected)];
+    ram_sink = (ram_sink_t){.buf = expected, .size = sizeof(expected)};
+    render_capture_per_bit(bench_buf, CAPTURE_PIN_BASE, pin_count, CAPTURE_EXPORT_TEXT_WIDTH, ram_put_char);
+    ram_sink_t sink = {.buf = actual, .size = sizeof(actual)};
+    capture_export_init(&exporter, CAPTURE_PIN_BASE, pin_count, ram_write, &sink);
+    capture_export_text(&exporter, bench_buf, CAPTURE_EXPORT_TEXT_WIDTH);
+    return sink.len == ram_sink.len && !memcmp(expected, actual, sink.len);
+}
+
+static void run_benchmarks(void) {
+    static const uint bench_pin_counts[] = {1, 2, 4, 8, 16};
+    printf("\nRendering %u samples (%u KB buffer, reused):\n", BENCH_N_SAMPLES, (uint)sizeof(bench_buf) / 1024);
+    for (uint i = 0; i < count_of(bench_pin_counts); ++i) {
+        uint pin_count = bench_pin_counts[i];
+        uint32_t n_samples = synth_capture(pin_count);
+        uint passes = BENCH_N_SAMPLES / n_samples;
+        bool ok = check_text(pin_count);
+
+        ram_sink = (ram_sink_t){0};
+        uint64_t start = time_us_64();
+        for (uint pass = 0; pass < passes; ++pass) {
+            render_capture_per_bit(bench_buf, CAPTURE_PIN_BASE, pin_count, n_samples, bench_put_char);
+        }
+        uint64_t per_bit_us = time_us_64() - start;
+
+        ram_sink_t sink = {0};
+        capture_export_init(&exporter, CAPTURE_PIN_BASE, pin_count, ram_write, &sink);
+        start = time_us_64();
+        for (uint pass = 0; pass < passes; ++pass) {
+            capture_export_text(&exporter, bench_buf, n_samples);
+        }
+        uint64_t text_us = time_us_64() - start;
+
+        sink.len = 0;
+        start = time_us_64();
+        capture_export_vcd_begin(&exporter, 1000);
+        for (uint pass = 0; pass < passes; ++pass) {
+            capture_export_vcd_samples(&exporter, bench_buf, n_samples);
+        }
+        capture_export_vcd_end(&exporter);
+        uint64_t vcd_us = time_us_64() - start;
+
+        printf("  %2u pins: per-bit %6u ms, bit planes %5u ms (%2ux faster, %s), VCD %5u ms (%u KB)\n",
+               pin_count, (uint)(per_bit_us / 1000), (uint)(text_us / 1000), (uint)(per_bit_us / text_us),
+               ok ? "output matches" : "OUTPUT DIFFERS", (uint)(vcd_us / 1000), (uint)(sink.len / 1024));
+    }
+}
+
+int main() {
+    stdio_init_all();
+    printf("PIO logic analyser export example\n");
+
+    uint total_sample_bits = CAPTURE_N_SAMPLES * CAPTURE_PIN_COUNT;
+    total_sample_bits += bits_packed_per_word(CAPTURE_PIN_COUNT) - 1;
+    uint buf_size_words = total_sample_bits / bits_packed_per_word(CAPTURE_PIN_COUNT);
+    uint32_t *capture_buf = malloc(buf_size_words * sizeof(uint32_t));
+    hard_assert(capture_buf);
+
+    PIO pio = pio0;
+    uint sm = pio_claim_unused_sm(pio, true);
+    uint dma_chan = dma_claim_unused_channel(true);
+
+    logic_analyser_init(pio, sm, CAPTURE_PIN_BASE, CAPTURE_PIN_COUNT, 1.f);
+    logic_analyser_arm_on_pin(pio, sm, dma_chan, capture_buf, buf_size_words, CAPTURE_PIN_BASE, true);
+
+    // Same PWM setup as logic_analyser.c
+    gpio_set_function(CAPTURE_PIN_BASE, GPIO_FUNC_PWM);
+    gpio_set_function(CAPTURE_PIN_BASE + 1, GPIO_FUNC_PWM);
+    pwm_hw->slice[0].top = 3;
+    pwm_hw->slice[0].div = 4 << PWM_CH0_DIV_INT_LSB;
+    pwm_hw->slice[0].cc =
+            (1 << PWM_CH0_CC_A_LSB) |
+            (3 << PWM_CH0_CC_B_LSB);
+    pwm_hw->slice[0].csr = PWM_CH0_CSR_EN_BITS;
+
+    dma_channel_wait_for_finish_blocking(dma_chan);
+
+    printf("Capture, one character at a time:\n");
+    uint64_t start = time_us_64();
+    render_capture_per_bit(capture_buf, CAPTURE_PIN_BASE, CAPTURE_PIN_COUNT, CAPTURE_N_SAMPLES, stdout_put_char);
+    uint64_t per_bit_us = time_us_64() - start;
+
+    printf("Capture, from bit planes:\n");
+    capture_export_init(&exporter, CAPTURE_PIN_BASE, CAPTURE_PIN_COUNT, stdout_write, NULL);
+    start = time_us_64();
+    capture_export_text(&exporter, capture_buf, CAPTURE_N_SAMPLES);
+    uint64_t text_us = time_us_64() - start;
+    printf("Printing took %u us one character at a time, %u us from bit planes\n",
+           (uint)per_bit_us, (uint)text_us);
+
+    // The samples were taken at the system clock frequency
+    printf("\nVCD:\n");
+    capture_export_vcd_begin(&exporter, (uint32_t)(1000000000000ull / clock_get_hz(clk_sys)));
+    capture_export_vcd_samples(&exporter, capture_buf, CAPTURE_N_SAMPLES);
+    capture_export_vcd_end(&exporter);
+
+    run_benchmarks();
+}
@@ -0,0 +1,274 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// PIO logic analyser example, streaming version
+//
+// Rather than stalling the capture state machine until the trigger condition
+// is seen, this version samples continuously into a ring buffer. Two DMA
+// channels are chained to each other, and each is re-pointed at the next free
+// block of the ring from the DMA IRQ as soon as it finishes, so there are no
+// gaps between blocks even at full system clock sample rate.
+//
+// A second state machine runs a trigger program built from the table in
+// trigger_stages (see trigger_program.h), and raises a PIO IRQ when it
+// matches. A third state machine counts cycles from the start of the capture
+// until the match, which gives the trigger position to within a few samples;
+// it is then located exactly in the captured data. The blocks covering
+// CAPTURE_PRE_TRIGGER_SAMPLES before the trigger and
+// CAPTURE_POST_TRIGGER_SAMPLES after it are handed to the consumer in order.
+
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "pico/sync.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/structs/bus_ctrl.h"
+
+#include "capture_ring.h"
+#include "capture_ring_dma.h"
+#include "logic_analyser_common.h"
+#include "trigger_program.h"
+
+// Some logic to analyse:
+#include "hardware/structs/pwm.h"
+
+#define CAPTURE_PIN_BASE 16
+#define CAPTURE_PIN_COUNT 2
+
+// Each block must take longer to fill than the worst case DMA IRQ latency. At
+// 2 pins and full speed, 256 words is 4096 system clock cycles.
+#define CAPTURE_BLOCK_WORDS 256
+#define CAPTURE_BLOCK_COUNT 8
+#define CAPTURE_PRE_TRIGGER_SAMPLES 32
+#define CAPTURE_POST_TRIGGER_SAMPLES 96
+
+#define DMA_IRQ_TO_USE 0
+#define PIO_IRQ_TO_USE 0
+// Flag raised to the processor when the trigger matches
+#define PIO_TRIGGER_IRQ_FLAG 0
+// Flag which stops the sample counter; this can't interrupt the processor
+#define PIO_TRIGGER_SYNC_FLAG 4
+
+// Trigger on the third rising edge of the second pin, followed by both pins
+// being high
+static const trigger_stage_t trigger_stages[] = {
+        {.type = TRIGGER_RISING, .pin = CAPTURE_PIN_BASE + 1, .count = 3},
+        {.type = TRIGGER_PATTERN, .pin = CAPTURE_PIN_BASE, .width = 2, .value = 0x3},
+};
+
+static uint32_t capture_buf[CAPTURE_BLOCK_WORDS * CAPTURE_BLOCK_COUNT];
+static capture_ring_t ring;
+
+static PIO pio;
+static uint capture_sm;
+static uint trigger_sm;
+static uint trigger_offset;
+static uint counter_sm;
+static uint counter_offset;
+static trigger_program_t trigger_prog;
+
+static volatile bool trigger_seen;
+static volatile uint64_t trigger_seen_at_sample;
+
+uint logic_analyser_counter_init(PIO pio, uint sm, float div) {
+    // Count down X every two cycles until the trigger sets the sync flag
+    uint16_t counter_prog_instr[] = {
+            pio_encode_wait_irq(false, false, PIO_TRIGGER_SYNC_FLAG),
+            pio_encode_jmp_x_dec(0), // relocated by pio_add_program
+    };
+    struct pio_program counter_prog = {
+            .instructions = counter_prog_instr,
+            .length = count_of(counter_prog_instr),
+            .origin = -1
+    };
+    uint offset = pio_add_program(pio, &counter_prog);
+
+    pio_sm_config c = pio_get_default_sm_config();
+    // When X runs out, `jmp x--` falls through; wrap back to the `wait` so
+    // the count carries on from 0xffffffff, still two cycles a step
+    sm_config_set_wrap(&c, offset, offset + 1);
+    sm_config_set_clkdiv(&c, div);
+    pio_sm_init(pio, sm, offset, &c);
+    return offset;
+}
+
+// The counter holds half the sample count in 32 bits, so wraps every 2^33
+// samples (over a minute at full speed). The ring's count of blocks written
+// gives the high bits: the trigger can't be more than the two blocks the DMA
+// owns, and what's in the FIFO, ahead of the blocks already written.
+static uint64_t counter_to_sample(uint32_t count) {
+    const uint64_t period = 1ull << 33;
+    uint64_t low = (uint64_t)count * 2;
+    uint64_t limit = ((uint64_t)ring.blocks_written + 3) * ring.samples_per_block;
+    if (limit < low) {
+        return low;
+    }
+    return limit - (limit - low) % period;
+}
+
+static void pio_irq_handler(void) {
+    pio_interrupt_clear(pio, PIO_TRIGGER_IRQ_FLAG);
+    pio_set_irqn_source_enabled(pio, PIO_IRQ_TO_USE, pis_interrupt0 + PIO_TRIGGER_IRQ_FLAG, false);
+    // The counter is stalled on the sync flag, so fish out its X register
+    pio_sm_exec(pio, counter_sm, pio_encode_mov(pio_isr, pio_x));
+    pio_sm_exec(pio, counter_sm, pio_encode_push(false, false));
+    uint32_t count = ~pio_sm_get(pio, counter_sm);
+    trigger_seen_at_sample = counter_to_sample(count);
+    trigger_seen = true;
+}
+
+void logic_analyser_stream_arm(PIO pio, uint capture_sm, uint trigger_sm, uint counter_sm) {
+    uint sm_mask = (1u << capture_sm) | (1u << trigger_sm) | (1u << counter_sm);
+    pio_set_sm_mask_enabled(pio, sm_mask, false);
+    pio_sm_clear_fifos(pio, capture_sm);
+    pio_sm_restart(pio, capture_sm);
+
+    pio_sm_clear_fifos(pio, trigger_sm);
+    pio_sm_restart(pio, trigger_sm);
+    pio_sm_exec(pio, trigger_sm, pio_encode_jmp(trigger_offset));
+    for (uint i = 0; i < trigger_prog.fifo_word_count; ++i) {
+        pio_sm_put(pio, trigger_sm, trigger_prog.fifo_words[i]);
+    }
+
+    pio_sm_clear_fifos(pio, counter_sm);
+    pio_sm_restart(pio, counter_sm);
+    pio_sm_exec(pio, counter_sm, pio_encode_jmp(counter_offset));
+    pio_sm_exec(pio, counter_sm, pio_encode_mov_not(pio_x, pio_null));
+
+    capture_ring_dma_setup(pio, capture_sm);
+
+    trigger_seen = false;
+    pio_interrupt_clear(pio, PIO_TRIGGER_IRQ_FLAG);
+    pio_interrupt_clear(pio, PIO_TRIGGER_SYNC_FLAG);
+    pio_set_irqn_source_enabled(pio, PIO_IRQ_TO_USE, pis_interrupt0 + PIO_TRIGGER_IRQ_FLAG, true);
+
+    capture_ring_dma_start();
+    // Start all the state machines on the same cycle, so the counter counts
+    // samples, and sample 0 is the first one the trigger could have matched
+    pio_enable_sm_mask_in_sync(pio, sm_mask);
+}
+
+static uint64_t find_trigger_sample(uint64_t seen_at_sample) {
+    // The counter only resolves to two cycles, and the trigger program takes
+    // a few cycles to notice the final condition, so look back over that
+    // window for the sample where it actually happened.
+    const trigger_stage_t *stage = &trigger_stages[count_of(trigger_stages) - 1];
+    uint64_t last = seen_at_sample + 1;
+    uint64_t first = last > trigger_prog.match_latency + 2 ? last - trigger_prog.match_latency - 2 : 1;
+    bool found = false;
+    uint64_t sample = last;
+    for (uint64_t s = last; s >= first; --s) {
+        if (!capture_ring_sample_retained(&ring, s) || !capture_ring_sample_retained(&ring, s - 1)) {
+            break;
+        }
+        bool hit = trigger_stage_hit(stage, CAPTURE_PIN_BASE, capture_ring_get_sample(&ring, s - 1),
+                                     capture_ring_get_sample(&ring, s));
+        if (hit) {
+            found = true;
+            sample = s;
+            if (stage->type == TRIGGER_RISING || stage->type == TRIGGER_FALLING || stage->type == TRIGGER_ANY_EDGE) {
+                break;
+            }
+        } else if (found) {
+            // Start of the run of samples where the level or pattern held
+            break;
+        }
+    }
+    // Otherwise the trigger pins aren't being captured; use the estimate
+    return found ? sample : seen_at_sample;
+}
+
+void print_capture_block(const capture_block_t *block, uint pin_base, uint pin_count, uint64_t trigger_sample) {
+    printf("Samples %llu to %llu:\n", block->first_sample, block->first_sample + block->sample_count - 1);
+    for (uint pin = 0; pin < pin_count; ++pin) {
+        printf("%02d: ", pin + pin_base);
+        for (uint32_t i = 0; i < block->sample_count; ++i) {
+            uint32_t sample = capture_ring_get_sample(&ring, block->first_sample + i);
+            printf(sample & (1u << pin) ? "-" : "_");
+        }
+        printf("\n");
+    }
+    if (trigger_sample >= block->first_sample && trigger_sample < block->first_sample + block->sample_count) {
+        printf("    %*s^ trigger\n", (int)(trigger_sample - block->first_sample), "");
+    }
+}
+
+int main() {
+    stdio_init_all();
+    printf("PIO logic analyser streaming example\n");
+
+    capture_ring_init(&ring, capture_buf, CAPTURE_BLOCK_WORDS, CAPTURE_BLOCK_COUNT, CAPTURE_PIN_COUNT,
+                      CAPTURE_PRE_TRIGGER_SAMPLES, CAPTURE_POST_TRIGGER_SAMPLES);
+
+    // Grant high bus priority to the DMA, so it can shove the processors out
+    // of the way. This should only be needed if you are pushing things up to
+    // >16bits/clk here, i.e. if you need to saturate the bus completely.
+    bus_ctrl_hw->priority = BUSCTRL_BUS_PRIORITY_DMA_W_BITS | BUSCTRL_BUS_PRIORITY_DMA_R_BITS;
+
+    pio = pio0;
+    capture_sm = pio_claim_unused_sm(pio, true);
+    trigger_sm = pio_claim_unused_sm(pio, true);
+    counter_sm = pio_claim_unused_sm(pio, true);
+    capture_ring_dma_init(&ring, DMA_IRQ_TO_USE);
+
+    logic_analyser_init(pio, capture_sm, CAPTURE_PIN_BASE, CAPTURE_PIN_COUNT, 1.f);
+    if (!trigger_program_build(&trigger_prog, trigger_stages, count_of(trigger_stages), CAPTURE_PIN_BASE,
+                               PIO_TRIGGER_SYNC_FLAG, PIO_TRIGGER_IRQ_FLAG)) {
+        panic("Trigger program doesn't fit");
+    }
+    trigger_offset = logic_analyser_trigger_init(pio, trigger_sm, &trigger_prog, CAPTURE_PIN_BASE, 1.f);
+    counter_offset = logic_analyser_counter_init(pio, counter_sm, 1.f);
+
+    irq_set_exclusive_handler(pio_get_irq_num(pio, PIO_IRQ_TO_USE), pio_irq_handler);
+    irq_set_enabled(pio_get_irq_num(pio, PIO_IRQ_TO_USE), true);
+
+    printf("Arming trigger\n");
+    logic_analyser_stream_arm(pio, capture_sm, trigger_sm, counter_sm);
+
+    // Let some pre-trigger history build up first
+    sleep_us(100);
+
+    printf("Starting PWM example\n");
+    // PWM example: -----------------------------------------------------------
+    gpio_set_function(CAPTURE_PIN_BASE, GPIO_FUNC_PWM);
+    gpio_set_function(CAPTURE_PIN_BASE + 1, GPIO_FUNC_PWM);
+    // Topmost value of 3: count from 0 to 3 and then wrap, so period is 4 cycles
+    pwm_hw->slice[0].top = 3;
+    // Divide frequency by two to slow things down a little
+    pwm_hw->slice[0].div = 4 << PWM_CH0_DIV_INT_LSB;
+    // Set channel A to be high for 1 cycle each period (duty cycle 1/4) and
+    // channel B for 3 cycles (duty cycle 3/4)
+    pwm_hw->slice[0].cc =
+            (1 << PWM_CH0_CC_A_LSB) |
+            (3 << PWM_CH0_CC_B_LSB);
+    // Enable this PWM slice
+    pwm_hw->slice[0].csr = PWM_CH0_CSR_EN_BITS;
+    // ------------------------------------------------------------------------
+
+    while (!trigger_seen) {
+        tight_loop_contents();
+    }
+    // Give the DMA a moment to drain the capture FIFO past the trigger
+    busy_wait_us(10);
+    uint64_t trigger_sample = find_trigger_sample(trigger_seen_at_sample);
+    uint32_t save = save_and_disable_interrupts();
+    capture_ring_trigger(&ring, trigger_sample);
+    restore_interrupts(save);
+    printf("Triggered at sample %llu (seen at %llu)\n", trigger_sample, trigger_seen_at_sample);
+
+    capture_block_t block;
+    while (!capture_ring_drained(&ring)) {
+        if (capture_ring_peek(&ring, &block)) {
+            print_capture_block(&block, CAPTURE_PIN_BASE, CAPTURE_PIN_COUNT, trigger_sample);
+            capture_ring_release(&ring, &block);
+        }
+    }
+
+    pio_set_sm_mask_enabled(pio, (1u << capture_sm) | (1u << trigger_sm) | (1u << counter_sm), false);
+    printf("Capture complete, %u blocks written, %u overruns\n", ring.blocks_written, ring.overruns);
+}
@@ -0,0 +1,181 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "trigger_program.h"
+
+static inline void emit(trigger_program_t *prog, uint16_t instr) {
+    if (prog->length < TRIGGER_PROGRAM_MAX_INSTRUCTIONS) {
+        prog->instructions[prog->length] = instr;
+    }
+    prog->length++;
+}
+
+static inline void patch(trigger_program_t *prog, uint index, uint16_t instr) {
+    if (index < TRIGGER_PROGRAM_MAX_INSTRUCTIONS) {
+        prog->instructions[index] = instr;
+    }
+}
+
+static inline void emit_fifo_word(trigger_program_t *prog, uint32_t word) {
+    if (prog->fifo_word_count < TRIGGER_PROGRAM_MAX_FIFO_WORDS) {
+        prog->fifo_words[prog->fifo_word_count] = word;
+    }
+    prog->fifo_word_count++;
+}
+
+static inline uint32_t group_mask(uint width) {
+    return width >= 32 ? 0xffffffffu : (1u << width) - 1;
+}
+
+// Read a group of pins into x or y, returning the number of instructions
+static uint emit_read_group(trigger_program_t *prog, enum pio_src_dest dest, uint offset, uint width) {
+    // mov resets the output shift count, so OSR is ready to shift out again
+    emit(prog, pio_encode_mov(pio_osr, pio_pins));
+    if (offset) {
+        emit(prog, pio_encode_out(pio_null, offset));
+    }
+    emit(prog, pio_encode_out(dest, width));
+    return offset ? 3 : 2;
+}
+
+// Code which waits for one occurrence of the stage condition. Returns the
+// worst case number of cycles from the condition becoming true until it
+// falls through.
+static uint emit_occurrence(trigger_program_t *prog, const trigger_stage_t *stage, uint offset) {
+    switch (stage->type) {
+        case TRIGGER_LEVEL:
+            emit(prog, pio_encode_wait_gpio(stage->value, stage->pin));
+            return 1;
+        case TRIGGER_RISING:
+        case TRIGGER_FALLING: {
+            bool level = stage->type == TRIGGER_RISING;
+            emit(prog, pio_encode_wait_gpio(!level, stage->pin));
+            emit(prog, pio_encode_wait_gpio(level, stage->pin));
+            return 1;
+        }
+        case TRIGGER_PATTERN: {
+            // y holds the pattern; loop until the pins match it
+            uint loop = prog->length;
+            uint len = emit_read_group(prog, pio_x, offset, stage->width);
+            emit(prog, pio_encode_jmp_x_ne_y(loop));
+            return 2 * (len + 1);
+        }
+        case TRIGGER_ANY_EDGE: {
+            // Snapshot the pins into y, then loop until they differ from it
+            emit_read_group(prog, pio_y, offset, stage->width);
+            uint loop = prog->length;
+            uint len = emit_read_group(prog, pio_x, offset, stage->width);
+            emit(prog, pio_encode_jmp_x_ne_y(prog->length + 2));
+            emit(prog, pio_encode_jmp(loop));
+            return 2 * (len + 2);
+        }
+    }
+    return 0;
+}
+
+// Code which waits until the condition can occur again, for counted stages
+static void emit_rearm(trigger_program_t *prog, const trigger_stage_t *stage, uint offset) {
+    switch (stage->type) {
+        case TRIGGER_LEVEL:
+            emit(prog, pio_encode_wait_gpio(!stage->value, stage->pin));
+            break;
+        case TRIGGER_PATTERN: {
+            uint loop = prog->length;
+            emit_read_group(prog, pio_x, offset, stage->width);
+            emit(prog, pio_encode_jmp_x_ne_y(prog->length + 2));
+            emit(prog, pio_encode_jmp(loop));
+            break;
+        }
+        default:
+            // Edges can't happen twice without the pin changing back anyway
+            break;
+    }
+}
+
+static bool stage_valid(const trigger_stage_t *stage, uint in_base) {
+    switch (stage->type) {
+        case TRIGGER_LEVEL:
+            return stage->value <= 1;
+        case TRIGGER_RISING:
+        case TRIGGER_FALLING:
+            return true;
+        case TRIGGER_PATTERN:
+        case TRIGGER_ANY_EDGE:
+            return stage->pin >= in_base && stage->width >= 1 && stage->pin - in_base + stage->width <= 32;
+    }
+    return false;
+}
+
+bool trigger_program_build(trigger_program_t *prog, const trigger_stage_t *stages, uint n_stages, uint in_base,
+                           uint sync_irq, uint cpu_irq) {
+    prog->length = 0;
+    prog->fifo_word_count = 0;
+    prog->match_latency = 0;
+    if (!n_stages) {
+        return false;
+    }
+    for (uint i = 0; i < n_stages; ++i) {
+        const trigger_stage_t *stage = &stages[i];
+        if (!stage_valid(stage, in_base)) {
+            return false;
+        }
+        uint offset = stage->pin - in_base;
+        uint32_t count = stage->count ? stage->count : 1;
+        if (count > 1) {
+            // The remaining count lives in ISR, as x and y may be in use
+            emit_fifo_word(prog, count - 1);
+            emit(prog, pio_encode_pull(false, true));
+            emit(prog, pio_encode_mov(pio_isr, pio_osr));
+        }
+        if (stage->type == TRIGGER_PATTERN) {
+            emit_fifo_word(prog, stage->value & group_mask(stage->width));
+            emit(prog, pio_encode_pull(false, true));
+            emit(prog, pio_encode_mov(pio_y, pio_osr));
+        }
+        uint occurrence = prog->length;
+        prog->match_latency = emit_occurrence(prog, stage, offset);
+        if (count > 1) {
+            // if (isr--) { rearm; goto occurrence; }
+            emit(prog, pio_encode_mov(pio_x, pio_isr));
+            uint jmp_cont = prog->length;
+            emit(prog, pio_encode_jmp_x_dec(0));
+            uint jmp_next = prog->length;
+            emit(prog, pio_encode_jmp(0));
+            patch(prog, jmp_cont, pio_encode_jmp_x_dec(prog->length));
+            emit(prog, pio_encode_mov(pio_isr, pio_x));
+            emit_rearm(prog, stage, offset);
+            emit(prog, pio_encode_jmp(occurrence));
+            patch(prog, jmp_next, pio_encode_jmp(prog->length));
+            prog->match_latency += 3;
+        }
+    }
+    emit(prog, pio_encode_irq_set(false, sync_irq));
+    emit(prog, pio_encode_irq_set(false, cpu_irq));
+    emit(prog, pio_encode_jmp(prog->length));
+    prog->match_latency += 1;
+    return prog->length <= TRIGGER_PROGRAM_MAX_INSTRUCTIONS && prog->fifo_word_count <= TRIGGER_PROGRAM_MAX_FIFO_WORDS;
+}
+
+bool trigger_stage_hit(const trigger_stage_t *stage, uint in_base, uint32_t prev, uint32_t cur) {
+    if (stage->pin < in_base || stage->pin - in_base >= 32) {
+        // Not a pin we have samples for
+        return false;
+    }
+    uint offset = stage->pin - in_base;
+    switch (stage->type) {
+        case TRIGGER_LEVEL:
+            return ((cur >> offset) & 1u) == stage->value;
+        case TRIGGER_RISING:
+            return !((prev >> offset) & 1u) && ((cur >> offset) & 1u);
+        case TRIGGER_FALLING:
+            return ((prev >> offset) & 1u) && !((cur >> offset) & 1u);
+        case TRIGGER_PATTERN:
+            return ((cur >> offset) & group_mask(stage->width)) == (stage->value & group_mask(stage->width));
+        case TRIGGER_ANY_EDGE:
+            return ((cur ^ prev) >> offset) & group_mask(stage->width);
+    }
+    return false;
+}
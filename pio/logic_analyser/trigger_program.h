@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _TRIGGER_PROGRAM_H
+#define _TRIGGER_PROGRAM_H
+
+// Trigger program generator for the logic analyser.
+//
+// A trigger is described by a table of stages, which must be satisfied one
+// after the other (so two stages give an "A then B" sequence). Each stage can
+// optionally be required to happen `count` times before moving on. The table
+// is turned into a PIO program which runs on its own state machine, next to
+// the capture state machine and at the same clock divisor, so matching
+// happens at the sample rate rather than in a CPU polling loop:
+//
+// - Level and edge stages use `wait gpio`, so are checked every cycle.
+// - Pattern and any-edge stages compare a group of contiguous pins, using
+//   `mov osr, pins; out null, n; out x, n; jmp x!=y`, so are checked every 3
+//   or 4 cycles.
+//
+// Pattern values and occurrence counts don't fit in instructions, so the
+// generator also produces a list of words which must be written to the TX
+// FIFO before the state machine is started. The TX FIFO is joined, giving
+// room for 8 words.
+//
+// When every stage has matched, the program sets the `sync_irq` PIO IRQ flag
+// (for other state machines to wait on) and then the `cpu_irq` flag (to
+// interrupt the processor), and parks.
+//
+// This only uses the instruction encoders from hardware/pio_instructions.h,
+// so trigger_program_check.c can check the generated programs on the host.
+
+#include "hardware/pio_instructions.h"
+
+// The capture program and sample counter need some instruction memory too
+#define TRIGGER_PROGRAM_MAX_INSTRUCTIONS 28
+#define TRIGGER_PROGRAM_MAX_FIFO_WORDS 8
+
+typedef enum trigger_stage_type {
+    TRIGGER_LEVEL,      // pin is at level `value`
+    TRIGGER_RISING,     // pin goes from 0 to 1
+    TRIGGER_FALLING,    // pin goes from 1 to 0
+    TRIGGER_PATTERN,    // width pins starting at pin equal value
+    TRIGGER_ANY_EDGE,   // any of width pins starting at pin changes
+} trigger_stage_type_t;
+
+typedef struct trigger_stage {
+    trigger_stage_type_t type;
+    // GPIO number; for pattern and any-edge stages, the lowest pin of the
+    // group, which must be within 32 pins of the state machine's in_base
+    uint pin;
+    uint width;
+    uint32_t value;
+    // Number of occurrences to wait for; 0 is treated as 1. For level and
+    // pattern stages, the condition must go away before it can occur again.
+    uint32_t count;
+} trigger_stage_t;
+
+typedef struct trigger_program {
+    uint16_t instructions[TRIGGER_PROGRAM_MAX_INSTRUCTIONS];
+    uint length;
+    uint32_t fifo_words[TRIGGER_PROGRAM_MAX_FIFO_WORDS];
+    uint fifo_word_count;
+    // Worst case number of cycles between the final condition becoming true
+    // and the sync_irq flag being set
+    uint match_latency;
+} trigger_program_t;
+
+// Build a program for the given stages. Jump targets are relative to the
+// start of the program, so it must be loaded with pio_add_program(), which
+// relocates them. in_base is the state machine's in_base pin. Returns false
+// if a stage is invalid or the program doesn't fit.
+bool trigger_program_build(trigger_program_t *prog, const trigger_stage_t *stages, uint n_stages, uint in_base,
+                           uint sync_irq, uint cpu_irq);
+
+// Software reference for one stage. prev and cur are consecutive samples,
+// with pin in_base in bit 0. Returns true if the condition holds at cur (for
+// level and pattern stages) or happens between prev and cur (for edges).
+bool trigger_stage_hit(const trigger_stage_t *stage, uint in_base, uint32_t prev, uint32_t cur);
+
+#endif
@@ -0,0 +1,294 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Check the trigger programs built by trigger_program.c, for each kind of
+// stage, with and without an occurrence count, against the instruction
+// encodings worked out by hand from the datasheet. The TX FIFO words and
+// match latencies are checked too, as are stages which should be rejected.
+//
+// The generator only uses the instruction encoders, for which host/ stands in
+// with a copy of the SDK's hardware/pio_instructions.h, so no PIO is needed:
+//
+//   cc -DPICO_NO_HARDWARE=1 -Ihost trigger_program_check.c trigger_program.c
+//
+// A single instruction that differs from the hand encoding fails the run.
+
+#include <stdio.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#define count_of(a) (sizeof(a)/sizeof((a)[0]))
+#endif
+
+#include "trigger_program.h"
+
+// The capture pins start at GPIO 16, as in the examples
+#define IN_BASE 16
+#define SYNC_IRQ 4
+#define CPU_IRQ 0
+
+#define MAX_STAGES 2
+
+typedef struct trigger_check {
+    const char *name;
+    trigger_stage_t stages[MAX_STAGES];
+    uint n_stages;
+    uint16_t instructions[TRIGGER_PROGRAM_MAX_INSTRUCTIONS];
+    uint length;
+    uint32_t fifo_words[TRIGGER_PROGRAM_MAX_FIFO_WORDS];
+    uint fifo_word_count;
+    uint match_latency;
+} trigger_check_t;
+
+static const trigger_check_t checks[] = {
+    {
+        "Level",
+        {{.type = TRIGGER_LEVEL, .pin = 17, .value = 1}}, 1,
+        {
+            0x2091, // wait 1 gpio 17
+            0xc004, // irq set 4
+            0xc000, // irq set 0
+            0x0003, // jmp 3
+        }, 4,
+        {0}, 0,
+        2,
+    },
+    {
+        "Rising",
+        {{.type = TRIGGER_RISING, .pin = 17}}, 1,
+        {
+            0x2011, // wait 0 gpio 17
+            0x2091, // wait 1 gpio 17
+            0xc004, // irq set 4
+            0xc000, // irq set 0
+            0x0004, // jmp 4
+        }, 5,
+        {0}, 0,
+        2,
+    },
+    {
+        "Falling",
+        {{.type = TRIGGER_FALLING, .pin = 16}}, 1,
+        {
+            0x2090, // wait 1 gpio 16
+            0x2010, // wait 0 gpio 16
+            0xc004, // irq set 4
+            0xc000, // irq set 0
+            0x0004, // jmp 4
+        }, 5,
+        {0}, 0,
+        2,
+    },
+    {
+        "Pattern",
+        {{.type = TRIGGER_PATTERN, .pin = 16, .width = 2, .value = 3}}, 1,
+        {
+            0x80a0, // pull block
+            0xa047, // mov y, osr
+            0xa0e0, // mov osr, pins
+            0x6022, // out x, 2
+            0x00a2, // jmp x!=y 2
+            0xc004, // irq set 4
+            0xc000, // irq set 0
+            0x0007, // jmp 7
+        }, 8,
+        {3}, 1,
+        7,
+    },
+    {
+        "Pattern, offset",
+        // Bits above the width are dropped from the value
+        {{.type = TRIGGER_PATTERN, .pin = 18, .width = 3, .value = 0xd}}, 1,
+        {
+            0x80a0, // pull block
+            0xa047, // mov y, osr
+            0xa0e0, // mov osr, pins
+            0x6062, // out null, 2
+            0x6023, // out x, 3
+            0x00a2, // jmp x!=y 2
+            0xc004, // irq set 4
+            0xc000, // irq set 0
+            0x0008, // jmp 8
+        }, 9,
+        {5}, 1,
+        9,
+    },
+    {
+        "Any edge",
+        {{.type = TRIGGER_ANY_EDGE, .pin = 16, .width = 2}}, 1,
+        {
+            0xa0e0, // mov osr, pins
+            0x6042, // out y, 2
+            0xa0e0, // mov osr, pins
+            0x6022, // out x, 2
+            0x00a6, // jmp x!=y 6
+            0x0002, // jmp 2
+            0xc004, // irq set 4
+            0xc000, // irq set 0
+            0x0008, // jmp 8
+        }, 9,
+        {0}, 0,
+        9,
+    },
+    {
+        "Level x2",
+        {{.type = TRIGGER_LEVEL, .pin = 16, .value = 0, .count = 2}}, 1,
+        {
+            0x80a0, // pull block
+            0xa0c7, // mov isr, osr
+            0x2010, // wait 0 gpio 16
+            0xa026, // mov x, isr
+            0x0046, // jmp x-- 6
+            0x0009, // jmp 9
+            0xa0c1, // mov isr, x
+            0x2090, // wait 1 gpio 16
+            0x0002, // jmp 2
+            0xc004, // irq set 4
+            0xc000, // irq set 0
+            0x000b, // jmp 11
+        }, 12,
+        {1}, 1,
+        5,
+    },
+    {
+        "Pattern x2",
+        {{.type = TRIGGER_PATTERN, .pin = 16, .width = 2, .value = 1, .count = 2}}, 1,
+        {
+            0x80a0, // pull block
+            0xa0c7, // mov isr, osr
+            0x80a0, // pull block
+            0xa047, // mov y, osr
+            0xa0e0, // mov osr, pins
+            0x6022, // out x, 2
+            0x00a4, // jmp x!=y 4
+            0xa026, // mov x, isr
+            0x004a, // jmp x-- 10
+            0x0010, // jmp 16
+            0xa0c1, // mov isr, x
+            0xa0e0, // mov osr, pins
+            0x6022, // out x, 2
+            0x00af, // jmp x!=y 15
+            0x000b, // jmp 11
+            0x0004, // jmp 4
+            0xc004, // irq set 4
+            0xc000, // irq set 0
+            0x0012, // jmp 18
+        }, 19,
+        {1, 1}, 2,
+        10,
+    },
+    {
+        // The sequence in logic_analyser_stream.c
+        "Rising x3, pattern",
+        {
+            {.type = TRIGGER_RISING, .pin = 17, .count = 3},
+            {.type = TRIGGER_PATTERN, .pin = 16, .width = 2, .value = 3},
+        }, 2,
+        {
+            0x80a0, // pull block
+            0xa0c7, // mov isr, osr
+            0x2011, // wait 0 gpio 17
+            0x2091, // wait 1 gpio 17
+            0xa026, // mov x, isr
+            0x0047, // jmp x-- 7
+            0x0009, // jmp 9
+            0xa0c1, // mov isr, x
+            0x0002, // jmp 2
+            0x80a0, // pull block
+            0xa047, // mov y, osr
+            0xa0e0, // mov osr, pins
+            0x6022, // out x, 2
+            0x00ab, // jmp x!=y 11
+            0xc004, // irq set 4
+            0xc000, // irq set 0
+            0x0010, // jmp 16
+        }, 17,
+        {2, 3}, 2,
+        7,
+    },
+};
+
+// Stages which trigger_program_build should refuse
+static const trigger_stage_t invalid_stages[] = {
+    {.type = TRIGGER_LEVEL, .pin = 16, .value = 2},
+    {.type = TRIGGER_PATTERN, .pin = 15, .width = 2, .value = 1},
+    {.type = TRIGGER_PATTERN, .pin = 16, .width = 0, .value = 0},
+    {.type = TRIGGER_ANY_EDGE, .pin = 40, .width = 9},
+};
+
+static uint32_t failures;
+
+static bool run_check(const trigger_check_t *check) {
+    trigger_program_t prog;
+    if (!trigger_program_build(&prog, check->stages, check->n_stages, IN_BASE, SYNC_IRQ, CPU_IRQ)) {
+        printf("  not built\n");
+        return false;
+    }
+    bool ok = true;
+    if (prog.length != check->length) {
+        printf("  %u instructions, expected %u\n", prog.length, check->length);
+        ok = false;
+    }
+    for (uint i = 0; i < prog.length && i < check->length; ++i) {
+        if (prog.instructions[i] != check->instructions[i]) {
+            printf("  instruction %u is %04x, expected %04x\n", i, prog.instructions[i], check->instructions[i]);
+            ok = false;
+        }
+    }
+    if (prog.fifo_word_count != check->fifo_word_count ||
+        memcmp(prog.fifo_words, check->fifo_words, check->fifo_word_count * sizeof(uint32_t))) {
+        printf("  FIFO words are wrong\n");
+        ok = false;
+    }
+    if (prog.match_latency != check->match_latency) {
+        printf("  match latency %u, expected %u\n", prog.match_latency, check->match_latency);
+        ok = false;
+    }
+    return ok;
+}
+
+// Nine counted patterns need more FIFO words than there are, and more
+// instructions
+static bool check_too_big(void) {
+    trigger_stage_t stages[9];
+    for (uint i = 0; i < count_of(stages); ++i) {
+        stages[i] = (trigger_stage_t){.type = TRIGGER_PATTERN, .pin = 16, .width = 2, .value = i & 3, .count = 2};
+    }
+    trigger_program_t prog;
+    return !trigger_program_build(&prog, stages, count_of(stages), IN_BASE, SYNC_IRQ, CPU_IRQ);
+}
+
+static bool check_invalid(void) {
+    bool ok = true;
+    for (uint i = 0; i < count_of(invalid_stages); ++i) {
+        trigger_program_t prog;
+        if (trigger_program_build(&prog, &invalid_stages[i], 1, IN_BASE, SYNC_IRQ, CPU_IRQ)) {
+            printf("  invalid stage %u was built\n", i);
+            ok = false;
+        }
+    }
+    trigger_program_t prog;
+    return ok && check_too_big() && !trigger_program_build(&prog, NULL, 0, IN_BASE, SYNC_IRQ, CPU_IRQ);
+}
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+#endif
+    puts("Trigger program checks");
+    for (uint i = 0; i < count_of(checks); ++i) {
+        bool ok = run_check(&checks[i]);
+        failures += !ok;
+        printf("%-20s %s\n", checks[i].name, ok ? "ok" : "FAILED");
+    }
+    bool ok = check_invalid();
+    failures += !ok;
+    printf("%-20s %s\n", "Invalid", ok ? "ok" : "FAILED");
+    printf("\n%s\n", failures ? "Trigger program checks FAILED" : "All trigger program checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <math.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#define __not_in_flash_func(f) f
+#endif
+
+#include "hardware/interp.h"
+
+#include "blit.h"
+#include "affine_span.h"
+
+#define UNIT_LSB 16
+
+static inline uint16_t lcd_order(uint16_t colour) {
+    return (uint16_t)(colour >> 8 | colour << 8);
+}
+
+void affine_transform_rotate(affine_transform_t *t, float theta) {
+    int32_t c = (int32_t) (cosf(theta) * (1 << UNIT_LSB));
+    int32_t s = (int32_t) (sinf(theta) * (1 << UNIT_LSB));
+    t->u0 = 0;
+    t->v0 = 0;
+    t->du_dx = c;
+    t->dv_dx = s;
+    t->du_dy = -s;
+    t->dv_dy = c;
+}
+
+// Each POP_FULL gives the byte offset of the pixel at the current coords,
+// which the pixels pointer is added to here rather than in BASE2, so this
+// also runs on the host
+void affine_span_init(const affine_image_t *image) {
+    blit_affine_setup(interp0, UNIT_LSB, image->log_size, image->log_size, 1);
+}
+
+void __not_in_flash_func(affine_render_span)(const affine_image_t *image, const affine_transform_t *t, uint32_t y,
+                                             uint32_t x0, uint32_t count, uint16_t *out) {
+    uint32_t u = (uint32_t) t->u0 + x0 * (uint32_t) t->du_dx + y * (uint32_t) t->du_dy;
+    uint32_t v = (uint32_t) t->v0 + x0 * (uint32_t) t->dv_dx + y * (uint32_t) t->dv_dy;
+    blit_affine_start(interp0, u, v, t->du_dx, t->dv_dx);
+    const uint8_t *base = (const uint8_t *) image->pixels;
+    for (uint32_t i = 0; i < count; ++i) {
+        out[i] = lcd_order(*(const uint16_t *) (base + interp_pop_full_result(interp0)));
+    }
+}
+
+void affine_render_span_reference(const affine_image_t *image, const affine_transform_t *t, uint32_t y, uint32_t x0,
+                                  uint32_t count, uint16_t *out) {
+    const uint32_t size = 1u << image->log_size;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t x = x0 + i;
+        uint32_t u = (uint32_t) t->u0 + x * (uint32_t) t->du_dx + y * (uint32_t) t->du_dy;
+        uint32_t v = (uint32_t) t->v0 + x * (uint32_t) t->dv_dx + y * (uint32_t) t->dv_dy;
+        out[i] = lcd_order(image->pixels[(v >> UNIT_LSB) % size * size + (u >> UNIT_LSB) % size]);
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _AFFINE_SPAN_H
+#define _AFFINE_SPAN_H
+
+// Affine texture mapping of a square RGB565 image, a span of a line at a time.
+//
+// Each screen pixel (x, y) is mapped to the image pixel at
+//
+//   u = u0 + x * du_dx + y * du_dy
+//   v = v0 + x * dv_dx + y * dv_dy
+//
+// in 16.16 fixed point, wrapping at the edges of the image. Pixels are written
+// out with their bytes swapped, in the order the LCD wants them, so a line can
+// be sent to it by DMA as bytes.
+//
+// affine_render_span() uses interp0 of the calling core, set up by
+// blit_affine_setup() from interp/blit, so each core which renders spans must
+// call affine_span_init() first. affine_render_span_reference() gives the same
+// pixels in plain C. On the host, interp0 is the software model in
+// interp/interp_model, and affine_span_check.c compares the two.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct affine_image {
+    // (1 << log_size) pixels square
+    const uint16_t *pixels;
+    uint8_t log_size;
+} affine_image_t;
+
+typedef struct affine_transform {
+    int32_t u0;
+    int32_t v0;
+    int32_t du_dx;
+    int32_t dv_dx;
+    int32_t du_dy;
+    int32_t dv_dy;
+} affine_transform_t;
+
+// Rotate by theta radians about the top left corner of the image, which is
+// at the top left of the screen
+void affine_transform_rotate(affine_transform_t *t, float theta);
+
+// Set up interp0 of the calling core for affine_render_span() of this image
+void affine_span_init(const affine_image_t *image);
+
+// Render count pixels of line y, starting at column x0
+void affine_render_span(const affine_image_t *image, const affine_transform_t *t, uint32_t y, uint32_t x0,
+                        uint32_t count, uint16_t *out);
+
+void affine_render_span_reference(const affine_image_t *image, const affine_transform_t *t, uint32_t y, uint32_t x0,
+                                  uint32_t count, uint16_t *out);
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Check affine_render_span() against affine_render_span_reference(), for the
+// frames st7789_lcd.c checks at startup: the same image and rotations, with
+// each line rendered in two spans split where the two cores split it. Some
+// transforms which wrap at the edges of the image, or step backwards, are
+// checked too, and a span which doesn't start at the left of the screen.
+//
+// Off the device, interp/interp_model stands in for interp0, so the spans can
+// be compared without an LCD or a Pico:
+//
+//   cc -DPICO_NO_HARDWARE=1 -I../../interp/interp_model/include -I../../interp/blit affine_span_check.c affine_span.c ../../interp/blit/blit.c ../../interp/interp_model/interp_model.c -lm
+
+#include <stdio.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#define count_of(a) (sizeof(a)/sizeof((a)[0]))
+#endif
+
+#include "raspberry_256x256_rgb565.h"
+#include "affine_span.h"
+
+// As in st7789_lcd.c
+#define SCREEN_WIDTH 240
+#define SCREEN_HEIGHT 240
+#define LOG_IMAGE_SIZE 8
+#define SPLIT_X (SCREEN_WIDTH / 2)
+
+static const affine_image_t image = {
+    .pixels = (const uint16_t *) raspberry_256x256,
+    .log_size = LOG_IMAGE_SIZE,
+};
+
+static uint16_t line[SCREEN_WIDTH];
+static uint16_t expected[SCREEN_WIDTH];
+
+// Render a frame as the two cores do, and return the number of lines which
+// differ from the reference
+static uint32_t check_frame(const affine_transform_t *t) {
+    uint32_t bad_lines = 0;
+    for (uint32_t y = 0; y < SCREEN_HEIGHT; ++y) {
+        memset(line, 0, sizeof(line));
+        affine_render_span(&image, t, y, 0, SPLIT_X, line);
+        affine_render_span(&image, t, y, SPLIT_X, SCREEN_WIDTH - SPLIT_X, line + SPLIT_X);
+        affine_render_span_reference(&image, t, y, 0, SCREEN_WIDTH, expected);
+        bad_lines += memcmp(line, expected, sizeof(expected)) != 0;
+    }
+    return bad_lines;
+}
+
+static bool check_rotations(void) {
+    uint32_t failures = 0;
+    for (uint32_t i = 0; i < 8; ++i) {
+        affine_transform_t t;
+        affine_transform_rotate(&t, (float) i * 0.8f);
+        uint32_t bad_lines = check_frame(&t);
+        if (bad_lines) {
+            printf("  frame %u: %u lines differ\n", (unsigned) i, (unsigned) bad_lines);
+            failures++;
+        }
+    }
+    return !failures;
+}
+
+// Scaled up, mirrored and offset, so the image repeats across the screen and
+// coords go negative
+static bool check_wrapping(void) {
+    static const affine_transform_t transforms[] = {
+        {.u0 = 0, .v0 = 0, .du_dx = 3 << 16, .dv_dx = 0, .du_dy = 0, .dv_dy = 3 << 16},
+        {.u0 = 100 << 16, .v0 = 7 << 16, .du_dx = -(1 << 16), .dv_dx = 0, .du_dy = 0, .dv_dy = -(5 << 15)},
+        {.u0 = -12345, .v0 = 0x7fff0000, .du_dx = 0x12345, .dv_dx = -0x6789, .du_dy = 0x4321, .dv_dy = 0x2468},
+    };
+    uint32_t failures = 0;
+    for (uint32_t i = 0; i < count_of(transforms); ++i) {
+        uint32_t bad_lines = check_frame(&transforms[i]);
+        if (bad_lines) {
+            printf("  transform %u: %u lines differ\n", (unsigned) i, (unsigned) bad_lines);
+            failures++;
+        }
+    }
+    return !failures;
+}
+
+// A short span in the middle of a line, with the pixels either side untouched
+static bool check_span(void) {
+    affine_transform_t t;
+    affine_transform_rotate(&t, 2.0f);
+    memset(line, 0xa5, sizeof(line));
+    affine_render_span(&image, &t, 77, 33, 50, line + 33);
+    affine_render_span_reference(&image, &t, 77, 33, 50, expected + 33);
+    bool ok = !memcmp(line + 33, expected + 33, 50 * sizeof(uint16_t));
+    ok &= line[32] == 0xa5a5 && line[83] == 0xa5a5;
+    return ok;
+}
+
+typedef struct affine_check {
+    const char *name;
+    bool (*run)(void);
+} affine_check_t;
+
+static const affine_check_t checks[] = {
+    {"Rotations", check_rotations},
+    {"Wrapping", check_wrapping},
+    {"Span", check_span},
+};
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+#endif
+    puts("Affine span checks");
+    affine_span_init(&image);
+    uint32_t failures = 0;
+    for (uint32_t i = 0; i < count_of(checks); ++i) {
+        bool ok = checks[i].run();
+        failures += !ok;
+        printf("%-10s %s\n", checks[i].name, ok ? "ok" : "FAILED");
+    }
+    printf("\n%s\n", failures ? "Affine span checks FAILED" : "All affine span checks passed");
+    return failures ? 1 : 0;
+}
@@ -4,16 +4,26 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+// Spin an image on a ST7789 LCD. Both cores render each line, core 0 the
+// left half and core 1 the right half, each with its own interpolator (see
+// affine_span.h), into one of two line buffers. While they render a line,
+// DMA sends the previous one to the PIO. Frame times are printed every few
+// seconds, along with where core 0 spent them. At startup, some frames are
+// rendered this way and checked against a plain C reference renderer.
+
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 
 #include "pico/stdlib.h"
+#include "pico/multicore.h"
 #include "hardware/pio.h"
 #include "hardware/gpio.h"
-#include "hardware/interp.h"
+#include "hardware/dma.h"
 
 #include "st7789_lcd.pio.h"
 #include "raspberry_256x256_rgb565.h"
+#include "affine_span.h"
 
 // Tested with the parts that have the height of 240 and 320
 #define SCREEN_WIDTH 240
@@ -30,6 +40,11 @@
 
 #define SERIAL_CLK_DIV 1.f
 
+// Core 0 renders columns [0, SPLIT_X), core 1 the rest
+#define SPLIT_X (SCREEN_WIDTH / 2)
+
+#define STATS_INTERVAL_FRAMES 100
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -84,6 +99,88 @@ static inline void st7789_start_pixels(PIO pio, uint sm) {
     lcd_set_dc_cs(1, 0);
 }
 
+static const affine_image_t image = {
+    .pixels = (const uint16_t *) raspberry_256x256,
+    .log_size = LOG_IMAGE_SIZE,
+};
+
+// The frame being rendered. Only changed between frames, when core 1 is idle.
+static affine_transform_t transform;
+
+static uint16_t line_bufs[2][SCREEN_WIDTH];
+
+static volatile uint32_t core1_render_us;
+
+static void __not_in_flash_func(core1_entry)(void) {
+    affine_span_init(&image);
+    while (true) {
+        uint32_t y = multicore_fifo_pop_blocking();
+        uint16_t *buf = (uint16_t *) multicore_fifo_pop_blocking();
+        uint32_t start = time_us_32();
+        affine_render_span(&image, &transform, y, SPLIT_X, SCREEN_WIDTH - SPLIT_X, buf + SPLIT_X);
+        core1_render_us += time_us_32() - start;
+        multicore_fifo_push_blocking(y);
+    }
+}
+
+typedef struct frame_stats {
+    uint32_t frame_us;
+    uint32_t render_us;      // core 0 rendering its half
+    uint32_t core1_wait_us;  // core 0 waiting for core 1 to finish its half
+    uint32_t dma_wait_us;    // waiting for the previous line to be sent
+} frame_stats_t;
+
+// Render line y with both cores
+static void __not_in_flash_func(render_line)(uint32_t y, uint16_t *buf, frame_stats_t *stats) {
+    multicore_fifo_push_blocking(y);
+    multicore_fifo_push_blocking((uintptr_t) buf);
+    uint32_t t0 = time_us_32();
+    affine_render_span(&image, &transform, y, 0, SPLIT_X, buf);
+    uint32_t t1 = time_us_32();
+    multicore_fifo_pop_blocking();
+    stats->render_us += t1 - t0;
+    stats->core1_wait_us += time_us_32() - t1;
+}
+
+static void __not_in_flash_func(send_frame)(PIO pio, uint sm, uint dma_chan, frame_stats_t *stats) {
+    uint32_t frame_start = time_us_32();
+    st7789_start_pixels(pio, sm);
+    for (uint32_t y = 0; y < SCREEN_HEIGHT; ++y) {
+        // Line y - 1 is still being sent from the other buffer
+        uint16_t *buf = line_bufs[y & 1];
+        render_line(y, buf, stats);
+        uint32_t t = time_us_32();
+        dma_channel_wait_for_finish_blocking(dma_chan);
+        stats->dma_wait_us += time_us_32() - t;
+        dma_channel_transfer_from_buffer_now(dma_chan, buf, SCREEN_WIDTH * sizeof(uint16_t));
+    }
+    dma_channel_wait_for_finish_blocking(dma_chan);
+    stats->frame_us += time_us_32() - frame_start;
+}
+
+// Render some frames with both cores, and compare every line with the
+// reference renderer
+static bool check_frames(void) {
+    static uint16_t expected[SCREEN_WIDTH];
+    frame_stats_t unused = {0};
+    uint32_t failures = 0;
+    for (uint i = 0; i < 8; ++i) {
+        affine_transform_rotate(&transform, (float) i * 0.8f);
+        for (uint32_t y = 0; y < SCREEN_HEIGHT; ++y) {
+            render_line(y, line_bufs[0], &unused);
+            affine_render_span_reference(&image, &transform, y, 0, SCREEN_WIDTH, expected);
+            if (memcmp(line_bufs[0], expected, sizeof(expected))) {
+                if (!failures) {
+                    printf("Line %u of frame %u differs from the reference\n", (unsigned) y, i);
+                }
+                failures++;
+            }
+        }
+    }
+    printf("Renderer check: %s\n", failures ? "FAILED" : "passed");
+    return !failures;
+}
+
 int main() {
     stdio_init_all();
 
@@ -106,48 +203,39 @@ int main() {
     lcd_init(pio, sm, st7789_init_seq);
     gpio_put(PIN_BL, 1);
 
+    // Each byte is replicated across the FIFO entry, as with st7789_lcd_put()
+    uint dma_chan = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_dreq(&c, pio_get_dreq(pio, sm, true));
+    dma_channel_configure(dma_chan, &c, &pio->txf[sm], NULL, 0, false);
+
+    multicore_launch_core1(core1_entry);
+    affine_span_init(&image);
+    check_frames();
+
     // Other SDKs: static image on screen, lame, boring
     // Raspberry Pi Pico SDK: spinning image on screen, bold, exciting
 
-    // Lane 0 will be u coords (bits 8:1 of addr offset), lane 1 will be v
-    // coords (bits 16:9 of addr offset), and we'll represent coords with
-    // 16.16 fixed point. ACCUM0,1 will contain current coord, BASE0/1 will
-    // contain increment vector, and BASE2 will contain image base pointer
-#define UNIT_LSB 16
-    interp_config lane0_cfg = interp_default_config();
-    interp_config_set_shift(&lane0_cfg, UNIT_LSB - 1); // -1 because 2 bytes per pixel
-    interp_config_set_mask(&lane0_cfg, 1, 1 + (LOG_IMAGE_SIZE - 1));
-    interp_config_set_add_raw(&lane0_cfg, true); // Add full accumulator to base with each POP
-    interp_config lane1_cfg = interp_default_config();
-    interp_config_set_shift(&lane1_cfg, UNIT_LSB - (1 + LOG_IMAGE_SIZE));
-    interp_config_set_mask(&lane1_cfg, 1 + LOG_IMAGE_SIZE, 1 + (2 * LOG_IMAGE_SIZE - 1));
-    interp_config_set_add_raw(&lane1_cfg, true);
-
-    interp_set_config(interp0, 0, &lane0_cfg);
-    interp_set_config(interp0, 1, &lane1_cfg);
-    interp0->base[2] = (uint32_t) raspberry_256x256;
-
     float theta = 0.f;
     float theta_max = 2.f * (float) M_PI;
+    frame_stats_t stats = {0};
+    uint32_t frames = 0;
     while (1) {
         theta += 0.02f;
         if (theta > theta_max)
             theta -= theta_max;
-        int32_t rotate[4] = {
-                (int32_t) (cosf(theta) * (1 << UNIT_LSB)), (int32_t) (-sinf(theta) * (1 << UNIT_LSB)),
-                (int32_t) (sinf(theta) * (1 << UNIT_LSB)), (int32_t) (cosf(theta) * (1 << UNIT_LSB))
-        };
-        interp0->base[0] = rotate[0];
-        interp0->base[1] = rotate[2];
-        st7789_start_pixels(pio, sm);
-        for (int y = 0; y < SCREEN_HEIGHT; ++y) {
-            interp0->accum[0] = rotate[1] * y;
-            interp0->accum[1] = rotate[3] * y;
-            for (int x = 0; x < SCREEN_WIDTH; ++x) {
-                uint16_t colour = *(uint16_t *) (interp0->pop[2]);
-                st7789_lcd_put(pio, sm, colour >> 8);
-                st7789_lcd_put(pio, sm, colour & 0xff);
-            }
+        affine_transform_rotate(&transform, theta);
+        send_frame(pio, sm, dma_chan, &stats);
+        if (++frames == STATS_INTERVAL_FRAMES) {
+            printf("%.1f fps, %u us per frame: core 0 rendering %u us, waiting for core 1 %u us, "
+                   "waiting for DMA %u us; core 1 rendering %u us\n",
+                   frames * 1e6f / stats.frame_us, (unsigned) (stats.frame_us / frames),
+                   (unsigned) (stats.render_us / frames), (unsigned) (stats.core1_wait_us / frames),
+                   (unsigned) (stats.dma_wait_us / frames), (unsigned) (core1_render_us / frames));
+            memset(&stats, 0, sizeof(stats));
+            core1_render_us = 0;
+            frames = 0;
         }
     }
 }
@@ -9,31 +9,65 @@
 #include <string.h>
 
 #include "pico/stdlib.h"
+#include "pico/multicore.h"
 #include "pico/sem.h"
 #include "hardware/pio.h"
 #include "hardware/dma.h"
 #include "hardware/irq.h"
 #include "ws2812.pio.h"
 
+#include "ws2812_planes.h"
+
+// default dithering setup; see dither_init()
 #define FRAC_BITS 4
+#define GAMMA 2.2f
+// maximum number of pixels on any one strip
 #define NUM_PIXELS 64
 #define WS2812_PIN_BASE 2
+// one strip per pin, starting at WS2812_PIN_BASE; up to 32
+#ifndef NUM_STRIPS
+#define NUM_STRIPS 4
+#endif
 
 // Check the pin is compatible with the platform
 #if WS2812_PIN_BASE >= NUM_BANK0_GPIOS
 #error Attempting to use a pin>=32 on a platform that does not support it
 #endif
+#if NUM_STRIPS > 32 || WS2812_PIN_BASE + NUM_STRIPS > NUM_BANK0_GPIOS
+#error Too many strips for the available pins
+#endif
 
 // horrible temporary hack to avoid changing pattern code
 static uint8_t *current_strip_out;
-static bool current_strip_4color;
+static color_order_t current_strip_order;
 
 static inline void put_pixel(uint32_t pixel_grb) {
-    *current_strip_out++ = (pixel_grb >> 16u) & 0xffu;
-    *current_strip_out++ = (pixel_grb >> 8u) & 0xffu;
-    *current_strip_out++ = pixel_grb & 0xffu;
-    if (current_strip_4color) {
-        *current_strip_out++ = 0;  // todo adjust?
+    uint8_t r = (pixel_grb >> 8u) & 0xffu;
+    uint8_t g = (pixel_grb >> 16u) & 0xffu;
+    uint8_t b = pixel_grb & 0xffu;
+    uint8_t w = 0;
+    if (current_strip_order >= COLOR_ORDER_GRBW) {
+        // drive the white LED with the part common to all three colors
+        w = MIN(r, MIN(g, b));
+        r -= w;
+        g -= w;
+        b -= w;
+    }
+    switch (current_strip_order) {
+        case COLOR_ORDER_GRB:
+        case COLOR_ORDER_GRBW:
+            *current_strip_out++ = g;
+            *current_strip_out++ = r;
+            break;
+        case COLOR_ORDER_RGB:
+        case COLOR_ORDER_RGBW:
+            *current_strip_out++ = r;
+            *current_strip_out++ = g;
+            break;
+    }
+    *current_strip_out++ = b;
+    if (current_strip_order >= COLOR_ORDER_GRBW) {
+        *current_strip_out++ = w;
     }
 }
 
@@ -124,89 +158,103 @@ const struct {
 //        {pattern_fade, "Fade"},
 };
 
-#define VALUE_PLANE_COUNT (8 + FRAC_BITS)
-// we store value (8 bits + fractional bits of a single color (R/G/B/W) value) for multiple
-// strips of pixels, in bit planes. bit plane N has the Nth bit of each strip of pixels.
-typedef struct {
-    // stored MSB first
-    uint32_t planes[VALUE_PLANE_COUNT];
-} value_bits_t;
-
-// Add FRAC_BITS planes of e to s and store in d
-void add_error(value_bits_t *d, const value_bits_t *s, const value_bits_t *e) {
-    uint32_t carry_plane = 0;
-    // add the FRAC_BITS low planes
-    for (int p = VALUE_PLANE_COUNT - 1; p >= 8; p--) {
-        uint32_t e_plane = e->planes[p];
-        uint32_t s_plane = s->planes[p];
-        d->planes[p] = (e_plane ^ s_plane) ^ carry_plane;
-        carry_plane = (e_plane & s_plane) | (carry_plane & (s_plane ^ e_plane));
-    }
-    // then just ripple carry through the non fractional bits
-    for (int p = 7; p >= 0; p--) {
-        uint32_t s_plane = s->planes[p];
-        d->planes[p] = s_plane ^ carry_plane;
-        carry_plane &= s_plane;
+// requested colors * 4 to allow for RGBW
+static value_bits_t colors[NUM_PIXELS * 4];
+// double buffer the state of the pixel strip, since we update next version in parallel with DMAing out old version
+static value_bits_t states[2][NUM_PIXELS * 4];
+
+// The strips, in pin order. Strips can have different lengths (up to
+// NUM_PIXELS), brightness and number of colors; shorter strips are padded
+// with zeros when the planes are built.
+static uint8_t strip_data[NUM_STRIPS][NUM_PIXELS * 4];
+static strip_t strip_array[NUM_STRIPS];
+strip_t *strips[NUM_STRIPS];
+static uint num_strips;
+// number of values to output per frame, which is the longest strip's data_len
+static uint max_data_len;
+
+// Add the next strip, and return it. frac_brightness can be changed at any
+// time, and takes effect from the next frame rendered.
+strip_t *strip_array_add(uint num_pixels, color_order_t color_order, uint frac_brightness) {
+    if (num_strips == NUM_STRIPS || num_pixels > NUM_PIXELS) {
+        return NULL;
     }
+    strip_t *strip = &strip_array[num_strips];
+    strip->data = strip_data[num_strips];
+    strip->num_pixels = num_pixels;
+    strip->color_order = color_order;
+    strip->data_len = num_pixels * color_order_bytes(color_order);
+    strip->frac_brightness = frac_brightness;
+    strips[num_strips++] = strip;
+    max_data_len = MAX(max_data_len, strip->data_len);
+    return strip;
 }
 
-typedef struct {
-    uint8_t *data;
-    uint data_len;
-    uint frac_brightness; // 256 = *1.0;
-} strip_t;
-
-// takes 8 bit color values, multiply by brightness and store in bit planes
-void transform_strips(strip_t **strips, uint num_strips, value_bits_t *values, uint value_length,
-                       uint frac_brightness) {
-    for (uint v = 0; v < value_length; v++) {
-        memset(&values[v], 0, sizeof(values[v]));
-        for (uint i = 0; i < num_strips; i++) {
-            if (v < strips[i]->data_len) {
-                // todo clamp?
-                uint32_t value = (strips[i]->data[v] * strips[i]->frac_brightness) >> 8u;
-                value = (value * frac_brightness) >> 8u;
-                for (int j = 0; j < VALUE_PLANE_COUNT && value; j++, value >>= 1u) {
-                    if (value & 1u) values[v].planes[VALUE_PLANE_COUNT - 1 - j] |= 1u << i;
+// Check transform_strips against the reference implementation, using up to
+// 32 strips of differing lengths and brightness, and print how long each
+// takes. ws2812_planes_check.c checks the planes more fully, along with the
+// dithering.
+#define TEST_STRIP_COUNT 32
+#define TEST_REPEATS 16
+static uint8_t test_strip_data[TEST_STRIP_COUNT][NUM_PIXELS * 4];
+static strip_t test_strips[TEST_STRIP_COUNT];
+static strip_t *test_strip_ptrs[TEST_STRIP_COUNT];
+
+void check_transform_strips(void) {
+    for (uint i = 0; i < TEST_STRIP_COUNT; i++) {
+        // alternate RGB and RGBW strips
+        test_strips[i].data = test_strip_data[i];
+        test_strips[i].num_pixels = NUM_PIXELS - i;
+        test_strips[i].color_order = i & 1 ? COLOR_ORDER_GRBW : COLOR_ORDER_GRB;
+        test_strips[i].data_len = test_strips[i].num_pixels * color_order_bytes(test_strips[i].color_order);
+        test_strips[i].frac_brightness = 0x100 - i * 7;
+        for (uint v = 0; v < test_strips[i].data_len; v++) {
+            test_strip_data[i][v] = (uint8_t) rand();
+        }
+        test_strip_ptrs[i] = &test_strips[i];
+    }
+    // colors and states[0] are free to use as scratch until main starts
+    // drawing, as long as the dither state is cleared again afterwards
+    value_bits_t *expected = states[0];
+    value_bits_t *actual = colors;
+    uint cycles_per_us = clock_get_hz(clk_sys) / 1000000;
+    static const uint strip_counts[] = {2, 8, 16, 32};
+    for (uint n = 0; n < count_of(strip_counts); n++) {
+        uint num_strips = strip_counts[n];
+        bool match = true;
+        for (uint frac_bits = 0; frac_bits <= MAX_FRAC_BITS; frac_bits += 4) {
+            dither_init(frac_bits, GAMMA);
+            for (uint32_t brightness = 0; brightness <= 0x10000; brightness += 0x1234) {
+                transform_strips_reference(test_strip_ptrs, num_strips, expected, NUM_PIXELS * 4, brightness);
+                transform_strips(test_strip_ptrs, num_strips, actual, NUM_PIXELS * 4, brightness);
+                // planes beyond the fractional bits in use are left alone
+                for (uint v = 0; v < NUM_PIXELS * 4; v++) {
+                    match &= !memcmp(expected[v].planes, actual[v].planes, (8 + frac_bits) * sizeof(uint32_t));
                 }
             }
         }
-    }
-}
+        dither_init(FRAC_BITS, GAMMA);
 
-void dither_values(const value_bits_t *colors, value_bits_t *state, const value_bits_t *old_state, uint value_length) {
-    for (uint i = 0; i < value_length; i++) {
-        add_error(state + i, colors + i, old_state + i);
+        uint64_t start = time_us_64();
+        for (uint r = 0; r < TEST_REPEATS; r++) {
+            transform_strips_reference(test_strip_ptrs, num_strips, expected, NUM_PIXELS * 4, 0x10000);
+        }
+        uint64_t reference_us = time_us_64() - start;
+        start = time_us_64();
+        for (uint r = 0; r < TEST_REPEATS; r++) {
+            transform_strips(test_strip_ptrs, num_strips, actual, NUM_PIXELS * 4, 0x10000);
+        }
+        uint64_t transposed_us = time_us_64() - start;
+
+        // a pixel here is one RGBW pixel on one strip
+        uint pixels = TEST_REPEATS * NUM_PIXELS * num_strips;
+        printf("transform_strips, %2u strips: reference %3u cycles/pixel, transposed %3u cycles/pixel, %s\n",
+               num_strips, (uint) (reference_us * cycles_per_us / pixels),
+               (uint) (transposed_us * cycles_per_us / pixels), match ? "output matches" : "OUTPUT DIFFERS");
     }
+    memset(&states, 0, sizeof(states));
 }
 
-// requested colors * 4 to allow for RGBW
-static value_bits_t colors[NUM_PIXELS * 4];
-// double buffer the state of the pixel strip, since we update next version in parallel with DMAing out old version
-static value_bits_t states[2][NUM_PIXELS * 4];
-
-// example - strip 0 is RGB only
-static uint8_t strip0_data[NUM_PIXELS * 3];
-// example - strip 1 is RGBW
-static uint8_t strip1_data[NUM_PIXELS * 4];
-
-strip_t strip0 = {
-        .data = strip0_data,
-        .data_len = sizeof(strip0_data),
-        .frac_brightness = 0x40,
-};
-
-strip_t strip1 = {
-        .data = strip1_data,
-        .data_len = sizeof(strip1_data),
-        .frac_brightness = 0x100,
-};
-
-strip_t *strips[] = {
-        &strip0,
-        &strip1,
-};
-
 // bit plane content dma channel
 #define DMA_CHANNEL 0
 // chain channel for configuring main dma channel to output from disjoint 8 word fragments of memory
@@ -280,10 +328,76 @@ void output_strips_dma(value_bits_t *bits, uint value_length) {
 }
 
 
+// Frame pipeline: core 1 renders and dithers frame N+1 into one state buffer
+// while the DMA streams frame N out of the other. Core 1 passes the index of
+// each finished buffer to core 0 through the inter-core FIFO; core 0 waits
+// for the reset delay, starts the DMA, and passes the index back, after which
+// the previous buffer is no longer being read and core 1 can reuse it.
+
+// render statistics, written by core 1
+static volatile uint32_t frames_rendered;
+static volatile uint32_t render_busy_us;
+
+void render_frame(uint pat, uint t, uint32_t brightness, value_bits_t *state, const value_bits_t *old_state,
+                  bool clear_errors) {
+    for (uint i = 0; i < num_strips; i++) {
+        current_strip_out = strips[i]->data;
+        current_strip_order = strips[i]->color_order;
+        pattern_table[pat].pat(strips[i]->num_pixels, t);
+    }
+    transform_strips(strips, num_strips, colors, max_data_len, brightness);
+    if (clear_errors) {
+        // no accumulated error to add in
+        memcpy(state, colors, sizeof(value_bits_t) * max_data_len);
+    } else {
+        dither_values(colors, state, old_state, max_data_len);
+    }
+}
+
+void core1_render_loop(void) {
+    int t = 0;
+    uint current = 0;
+    while (1) {
+        int pat = rand() % count_of(pattern_table);
+        int dir = (rand() >> 30) & 1 ? 1 : -1;
+        if (rand() & 1) dir = 0;
+        puts(pattern_table[pat].name);
+        puts(dir == 1 ? "(forward)" : dir ? "(backward)" : "(still)");
+        uint32_t brightness = 0;
+        for (int i = 0; i < 1000; ++i) {
+            uint32_t start = time_us_32();
+            // clear out errors when the pattern changes
+            render_frame(pat, t, brightness, states[current], states[current ^ 1], i == 0);
+            render_busy_us += time_us_32() - start;
+            frames_rendered++;
+
+            // hand the frame over, and wait for the other buffer to be free
+            multicore_fifo_push_blocking(current);
+            multicore_fifo_pop_blocking();
+
+            current ^= 1;
+            t += dir;
+            // ramp up to 1/8 brightness; let's not draw too much current!
+            brightness += 0x10;
+            if (brightness == 0x2000) brightness = 0;
+        }
+    }
+}
+
 int main() {
     //set_sys_clock_48();
     stdio_init_all();
-    printf("WS2812 parallel using pin %d\n", WS2812_PIN_BASE);
+    printf("WS2812 parallel using pins %d to %d\n", WS2812_PIN_BASE, WS2812_PIN_BASE + NUM_STRIPS - 1);
+
+    dither_init(FRAC_BITS, GAMMA);
+    check_transform_strips();
+
+    // example - a mix of RGB and RGBW strips, of different lengths and
+    // brightness
+    for (uint i = 0; i < NUM_STRIPS; i++) {
+        bool rgbw = i & 1;
+        strip_array_add(NUM_PIXELS - (i / 2) * 4, rgbw ? COLOR_ORDER_GRBW : COLOR_ORDER_GRB, rgbw ? 0x100 : 0x40);
+    }
 
     PIO pio;
     uint sm;
@@ -292,41 +406,49 @@ int main() {
     // This will find a free pio and state machine for our program and load it for us
     // We use pio_claim_free_sm_and_add_program_for_gpio_range (for_gpio_range variant)
     // so we will get a PIO instance suitable for addressing gpios >= 32 if needed and supported by the hardware
-    bool success = pio_claim_free_sm_and_add_program_for_gpio_range(&ws2812_parallel_program, &pio, &sm, &offset, WS2812_PIN_BASE, count_of(strips), true);
+    bool success = pio_claim_free_sm_and_add_program_for_gpio_range(&ws2812_parallel_program, &pio, &sm, &offset, WS2812_PIN_BASE, num_strips, true);
     hard_assert(success);
 
-    ws2812_parallel_program_init(pio, sm, offset, WS2812_PIN_BASE, count_of(strips), 800000);
+    ws2812_parallel_program_init(pio, sm, offset, WS2812_PIN_BASE, num_strips, 800000);
 
     sem_init(&reset_delay_complete_sem, 1, 1); // initially posted so we don't block first time
     dma_init(pio, sm);
-    int t = 0;
-    while (1) {
-        int pat = rand() % count_of(pattern_table);
-        int dir = (rand() >> 30) & 1 ? 1 : -1;
-        if (rand() & 1) dir = 0;
-        puts(pattern_table[pat].name);
-        puts(dir == 1 ? "(forward)" : dir ? "(backward)" : "(still)");
-        int brightness = 0;
-        uint current = 0;
-        for (int i = 0; i < 1000; ++i) {
-            current_strip_out = strip0.data;
-            current_strip_4color = false;
-            pattern_table[pat].pat(NUM_PIXELS, t);
-            current_strip_out = strip1.data;
-            current_strip_4color = true;
-            pattern_table[pat].pat(NUM_PIXELS, t);
-
-            transform_strips(strips, count_of(strips), colors, NUM_PIXELS * 4, brightness);
-            dither_values(colors, states[current], states[current ^ 1], NUM_PIXELS * 4);
-            sem_acquire_blocking(&reset_delay_complete_sem);
-            output_strips_dma(states[current], NUM_PIXELS * 4);
 
-            current ^= 1;
-            t += dir;
-            brightness++;
-            if (brightness == (0x20 << FRAC_BITS)) brightness = 0;
+    multicore_launch_core1(core1_render_loop);
+
+    // each value is 8 bits of 1.25us, followed by the reset delay
+    uint frame_output_us = max_data_len * 8 * 5 / 4 + 400;
+    printf("%u strips, %u values per frame, so at most %u fps\n", num_strips, max_data_len,
+           1000000 / frame_output_us);
+
+    uint32_t frames_output = 0;
+    uint32_t last_frames_output = 0;
+    uint32_t last_frames_rendered = 0;
+    uint32_t last_render_busy_us = 0;
+    uint32_t last_report_us = time_us_32();
+    while (1) {
+        uint32_t current = multicore_fifo_pop_blocking();
+        sem_acquire_blocking(&reset_delay_complete_sem);
+        output_strips_dma(states[current], max_data_len);
+        frames_output++;
+        multicore_fifo_push_blocking(current);
+
+        uint32_t elapsed_us = time_us_32() - last_report_us;
+        if (elapsed_us >= 1000000) {
+            // fps is limited by the output time; headroom is the fraction of
+            // core 1's time not spent rendering, which could be used to
+            // render something more complicated or drive longer strips
+            uint32_t rendered = frames_rendered - last_frames_rendered;
+            uint32_t busy_us = render_busy_us - last_render_busy_us;
+            uint busy_percent = MIN(100, (uint) ((uint64_t) busy_us * 100 / elapsed_us));
+            printf("%u fps, render %u us per frame, core 1 headroom %u%%\n",
+                   (uint) ((uint64_t) (frames_output - last_frames_output) * 1000000 / elapsed_us),
+                   rendered ? (uint) (busy_us / rendered) : 0, 100 - busy_percent);
+            last_frames_output = frames_output;
+            last_frames_rendered += rendered;
+            last_render_busy_us += busy_us;
+            last_report_us += elapsed_us;
         }
-        memset(&states, 0, sizeof(states)); // clear out errors
     }
 
     // This will free resources and unload our program
@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <math.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#define __force_inline inline __attribute__((always_inline))
+#define MIN(a, b) ((b) < (a) ? (b) : (a))
+#endif
+
+#include "ws2812_planes.h"
+
+typedef void (*dither_fn)(const value_bits_t *colors, value_bits_t *state, const value_bits_t *old_state,
+                          uint32_t value_length);
+
+// Dithering setup, chosen by dither_init()
+static struct {
+    uint32_t frac_bits;
+    // 8 bit color value to 8.8 fixed point intensity
+    uint16_t gamma_lut[256];
+    dither_fn dither;
+} dither_config;
+
+// Add the frac_bits low planes of e to s and store in d. This is only used
+// with a constant frac_bits (see DITHER_VALUES_FN), so the loops are unrolled
+// and the plane offsets are constant.
+static __force_inline void add_error(value_bits_t *d, const value_bits_t *s, const value_bits_t *e,
+                                     const uint32_t frac_bits) {
+    uint32_t carry_plane = 0;
+    // add the frac_bits low planes
+    for (int p = 8 + (int) frac_bits - 1; p >= 8; p--) {
+        uint32_t e_plane = e->planes[p];
+        uint32_t s_plane = s->planes[p];
+        d->planes[p] = (e_plane ^ s_plane) ^ carry_plane;
+        carry_plane = (e_plane & s_plane) | (carry_plane & (s_plane ^ e_plane));
+    }
+    // then just ripple carry through the non fractional bits
+    for (int p = 7; p >= 0; p--) {
+        uint32_t s_plane = s->planes[p];
+        d->planes[p] = s_plane ^ carry_plane;
+        carry_plane &= s_plane;
+    }
+}
+
+// One dither loop per fractional bit depth
+#define DITHER_VALUES_FN(n) \
+static void dither_values_##n(const value_bits_t *colors, value_bits_t *state, const value_bits_t *old_state, \
+                              uint32_t value_length) { \
+    for (uint32_t i = 0; i < value_length; i++) { \
+        add_error(state + i, colors + i, old_state + i, n); \
+    } \
+}
+
+DITHER_VALUES_FN(0)
+DITHER_VALUES_FN(1)
+DITHER_VALUES_FN(2)
+DITHER_VALUES_FN(3)
+DITHER_VALUES_FN(4)
+DITHER_VALUES_FN(5)
+DITHER_VALUES_FN(6)
+DITHER_VALUES_FN(7)
+DITHER_VALUES_FN(8)
+
+static const dither_fn dither_values_fns[MAX_FRAC_BITS + 1] = {
+        dither_values_0, dither_values_1, dither_values_2, dither_values_3, dither_values_4,
+        dither_values_5, dither_values_6, dither_values_7, dither_values_8,
+};
+
+void dither_init(uint32_t frac_bits, float gamma) {
+    frac_bits = MIN(frac_bits, MAX_FRAC_BITS);
+    dither_config.frac_bits = frac_bits;
+    dither_config.dither = dither_values_fns[frac_bits];
+    for (uint32_t i = 0; i < 256; i++) {
+        float intensity = powf((float) i / 255.f, gamma) * 255.f;
+        dither_config.gamma_lut[i] = (uint16_t) (intensity * 256.f + 0.5f);
+    }
+}
+
+void dither_values(const value_bits_t *colors, value_bits_t *state, const value_bits_t *old_state,
+                   uint32_t value_length) {
+    dither_config.dither(colors, state, old_state, value_length);
+}
+
+// Apply the gamma curve and brightness to a color value, returning it as a
+// fixed point value with 8 integer and frac_bits fractional bits.
+// brightness is the overall brightness, with 0x10000 = *1.0
+static inline uint32_t scale_value(uint8_t value, uint32_t frac_brightness, uint32_t brightness) {
+    uint32_t intensity = (dither_config.gamma_lut[value] * frac_brightness) >> 8u;
+    // clamp so the multiply below can't overflow
+    intensity = MIN(intensity, 0xffffu);
+    intensity = (intensity * MIN(brightness, 0x10000u)) >> 16u;
+    return intensity >> (8 - dither_config.frac_bits);
+}
+
+// Transpose the low 16 bits of rows[0..15] as a 16x16 bit matrix, so bit j
+// of rows[i] ends up in bit i of rows[j]. The high 16 bits of each row are
+// transposed in the same way, as a second independent matrix.
+static inline void transpose_16x16_x2(uint32_t rows[16]) {
+    // Swap the off-diagonal 8x8 blocks, then the off-diagonal 4x4 blocks
+    // within each of those, and so on down to single bits. m selects the low
+    // half of each group of 2j bits.
+    uint32_t m = 0x00ff00ffu;
+    for (uint32_t j = 8; j; j >>= 1, m ^= m << j) {
+        for (uint32_t k = 0; k < 16; k = (k + j + 1) & ~j) {
+            uint32_t t = ((rows[k] >> j) ^ rows[k + j]) & m;
+            rows[k] ^= t << j;
+            rows[k + j] ^= t;
+        }
+    }
+}
+
+// Rather than setting plane bits one at a time, this scales the values for up
+// to 32 strips, then transposes them as a block: strip i's value goes in row
+// i (strips 16 to 31 in the top half of rows 0 to 15), and after the
+// transpose row j holds bit j of every strip, which is plane
+// plane_count - 1 - j.
+void transform_strips(strip_t **strips, uint32_t num_strips, value_bits_t *values, uint32_t value_length,
+                      uint32_t brightness) {
+    uint32_t rows[32];
+    uint32_t num_rows = num_strips > 16 ? 32 : 16;
+    uint32_t plane_count = 8 + dither_config.frac_bits;
+    for (uint32_t v = 0; v < value_length; v++) {
+        // the transpose is done in place, so unused rows need clearing again
+        for (uint32_t i = num_strips; i < num_rows; i++) {
+            rows[i] = 0;
+        }
+        for (uint32_t i = 0; i < num_strips; i++) {
+            uint32_t value = 0;
+            if (v < strips[i]->data_len) {
+                value = scale_value(strips[i]->data[v], strips[i]->frac_brightness, brightness);
+            }
+            rows[i] = value;
+        }
+        if (num_rows > 16) {
+            for (uint32_t i = 0; i < 16; i++) {
+                rows[i] |= rows[i + 16] << 16;
+            }
+        }
+        transpose_16x16_x2(rows);
+        for (uint32_t j = 0; j < plane_count; j++) {
+            values[v].planes[plane_count - 1 - j] = rows[j];
+        }
+    }
+}
+
+// The original version of transform_strips
+void transform_strips_reference(strip_t **strips, uint32_t num_strips, value_bits_t *values, uint32_t value_length,
+                                uint32_t brightness) {
+    uint32_t plane_count = 8 + dither_config.frac_bits;
+    for (uint32_t v = 0; v < value_length; v++) {
+        memset(&values[v], 0, sizeof(values[v]));
+        for (uint32_t i = 0; i < num_strips; i++) {
+            if (v < strips[i]->data_len) {
+                uint32_t value = scale_value(strips[i]->data[v], strips[i]->frac_brightness, brightness);
+                for (uint32_t j = 0; j < plane_count && value; j++, value >>= 1u) {
+                    if (value & 1u) values[v].planes[plane_count - 1 - j] |= 1u << i;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _WS2812_PLANES_H
+#define _WS2812_PLANES_H
+
+// Bit planes and temporal dithering for ws2812_parallel.c.
+//
+// The ws2812_parallel program sends one bit to every strip at once, so each
+// color value of a frame (the Nth byte of every strip) is stored as bit
+// planes: plane p holds bit p of the value, MSB first, for each strip, with
+// strip i in bit i. The DMA sends the 8 integer planes of each value.
+//
+// Below those are up to 8 fractional planes, which are never sent. Instead,
+// each frame adds the fractional part left over from the last one, so a
+// value between two levels is shown as a mix of the two over a few frames.
+//
+// ws2812_planes_check.c checks transform_strips() against the plain bit at a
+// time transform_strips_reference() and some hand worked planes, and the
+// long run average of the dithered output against the intended brightness.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MAX_FRAC_BITS 8
+#define MAX_VALUE_PLANE_COUNT (8 + MAX_FRAC_BITS)
+
+// Order the color bytes are sent in, which varies between LED types
+typedef enum {
+    COLOR_ORDER_GRB,    // WS2812, WS2812B
+    COLOR_ORDER_RGB,
+    COLOR_ORDER_GRBW,   // SK6812 RGBW
+    COLOR_ORDER_RGBW,
+} color_order_t;
+
+static inline uint32_t color_order_bytes(color_order_t order) {
+    return order >= COLOR_ORDER_GRBW ? 4 : 3;
+}
+
+// we store value (8 bits + fractional bits of a single color (R/G/B/W) value) for multiple
+// strips of pixels, in bit planes. bit plane N has the Nth bit of each strip of pixels.
+typedef struct {
+    // stored MSB first: the 8 integer planes, which are output, then the
+    // fractional planes
+    uint32_t planes[MAX_VALUE_PLANE_COUNT];
+} value_bits_t;
+
+typedef struct {
+    uint8_t *data;
+    uint32_t data_len;
+    uint32_t frac_brightness; // 256 = *1.0;
+    uint32_t num_pixels;
+    color_order_t color_order;
+} strip_t;
+
+// Choose the number of fractional bits (0 to MAX_FRAC_BITS) carried between
+// frames, and the gamma curve applied to color values (1.0 for linear). More
+// fractional bits give finer steps at low brightness, at the cost of a slower
+// flicker pattern.
+void dither_init(uint32_t frac_bits, float gamma);
+
+// Add the fractional part of each value in old_state to the one in colors,
+// and store the result in state
+void dither_values(const value_bits_t *colors, value_bits_t *state, const value_bits_t *old_state,
+                   uint32_t value_length);
+
+// Take 8 bit color values from up to 32 strips, apply gamma and brightness,
+// and store them in bit planes. Strips shorter than value_length are padded
+// with zeros. brightness is the overall brightness, with 0x10000 = *1.0.
+void transform_strips(strip_t **strips, uint32_t num_strips, value_bits_t *values, uint32_t value_length,
+                      uint32_t brightness);
+
+// The same, one bit at a time
+void transform_strips_reference(strip_t **strips, uint32_t num_strips, value_bits_t *values, uint32_t value_length,
+                                uint32_t brightness);
+
+#endif
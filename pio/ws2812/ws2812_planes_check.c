@@ -0,0 +1,238 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Check the bit planes and dithering in ws2812_planes.c: transform_strips()
+// against transform_strips_reference() for every fractional bit depth and
+// 1 to 32 strips of differing lengths, both against planes worked out by
+// hand, and the dithered output against the intended brightness. Over
+// 1 << frac_bits frames the output must add up to exactly the value with its
+// fractional bits, and over many frames, average out to the gamma corrected,
+// scaled intensity worked out in floating point.
+//
+// ws2812_parallel.c runs only a quick comparison at startup. The whole sweep
+// takes a while on the device, but the planes are only arrays of words, so it
+// can be left to a PC:
+//
+//   cc -DPICO_NO_HARDWARE=1 ws2812_planes_check.c ws2812_planes.c -lm
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#define count_of(a) (sizeof(a)/sizeof((a)[0]))
+#endif
+
+#include "ws2812_planes.h"
+
+#define GAMMA 2.2f
+#define MAX_STRIPS 32
+#define MAX_VALUES 64
+
+static uint8_t strip_data[MAX_STRIPS][MAX_VALUES];
+static strip_t strip_array[MAX_STRIPS];
+static strip_t *strips[MAX_STRIPS];
+static value_bits_t expected[MAX_VALUES];
+static value_bits_t actual[MAX_VALUES];
+static value_bits_t states[2][1];
+
+static uint32_t failures;
+
+static void check(const char *what, bool ok) {
+    if (!ok) {
+        printf("  %s is wrong\n", what);
+        failures++;
+    }
+}
+
+static uint32_t rand_state;
+
+static uint32_t next_rand(void) {
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+}
+
+static void init_strips(void) {
+    for (uint32_t i = 0; i < MAX_STRIPS; i++) {
+        strip_array[i].data = strip_data[i];
+        strips[i] = &strip_array[i];
+    }
+}
+
+// Random strips, each shorter and dimmer than the one before
+static void random_strips(void) {
+    rand_state = 0x5eed1234u;
+    for (uint32_t i = 0; i < MAX_STRIPS; i++) {
+        strip_array[i].data_len = MAX_VALUES - i;
+        strip_array[i].frac_brightness = 0x100 - i * 7;
+        for (uint32_t v = 0; v < MAX_VALUES; v++) {
+            strip_data[i][v] = (uint8_t) next_rand();
+        }
+    }
+}
+
+static void check_transform(void) {
+    static const uint32_t strip_counts[] = {1, 2, 8, 15, 16, 17, 31, 32};
+    random_strips();
+    for (uint32_t frac_bits = 0; frac_bits <= MAX_FRAC_BITS; frac_bits++) {
+        dither_init(frac_bits, GAMMA);
+        for (uint32_t n = 0; n < count_of(strip_counts); n++) {
+            for (uint32_t brightness = 0; brightness <= 0x10000; brightness += 0x1234) {
+                transform_strips_reference(strips, strip_counts[n], expected, MAX_VALUES, brightness);
+                transform_strips(strips, strip_counts[n], actual, MAX_VALUES, brightness);
+                bool match = true;
+                for (uint32_t v = 0; v < MAX_VALUES; v++) {
+                    match &= !memcmp(expected[v].planes, actual[v].planes, (8 + frac_bits) * sizeof(uint32_t));
+                }
+                if (!match) {
+                    printf("  %u fractional bits, %u strips, brightness %05x: planes differ\n",
+                           (unsigned) frac_bits, (unsigned) strip_counts[n], (unsigned) brightness);
+                    failures++;
+                }
+            }
+        }
+    }
+}
+
+static void set_strips(const uint8_t *values, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        strip_array[i].data_len = 1;
+        strip_array[i].frac_brightness = 0x100;
+        strip_data[i][0] = values[i];
+    }
+}
+
+// With a linear gamma, the values come out as they went in. Strips 0, 1 and
+// 2 are 0x80, 0x01 and 0xa5, and the rest 0xff.
+static void check_golden(void) {
+    uint8_t values[MAX_STRIPS];
+    memset(values, 0xff, sizeof(values));
+    values[0] = 0x80;
+    values[1] = 0x01;
+    values[2] = 0xa5;
+    set_strips(values, MAX_STRIPS);
+
+    dither_init(0, 1.0f);
+    static const uint32_t full[8] = {
+        0xfffffffdu, 0xfffffff8u, 0xfffffffcu, 0xfffffff8u, 0xfffffff8u, 0xfffffffcu, 0xfffffff8u, 0xfffffffeu,
+    };
+    transform_strips(strips, MAX_STRIPS, actual, 1, 0x10000);
+    check("full brightness", !memcmp(actual[0].planes, full, sizeof(full)));
+
+    // At half brightness, with 4 fractional bits, 0x80 is 0x40.0, 0x01 is
+    // 0x00.8, 0xa5 is 0x52.8 and 0xff is 0x7f.8
+    dither_init(4, 1.0f);
+    static const uint32_t half[12] = {
+        0x00000000u, 0xfffffffdu, 0xfffffff8u, 0xfffffffcu, 0xfffffff8u, 0xfffffff8u,
+        0xfffffffcu, 0xfffffff8u, 0xfffffffeu, 0x00000000u, 0x00000000u, 0x00000000u,
+    };
+    transform_strips(strips, MAX_STRIPS, actual, 1, 0x8000);
+    check("half brightness", !memcmp(actual[0].planes, half, sizeof(half)));
+}
+
+// The value of strip i, including its fractional bits
+static uint32_t plane_value(const value_bits_t *v, uint32_t i, uint32_t plane_count) {
+    uint32_t value = 0;
+    for (uint32_t p = 0; p < plane_count; p++) {
+        value = (value << 1) | ((v->planes[p] >> i) & 1u);
+    }
+    return value;
+}
+
+// Run frames of dithering on value_bits colors, starting with no error, and
+// add up each strip's output
+static void dither_frames(const value_bits_t *colors, uint32_t frames, uint32_t *totals) {
+    memset(totals, 0, MAX_STRIPS * sizeof(uint32_t));
+    memset(states, 0, sizeof(states));
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        value_bits_t *state = states[frame & 1];
+        dither_values(colors, state, states[(frame & 1) ^ 1], 1);
+        // the integer planes are what gets output
+        for (uint32_t i = 0; i < MAX_STRIPS; i++) {
+            totals[i] += plane_value(state, i, 8);
+        }
+    }
+}
+
+// The brightness is low, so the fractional bits matter
+#define DITHER_FRAMES 1024
+#define DITHER_BRIGHTNESS 0x2800
+
+static void check_dithering(void) {
+    static uint32_t totals[MAX_STRIPS];
+    for (uint32_t i = 0; i < MAX_STRIPS; i++) {
+        strip_array[i].data_len = 1;
+        strip_data[i][0] = (uint8_t) (i * 8 + 7);
+        strip_array[i].frac_brightness = 0x100 - i * 3;
+    }
+    static const uint32_t frac_bits_list[] = {0, 1, 2, 4, 8};
+    for (uint32_t n = 0; n < count_of(frac_bits_list); n++) {
+        uint32_t frac_bits = frac_bits_list[n];
+        dither_init(frac_bits, GAMMA);
+        static value_bits_t colors[1];
+        transform_strips(strips, MAX_STRIPS, colors, 1, DITHER_BRIGHTNESS);
+
+        // Exact over one cycle of the fractional bits
+        dither_frames(colors, 1u << frac_bits, totals);
+        bool exact = true;
+        for (uint32_t i = 0; i < MAX_STRIPS; i++) {
+            exact &= totals[i] == plane_value(&colors[0], i, 8 + frac_bits);
+        }
+        if (!exact) {
+            printf("  %u fractional bits: output over %u frames isn't the value\n", (unsigned) frac_bits,
+                   1u << frac_bits);
+            failures++;
+        }
+
+        // Close to the intended intensity in the long run. Values are
+        // truncated to frac_bits fractional bits, and the gamma table and
+        // scaling each lose a little more.
+        dither_frames(colors, DITHER_FRAMES, totals);
+        float max_error = 0;
+        for (uint32_t i = 0; i < MAX_STRIPS; i++) {
+            float intended = powf(strip_data[i][0] / 255.f, GAMMA) * 255.f *
+                             strip_array[i].frac_brightness / 256.f * DITHER_BRIGHTNESS / 65536.f;
+            float average = (float) totals[i] / DITHER_FRAMES;
+            max_error = fmaxf(max_error, fabsf(average - intended));
+        }
+        float allowed_error = 1.f / (float) (1u << frac_bits) + 0.02f;
+        if (max_error > allowed_error) {
+            printf("  %u fractional bits: average error %.4f, more than %.4f\n", (unsigned) frac_bits,
+                   (double) max_error, (double) allowed_error);
+            failures++;
+        }
+    }
+}
+
+typedef struct planes_check {
+    const char *name;
+    void (*run)(void);
+} planes_check_t;
+
+static const planes_check_t checks[] = {
+    {"Transform", check_transform},
+    {"Golden planes", check_golden},
+    {"Dithering", check_dithering},
+};
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+#endif
+    puts("WS2812 bit plane checks");
+    init_strips();
+    for (uint32_t i = 0; i < count_of(checks); i++) {
+        uint32_t before = failures;
+        checks[i].run();
+        printf("%-14s %s\n", checks[i].name, failures == before ? "ok" : "FAILED");
+    }
+    printf("\n%s\n", failures ? "WS2812 bit plane checks FAILED" : "All WS2812 bit plane checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,343 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "ws2812_sim.h"
+
+// Newer WS2812B parts need 280us of low to latch, rather than the original 50us
+const ws2812_timing_limits_t ws2812_default_limits = {
+        .t0h_min_ns = 250,
+        .t0h_max_ns = 550,
+        .t1h_min_ns = 650,
+        .t1h_max_ns = 950,
+        .bit_min_ns = 650,
+        .bit_max_ns = 1850,
+        .reset_min_ns = 280000,
+};
+
+// Instruction fields
+#define OP_JMP  0u
+#define OP_WAIT 1u
+#define OP_IN   2u
+#define OP_OUT  3u
+#define OP_PUSH_PULL 4u
+#define OP_MOV  5u
+#define OP_IRQ  6u
+#define OP_SET  7u
+
+// Source/destination encodings
+#define SRC_DEST_PINS 0u
+#define SRC_DEST_X    1u
+#define SRC_DEST_Y    2u
+#define SRC_DEST_NULL 3u
+#define MOV_SRC_OSR   7u
+#define MOV_DEST_OSR  7u
+
+typedef struct sim_state {
+    const ws2812_sim_config_t *config;
+    uint32_t pc;
+    uint32_t x;
+    uint32_t y;
+    uint32_t osr;
+    uint32_t osr_count;
+    uint32_t pins;
+    const uint32_t *fifo;
+    size_t fifo_len;
+    size_t fifo_pos;
+    uint32_t cycle;
+    uint32_t frac_acc;
+    ws2812_sim_edge_t *edges;
+    size_t max_edges;
+    ws2812_sim_result_t *result;
+} sim_state_t;
+
+static inline uint32_t bit_mask(uint32_t count) {
+    return count >= 32 ? 0xffffffffu : (1u << count) - 1;
+}
+
+static inline uint32_t bit_reverse(uint32_t v) {
+    uint32_t r = 0;
+    for (uint32_t i = 0; i < 32; i++, v >>= 1) {
+        r = (r << 1) | (v & 1u);
+    }
+    return r;
+}
+
+// Drive `count` pins from `base` with the low bits of `value`, recording edges
+static void write_pins(sim_state_t *s, uint32_t base, uint32_t count, uint32_t value) {
+    uint32_t mask = bit_mask(count);
+    uint32_t new_pins = s->pins;
+    // pin numbers wrap around at 32
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t pin = (base + i) & 31u;
+        new_pins = (new_pins & ~(1u << pin)) | (((value & mask) >> i & 1u) << pin);
+    }
+    uint32_t changed = new_pins ^ s->pins;
+    for (uint32_t pin = 0; changed; pin++, changed >>= 1) {
+        if (changed & 1u) {
+            if (s->result->n_edges < s->max_edges) {
+                ws2812_sim_edge_t *e = &s->edges[s->result->n_edges++];
+                e->cycle = s->cycle;
+                e->pin = (uint8_t) pin;
+                e->level = (uint8_t) ((new_pins >> pin) & 1u);
+            } else {
+                s->result->edges_overflowed = true;
+            }
+        }
+    }
+    s->pins = new_pins;
+}
+
+// Advance by one state machine clock
+static inline void tick(sim_state_t *s) {
+    uint32_t frac = s->frac_acc + s->config->clkdiv_frac;
+    s->frac_acc = frac & 0xffu;
+    s->cycle += (s->config->clkdiv_int ? s->config->clkdiv_int : 65536u) + (frac >> 8);
+    s->result->sm_cycles++;
+}
+
+// Refill the OSR from the FIFO if possible; returns false if the FIFO is empty
+static inline bool pull(sim_state_t *s) {
+    if (s->fifo_pos == s->fifo_len) {
+        return false;
+    }
+    s->osr = s->fifo[s->fifo_pos++];
+    s->osr_count = 0;
+    return true;
+}
+
+static uint32_t mov_source(sim_state_t *s, uint32_t src) {
+    switch (src) {
+        case SRC_DEST_PINS:
+            return s->pins;
+        case SRC_DEST_X:
+            return s->x;
+        case SRC_DEST_Y:
+            return s->y;
+        case SRC_DEST_NULL:
+            return 0;
+        case MOV_SRC_OSR:
+            return s->osr;
+        default:
+            s->result->unsupported = true;
+            return 0;
+    }
+}
+
+void ws2812_sim_set_clkdiv(ws2812_sim_config_t *config, float div) {
+    config->clkdiv_int = (uint16_t) div;
+    config->clkdiv_frac = config->clkdiv_int ? (uint8_t) ((div - (float) config->clkdiv_int) * 256.f) : 0;
+}
+
+void ws2812_sim_run(const ws2812_sim_config_t *config, const uint32_t *fifo_words, size_t n_words,
+                    ws2812_sim_edge_t *edges, size_t max_edges, ws2812_sim_result_t *result) {
+    *result = (ws2812_sim_result_t) {0};
+    sim_state_t s = {
+            .config = config,
+            .pc = config->wrap_target,
+            // the OSR starts off empty
+            .osr_count = 32,
+            .fifo = fifo_words,
+            .fifo_len = n_words,
+            .edges = edges,
+            .max_edges = max_edges,
+            .result = result,
+    };
+    const uint32_t delay_bits = 5 - config->sideset_count;
+    while (!result->unsupported) {
+        uint16_t instr = config->instructions[s.pc];
+        uint32_t op = instr >> 13;
+        uint32_t delay_sideset = (instr >> 8) & 0x1fu;
+        uint32_t delay = delay_sideset & bit_mask(delay_bits);
+        uint32_t arg1 = (instr >> 5) & 7u;
+        uint32_t arg2 = instr & 0x1fu;
+
+        // Side-set happens when the instruction starts, even if it stalls
+        if (config->sideset_count) {
+            uint32_t sideset = delay_sideset >> delay_bits;
+            uint32_t count = config->sideset_count;
+            bool enabled = true;
+            if (config->sideset_optional) {
+                count--;
+                enabled = (sideset >> count) & 1u;
+            }
+            if (enabled) {
+                write_pins(&s, config->sideset_base, count, sideset);
+            }
+        }
+
+        // Instructions which need data from the FIFO stall until it arrives;
+        // once the data has run out, we're done
+        bool needs_pull = (op == OP_OUT && s.osr_count >= config->pull_threshold) ||
+                          (op == OP_PUSH_PULL && (instr & 0x80u));
+        if (needs_pull && !pull(&s)) {
+            break;
+        }
+
+        uint32_t next_pc = s.pc == config->wrap ? config->wrap_target : s.pc + 1;
+        switch (op) {
+            case OP_JMP: {
+                bool jump;
+                switch (arg1) {
+                    case 0: jump = true; break;
+                    case 1: jump = !s.x; break;
+                    case 2: jump = s.x-- != 0; break;
+                    case 3: jump = !s.y; break;
+                    case 4: jump = s.y-- != 0; break;
+                    case 5: jump = s.x != s.y; break;
+                    case 7: jump = s.osr_count < config->pull_threshold; break;
+                    default: jump = false; result->unsupported = true; break;
+                }
+                if (jump) {
+                    next_pc = arg2;
+                }
+                break;
+            }
+            case OP_OUT: {
+                uint32_t count = arg2 ? arg2 : 32;
+                uint32_t data;
+                if (config->out_shift_right) {
+                    data = s.osr & bit_mask(count);
+                    s.osr = count == 32 ? 0 : s.osr >> count;
+                } else {
+                    data = count == 32 ? s.osr : s.osr >> (32 - count);
+                    s.osr = count == 32 ? 0 : s.osr << count;
+                }
+                s.osr_count += count;
+                switch (arg1) {
+                    case SRC_DEST_PINS: write_pins(&s, config->out_base, config->out_count, data); break;
+                    case SRC_DEST_X: s.x = data; break;
+                    case SRC_DEST_Y: s.y = data; break;
+                    case SRC_DEST_NULL: break;
+                    default: result->unsupported = true; break;
+                }
+                break;
+            }
+            case OP_PUSH_PULL:
+                if (!(instr & 0x80u)) {
+                    // push
+                    result->unsupported = true;
+                }
+                // the pull itself was done above
+                break;
+            case OP_MOV: {
+                uint32_t data = mov_source(&s, arg2 & 7u);
+                uint32_t mov_op = (arg2 >> 3) & 3u;
+                if (mov_op == 1) {
+                    data = ~data;
+                } else if (mov_op == 2) {
+                    data = bit_reverse(data);
+                }
+                switch (arg1) {
+                    case SRC_DEST_PINS: write_pins(&s, config->out_base, config->out_count, data); break;
+                    case SRC_DEST_X: s.x = data; break;
+                    case SRC_DEST_Y: s.y = data; break;
+                    case MOV_DEST_OSR: s.osr = data; s.osr_count = 0; break;
+                    default: result->unsupported = true; break;
+                }
+                break;
+            }
+            case OP_SET:
+                switch (arg1) {
+                    case SRC_DEST_PINS: write_pins(&s, config->set_base, config->set_count, arg2); break;
+                    case SRC_DEST_X: s.x = arg2; break;
+                    case SRC_DEST_Y: s.y = arg2; break;
+                    default: result->unsupported = true; break;
+                }
+                break;
+            default:
+                result->unsupported = true;
+                break;
+        }
+        s.pc = next_pc;
+        for (uint32_t i = 0; i <= delay; i++) {
+            tick(&s);
+        }
+    }
+    result->end_cycle = s.cycle;
+}
+
+static inline uint32_t cycles_to_ns(uint32_t cycles, uint32_t sys_clock_hz) {
+    return (uint32_t) ((uint64_t) cycles * 1000000000u / sys_clock_hz);
+}
+
+bool ws2812_check_pin(const ws2812_sim_edge_t *edges, size_t n_edges, uint32_t end_cycle, uint32_t pin,
+                      uint32_t sys_clock_hz, const ws2812_timing_limits_t *limits,
+                      uint8_t *bits, size_t max_bits, ws2812_check_result_t *result) {
+    *result = (ws2812_check_result_t) {
+            .t0h_min_ns = UINT32_MAX,
+            .t1h_min_ns = UINT32_MAX,
+            .bit_min_ns = UINT32_MAX,
+    };
+    // the line starts off low, which counts as a reset
+    bool have_rise = false;
+    bool have_fall = false;
+    bool in_frame = false;
+    uint32_t rise = 0;
+    uint32_t fall = 0;
+    uint32_t threshold_ns = (limits->t0h_max_ns + limits->t1h_min_ns) / 2;
+    for (size_t i = 0; i < n_edges; i++) {
+        if (edges[i].pin != pin) {
+            continue;
+        }
+        if (edges[i].level) {
+            if (have_fall) {
+                uint32_t low_ns = cycles_to_ns(edges[i].cycle - fall, sys_clock_hz);
+                if (low_ns >= limits->reset_min_ns) {
+                    result->frames++;
+                    in_frame = false;
+                }
+            }
+            if (in_frame) {
+                uint32_t bit_ns = cycles_to_ns(edges[i].cycle - rise, sys_clock_hz);
+                if (bit_ns < result->bit_min_ns) result->bit_min_ns = bit_ns;
+                if (bit_ns > result->bit_max_ns) result->bit_max_ns = bit_ns;
+                if (bit_ns < limits->bit_min_ns || bit_ns > limits->bit_max_ns) {
+                    // includes low times too short to be a bit, but too long
+                    // to be sure of a reset
+                    result->violations++;
+                }
+            }
+            rise = edges[i].cycle;
+            have_rise = true;
+            in_frame = true;
+        } else if (have_rise) {
+            fall = edges[i].cycle;
+            have_fall = true;
+            uint32_t high_ns = cycles_to_ns(fall - rise, sys_clock_hz);
+            bool one = high_ns > threshold_ns;
+            if (one) {
+                if (high_ns < result->t1h_min_ns) result->t1h_min_ns = high_ns;
+                if (high_ns > result->t1h_max_ns) result->t1h_max_ns = high_ns;
+                if (high_ns < limits->t1h_min_ns || high_ns > limits->t1h_max_ns) result->violations++;
+            } else {
+                if (high_ns < result->t0h_min_ns) result->t0h_min_ns = high_ns;
+                if (high_ns > result->t0h_max_ns) result->t0h_max_ns = high_ns;
+                if (high_ns < limits->t0h_min_ns || high_ns > limits->t0h_max_ns) result->violations++;
+            }
+            if (bits && result->bits < max_bits) {
+                uint8_t mask = (uint8_t) (0x80u >> (result->bits & 7u));
+                if (one) {
+                    bits[result->bits / 8] |= mask;
+                } else {
+                    bits[result->bits / 8] &= (uint8_t) ~mask;
+                }
+            }
+            result->bits++;
+        }
+    }
+    if (in_frame) {
+        // the last frame needs a long enough low time after it to latch
+        if (have_fall && rise < fall && cycles_to_ns(end_cycle - fall, sys_clock_hz) >= limits->reset_min_ns) {
+            result->frames++;
+        } else {
+            result->violations++;
+        }
+    }
+    if (result->t0h_min_ns == UINT32_MAX) result->t0h_min_ns = 0;
+    if (result->t1h_min_ns == UINT32_MAX) result->t1h_min_ns = 0;
+    if (result->bit_min_ns == UINT32_MAX) result->bit_min_ns = 0;
+    return !result->violations;
+}
@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _WS2812_SIM_H
+#define _WS2812_SIM_H
+
+// Cycle model of a PIO state machine running the WS2812 programs, and a
+// checker for the resulting waveform.
+//
+// ws2812_sim_run() executes a program (as assembled into ws2812.pio.h) one
+// state machine clock at a time, including delays, side-set, autopull and the
+// fractional clock divider, and records a timestamp (in system clock cycles)
+// for every edge on every output pin. It stops when the program stalls on an
+// empty TX FIFO after the last word has been consumed.
+//
+// Only the instructions the WS2812 programs need are modelled: JMP, OUT, MOV,
+// SET and PULL. Anything else stops the simulation with `unsupported` set.
+//
+// ws2812_check_pin() then decodes the bits sent on one pin, checks each
+// high time against the T0H / T1H windows, checks the bit period, and checks
+// that frames are separated by a low time long enough to latch.
+//
+// The model only reads the assembled instructions, never a PIO block, which
+// is what lets ws2812_timing.c check the programs on the host.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct ws2812_sim_config {
+    const uint16_t *instructions;
+    uint32_t length;
+    uint32_t wrap_target;
+    uint32_t wrap;
+    // number of side-set bits, including the enable bit if optional
+    uint32_t sideset_count;
+    bool sideset_optional;
+    uint32_t sideset_base;
+    uint32_t out_base;
+    uint32_t out_count;
+    uint32_t set_base;
+    uint32_t set_count;
+    bool out_shift_right;
+    // autopull is always enabled; 1 to 32
+    uint32_t pull_threshold;
+    // as in sm_config_set_clkdiv_int_frac8()
+    uint16_t clkdiv_int;
+    uint8_t clkdiv_frac;
+} ws2812_sim_config_t;
+
+typedef struct ws2812_sim_edge {
+    // system clock cycles since the start of the simulation
+    uint32_t cycle;
+    uint8_t pin;
+    uint8_t level;
+} ws2812_sim_edge_t;
+
+typedef struct ws2812_sim_result {
+    size_t n_edges;
+    // true if there were more edges than room to store them
+    bool edges_overflowed;
+    bool unsupported;
+    // time at which the program stalled for good
+    uint32_t end_cycle;
+    // state machine clocks executed
+    uint32_t sm_cycles;
+} ws2812_sim_result_t;
+
+// WS2812B datasheet limits, in nanoseconds. T0L and T1L are checked via the
+// bit period rather than directly.
+typedef struct ws2812_timing_limits {
+    uint32_t t0h_min_ns;
+    uint32_t t0h_max_ns;
+    uint32_t t1h_min_ns;
+    uint32_t t1h_max_ns;
+    uint32_t bit_min_ns;
+    uint32_t bit_max_ns;
+    // a low time of at least this long latches the data
+    uint32_t reset_min_ns;
+} ws2812_timing_limits_t;
+
+extern const ws2812_timing_limits_t ws2812_default_limits;
+
+typedef struct ws2812_check_result {
+    uint32_t bits;
+    uint32_t frames;
+    uint32_t violations;
+    uint32_t t0h_min_ns, t0h_max_ns;
+    uint32_t t1h_min_ns, t1h_max_ns;
+    uint32_t bit_min_ns, bit_max_ns;
+} ws2812_check_result_t;
+
+// Set the clock divider the same way sm_config_set_clkdiv() would
+void ws2812_sim_set_clkdiv(ws2812_sim_config_t *config, float div);
+
+void ws2812_sim_run(const ws2812_sim_config_t *config, const uint32_t *fifo_words, size_t n_words,
+                    ws2812_sim_edge_t *edges, size_t max_edges, ws2812_sim_result_t *result);
+
+// Decode and check the waveform on one pin. Decoded bits are written MSB
+// first into `bits` (which may be NULL), up to max_bits. Returns true if there
+// were no violations.
+bool ws2812_check_pin(const ws2812_sim_edge_t *edges, size_t n_edges, uint32_t end_cycle, uint32_t pin,
+                      uint32_t sys_clock_hz, const ws2812_timing_limits_t *limits,
+                      uint8_t *bits, size_t max_bits, ws2812_check_result_t *result);
+
+#endif
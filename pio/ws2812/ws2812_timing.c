@@ -0,0 +1,249 @@
+/**
+ * Copyright (c) 2026 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// Check the timing of the WS2812 PIO programs without a scope
+//
+// This runs ws2812.pio through the cycle model in ws2812_sim.c, with the same
+// shift and clock divider settings as ws2812_program_init() and
+// ws2812_parallel_program_init(), checks the resulting waveforms against the
+// WS2812B datasheet, and checks the bits decode back to the data sent. It then
+// reports how many LEDs per second each program can drive.
+//
+// No LEDs are driven, so with the header pioasm generates in generated/ it
+// runs on the host too, and a change to ws2812.pio that breaks the timing
+// fails there:
+//
+//   cc -DPICO_NO_HARDWARE=1 -Igenerated ws2812_timing.c ws2812_sim.c
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#else
+#define count_of(a) (sizeof(a)/sizeof((a)[0]))
+#endif
+
+#include "ws2812.pio.h"
+#include "ws2812_sim.h"
+
+// The LED data rate both programs are set up for
+#define WS2812_FREQ 800000
+
+// Low time left after each frame, as in ws2812_parallel.c
+#define RESET_US 400
+
+#define SERIAL_NUM_PIXELS 64
+#define PARALLEL_NUM_PIXELS 6
+#define MAX_STRIPS 32
+
+// Worst case is every strip changing twice per bit
+#define MAX_EDGES (PARALLEL_NUM_PIXELS * 24 * MAX_STRIPS * 2)
+
+static ws2812_sim_edge_t edges[MAX_EDGES];
+static uint32_t fifo[PARALLEL_NUM_PIXELS * 24 > SERIAL_NUM_PIXELS ? PARALLEL_NUM_PIXELS * 24 : SERIAL_NUM_PIXELS];
+static uint8_t sent[MAX_STRIPS][SERIAL_NUM_PIXELS * 3];
+static uint8_t received[SERIAL_NUM_PIXELS * 3];
+
+static uint32_t failures;
+
+static uint32_t rand_state = 1;
+
+// Host and device rand() differ, and we want the same data on both
+static uint32_t next_rand(void) {
+    rand_state = rand_state * 1103515245u + 12345u;
+    return rand_state >> 8;
+}
+
+static void config_serial(ws2812_sim_config_t *config, uint32_t sys_clock_hz, uint32_t freq) {
+    *config = (ws2812_sim_config_t) {
+            .instructions = ws2812_program_instructions,
+            .length = count_of(ws2812_program_instructions),
+            .wrap_target = ws2812_wrap_target,
+            .wrap = ws2812_wrap,
+            .sideset_count = 1,
+            .sideset_base = 0,
+            .out_shift_right = false,
+            .pull_threshold = 24,
+    };
+    uint32_t cycles_per_bit = ws2812_T1 + ws2812_T2 + ws2812_T3;
+    ws2812_sim_set_clkdiv(config, (float) sys_clock_hz / (float) (freq * cycles_per_bit));
+}
+
+static void config_parallel(ws2812_sim_config_t *config, uint32_t sys_clock_hz, uint32_t num_strips) {
+    *config = (ws2812_sim_config_t) {
+            .instructions = ws2812_parallel_program_instructions,
+            .length = count_of(ws2812_parallel_program_instructions),
+            .wrap_target = ws2812_parallel_wrap_target,
+            .wrap = ws2812_parallel_wrap,
+            .out_base = 0,
+            .out_count = num_strips,
+            .out_shift_right = true,
+            .pull_threshold = 32,
+    };
+    uint32_t cycles_per_bit = ws2812_parallel_T1 + ws2812_parallel_T2 + ws2812_parallel_T3;
+    ws2812_sim_set_clkdiv(config, (float) sys_clock_hz / (float) (WS2812_FREQ * cycles_per_bit));
+}
+
+static inline uint32_t reset_cycles(uint32_t sys_clock_hz) {
+    return (uint32_t) ((uint64_t) sys_clock_hz * RESET_US / 1000000);
+}
+
+// Check the waveform on one pin, and that it decodes back to `expected`.
+// Returns true if both are ok.
+static bool check_pin(const ws2812_sim_result_t *sim, uint32_t pin, uint32_t sys_clock_hz,
+                      const uint8_t *expected, uint32_t n_bytes, ws2812_check_result_t *check) {
+    memset(received, 0, sizeof(received));
+    bool ok = ws2812_check_pin(edges, sim->n_edges, sim->end_cycle + reset_cycles(sys_clock_hz), pin,
+                               sys_clock_hz, &ws2812_default_limits, received, n_bytes * 8, check);
+    ok = ok && !sim->unsupported && !sim->edges_overflowed;
+    ok = ok && check->bits == n_bytes * 8 && check->frames == 1 && !memcmp(received, expected, n_bytes);
+    return ok;
+}
+
+static void print_check(const ws2812_check_result_t *check) {
+    printf("T0H %3u-%3u ns, T1H %3u-%3u ns, bit %4u-%4u ns",
+           (unsigned) check->t0h_min_ns, (unsigned) check->t0h_max_ns,
+           (unsigned) check->t1h_min_ns, (unsigned) check->t1h_max_ns,
+           (unsigned) check->bit_min_ns, (unsigned) check->bit_max_ns);
+}
+
+// Simulate one frame of SERIAL_NUM_PIXELS, sent with put_pixel() as in ws2812.c
+static bool run_serial(uint32_t sys_clock_hz, uint32_t freq, ws2812_sim_result_t *sim,
+                       ws2812_check_result_t *check) {
+    ws2812_sim_config_t config;
+    config_serial(&config, sys_clock_hz, freq);
+    for (uint32_t i = 0; i < SERIAL_NUM_PIXELS; i++) {
+        uint32_t pixel_grb = next_rand() & 0xffffffu;
+        sent[0][i * 3] = (uint8_t) (pixel_grb >> 16);
+        sent[0][i * 3 + 1] = (uint8_t) (pixel_grb >> 8);
+        sent[0][i * 3 + 2] = (uint8_t) pixel_grb;
+        fifo[i] = pixel_grb << 8u;
+    }
+    ws2812_sim_run(&config, fifo, SERIAL_NUM_PIXELS, edges, MAX_EDGES, sim);
+    return check_pin(sim, 0, sys_clock_hz, sent[0], SERIAL_NUM_PIXELS * 3, check);
+}
+
+// Simulate one frame of PARALLEL_NUM_PIXELS on each strip. The FIFO words are
+// bit planes, one bit of every strip per word, as ws2812_parallel.c sends them
+// with a single frac bit plane.
+static bool run_parallel(uint32_t sys_clock_hz, uint32_t num_strips, ws2812_sim_result_t *sim,
+                         ws2812_check_result_t *check) {
+    ws2812_sim_config_t config;
+    config_parallel(&config, sys_clock_hz, num_strips);
+    const uint32_t n_bytes = PARALLEL_NUM_PIXELS * 3;
+    for (uint32_t strip = 0; strip < num_strips; strip++) {
+        for (uint32_t i = 0; i < n_bytes; i++) {
+            sent[strip][i] = (uint8_t) next_rand();
+        }
+    }
+    for (uint32_t bit = 0; bit < n_bytes * 8; bit++) {
+        fifo[bit] = 0;
+        for (uint32_t strip = 0; strip < num_strips; strip++) {
+            fifo[bit] |= (uint32_t) ((sent[strip][bit / 8] >> (7 - bit % 8)) & 1u) << strip;
+        }
+    }
+    ws2812_sim_run(&config, fifo, n_bytes * 8, edges, MAX_EDGES, sim);
+    bool ok = true;
+    for (uint32_t strip = 0; strip < num_strips; strip++) {
+        ws2812_check_result_t strip_check;
+        ok &= check_pin(sim, strip, sys_clock_hz, sent[strip], n_bytes, &strip_check);
+        if (!strip || !ok) {
+            *check = strip_check;
+        }
+    }
+    return ok;
+}
+
+static void check_sys_clocks(void) {
+    static const uint32_t sys_clocks_mhz[] = {48, 125, 133, 150, 200};
+    ws2812_sim_result_t sim;
+    ws2812_check_result_t check;
+    printf("\nws2812 program at %u kHz:\n", WS2812_FREQ / 1000);
+    for (uint32_t i = 0; i < count_of(sys_clocks_mhz); i++) {
+        uint32_t sys_clock_hz = sys_clocks_mhz[i] * 1000000;
+        bool ok = run_serial(sys_clock_hz, WS2812_FREQ, &sim, &check);
+        failures += !ok;
+        ws2812_sim_config_t config;
+        config_serial(&config, sys_clock_hz, WS2812_FREQ);
+        printf("  sysclk %3u MHz, clkdiv %3u + %3u/256: ", (unsigned) sys_clocks_mhz[i],
+               config.clkdiv_int, config.clkdiv_frac);
+        print_check(&check);
+        printf(" %s\n", ok ? "ok" : "FAILED");
+    }
+}
+
+// Find the range of bit rates the program stays within the datasheet limits
+// for, which is how much room there is to change T1/T2/T3 or the divider
+static void sweep_freq(uint32_t sys_clock_hz) {
+    ws2812_sim_result_t sim;
+    ws2812_check_result_t check;
+    uint32_t min_ok = 0;
+    uint32_t max_ok = 0;
+    printf("\nws2812 program bit rate sweep at sysclk %u MHz:\n", (unsigned) (sys_clock_hz / 1000000));
+    for (uint32_t freq = 500000; freq <= 1200000; freq += 25000) {
+        if (run_serial(sys_clock_hz, freq, &sim, &check)) {
+            if (!min_ok) min_ok = freq;
+            max_ok = freq;
+        } else if (freq % 100000 == 0 || freq == max_ok + 25000) {
+            printf("  %4u kHz: ", (unsigned) (freq / 1000));
+            print_check(&check);
+            printf(" out of spec\n");
+        }
+    }
+    printf("  in spec from %u to %u kHz\n", (unsigned) (min_ok / 1000), (unsigned) (max_ok / 1000));
+}
+
+static void report_throughput(uint32_t sys_clock_hz) {
+    ws2812_sim_result_t sim;
+    ws2812_check_result_t check;
+    // A typical strip length, to turn LEDs per second into frames per second
+    const uint32_t strip_len = 150;
+    printf("\nThroughput at sysclk %u MHz, %u us reset:\n", (unsigned) (sys_clock_hz / 1000000), RESET_US);
+
+    bool ok = run_serial(sys_clock_hz, WS2812_FREQ, &sim, &check);
+    failures += !ok;
+    uint64_t leds_per_sec = (uint64_t) SERIAL_NUM_PIXELS * sys_clock_hz / sim.end_cycle;
+    uint64_t frame_cycles = (uint64_t) sim.end_cycle * strip_len / SERIAL_NUM_PIXELS + reset_cycles(sys_clock_hz);
+    printf("  ws2812:                     %8u LEDs/s, %3u fps at %u LEDs %s\n",
+           (unsigned) leds_per_sec, (unsigned) (sys_clock_hz / frame_cycles), (unsigned) strip_len,
+           ok ? "ok" : "FAILED");
+
+    static const uint32_t strip_counts[] = {1, 8, 32};
+    for (uint32_t i = 0; i < count_of(strip_counts); i++) {
+        uint32_t num_strips = strip_counts[i];
+        ok = run_parallel(sys_clock_hz, num_strips, &sim, &check);
+        failures += !ok;
+        leds_per_sec = (uint64_t) PARALLEL_NUM_PIXELS * num_strips * sys_clock_hz / sim.end_cycle;
+        frame_cycles = (uint64_t) sim.end_cycle * strip_len / PARALLEL_NUM_PIXELS + reset_cycles(sys_clock_hz);
+        printf("  ws2812_parallel, %2u strip%s: %8u LEDs/s, %3u fps at %u LEDs per strip ",
+               (unsigned) num_strips, num_strips == 1 ? " " : "s", (unsigned) leds_per_sec,
+               (unsigned) (sys_clock_hz / frame_cycles), (unsigned) strip_len);
+        print_check(&check);
+        printf(" %s\n", ok ? "ok" : "FAILED");
+    }
+}
+
+int main() {
+#if !PICO_NO_HARDWARE
+    stdio_init_all();
+#endif
+    printf("WS2812 PIO timing check\n");
+    printf("Limits: T0H %u-%u ns, T1H %u-%u ns, bit %u-%u ns, reset >= %u us\n",
+           (unsigned) ws2812_default_limits.t0h_min_ns, (unsigned) ws2812_default_limits.t0h_max_ns,
+           (unsigned) ws2812_default_limits.t1h_min_ns, (unsigned) ws2812_default_limits.t1h_max_ns,
+           (unsigned) ws2812_default_limits.bit_min_ns, (unsigned) ws2812_default_limits.bit_max_ns,
+           (unsigned) (ws2812_default_limits.reset_min_ns / 1000));
+
+    check_sys_clocks();
+    sweep_freq(125000000);
+    report_throughput(125000000);
+    report_throughput(200000000);
+
+    printf("\n%s\n", failures ? "Timing checks FAILED" : "All timing checks passed");
+    return failures ? 1 : 0;
+}